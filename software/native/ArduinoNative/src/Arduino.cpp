@@ -0,0 +1,390 @@
+/**
+ * @file        Arduino.cpp
+ * @brief       ESP8266 Arduino core for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#include <errno.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <new>
+#include <random>
+
+#include "Arduino.h"
+#include "native.h"
+
+#define NATIVE_DEFAULT_CHIP_ID      0x10c488u
+#define NATIVE_HEAP_HEADER_SIZE     16u     /* Keeps alignment of new */
+
+typedef struct
+{
+    uint8_t mode;
+    uint8_t level;
+    void (*isr)(void);
+    int isrMode;
+} nativePin_t;
+
+HardwareSerial Serial;
+EspClass ESP;
+
+static std::atomic<uint64_t> clockOffset_us(0);
+static nativePin_t pins[NUM_DIGITAL_PINS];
+static std::mt19937 randomEngine;
+static uint32_t chipId = NATIVE_DEFAULT_CHIP_ID;
+static bool serialEcho = true;
+
+static std::atomic<uint32_t> heapAllocCntr(0);
+static std::atomic<uint64_t> heapAllocBytes(0);
+static std::atomic<int64_t> heapUsedBytes(0);
+static std::atomic<int64_t> heapPeakUsedBytes(0);
+static thread_local bool heapTracked = true;
+
+/*
+ * Allocations keep their size in a header, so free can update the counters.
+ */
+static void *native_heap_alloc(size_t size)
+{
+    uint8_t *p = static_cast<uint8_t *>(malloc(size + NATIVE_HEAP_HEADER_SIZE));
+    int64_t used;
+
+    if (!p)
+    {
+        throw std::bad_alloc();
+    }
+    *reinterpret_cast<size_t *>(p) = heapTracked ? size : 0;
+    if (heapTracked)
+    {
+        heapAllocCntr++;
+        heapAllocBytes += size;
+        used = heapUsedBytes += size;
+        if (used > heapPeakUsedBytes)
+        {
+            heapPeakUsedBytes = used;
+        }
+    }
+
+    return p + NATIVE_HEAP_HEADER_SIZE;
+}
+
+static void native_heap_free(void *ptr)
+{
+    uint8_t *p = static_cast<uint8_t *>(ptr);
+
+    if (!p)
+    {
+        return;
+    }
+    p -= NATIVE_HEAP_HEADER_SIZE;
+    heapUsedBytes -= *reinterpret_cast<size_t *>(p);
+    free(p);
+}
+
+void *operator new(size_t size)
+{
+    return native_heap_alloc(size);
+}
+
+void *operator new[](size_t size)
+{
+    return native_heap_alloc(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    native_heap_free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    native_heap_free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    native_heap_free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+    native_heap_free(ptr);
+}
+
+nativeHeapStats_t native_heap_stats()
+{
+    nativeHeapStats_t stats;
+
+    stats.allocCntr = heapAllocCntr;
+    stats.allocBytes = heapAllocBytes;
+    stats.usedBytes = heapUsedBytes;
+    stats.peakUsedBytes = heapPeakUsedBytes;
+
+    return stats;
+}
+
+void native_heap_reset_peak()
+{
+    heapPeakUsedBytes = static_cast<int64_t>(heapUsedBytes);
+}
+
+/*
+ * Threads of the test (fake broker, etc.) are not part of the device.
+ */
+void native_heap_track_thread(bool track)
+{
+    heapTracked = track;
+}
+
+static uint64_t native_clock_host_ns()
+{
+    struct timespec ts;
+    static uint64_t start_ns = 0;
+    uint64_t now_ns;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    now_ns = static_cast<uint64_t>(ts.tv_sec) * 1000000000u + ts.tv_nsec;
+    if (!start_ns)
+    {
+        start_ns = now_ns;
+    }
+
+    return now_ns - start_ns;
+}
+
+uint64_t native_clock_us()
+{
+    return native_clock_host_ns() / 1000u + clockOffset_us;
+}
+
+void native_clock_advance(uint32_t us)
+{
+    clockOffset_us += us;
+}
+
+/*
+ * Wall clock of the host, moved by native_clock_advance() and delay() as
+ * well, so time() of the firmware passes with the simulated clock.
+ */
+int gettimeofday(struct timeval *__restrict tv, void *__restrict) noexcept
+{
+    struct timespec ts;
+    uint64_t now_us;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    now_us = static_cast<uint64_t>(ts.tv_sec) * 1000000u + ts.tv_nsec / 1000u + clockOffset_us;
+    tv->tv_sec = now_us / 1000000u;
+    tv->tv_usec = now_us % 1000000u;
+
+    return 0;
+}
+
+time_t time(time_t *t) noexcept
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    if (t)
+    {
+        *t = tv.tv_sec;
+    }
+
+    return tv.tv_sec;
+}
+
+uint32_t millis()
+{
+    return native_clock_us() / 1000u;
+}
+
+uint32_t micros()
+{
+    return native_clock_us();
+}
+
+/*
+ * Time passes without waiting: setup() and retry waits of the firmware
+ * do not slow down the test.
+ */
+void delay(uint32_t ms)
+{
+    native_clock_advance(ms * 1000u);
+}
+
+/*
+ * Busy wait as on the target, its cost shall be measured.
+ */
+void delayMicroseconds(unsigned int us)
+{
+    uint64_t start_us = native_clock_us();
+
+    while (native_clock_us() - start_us < us)
+    {
+    }
+}
+
+void yield()
+{
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    if (pin < NUM_DIGITAL_PINS)
+    {
+        pins[pin].mode = mode;
+        if (mode == INPUT_PULLUP)
+        {
+            pins[pin].level = HIGH;
+        }
+    }
+}
+
+int digitalRead(uint8_t pin)
+{
+    return pin < NUM_DIGITAL_PINS ? pins[pin].level : LOW;
+}
+
+void digitalWrite(uint8_t pin, uint8_t level)
+{
+    if (pin < NUM_DIGITAL_PINS)
+    {
+        pins[pin].level = level ? HIGH : LOW;
+    }
+}
+
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode)
+{
+    if (pin < NUM_DIGITAL_PINS)
+    {
+        pins[pin].isr = isr;
+        pins[pin].isrMode = mode;
+    }
+}
+
+void detachInterrupt(uint8_t pin)
+{
+    if (pin < NUM_DIGITAL_PINS)
+    {
+        pins[pin].isr = NULL;
+    }
+}
+
+void native_gpio_input(uint8_t pin, int level)
+{
+    nativePin_t *p;
+    bool rising;
+
+    if (pin >= NUM_DIGITAL_PINS)
+    {
+        return;
+    }
+    p = &pins[pin];
+    level = level ? HIGH : LOW;
+    if (p->level == level)
+    {
+        return;
+    }
+    rising = level == HIGH;
+    p->level = level;
+    if (p->isr && (p->isrMode == CHANGE || (p->isrMode == RISING && rising) || (p->isrMode == FALLING && !rising)))
+    {
+        p->isr();
+    }
+}
+
+int native_gpio_output(uint8_t pin)
+{
+    return digitalRead(pin);
+}
+
+long random(long max)
+{
+    return max > 0 ? random(0, max) : 0;
+}
+
+long random(long min, long max)
+{
+    if (min >= max)
+    {
+        return min;
+    }
+
+    return min + static_cast<long>(randomEngine() % static_cast<unsigned long>(max - min));
+}
+
+void randomSeed(unsigned long seed)
+{
+    if (seed)
+    {
+        randomEngine.seed(seed);
+    }
+}
+
+/*
+ * Host clock is synchronized already, only the time zone is set.
+ */
+void configTime(const char *tz, const char *, const char *, const char *)
+{
+    setenv("TZ", tz, 1);
+    tzset();
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+    if (serialEcho)
+    {
+        fwrite(buffer, 1, size, stdout);
+    }
+
+    return size;
+}
+
+void native_serial_echo(bool echo)
+{
+    serialEcho = echo;
+    fflush(stdout);
+}
+
+uint32_t EspClass::getFreeHeap()
+{
+    int64_t used = heapUsedBytes;
+
+    return used < NATIVE_HEAP_SIZE ? NATIVE_HEAP_SIZE - used : 0;
+}
+
+uint32_t EspClass::getChipId()
+{
+    return chipId;
+}
+
+void native_set_chip_id(uint32_t id)
+{
+    chipId = id;
+}
+
+/*
+ * Cycles of an 80 MHz CPU which is as fast as the host.
+ */
+uint32_t EspClass::getCycleCount()
+{
+    return native_clock_host_ns() * getCpuFreqMHz() / 1000u;
+}
+
+uint32_t EspClass::random()
+{
+    static std::random_device device;
+
+    return device();
+}
+
+void EspClass::restart()
+{
+    fflush(stdout);
+    fprintf(stderr, "ESP.restart() called, exiting\n");
+    exit(0);
+}
@@ -0,0 +1,133 @@
+/**
+ * @file        Arduino.h
+ * @brief       ESP8266 Arduino core for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * The subset of the core used by the firmware, so it can be built and run
+ * on Linux unchanged. Flash strings are normal strings, time comes from
+ * the monotonic clock, GPIO pins are an array which can be driven by the
+ * test through native.h.
+ */
+
+#ifndef INCLUDE_ARDUINO_H
+#define INCLUDE_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <math.h>
+#include <time.h>
+#include <sys/time.h>
+
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+#include "IPAddress.h"
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH                    0x1
+#define LOW                     0x0
+
+#define INPUT                   0x00
+#define OUTPUT                  0x01
+#define INPUT_PULLUP            0x02
+
+#define RISING                  0x01
+#define FALLING                 0x02
+#define CHANGE                  0x03
+
+#define LED_BUILTIN             2
+#define NUM_DIGITAL_PINS        17
+#define digitalPinToInterrupt(p) (((p) < NUM_DIGITAL_PINS) ? (p) : -1)
+
+#define IRAM_ATTR
+#define ICACHE_RAM_ATTR
+#define ICACHE_FLASH_ATTR
+
+/* Flash is ordinary memory on the host */
+#define PROGMEM
+#define PGM_P                   const char *
+#define PGM_VOID_P              const void *
+#define PSTR(s)                 (s)
+#define F(s)                    (reinterpret_cast<const __FlashStringHelper *>(PSTR(s)))
+#define FPSTR(p)                (reinterpret_cast<const __FlashStringHelper *>(p))
+#define pgm_read_byte(addr)     (*reinterpret_cast<const uint8_t *>(addr))
+#define pgm_read_word(addr)     (*reinterpret_cast<const uint16_t *>(addr))
+#define pgm_read_dword(addr)    (*reinterpret_cast<const uint32_t *>(addr))
+#define pgm_read_ptr(addr)      (*reinterpret_cast<const void * const *>(addr))
+#define memcpy_P                memcpy
+#define memcmp_P                memcmp
+#define strlen_P                strlen
+#define strcpy_P                strcpy
+#define strncpy_P               strncpy
+#define strcmp_P                strcmp
+#define strncmp_P               strncmp
+#define strcasecmp_P            strcasecmp
+#define sprintf_P               sprintf
+#define snprintf_P              snprintf
+#define vsnprintf_P             vsnprintf
+
+extern uint32_t millis();
+extern uint32_t micros();
+extern void delay(uint32_t ms);
+extern void delayMicroseconds(unsigned int us);
+extern void yield();
+
+extern void pinMode(uint8_t pin, uint8_t mode);
+extern int digitalRead(uint8_t pin);
+extern void digitalWrite(uint8_t pin, uint8_t level);
+extern void attachInterrupt(uint8_t pin, void (*isr)(void), int mode);
+extern void detachInterrupt(uint8_t pin);
+static inline void noInterrupts() {}
+static inline void interrupts() {}
+
+extern long random(long max);
+extern long random(long min, long max);
+extern void randomSeed(unsigned long seed);
+
+extern void configTime(const char *tz, const char *server1, const char *server2 = NULL, const char *server3 = NULL);
+
+class HardwareSerial : public Stream
+{
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    void setDebugOutput(bool enable) { (void)enable; }
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+    /* Size of UART FIFO, the host never has to wait */
+    int availableForWrite() override { return 128; }
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+};
+
+extern HardwareSerial Serial;
+
+class EspClass
+{
+public:
+    uint32_t getFreeHeap();
+    uint32_t getMaxFreeBlockSize() { return getFreeHeap(); }
+    uint8_t getHeapFragmentation() { return 0; }
+    uint32_t getChipId();
+    uint32_t getFlashChipSize() { return 4 * 1024 * 1024; }
+    uint8_t getCpuFreqMHz() { return 80; }
+    uint32_t getCycleCount();
+    uint32_t random();
+    [[noreturn]] void restart();
+    [[noreturn]] void reset() { restart(); }
+};
+
+extern EspClass ESP;
+
+#endif /* INCLUDE_ARDUINO_H */
@@ -0,0 +1,32 @@
+/**
+ * @file        Client.h
+ * @brief       Arduino Client for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#ifndef INCLUDE_CLIENT_H
+#define INCLUDE_CLIENT_H
+
+#include <stdint.h>
+
+#include "Stream.h"
+#include "IPAddress.h"
+
+class Client : public Stream
+{
+public:
+    virtual int connect(IPAddress ip, uint16_t port) = 0;
+    virtual int connect(const char *host, uint16_t port) = 0;
+    using Print::write;
+    virtual int read(uint8_t *buffer, size_t size) = 0;
+    using Stream::read;
+    virtual void stop() = 0;
+    virtual uint8_t connected() = 0;
+    virtual operator bool() = 0;
+};
+
+#endif /* INCLUDE_CLIENT_H */
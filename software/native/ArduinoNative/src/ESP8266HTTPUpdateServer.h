@@ -0,0 +1,38 @@
+/**
+ * @file        ESP8266HTTPUpdateServer.h
+ * @brief       Firmware update page of the ESP8266 core for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * Handlers are registered like on the target, so order of handlers is the
+ * same, but flash cannot be written: update is always refused.
+ */
+
+#ifndef INCLUDE_ESP8266HTTPUPDATESERVER_H
+#define INCLUDE_ESP8266HTTPUPDATESERVER_H
+
+#include "ESP8266WebServer.h"
+
+class ESP8266HTTPUpdateServer
+{
+public:
+    void setup(ESP8266WebServer *server, const char *path = "/update", const char *username = NULL,
+               const char *password = NULL)
+    {
+        (void)username;
+        (void)password;
+        server->on(path, HTTP_GET, [server]()
+                   { server->send(200, "text/html",
+                                  "<html><body><form method='POST' action='' enctype='multipart/form-data'>"
+                                  "<input type='file' accept='.bin,.bin.gz' name='firmware'>"
+                                  "<input type='submit' value='Update Firmware'></form></body></html>"); });
+        server->on(path, HTTP_POST, [server]()
+                   { server->send(200, "text/html", "Update error: not supported in native environment"); },
+                   []() {});
+    }
+};
+
+#endif /* INCLUDE_ESP8266HTTPUPDATESERVER_H */
@@ -0,0 +1,622 @@
+/**
+ * @file        ESP8266WebServer.cpp
+ * @brief       Web server of the ESP8266 core for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "ESP8266WebServer.h"
+#include "detail/mimetable.h"
+
+#define NATIVE_HTTP_ETAG_BUF_SIZE   512
+
+class FunctionRequestHandler : public RequestHandler
+{
+public:
+    FunctionRequestHandler(ESP8266WebServer::THandlerFunction fn, ESP8266WebServer::THandlerFunction ufn,
+                           const String &uri, HTTPMethod method)
+        : m_fn(fn), m_ufn(ufn), m_uri(uri), m_method(method)
+    {
+    }
+
+    bool canHandle(HTTPMethod requestMethod, const String &requestUri) override
+    {
+        return (m_method == HTTP_ANY || m_method == requestMethod) && m_uri == requestUri;
+    }
+
+    bool canUpload(const String &requestUri) override
+    {
+        return m_ufn && (m_method == HTTP_ANY || m_method == HTTP_POST) && m_uri == requestUri;
+    }
+
+    bool handle(ESP8266WebServer &server, HTTPMethod requestMethod, const String &requestUri) override
+    {
+        (void)server;
+        if (!canHandle(requestMethod, requestUri))
+        {
+            return false;
+        }
+        m_fn();
+
+        return true;
+    }
+
+    void upload(ESP8266WebServer &server, const String &requestUri, HTTPUpload &upload) override
+    {
+        (void)server;
+        (void)upload;
+        if (canUpload(requestUri))
+        {
+            m_ufn();
+        }
+    }
+
+private:
+    ESP8266WebServer::THandlerFunction m_fn;
+    ESP8266WebServer::THandlerFunction m_ufn;
+    String m_uri;
+    HTTPMethod m_method;
+};
+
+/*
+ * Files of a directory. Like in the core, ETag is a hash of the whole file,
+ * so it is read twice when ETag is enabled.
+ */
+class StaticRequestHandler : public RequestHandler
+{
+public:
+    StaticRequestHandler(fs::FS &fs, const char *path, const char *uri, const char *cacheHeader)
+        : m_fs(fs), m_uri(uri), m_path(path), m_cacheHeader(cacheHeader ? cacheHeader : "")
+    {
+    }
+
+    bool canHandle(HTTPMethod requestMethod, const String &requestUri) override
+    {
+        return (requestMethod == HTTP_GET || requestMethod == HTTP_HEAD) && requestUri.startsWith(m_uri);
+    }
+
+    bool handle(ESP8266WebServer &server, HTTPMethod requestMethod, const String &requestUri) override
+    {
+        String path = m_path;
+        String contentType;
+        String etag;
+
+        if (!canHandle(requestMethod, requestUri))
+        {
+            return false;
+        }
+        if (!path.endsWith("/"))
+        {
+            path += "/";
+        }
+        path += requestUri.substring(m_uri.length() + (m_uri.endsWith("/") ? 0 : 1));
+        if (path.endsWith("/"))
+        {
+            path += "index.htm";
+        }
+        contentType = mime::getContentType(path);
+        if (!m_fs.exists(path))
+        {
+            if (!m_fs.exists(path + ".gz"))
+            {
+                return false;
+            }
+            path += ".gz";
+        }
+        fs::File file = m_fs.open(path, "r");
+        if (!file)
+        {
+            return false;
+        }
+        if (server.etagEnabled())
+        {
+            etag = "\"" + hash(file) + "\"";
+            if (server.header("If-None-Match") == etag)
+            {
+                server.send(304);
+                return true;
+            }
+            server.sendHeader("ETag", etag);
+        }
+        if (m_cacheHeader.length())
+        {
+            server.sendHeader("Cache-Control", m_cacheHeader);
+        }
+        server.streamFile(file, contentType);
+
+        return true;
+    }
+
+private:
+    static String hash(fs::File &file)
+    {
+        uint8_t buf[NATIVE_HTTP_ETAG_BUF_SIZE];
+        uint32_t hash = 2166136261u;
+        size_t len;
+        size_t i;
+        char str[9];
+
+        while ((len = file.read(buf, sizeof(buf))) > 0)
+        {
+            for (i = 0; i < len; i++)
+            {
+                hash = (hash ^ buf[i]) * 16777619u;
+            }
+        }
+        file.seek(0, SeekSet);
+        snprintf(str, sizeof(str), "%08x", hash);
+
+        return String(str);
+    }
+
+    fs::FS &m_fs;
+    String m_uri;
+    String m_path;
+    String m_cacheHeader;
+};
+
+static const char *native_http_reason(int code)
+{
+    switch (code)
+    {
+        case 200: return "OK";
+        case 204: return "No Content";
+        case 301: return "Moved Permanently";
+        case 302: return "Found";
+        case 304: return "Not Modified";
+        case 400: return "Bad Request";
+        case 401: return "Unauthorized";
+        case 403: return "Forbidden";
+        case 404: return "Not Found";
+        case 500: return "Internal Server Error";
+        case 503: return "Service Unavailable";
+        default: return "";
+    }
+}
+
+static String native_url_decode(const String &str)
+{
+    String decoded;
+    unsigned int i;
+    char hex[3] = { 0, 0, 0 };
+
+    for (i = 0; i < str.length(); i++)
+    {
+        if (str[i] == '+')
+        {
+            decoded += ' ';
+        }
+        else if (str[i] == '%' && i + 2 < str.length())
+        {
+            hex[0] = str[i + 1];
+            hex[1] = str[i + 2];
+            decoded += static_cast<char>(strtol(hex, NULL, 16));
+            i += 2;
+        }
+        else
+        {
+            decoded += str[i];
+        }
+    }
+
+    return decoded;
+}
+
+String NativeHttpResponse::header(const char *name) const
+{
+    for (const std::pair<String, String> &h : headers)
+    {
+        if (!strcasecmp(h.first.c_str(), name))
+        {
+            return h.second;
+        }
+    }
+
+    return String();
+}
+
+ESP8266WebServer::~ESP8266WebServer()
+{
+    RequestHandler *handler = m_firstHandler;
+    RequestHandler *next;
+
+    while (handler)
+    {
+        next = handler->next();
+        delete handler;
+        handler = next;
+    }
+    if (m_response.clientFd >= 0)
+    {
+        ::close(m_response.clientFd);
+    }
+}
+
+void ESP8266WebServer::on(const String &uri, HTTPMethod method, THandlerFunction fn, THandlerFunction ufn)
+{
+    addHandler(new FunctionRequestHandler(fn, ufn, uri, method));
+}
+
+void ESP8266WebServer::addHandler(RequestHandler *handler)
+{
+    if (!m_lastHandler)
+    {
+        m_firstHandler = handler;
+    }
+    else
+    {
+        m_lastHandler->next(handler);
+    }
+    m_lastHandler = handler;
+}
+
+void ESP8266WebServer::serveStatic(const char *uri, fs::FS &fs, const char *path, const char *cache_header)
+{
+    addHandler(new StaticRequestHandler(fs, path, uri, cache_header));
+}
+
+String ESP8266WebServer::arg(const String &name) const
+{
+    for (const std::pair<String, String> &a : m_args)
+    {
+        if (a.first == name)
+        {
+            return a.second;
+        }
+    }
+
+    return String();
+}
+
+String ESP8266WebServer::arg(int i) const
+{
+    return i >= 0 && i < args() ? m_args[i].second : String();
+}
+
+String ESP8266WebServer::argName(int i) const
+{
+    return i >= 0 && i < args() ? m_args[i].first : String();
+}
+
+bool ESP8266WebServer::hasArg(const String &name) const
+{
+    for (const std::pair<String, String> &a : m_args)
+    {
+        if (a.first == name)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*
+ * Like in the core, only these headers (and Authorization) are kept.
+ */
+void ESP8266WebServer::collectHeaders(const char *headerKeys[], const size_t headerKeysCount)
+{
+    size_t i;
+
+    m_collectedHeaders.clear();
+    m_collectedHeaders.push_back("Authorization");
+    for (i = 0; i < headerKeysCount; i++)
+    {
+        m_collectedHeaders.push_back(headerKeys[i]);
+    }
+}
+
+String ESP8266WebServer::header(const String &name) const
+{
+    for (const std::pair<String, String> &h : m_headers)
+    {
+        if (h.first.equalsIgnoreCase(name))
+        {
+            return h.second;
+        }
+    }
+
+    return String();
+}
+
+String ESP8266WebServer::header(int i) const
+{
+    return i >= 0 && i < headers() ? m_headers[i].second : String();
+}
+
+String ESP8266WebServer::headerName(int i) const
+{
+    return i >= 0 && i < headers() ? m_headers[i].first : String();
+}
+
+bool ESP8266WebServer::hasHeader(const String &name) const
+{
+    for (const std::pair<String, String> &h : m_headers)
+    {
+        if (h.first.equalsIgnoreCase(name))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ESP8266WebServer::sendHeader(const String &name, const String &value, bool first)
+{
+    if (first)
+    {
+        m_pendingHeaders.insert(m_pendingHeaders.begin(), std::make_pair(name, value));
+    }
+    else
+    {
+        m_pendingHeaders.push_back(std::make_pair(name, value));
+    }
+}
+
+void ESP8266WebServer::sendStatusAndHeaders(int code, const char *contentType, size_t contentLength)
+{
+    char statusLine[64];
+
+    m_response.code = code;
+    m_response.headers.clear();
+    m_response.body.clear();
+    addWire(snprintf(statusLine, sizeof(statusLine), "HTTP/1.1 %d %s\r\n", code, native_http_reason(code)));
+    if (!contentType)
+    {
+        contentType = "text/html";
+    }
+    m_response.headers.push_back(std::make_pair(String("Content-Type"), String(contentType)));
+    if (contentLength == CONTENT_LENGTH_UNKNOWN)
+    {
+        m_chunked = true;
+        m_response.headers.push_back(std::make_pair(String("Transfer-Encoding"), String("chunked")));
+    }
+    else
+    {
+        m_response.headers.push_back(std::make_pair(String("Content-Length"), String(static_cast<unsigned long>(contentLength))));
+    }
+    if (m_cors)
+    {
+        m_response.headers.push_back(std::make_pair(String("Access-Control-Allow-Origin"), String("*")));
+    }
+    m_response.headers.push_back(std::make_pair(String("Connection"), String("close")));
+    for (const std::pair<String, String> &h : m_pendingHeaders)
+    {
+        m_response.headers.push_back(h);
+    }
+    m_pendingHeaders.clear();
+    for (const std::pair<String, String> &h : m_response.headers)
+    {
+        addWire(h.first.length() + 2 + h.second.length() + 2);
+    }
+    addWire(2);
+    m_headersSent = true;
+}
+
+void ESP8266WebServer::send(int code, const char *contentType, const String &content)
+{
+    send(code, contentType, content.c_str(), content.length());
+}
+
+void ESP8266WebServer::send(int code, const char *contentType, const char *content, size_t contentLength)
+{
+    size_t len = m_contentLength == CONTENT_LENGTH_NOT_SET ? contentLength : m_contentLength;
+
+    sendStatusAndHeaders(code, contentType, len);
+    if (contentLength)
+    {
+        sendContent(content, contentLength);
+    }
+}
+
+void ESP8266WebServer::sendContent(const char *content, size_t size)
+{
+    char chunkHeader[16];
+
+    if (m_chunked)
+    {
+        /* Empty chunk is the end of response */
+        addWire(snprintf(chunkHeader, sizeof(chunkHeader), "%zx\r\n", size) + 2);
+        if (!size)
+        {
+            m_chunked = false;
+            return;
+        }
+        m_response.chunkCnt++;
+    }
+    m_response.body.append(content, size);
+    addWire(size);
+}
+
+/*
+ * Content-Encoding is added for .gz files, like in the core.
+ */
+size_t ESP8266WebServer::streamFile(fs::File &file, const String &contentType, int code)
+{
+    uint8_t buf[HTTP_DOWNLOAD_UNIT_SIZE];
+    size_t total = 0;
+    size_t len;
+
+    if (String(file.name()).endsWith(".gz") && contentType != "application/x-gzip"
+        && contentType != "application/octet-stream")
+    {
+        sendHeader("Content-Encoding", "gzip");
+    }
+    setContentLength(file.size());
+    send(code, contentType.c_str(), "");
+    while ((len = file.read(buf, sizeof(buf))) > 0)
+    {
+        sendContent(reinterpret_cast<const char *>(buf), len);
+        total += len;
+    }
+
+    return total;
+}
+
+void ESP8266WebServer::nativeBeginRequest(HTTPMethod method, const String &uri)
+{
+    int idx = uri.indexOf('?');
+    String query;
+    String param;
+    int start;
+    int end;
+    int eq;
+
+    m_currentMethod = method;
+    m_currentUri = idx < 0 ? uri : uri.substring(0, idx);
+    m_args.clear();
+    m_requestHeaders.clear();
+    m_hasUpload = false;
+    m_uploadData.clear();
+    m_requestPending = true;
+    if (idx >= 0)
+    {
+        query = uri.substring(idx + 1);
+        for (start = 0; start < static_cast<int>(query.length()); start = end + 1)
+        {
+            end = query.indexOf('&', start);
+            if (end < 0)
+            {
+                end = query.length();
+            }
+            param = query.substring(start, end);
+            eq = param.indexOf('=');
+            if (eq < 0)
+            {
+                nativeAddArg(native_url_decode(param), String());
+            }
+            else
+            {
+                nativeAddArg(native_url_decode(param.substring(0, eq)), native_url_decode(param.substring(eq + 1)));
+            }
+        }
+    }
+}
+
+void ESP8266WebServer::nativeAddArg(const String &name, const String &value)
+{
+    m_args.push_back(std::make_pair(name, value));
+}
+
+void ESP8266WebServer::nativeAddHeader(const String &name, const String &value)
+{
+    m_requestHeaders.push_back(std::make_pair(name, value));
+}
+
+void ESP8266WebServer::nativeSetUpload(const String &name, const String &fileName, const uint8_t *data, size_t len)
+{
+    m_hasUpload = true;
+    m_uploadName = name;
+    m_uploadFileName = fileName;
+    m_uploadData.assign(reinterpret_cast<const char *>(data), len);
+}
+
+void ESP8266WebServer::handleClient()
+{
+    int fds[2];
+
+    if (!m_started || !m_requestPending)
+    {
+        return;
+    }
+    m_requestPending = false;
+
+    if (m_response.clientFd >= 0)
+    {
+        ::close(m_response.clientFd);
+    }
+    m_response = NativeHttpResponse();
+    if (!socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds))
+    {
+        m_currentClient = WiFiClient(fds[0]);
+        m_response.clientFd = fds[1];
+    }
+    m_headers.clear();
+    for (const std::pair<String, String> &h : m_requestHeaders)
+    {
+        for (const String &collected : m_collectedHeaders)
+        {
+            if (collected.equalsIgnoreCase(h.first))
+            {
+                m_headers.push_back(h);
+            }
+        }
+    }
+    m_pendingHeaders.clear();
+    m_contentLength = CONTENT_LENGTH_NOT_SET;
+    m_chunked = false;
+    m_headersSent = false;
+
+    handleRequest();
+
+    /* Copies kept by handlers keep the connection open */
+    m_currentClient = WiFiClient();
+}
+
+void ESP8266WebServer::handleRequest()
+{
+    RequestHandler *handler;
+    RequestHandler *current = NULL;
+    size_t pos;
+    bool handled = false;
+
+    for (handler = m_firstHandler; handler; handler = handler->next())
+    {
+        if (handler->canHandle(m_currentMethod, m_currentUri))
+        {
+            current = handler;
+            break;
+        }
+    }
+
+    /* Body is given to upload handler in pieces of HTTP_UPLOAD_BUFLEN */
+    if (m_hasUpload && current && current->canUpload(m_currentUri))
+    {
+        m_upload.status = UPLOAD_FILE_START;
+        m_upload.name = m_uploadName;
+        m_upload.filename = m_uploadFileName;
+        m_upload.type = mime::getContentType(m_uploadFileName);
+        m_upload.totalSize = 0;
+        m_upload.currentSize = 0;
+        m_upload.contentLength = m_uploadData.size();
+        current->upload(*this, m_currentUri, m_upload);
+        for (pos = 0; pos < m_uploadData.size(); pos += m_upload.currentSize)
+        {
+            m_upload.status = UPLOAD_FILE_WRITE;
+            m_upload.currentSize = m_uploadData.size() - pos < HTTP_UPLOAD_BUFLEN ? m_uploadData.size() - pos : HTTP_UPLOAD_BUFLEN;
+            memcpy(m_upload.buf, m_uploadData.data() + pos, m_upload.currentSize);
+            current->upload(*this, m_currentUri, m_upload);
+            m_upload.totalSize += m_upload.currentSize;
+        }
+        m_upload.status = UPLOAD_FILE_END;
+        current->upload(*this, m_currentUri, m_upload);
+    }
+
+    if (current)
+    {
+        handled = current->handle(*this, m_currentMethod, m_currentUri);
+    }
+    if (!handled)
+    {
+        if (m_notFoundHandler)
+        {
+            m_notFoundHandler();
+        }
+        else
+        {
+            send(404, "text/plain", String("Not found: ") + m_currentUri);
+        }
+    }
+    if (m_chunked)
+    {
+        /* Response was not finished by handler */
+        sendContent("", 0);
+    }
+}
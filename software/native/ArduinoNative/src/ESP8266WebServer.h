@@ -0,0 +1,221 @@
+/**
+ * @file        ESP8266WebServer.h
+ * @brief       Web server of the ESP8266 core for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * Requests are not read from a socket but given by the test with the
+ * native...() methods, handleClient() processes them like the server of
+ * the core: handlers in order of registration, then not found handler.
+ * Response is captured with the bytes it would take on the wire.
+ * client() of a request is one end of a socket pair, so handlers which
+ * keep the connection (Server-Sent Events) work and the test reads the
+ * other end.
+ */
+
+#ifndef INCLUDE_ESP8266WEBSERVER_H
+#define INCLUDE_ESP8266WEBSERVER_H
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Arduino.h"
+#include "ESP8266WiFi.h"
+#include "FS.h"
+
+enum HTTPMethod
+{
+    HTTP_ANY,
+    HTTP_GET,
+    HTTP_HEAD,
+    HTTP_POST,
+    HTTP_PUT,
+    HTTP_PATCH,
+    HTTP_DELETE,
+    HTTP_OPTIONS
+};
+
+enum HTTPUploadStatus
+{
+    UPLOAD_FILE_START,
+    UPLOAD_FILE_WRITE,
+    UPLOAD_FILE_END,
+    UPLOAD_FILE_ABORTED
+};
+
+#define HTTP_DOWNLOAD_UNIT_SIZE     1460
+#define HTTP_UPLOAD_BUFLEN          2048
+#define CONTENT_LENGTH_UNKNOWN      ((size_t) -1)
+#define CONTENT_LENGTH_NOT_SET      ((size_t) -2)
+
+typedef struct
+{
+    HTTPUploadStatus status;
+    String filename;
+    String name;
+    String type;
+    size_t totalSize;       /* Size of file, known at UPLOAD_FILE_END */
+    size_t currentSize;     /* Size of data in buf */
+    size_t contentLength;   /* Size of request body */
+    uint8_t buf[HTTP_UPLOAD_BUFLEN];
+} HTTPUpload;
+
+class ESP8266WebServer;
+
+class RequestHandler
+{
+public:
+    virtual ~RequestHandler() {}
+    virtual bool canHandle(HTTPMethod method, const String &uri) { (void)method; (void)uri; return false; }
+    virtual bool canUpload(const String &uri) { (void)uri; return false; }
+    virtual bool handle(ESP8266WebServer &server, HTTPMethod requestMethod, const String &requestUri)
+    {
+        (void)server; (void)requestMethod; (void)requestUri;
+        return false;
+    }
+    virtual void upload(ESP8266WebServer &server, const String &requestUri, HTTPUpload &upload)
+    {
+        (void)server; (void)requestUri; (void)upload;
+    }
+
+    RequestHandler *next() { return m_next; }
+    void next(RequestHandler *r) { m_next = r; }
+
+private:
+    RequestHandler *m_next = NULL;
+};
+
+/* Captured response of the last request */
+class NativeHttpResponse
+{
+public:
+    String header(const char *name) const;
+
+    int code = 0;
+    std::vector<std::pair<String, String>> headers;
+    std::string body;           /* Without chunk framing */
+    size_t wireBytes = 0;       /* Status line, headers, body and chunk framing */
+    uint32_t chunkCnt = 0;      /* Chunks of chunked transfer encoding */
+    int clientFd = -1;          /* Test end of the connection, closed by next request unless taken */
+};
+
+class ESP8266WebServer
+{
+public:
+    typedef std::function<void(void)> THandlerFunction;
+
+    explicit ESP8266WebServer(int port = 80) : m_port(port) {}
+    ~ESP8266WebServer();
+
+    void begin() { m_started = true; }
+    void begin(uint16_t port) { m_port = port; begin(); }
+    void close() { m_started = false; }
+    void stop() { close(); }
+    void handleClient();
+
+    void on(const String &uri, THandlerFunction handler) { on(uri, HTTP_ANY, handler); }
+    void on(const String &uri, HTTPMethod method, THandlerFunction fn) { on(uri, method, fn, THandlerFunction()); }
+    void on(const String &uri, HTTPMethod method, THandlerFunction fn, THandlerFunction ufn);
+    void addHandler(RequestHandler *handler);
+    void serveStatic(const char *uri, fs::FS &fs, const char *path, const char *cache_header = NULL);
+    void onNotFound(THandlerFunction fn) { m_notFoundHandler = fn; }
+    void onFileUpload(THandlerFunction fn) { m_fileUploadHandler = fn; }
+
+    const String &uri() const { return m_currentUri; }
+    HTTPMethod method() const { return m_currentMethod; }
+    WiFiClient &client() { return m_currentClient; }
+    HTTPUpload &upload() { return m_upload; }
+
+    String arg(const String &name) const;
+    String arg(int i) const;
+    String argName(int i) const;
+    int args() const { return m_args.size(); }
+    bool hasArg(const String &name) const;
+    void collectHeaders(const char *headerKeys[], const size_t headerKeysCount);
+    String header(const String &name) const;
+    String header(int i) const;
+    String headerName(int i) const;
+    int headers() const { return m_headers.size(); }
+    bool hasHeader(const String &name) const;
+    String hostHeader() const { return header("Host"); }
+
+    void enableCORS(bool enable) { m_cors = enable; }
+    void enableETag(bool enable) { m_etag = enable; }
+    bool etagEnabled() const { return m_etag; }
+
+    void send(int code, const char *contentType = NULL, const String &content = String());
+    void send(int code, char *contentType, const String &content) { send(code, static_cast<const char *>(contentType), content); }
+    void send(int code, const String &contentType, const String &content) { send(code, contentType.c_str(), content); }
+    void send(int code, const char *contentType, const char *content) { send(code, contentType, content, content ? strlen(content) : 0); }
+    void send(int code, const char *contentType, const char *content, size_t contentLength);
+    void send(int code, const char *contentType, const uint8_t *content, size_t contentLength)
+    {
+        send(code, contentType, reinterpret_cast<const char *>(content), contentLength);
+    }
+    void send(int code, const char *contentType, const __FlashStringHelper *content)
+    {
+        send(code, contentType, reinterpret_cast<const char *>(content));
+    }
+    void send_P(int code, PGM_P contentType, PGM_P content) { send(code, contentType, content); }
+    void send_P(int code, PGM_P contentType, PGM_P content, size_t contentLength) { send(code, contentType, content, contentLength); }
+
+    void setContentLength(const size_t contentLength) { m_contentLength = contentLength; }
+    void sendHeader(const String &name, const String &value, bool first = false);
+    void sendContent(const String &content) { sendContent(content.c_str(), content.length()); }
+    void sendContent(const char *content) { sendContent(content, strlen(content)); }
+    void sendContent(const char *content, size_t size);
+    void sendContent_P(PGM_P content) { sendContent(content); }
+    void sendContent_P(PGM_P content, size_t size) { sendContent(content, size); }
+    size_t streamFile(fs::File &file, const String &contentType, int code = 200);
+
+    /* Native only: give a request to the server, it is processed by the
+     * next handleClient(). URI may have a query string. */
+    void nativeBeginRequest(HTTPMethod method, const String &uri);
+    void nativeAddArg(const String &name, const String &value);
+    void nativeAddHeader(const String &name, const String &value);
+    /* Body of multipart/form-data POST with one file */
+    void nativeSetUpload(const String &name, const String &fileName, const uint8_t *data, size_t len);
+    bool nativeRequestPending() const { return m_requestPending; }
+    NativeHttpResponse &nativeResponse() { return m_response; }
+
+private:
+    void handleRequest();
+    void sendStatusAndHeaders(int code, const char *contentType, size_t contentLength);
+    void addWire(size_t len) { m_response.wireBytes += len; }
+
+    int m_port;
+    bool m_started = false;
+    bool m_cors = false;
+    bool m_etag = false;
+    RequestHandler *m_firstHandler = NULL;
+    RequestHandler *m_lastHandler = NULL;
+    THandlerFunction m_notFoundHandler;
+    THandlerFunction m_fileUploadHandler;
+    std::vector<String> m_collectedHeaders;
+
+    bool m_requestPending = false;
+    HTTPMethod m_currentMethod = HTTP_GET;
+    String m_currentUri;
+    WiFiClient m_currentClient;
+    std::vector<std::pair<String, String>> m_args;
+    std::vector<std::pair<String, String>> m_headers;
+    std::vector<std::pair<String, String>> m_requestHeaders;    /* All, collected ones are copied to m_headers */
+    String m_uploadName;
+    String m_uploadFileName;
+    std::string m_uploadData;
+    bool m_hasUpload = false;
+    HTTPUpload m_upload;
+
+    std::vector<std::pair<String, String>> m_pendingHeaders;
+    size_t m_contentLength = CONTENT_LENGTH_NOT_SET;
+    bool m_chunked = false;
+    bool m_headersSent = false;
+    NativeHttpResponse m_response;
+};
+
+#endif /* INCLUDE_ESP8266WEBSERVER_H */
@@ -0,0 +1,353 @@
+/**
+ * @file        ESP8266WiFi.cpp
+ * @brief       WiFi and TCP client of the ESP8266 core for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "ESP8266WiFi.h"
+#include "native.h"
+
+#define NATIVE_TCP_MSS              1460    /* Free space of send buffer reported to firmware */
+
+typedef struct
+{
+    IPAddress ip;
+    uint16_t port;
+    uint16_t localPort;
+} nativeRedirect_t;
+
+class WiFiClientSocket
+{
+public:
+    explicit WiFiClientSocket(int fd) : m_fd(fd) {}
+    ~WiFiClientSocket() { close(); }
+
+    void close()
+    {
+        if (m_fd >= 0)
+        {
+            ::close(m_fd);
+            m_fd = -1;
+        }
+    }
+
+    int m_fd;
+};
+
+WiFiClass WiFi;
+
+static std::vector<nativeRedirect_t> redirects;
+static int wifiStatus = WL_CONNECTED;
+
+void native_net_redirect(IPAddress ip, uint16_t port, uint16_t localPort)
+{
+    for (nativeRedirect_t &redirect : redirects)
+    {
+        if (redirect.ip == ip && redirect.port == port)
+        {
+            redirect.localPort = localPort;
+            return;
+        }
+    }
+    redirects.push_back({ ip, port, localPort });
+}
+
+void native_wifi_set_status(int status)
+{
+    wifiStatus = status;
+}
+
+/*
+ * Wait until the socket is readable or writable. Time is limited by the
+ * stream timeout like on the target.
+ */
+static bool native_net_wait(int fd, short events, unsigned long timeout_ms)
+{
+    struct pollfd pfd = { fd, events, 0 };
+
+    return poll(&pfd, 1, static_cast<int>(timeout_ms)) > 0 && (pfd.revents & events);
+}
+
+WiFiClient::WiFiClient(int fd) : m_socket(std::make_shared<WiFiClientSocket>(fd))
+{
+}
+
+int WiFiClient::fd() const
+{
+    return m_socket ? m_socket->m_fd : -1;
+}
+
+int WiFiClient::connect(IPAddress ip, uint16_t port)
+{
+    struct sockaddr_in addr;
+    int err = 0;
+    socklen_t errLen = sizeof(err);
+    int sock;
+
+    stop();
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = static_cast<uint32_t>(ip);
+    addr.sin_port = htons(port);
+    for (const nativeRedirect_t &redirect : redirects)
+    {
+        if (redirect.ip == ip && redirect.port == port)
+        {
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            addr.sin_port = htons(redirect.localPort);
+        }
+    }
+
+    sock = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (sock < 0)
+    {
+        return 0;
+    }
+    if (::connect(sock, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)))
+    {
+        if (errno != EINPROGRESS
+            || !native_net_wait(sock, POLLOUT, getTimeout())
+            || getsockopt(sock, SOL_SOCKET, SO_ERROR, &err, &errLen) || err)
+        {
+            ::close(sock);
+            return 0;
+        }
+    }
+    m_socket = std::make_shared<WiFiClientSocket>(sock);
+    setNoDelay(m_noDelay);
+
+    return 1;
+}
+
+int WiFiClient::connect(const char *host, uint16_t port)
+{
+    IPAddress ip;
+
+    if (WiFi.hostByName(host, ip) != 1)
+    {
+        return 0;
+    }
+
+    return connect(ip, port);
+}
+
+/*
+ * Blocks while send buffer is full, but at most for the stream timeout.
+ */
+size_t WiFiClient::write(const uint8_t *buffer, size_t size)
+{
+    size_t written = 0;
+    ssize_t len;
+
+    while (fd() >= 0 && written < size)
+    {
+        len = send(fd(), buffer + written, size - written, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (len > 0)
+        {
+            written += len;
+        }
+        else if (len < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            if (!native_net_wait(fd(), POLLOUT, getTimeout()))
+            {
+                break;
+            }
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    return written;
+}
+
+/*
+ * Send buffer of a peer which does not read fills up, then nothing can be
+ * written without waiting, like in lwIP.
+ */
+int WiFiClient::availableForWrite()
+{
+    return connected() && native_net_wait(fd(), POLLOUT, 0) ? NATIVE_TCP_MSS : 0;
+}
+
+int WiFiClient::available()
+{
+    int len = 0;
+
+    if (fd() < 0 || ioctl(fd(), FIONREAD, &len))
+    {
+        return 0;
+    }
+
+    return len;
+}
+
+int WiFiClient::read()
+{
+    uint8_t c;
+
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int WiFiClient::read(uint8_t *buffer, size_t size)
+{
+    ssize_t len;
+
+    if (fd() < 0)
+    {
+        return -1;
+    }
+    len = recv(fd(), buffer, size, MSG_DONTWAIT);
+
+    return len > 0 ? len : 0;
+}
+
+int WiFiClient::peek()
+{
+    uint8_t c;
+
+    if (fd() < 0)
+    {
+        return -1;
+    }
+
+    return recv(fd(), &c, 1, MSG_DONTWAIT | MSG_PEEK) == 1 ? c : -1;
+}
+
+void WiFiClient::stop()
+{
+    if (m_socket)
+    {
+        m_socket->close();
+        m_socket.reset();
+    }
+}
+
+/*
+ * Connected while the peer did not close or there is still data to read.
+ */
+uint8_t WiFiClient::connected()
+{
+    uint8_t c;
+    ssize_t len;
+
+    if (fd() < 0)
+    {
+        return 0;
+    }
+    len = recv(fd(), &c, 1, MSG_DONTWAIT | MSG_PEEK);
+    if (len > 0)
+    {
+        return 1;
+    }
+
+    return len < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+}
+
+void WiFiClient::setNoDelay(bool noDelay)
+{
+    int flag = noDelay;
+
+    m_noDelay = noDelay;
+    if (fd() >= 0)
+    {
+        /* Fails for UNIX sockets of web server requests, they do not delay */
+        setsockopt(fd(), IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+    }
+}
+
+IPAddress WiFiClient::remoteIP()
+{
+    struct sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+
+    if (fd() < 0 || getpeername(fd(), reinterpret_cast<struct sockaddr *>(&addr), &len) || addr.sin_family != AF_INET)
+    {
+        /* Requests of web server come from the host itself */
+        return IPAddress(127, 0, 0, 1);
+    }
+
+    return IPAddress(static_cast<uint32_t>(addr.sin_addr.s_addr));
+}
+
+uint16_t WiFiClient::remotePort()
+{
+    struct sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+
+    if (fd() < 0 || getpeername(fd(), reinterpret_cast<struct sockaddr *>(&addr), &len) || addr.sin_family != AF_INET)
+    {
+        return 0;
+    }
+
+    return ntohs(addr.sin_port);
+}
+
+IPAddress WiFiClient::localIP()
+{
+    return WiFi.localIP();
+}
+
+int WiFiClass::status()
+{
+    return wifiStatus;
+}
+
+/*
+ * Low 3 bytes of MAC address are the chip ID on the target.
+ */
+String WiFiClass::macAddress()
+{
+    char buf[18];
+    uint32_t chipId = ESP.getChipId();
+
+    snprintf(buf, sizeof(buf), "5C:CF:7F:%02X:%02X:%02X",
+             (chipId >> 16) & 0xFF, (chipId >> 8) & 0xFF, chipId & 0xFF);
+
+    return String(buf);
+}
+
+int WiFiClass::hostByName(const char *host, IPAddress &ip, uint32_t timeout_ms)
+{
+    struct addrinfo hints;
+    struct addrinfo *result = NULL;
+
+    (void)timeout_ms;
+    if (wifiStatus != WL_CONNECTED || !host)
+    {
+        return 0;
+    }
+    if (ip.fromString(host))
+    {
+        return 1;
+    }
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(host, NULL, &hints, &result) || !result)
+    {
+        return 0;
+    }
+    ip = IPAddress(static_cast<uint32_t>(reinterpret_cast<struct sockaddr_in *>(result->ai_addr)->sin_addr.s_addr));
+    freeaddrinfo(result);
+
+    return 1;
+}
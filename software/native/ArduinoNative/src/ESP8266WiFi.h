@@ -0,0 +1,103 @@
+/**
+ * @file        ESP8266WiFi.h
+ * @brief       WiFi and TCP client of the ESP8266 core for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * The station is always connected to a network with address 127.0.0.1
+ * (native_wifi_set_status() can take it away). WiFiClient is a TCP socket
+ * of the host, connections can be redirected to local test servers by
+ * native_net_redirect().
+ */
+
+#ifndef INCLUDE_ESP8266WIFI_H
+#define INCLUDE_ESP8266WIFI_H
+
+#include <memory>
+
+#include "Arduino.h"
+#include "Client.h"
+
+#define WL_IDLE_STATUS          0
+#define WL_NO_SSID_AVAIL        1
+#define WL_SCAN_COMPLETED       2
+#define WL_CONNECTED            3
+#define WL_CONNECT_FAILED       4
+#define WL_CONNECTION_LOST      5
+#define WL_DISCONNECTED         6
+
+#define WIFI_OFF                0
+#define WIFI_STA                1
+#define WIFI_AP                 2
+#define WIFI_AP_STA             3
+
+class WiFiClientSocket;
+
+class WiFiClient : public Client
+{
+public:
+    WiFiClient() {}
+    /* Native only: client of an already connected socket, it is closed by
+     * the last copy */
+    explicit WiFiClient(int fd);
+
+    int connect(IPAddress ip, uint16_t port) override;
+    int connect(const char *host, uint16_t port) override;
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+    int availableForWrite() override;
+    int available() override;
+    int read() override;
+    int read(uint8_t *buffer, size_t size) override;
+    int read(char *buffer, size_t size) { return read(reinterpret_cast<uint8_t *>(buffer), size); }
+    int peek() override;
+    void flush() override {}
+    void stop() override;
+    uint8_t connected() override;
+    operator bool() override { return connected(); }
+
+    void setNoDelay(bool noDelay);
+    bool getNoDelay() const { return m_noDelay; }
+    void setSync(bool sync) { (void)sync; }
+    IPAddress remoteIP();
+    uint16_t remotePort();
+    IPAddress localIP();
+
+private:
+    int fd() const;
+
+    std::shared_ptr<WiFiClientSocket> m_socket;
+    bool m_noDelay = false;
+};
+
+class WiFiClass
+{
+public:
+    int status();
+    void mode(int mode) { m_mode = mode; }
+    int getMode() const { return m_mode; }
+    void begin() {}
+    void begin(const char *ssid, const char *passPhrase) { (void)ssid; (void)passPhrase; }
+    void disconnect() {}
+    String macAddress();
+    IPAddress localIP() { return IPAddress(127, 0, 0, 1); }
+    IPAddress subnetMask() { return IPAddress(255, 0, 0, 0); }
+    IPAddress gatewayIP() { return IPAddress(127, 0, 0, 1); }
+    IPAddress dnsIP(uint8_t idx = 0) { (void)idx; return IPAddress(127, 0, 0, 53); }
+    int32_t RSSI() { return -50; }
+    const char *getHostname() { return m_hostname.c_str(); }
+    bool setHostname(const char *hostname) { m_hostname = hostname; return true; }
+    int hostByName(const char *host, IPAddress &ip, uint32_t timeout_ms = 10000);
+
+private:
+    int m_mode = WIFI_OFF;
+    String m_hostname = "esp-native";
+};
+
+extern WiFiClass WiFi;
+
+#endif /* INCLUDE_ESP8266WIFI_H */
@@ -0,0 +1,13 @@
+/**
+ * @file        ESP8266mDNS.cpp
+ * @brief       mDNS responder of the ESP8266 core for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#include "ESP8266mDNS.h"
+
+MDNSResponder MDNS;
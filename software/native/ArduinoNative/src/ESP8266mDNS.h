@@ -0,0 +1,33 @@
+/**
+ * @file        ESP8266mDNS.h
+ * @brief       mDNS responder of the ESP8266 core for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * Host name is not announced, the simulated device is reached directly.
+ */
+
+#ifndef INCLUDE_ESP8266MDNS_H
+#define INCLUDE_ESP8266MDNS_H
+
+#include "Arduino.h"
+
+class MDNSResponder
+{
+public:
+    bool begin(const char *hostname) { (void)hostname; return true; }
+    bool begin(const String &hostname) { return begin(hostname.c_str()); }
+    void update() {}
+    bool addService(const char *service, const char *proto, uint16_t port)
+    {
+        (void)service; (void)proto; (void)port;
+        return true;
+    }
+};
+
+extern MDNSResponder MDNS;
+
+#endif /* INCLUDE_ESP8266MDNS_H */
@@ -0,0 +1,579 @@
+/**
+ * @file        FS.cpp
+ * @brief       File system API of the ESP8266 core for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#include <dirent.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "FS.h"
+#include "LittleFS.h"
+#include "native.h"
+
+#define NATIVE_FS_SIZE              (2 * 1024 * 1024)   /* LittleFS partition of 4 MB flash */
+#define NATIVE_FS_BLOCK_SIZE        8192
+#define NATIVE_FS_PAGE_SIZE         256
+#define NATIVE_FS_MAX_PATH_LENGTH   32
+
+namespace fs
+{
+
+class FileImpl
+{
+public:
+    FileImpl(FILE *fp, const std::string &name) : m_fp(fp), m_name(name) {}
+    ~FileImpl() { close(); }
+
+    void close()
+    {
+        if (m_fp)
+        {
+            fclose(m_fp);
+            m_fp = NULL;
+        }
+    }
+
+    FILE *m_fp;
+    std::string m_name;     /* Without leading '/', like on LittleFS */
+};
+
+class DirImpl
+{
+public:
+    std::vector<std::string> m_names;
+    size_t m_idx = 0;       /* Index of next entry + 1, 0: before first */
+};
+
+} /* namespace fs */
+
+FS LittleFS;
+
+static std::string fsRoot;
+static std::string fsTempRoot;  /* Made by native_fs_mount_copy(), removed at exit */
+static nativeFsStats_t fsStats;
+static std::map<std::string, uint32_t> fsOpenCntrs;  /* Successful opens by name without leading '/' */
+
+static std::string native_fs_path(const char *path)
+{
+    while (path && *path == '/')
+    {
+        path++;
+    }
+
+    return fsRoot + "/" + (path ? path : "");
+}
+
+static const char *native_fs_mode(const char *mode)
+{
+    if (!strcmp(mode, "r"))
+    {
+        return "rb";
+    }
+    if (!strcmp(mode, "w"))
+    {
+        return "wb";
+    }
+    if (!strcmp(mode, "a"))
+    {
+        return "ab";
+    }
+    if (!strcmp(mode, "r+"))
+    {
+        return "r+b";
+    }
+    if (!strcmp(mode, "w+"))
+    {
+        return "w+b";
+    }
+    if (!strcmp(mode, "a+"))
+    {
+        return "a+b";
+    }
+
+    return NULL;
+}
+
+static void native_fs_remove_tree(const std::string &dir)
+{
+    DIR *d = opendir(dir.c_str());
+    struct dirent *entry;
+
+    if (!d)
+    {
+        return;
+    }
+    while ((entry = readdir(d)) != NULL)
+    {
+        if (strcmp(entry->d_name, ".") && strcmp(entry->d_name, ".."))
+        {
+            unlink((dir + "/" + entry->d_name).c_str());
+        }
+    }
+    closedir(d);
+    rmdir(dir.c_str());
+}
+
+static void native_fs_cleanup()
+{
+    if (!fsTempRoot.empty())
+    {
+        native_fs_remove_tree(fsTempRoot);
+        fsTempRoot.clear();
+    }
+}
+
+bool native_fs_mount(const char *dir)
+{
+    struct stat st;
+
+    if (stat(dir, &st) || !S_ISDIR(st.st_mode))
+    {
+        return false;
+    }
+    fsRoot = dir;
+
+    return true;
+}
+
+/*
+ * Files of srcDir are copied to a new temporary directory, so the firmware
+ * can modify them freely. Like the image of data/, it is flat. NULL: empty
+ * file system.
+ */
+bool native_fs_mount_copy(const char *srcDir)
+{
+    char dir[] = "/tmp/native_fs_XXXXXX";
+    DIR *d;
+    struct dirent *entry;
+    char buf[4096];
+    size_t len;
+    bool ok = true;
+
+    native_fs_cleanup();
+    if (!mkdtemp(dir))
+    {
+        return false;
+    }
+    fsTempRoot = dir;
+    atexit(native_fs_cleanup);
+
+    if (!srcDir)
+    {
+        return native_fs_mount(dir);
+    }
+    d = opendir(srcDir);
+    if (!d)
+    {
+        return false;
+    }
+    while (ok && (entry = readdir(d)) != NULL)
+    {
+        std::string src = std::string(srcDir) + "/" + entry->d_name;
+        struct stat st;
+
+        if (stat(src.c_str(), &st) || !S_ISREG(st.st_mode))
+        {
+            continue;
+        }
+        FILE *in = fopen(src.c_str(), "rb");
+        FILE *out = fopen((fsTempRoot + "/" + entry->d_name).c_str(), "wb");
+        ok = in && out;
+        while (ok && (len = fread(buf, 1, sizeof(buf), in)) > 0)
+        {
+            ok = fwrite(buf, 1, len, out) == len;
+        }
+        if (in)
+        {
+            fclose(in);
+        }
+        if (out)
+        {
+            fclose(out);
+        }
+    }
+    closedir(d);
+
+    return ok && native_fs_mount(dir);
+}
+
+const char *native_fs_root()
+{
+    return fsRoot.c_str();
+}
+
+nativeFsStats_t native_fs_stats()
+{
+    return fsStats;
+}
+
+uint32_t native_fs_open_cntr(const char *path)
+{
+    while (*path == '/')
+    {
+        path++;
+    }
+    auto it = fsOpenCntrs.find(path);
+
+    return it != fsOpenCntrs.end() ? it->second : 0;
+}
+
+namespace fs
+{
+
+File::File()
+{
+    /* Reading a file never has to wait */
+    setTimeout(0);
+}
+
+File::File(std::shared_ptr<FileImpl> impl) : m_impl(impl)
+{
+    setTimeout(0);
+}
+
+size_t File::write(uint8_t c)
+{
+    return write(&c, 1);
+}
+
+size_t File::write(const uint8_t *buffer, size_t size)
+{
+    size_t written;
+
+    if (!m_impl || !m_impl->m_fp)
+    {
+        return 0;
+    }
+    written = fwrite(buffer, 1, size, m_impl->m_fp);
+    fsStats.writeBytes += written;
+
+    return written;
+}
+
+int File::available()
+{
+    size_t pos;
+
+    if (!m_impl || !m_impl->m_fp)
+    {
+        return 0;
+    }
+    pos = position();
+
+    return size() > pos ? size() - pos : 0;
+}
+
+int File::read()
+{
+    uint8_t c;
+
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+size_t File::read(uint8_t *buffer, size_t size)
+{
+    size_t len;
+
+    if (!m_impl || !m_impl->m_fp)
+    {
+        return 0;
+    }
+    len = fread(buffer, 1, size, m_impl->m_fp);
+    fsStats.readBytes += len;
+
+    return len;
+}
+
+int File::peek()
+{
+    int c;
+
+    if (!m_impl || !m_impl->m_fp)
+    {
+        return -1;
+    }
+    c = fgetc(m_impl->m_fp);
+    if (c != EOF)
+    {
+        ungetc(c, m_impl->m_fp);
+    }
+
+    return c == EOF ? -1 : c;
+}
+
+void File::flush()
+{
+    if (m_impl && m_impl->m_fp)
+    {
+        fflush(m_impl->m_fp);
+    }
+}
+
+bool File::seek(uint32_t pos, SeekMode mode)
+{
+    static const int whence[] = { SEEK_SET, SEEK_CUR, SEEK_END };
+
+    if (!m_impl || !m_impl->m_fp)
+    {
+        return false;
+    }
+
+    return !fseek(m_impl->m_fp, static_cast<long>(pos), whence[mode]);
+}
+
+size_t File::position() const
+{
+    long pos;
+
+    if (!m_impl || !m_impl->m_fp)
+    {
+        return 0;
+    }
+    pos = ftell(m_impl->m_fp);
+
+    return pos < 0 ? 0 : pos;
+}
+
+size_t File::size() const
+{
+    struct stat st;
+
+    if (!m_impl || !m_impl->m_fp)
+    {
+        return 0;
+    }
+    /* Buffered writes belong to the size */
+    fflush(m_impl->m_fp);
+
+    return fstat(fileno(m_impl->m_fp), &st) ? 0 : st.st_size;
+}
+
+bool File::truncate(uint32_t size)
+{
+    if (!m_impl || !m_impl->m_fp)
+    {
+        return false;
+    }
+    fflush(m_impl->m_fp);
+
+    return !ftruncate(fileno(m_impl->m_fp), size);
+}
+
+void File::close()
+{
+    if (m_impl)
+    {
+        m_impl->close();
+        m_impl.reset();
+    }
+}
+
+File::operator bool() const
+{
+    return m_impl && m_impl->m_fp;
+}
+
+const char *File::name() const
+{
+    return m_impl ? m_impl->m_name.c_str() : "";
+}
+
+const char *File::fullName() const
+{
+    return name();
+}
+
+time_t File::getLastWrite()
+{
+    struct stat st;
+
+    if (!m_impl || !m_impl->m_fp)
+    {
+        return 0;
+    }
+
+    return fstat(fileno(m_impl->m_fp), &st) ? 0 : st.st_mtime;
+}
+
+bool Dir::next()
+{
+    if (!m_impl || m_impl->m_idx > m_impl->m_names.size())
+    {
+        return false;
+    }
+    m_impl->m_idx++;
+
+    return m_impl->m_idx <= m_impl->m_names.size();
+}
+
+bool Dir::rewind()
+{
+    if (m_impl)
+    {
+        m_impl->m_idx = 0;
+    }
+
+    return true;
+}
+
+String Dir::fileName()
+{
+    if (!m_impl || !m_impl->m_idx || m_impl->m_idx > m_impl->m_names.size())
+    {
+        return String();
+    }
+
+    return String(m_impl->m_names[m_impl->m_idx - 1].c_str());
+}
+
+size_t Dir::fileSize()
+{
+    struct stat st;
+
+    return stat(native_fs_path(fileName().c_str()).c_str(), &st) ? 0 : st.st_size;
+}
+
+time_t Dir::fileTime()
+{
+    struct stat st;
+
+    return stat(native_fs_path(fileName().c_str()).c_str(), &st) ? 0 : st.st_mtime;
+}
+
+File Dir::openFile(const char *mode)
+{
+    return LittleFS.open(fileName(), mode);
+}
+
+bool FS::begin()
+{
+    if (fsRoot.empty())
+    {
+        /* Empty file system, like a freshly formatted flash */
+        return native_fs_mount_copy(NULL);
+    }
+
+    return true;
+}
+
+bool FS::format()
+{
+    DIR *d = opendir(fsRoot.c_str());
+    struct dirent *entry;
+
+    if (!d)
+    {
+        return false;
+    }
+    while ((entry = readdir(d)) != NULL)
+    {
+        if (strcmp(entry->d_name, ".") && strcmp(entry->d_name, ".."))
+        {
+            unlink(native_fs_path(entry->d_name).c_str());
+        }
+    }
+    closedir(d);
+
+    return true;
+}
+
+bool FS::info(FSInfo &info)
+{
+    Dir dir = openDir("/");
+
+    memset(&info, 0, sizeof(info));
+    info.totalBytes = NATIVE_FS_SIZE;
+    info.blockSize = NATIVE_FS_BLOCK_SIZE;
+    info.pageSize = NATIVE_FS_PAGE_SIZE;
+    info.maxOpenFiles = 5;
+    info.maxPathLength = NATIVE_FS_MAX_PATH_LENGTH;
+    while (dir.next())
+    {
+        /* Every file takes whole blocks */
+        info.usedBytes += (dir.fileSize() + NATIVE_FS_BLOCK_SIZE - 1) / NATIVE_FS_BLOCK_SIZE * NATIVE_FS_BLOCK_SIZE;
+    }
+
+    return true;
+}
+
+File FS::open(const char *path, const char *mode)
+{
+    const char *hostMode = native_fs_mode(mode);
+    struct stat st;
+    FILE *fp;
+
+    if (!hostMode || !path)
+    {
+        return File();
+    }
+    std::string hostPath = native_fs_path(path);
+    /* Directories cannot be opened as file */
+    if (!stat(hostPath.c_str(), &st) && !S_ISREG(st.st_mode))
+    {
+        return File();
+    }
+    fp = fopen(hostPath.c_str(), hostMode);
+    if (!fp)
+    {
+        return File();
+    }
+    fsStats.openCntr++;
+    while (*path == '/')
+    {
+        path++;
+    }
+    fsOpenCntrs[path]++;
+
+    return File(std::make_shared<FileImpl>(fp, path));
+}
+
+bool FS::exists(const char *path)
+{
+    struct stat st;
+
+    return path && !stat(native_fs_path(path).c_str(), &st);
+}
+
+bool FS::remove(const char *path)
+{
+    return path && !unlink(native_fs_path(path).c_str());
+}
+
+bool FS::rename(const char *pathFrom, const char *pathTo)
+{
+    return pathFrom && pathTo && !::rename(native_fs_path(pathFrom).c_str(), native_fs_path(pathTo).c_str());
+}
+
+Dir FS::openDir(const char *path)
+{
+    std::shared_ptr<DirImpl> impl = std::make_shared<DirImpl>();
+    DIR *d = opendir(native_fs_path(path).c_str());
+    struct dirent *entry;
+
+    if (d)
+    {
+        while ((entry = readdir(d)) != NULL)
+        {
+            if (entry->d_type == DT_REG)
+            {
+                impl->m_names.push_back(entry->d_name);
+            }
+        }
+        closedir(d);
+    }
+
+    return Dir(impl);
+}
+
+} /* namespace fs */
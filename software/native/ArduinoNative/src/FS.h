@@ -0,0 +1,131 @@
+/**
+ * @file        FS.h
+ * @brief       File system API of the ESP8266 core for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * Files are stored in a directory of the host (native_fs_mount()). The file
+ * system is flat like the image of data/, leading '/' of paths is optional.
+ * Opens and transferred bytes are counted for the benchmarks.
+ */
+
+#ifndef INCLUDE_FS_H
+#define INCLUDE_FS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#include <memory>
+
+#include "Arduino.h"
+
+namespace fs
+{
+
+enum SeekMode
+{
+    SeekSet = 0,
+    SeekCur = 1,
+    SeekEnd = 2
+};
+
+struct FSInfo
+{
+    size_t totalBytes;
+    size_t usedBytes;
+    size_t blockSize;
+    size_t pageSize;
+    size_t maxOpenFiles;
+    size_t maxPathLength;
+};
+
+class FileImpl;
+class DirImpl;
+
+class File : public Stream
+{
+public:
+    File();
+    explicit File(std::shared_ptr<FileImpl> impl);
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+    int available() override;
+    int read() override;
+    int peek() override;
+    void flush() override;
+    int availableForWrite() override { return 1024; }
+    size_t read(uint8_t *buffer, size_t size);
+    size_t readBytes(char *buffer, size_t length) override { return read(reinterpret_cast<uint8_t *>(buffer), length); }
+    bool seek(uint32_t pos, SeekMode mode);
+    bool seek(uint32_t pos) { return seek(pos, SeekSet); }
+    size_t position() const;
+    size_t size() const;
+    bool truncate(uint32_t size);
+    void close();
+    operator bool() const;
+    const char *name() const;
+    const char *fullName() const;
+    bool isFile() const { return static_cast<bool>(*this); }
+    bool isDirectory() const { return false; }
+    time_t getLastWrite();
+
+private:
+    std::shared_ptr<FileImpl> m_impl;
+};
+
+class Dir
+{
+public:
+    Dir() {}
+    explicit Dir(std::shared_ptr<DirImpl> impl) : m_impl(impl) {}
+
+    bool next();
+    bool rewind();
+    String fileName();
+    size_t fileSize();
+    time_t fileTime();
+    bool isFile() const { return true; }
+    bool isDirectory() const { return false; }
+    File openFile(const char *mode);
+
+private:
+    std::shared_ptr<DirImpl> m_impl;
+};
+
+class FS
+{
+public:
+    bool begin();
+    void end() {}
+    bool format();
+    bool info(FSInfo &info);
+    File open(const char *path, const char *mode);
+    File open(const String &path, const char *mode) { return open(path.c_str(), mode); }
+    bool exists(const char *path);
+    bool exists(const String &path) { return exists(path.c_str()); }
+    bool remove(const char *path);
+    bool remove(const String &path) { return remove(path.c_str()); }
+    bool rename(const char *pathFrom, const char *pathTo);
+    bool rename(const String &pathFrom, const String &pathTo) { return rename(pathFrom.c_str(), pathTo.c_str()); }
+    Dir openDir(const char *path);
+    Dir openDir(const String &path) { return openDir(path.c_str()); }
+};
+
+} /* namespace fs */
+
+using fs::FS;
+using fs::File;
+using fs::Dir;
+using fs::FSInfo;
+using fs::SeekMode;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
+
+#endif /* INCLUDE_FS_H */
@@ -0,0 +1,36 @@
+/**
+ * @file        IPAddress.cpp
+ * @brief       Arduino IPv4 address for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#include <arpa/inet.h>
+#include <stdio.h>
+
+#include "IPAddress.h"
+
+bool IPAddress::fromString(const char *str)
+{
+    struct in_addr addr;
+
+    if (!str || inet_pton(AF_INET, str, &addr) != 1)
+    {
+        return false;
+    }
+    m_addr = addr.s_addr;
+
+    return true;
+}
+
+String IPAddress::toString() const
+{
+    char buf[16];
+
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+
+    return String(buf);
+}
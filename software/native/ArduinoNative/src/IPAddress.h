@@ -0,0 +1,41 @@
+/**
+ * @file        IPAddress.h
+ * @brief       Arduino IPv4 address for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#ifndef INCLUDE_IPADDRESS_H
+#define INCLUDE_IPADDRESS_H
+
+#include <stdint.h>
+
+#include "WString.h"
+
+class IPAddress
+{
+public:
+    IPAddress() : m_addr(0) {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : m_addr(a | (b << 8) | (c << 16) | (static_cast<uint32_t>(d) << 24)) {}
+    IPAddress(uint32_t addr) : m_addr(addr) {}
+    IPAddress(const uint8_t *addr) : IPAddress(addr[0], addr[1], addr[2], addr[3]) {}
+
+    /* Network byte order, like on the target */
+    operator uint32_t() const { return m_addr; }
+    uint8_t operator[](int idx) const { return (m_addr >> (idx * 8)) & 0xFF; }
+    bool operator==(const IPAddress &addr) const { return m_addr == addr.m_addr; }
+    bool operator!=(const IPAddress &addr) const { return m_addr != addr.m_addr; }
+    bool isSet() const { return m_addr != 0; }
+
+    bool fromString(const char *str);
+    bool fromString(const String &str) { return fromString(str.c_str()); }
+    String toString() const;
+
+private:
+    uint32_t m_addr;
+};
+
+#endif /* INCLUDE_IPADDRESS_H */
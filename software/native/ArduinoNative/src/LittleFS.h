@@ -0,0 +1,18 @@
+/**
+ * @file        LittleFS.h
+ * @brief       LittleFS of the ESP8266 core for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#ifndef INCLUDE_LITTLEFS_H
+#define INCLUDE_LITTLEFS_H
+
+#include "FS.h"
+
+extern FS LittleFS;
+
+#endif /* INCLUDE_LITTLEFS_H */
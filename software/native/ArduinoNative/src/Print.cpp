@@ -0,0 +1,80 @@
+/**
+ * @file        Print.cpp
+ * @brief       Arduino Print for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+
+#include "Print.h"
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+    size_t n = 0;
+
+    while (size--)
+    {
+        if (!write(*buffer++))
+        {
+            break;
+        }
+        n++;
+    }
+
+    return n;
+}
+
+static size_t print_vformat(Print &out, const char *format, va_list args)
+{
+    char buf[128];
+    va_list copy;
+    int len;
+
+    va_copy(copy, args);
+    len = vsnprintf(buf, sizeof(buf), format, copy);
+    va_end(copy);
+    if (len < 0)
+    {
+        return 0;
+    }
+    if (static_cast<size_t>(len) < sizeof(buf))
+    {
+        return out.write(buf, len);
+    }
+
+    char *big = new char[len + 1];
+    vsnprintf(big, len + 1, format, args);
+    len = out.write(big, len);
+    delete[] big;
+
+    return len;
+}
+
+size_t Print::printf(const char *format, ...)
+{
+    va_list args;
+    size_t len;
+
+    va_start(args, format);
+    len = print_vformat(*this, format, args);
+    va_end(args);
+
+    return len;
+}
+
+size_t Print::printf_P(const char *format, ...)
+{
+    va_list args;
+    size_t len;
+
+    va_start(args, format);
+    len = print_vformat(*this, format, args);
+    va_end(args);
+
+    return len;
+}
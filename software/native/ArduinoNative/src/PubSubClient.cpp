@@ -0,0 +1,500 @@
+/**
+ * @file        PubSubClient.cpp
+ * @brief       MQTT client for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#include "PubSubClient.h"
+
+PubSubClient::PubSubClient()
+{
+    setBufferSize(MQTT_MAX_PACKET_SIZE);
+}
+
+PubSubClient::PubSubClient(Client &client) : PubSubClient()
+{
+    setClient(client);
+}
+
+PubSubClient::~PubSubClient()
+{
+    delete[] m_buffer;
+}
+
+PubSubClient &PubSubClient::setServer(IPAddress ip, uint16_t port)
+{
+    m_ip = ip;
+    m_port = port;
+    m_domain = NULL;
+
+    return *this;
+}
+
+PubSubClient &PubSubClient::setServer(const char *domain, uint16_t port)
+{
+    m_domain = domain;
+    m_port = port;
+
+    return *this;
+}
+
+PubSubClient &PubSubClient::setCallback(MQTT_CALLBACK_SIGNATURE)
+{
+    this->callback = callback;
+
+    return *this;
+}
+
+PubSubClient &PubSubClient::setClient(Client &client)
+{
+    m_client = &client;
+
+    return *this;
+}
+
+PubSubClient &PubSubClient::setKeepAlive(uint16_t keepAlive)
+{
+    m_keepAlive = keepAlive;
+
+    return *this;
+}
+
+PubSubClient &PubSubClient::setSocketTimeout(uint16_t timeout)
+{
+    m_socketTimeout = timeout;
+
+    return *this;
+}
+
+bool PubSubClient::setBufferSize(uint16_t size)
+{
+    uint8_t *buffer;
+
+    if (!size)
+    {
+        return false;
+    }
+    buffer = new uint8_t[size];
+    if (m_buffer)
+    {
+        memcpy(buffer, m_buffer, size < m_bufferSize ? size : m_bufferSize);
+        delete[] m_buffer;
+    }
+    m_buffer = buffer;
+    m_bufferSize = size;
+
+    return true;
+}
+
+bool PubSubClient::connect(const char *id)
+{
+    return connect(id, NULL, NULL, NULL, 0, false, NULL, true);
+}
+
+bool PubSubClient::connect(const char *id, const char *user, const char *pass)
+{
+    return connect(id, user, pass, NULL, 0, false, NULL, true);
+}
+
+bool PubSubClient::connect(const char *id, const char *willTopic, uint8_t willQos, bool willRetain, const char *willMessage)
+{
+    return connect(id, NULL, NULL, willTopic, willQos, willRetain, willMessage, true);
+}
+
+/*
+ * An already open TCP connection is used, otherwise it is opened here.
+ * CONNACK is waited for by polling, up to the socket timeout.
+ */
+bool PubSubClient::connect(const char *id, const char *user, const char *pass, const char *willTopic, uint8_t willQos,
+                           bool willRetain, const char *willMessage, bool cleanSession)
+{
+    static const uint8_t header[] = { 0x00, 0x04, 'M', 'Q', 'T', 'T', MQTT_VERSION };
+    uint16_t pos = MQTT_MAX_HEADER_SIZE;
+    uint8_t flags = 0;
+    uint8_t lengthLength;
+    int result;
+
+    if (connected())
+    {
+        return true;
+    }
+    if (!m_client)
+    {
+        m_state = MQTT_CONNECT_FAILED;
+        return false;
+    }
+    if (m_client->connected())
+    {
+        result = 1;
+    }
+    else if (m_domain)
+    {
+        result = m_client->connect(m_domain, m_port);
+    }
+    else
+    {
+        result = m_client->connect(m_ip, m_port);
+    }
+    if (result != 1)
+    {
+        m_state = MQTT_CONNECT_FAILED;
+        return false;
+    }
+
+    m_nextMsgId = 1;
+    memcpy(m_buffer + pos, header, sizeof(header));
+    pos += sizeof(header);
+    if (willTopic)
+    {
+        flags = 0x04 | (willQos << 3) | (willRetain << 5);
+    }
+    if (cleanSession)
+    {
+        flags |= 0x02;
+    }
+    if (user)
+    {
+        flags |= 0x80;
+        if (pass)
+        {
+            flags |= 0x40;
+        }
+    }
+    m_buffer[pos++] = flags;
+    m_buffer[pos++] = m_keepAlive >> 8;
+    m_buffer[pos++] = m_keepAlive & 0xFF;
+    if (!hasSpace(pos, id))
+    {
+        m_state = MQTT_CONNECT_FAILED;
+        return false;
+    }
+    pos = writeString(id, pos);
+    if (willTopic && hasSpace(pos, willTopic))
+    {
+        pos = writeString(willTopic, pos);
+        if (hasSpace(pos, willMessage))
+        {
+            pos = writeString(willMessage, pos);
+        }
+    }
+    if (user && hasSpace(pos, user))
+    {
+        pos = writeString(user, pos);
+        if (pass && hasSpace(pos, pass))
+        {
+            pos = writeString(pass, pos);
+        }
+    }
+    writePacket(MQTTCONNECT, pos - MQTT_MAX_HEADER_SIZE);
+
+    m_lastInActivity = m_lastOutActivity = millis();
+    while (!m_client->available())
+    {
+        yield();
+        if (millis() - m_lastInActivity >= m_socketTimeout * 1000u)
+        {
+            m_state = MQTT_CONNECTION_TIMEOUT;
+            m_client->stop();
+            return false;
+        }
+    }
+    if (readPacket(&lengthLength) == 4 && (m_buffer[0] & 0xF0) == MQTTCONNACK)
+    {
+        if (m_buffer[3] == 0)
+        {
+            m_lastInActivity = millis();
+            m_pingOutstanding = false;
+            m_state = MQTT_CONNECTED;
+            return true;
+        }
+        m_state = m_buffer[3];
+    }
+    m_client->stop();
+
+    return false;
+}
+
+void PubSubClient::disconnect()
+{
+    if (m_client)
+    {
+        m_buffer[0] = MQTTDISCONNECT;
+        m_buffer[1] = 0;
+        m_client->write(m_buffer, 2);
+        m_client->flush();
+        m_client->stop();
+    }
+    m_state = MQTT_DISCONNECTED;
+    m_lastInActivity = m_lastOutActivity = millis();
+}
+
+bool PubSubClient::publish(const char *topic, const char *payload, bool retained)
+{
+    return publish(topic, reinterpret_cast<const uint8_t *>(payload), payload ? strlen(payload) : 0, retained);
+}
+
+bool PubSubClient::publish(const char *topic, const uint8_t *payload, unsigned int length, bool retained)
+{
+    uint16_t pos;
+
+    if (!connected())
+    {
+        return false;
+    }
+    if (m_bufferSize < MQTT_MAX_HEADER_SIZE + 2 + strnlen(topic, m_bufferSize) + length)
+    {
+        /* Too long */
+        return false;
+    }
+    pos = writeString(topic, MQTT_MAX_HEADER_SIZE);
+    memcpy(m_buffer + pos, payload, length);
+    pos += length;
+
+    return writePacket(MQTTPUBLISH | (retained ? 1 : 0), pos - MQTT_MAX_HEADER_SIZE);
+}
+
+bool PubSubClient::subscribe(const char *topic, uint8_t qos)
+{
+    uint16_t pos = MQTT_MAX_HEADER_SIZE;
+
+    if (!topic || qos > 1 || m_bufferSize < 9 + strnlen(topic, m_bufferSize) || !connected())
+    {
+        return false;
+    }
+    m_nextMsgId = m_nextMsgId + 1 ? m_nextMsgId + 1 : 1;
+    m_buffer[pos++] = m_nextMsgId >> 8;
+    m_buffer[pos++] = m_nextMsgId & 0xFF;
+    pos = writeString(topic, pos);
+    m_buffer[pos++] = qos;
+
+    return writePacket(MQTTSUBSCRIBE | MQTTQOS1, pos - MQTT_MAX_HEADER_SIZE);
+}
+
+bool PubSubClient::unsubscribe(const char *topic)
+{
+    uint16_t pos = MQTT_MAX_HEADER_SIZE;
+
+    if (!topic || m_bufferSize < 9 + strnlen(topic, m_bufferSize) || !connected())
+    {
+        return false;
+    }
+    m_nextMsgId = m_nextMsgId + 1 ? m_nextMsgId + 1 : 1;
+    m_buffer[pos++] = m_nextMsgId >> 8;
+    m_buffer[pos++] = m_nextMsgId & 0xFF;
+    pos = writeString(topic, pos);
+
+    return writePacket(MQTTUNSUBSCRIBE | MQTTQOS1, pos - MQTT_MAX_HEADER_SIZE);
+}
+
+/*
+ * Keep alive and one received packet per call.
+ */
+bool PubSubClient::loop()
+{
+    uint32_t now;
+    uint32_t len;
+    uint16_t topicLen;
+    uint8_t lengthLength;
+    char *topic;
+
+    if (!connected())
+    {
+        return false;
+    }
+    now = millis();
+    if (now - m_lastInActivity > m_keepAlive * 1000u || now - m_lastOutActivity > m_keepAlive * 1000u)
+    {
+        if (m_pingOutstanding)
+        {
+            m_state = MQTT_CONNECTION_TIMEOUT;
+            m_client->stop();
+            return false;
+        }
+        m_buffer[0] = MQTTPINGREQ;
+        m_buffer[1] = 0;
+        m_client->write(m_buffer, 2);
+        m_lastOutActivity = now;
+        m_lastInActivity = now;
+        m_pingOutstanding = true;
+    }
+    if (!m_client->available())
+    {
+        return true;
+    }
+    len = readPacket(&lengthLength);
+    if (!len)
+    {
+        return connected();
+    }
+    m_lastInActivity = now;
+    switch (m_buffer[0] & 0xF0)
+    {
+        case MQTTPUBLISH:
+            if (callback && len >= lengthLength + 3u)
+            {
+                topicLen = (m_buffer[lengthLength + 1] << 8) + m_buffer[lengthLength + 2];
+                if (len < lengthLength + 3u + topicLen)
+                {
+                    break;
+                }
+                /* Topic is moved one byte to the front to make it zero terminated */
+                memmove(m_buffer + lengthLength + 2, m_buffer + lengthLength + 3, topicLen);
+                m_buffer[lengthLength + 2 + topicLen] = 0;
+                topic = reinterpret_cast<char *>(m_buffer + lengthLength + 2);
+                callback(topic, m_buffer + lengthLength + 3 + topicLen, len - lengthLength - 3 - topicLen);
+            }
+            break;
+        case MQTTPINGREQ:
+            m_buffer[0] = MQTTPINGRESP;
+            m_buffer[1] = 0;
+            m_client->write(m_buffer, 2);
+            break;
+        case MQTTPINGRESP:
+            m_pingOutstanding = false;
+            break;
+        default:
+            break;
+    }
+
+    return true;
+}
+
+bool PubSubClient::connected()
+{
+    if (!m_client)
+    {
+        return false;
+    }
+    if (m_client->connected())
+    {
+        return m_state == MQTT_CONNECTED;
+    }
+    if (m_state == MQTT_CONNECTED)
+    {
+        m_state = MQTT_CONNECTION_LOST;
+        m_client->flush();
+        m_client->stop();
+    }
+
+    return false;
+}
+
+/*
+ * Every byte is waited for up to the socket timeout.
+ */
+bool PubSubClient::readByte(uint8_t *c)
+{
+    uint32_t start_ms = millis();
+
+    while (!m_client->available())
+    {
+        yield();
+        if (millis() - start_ms >= m_socketTimeout * 1000u)
+        {
+            return false;
+        }
+    }
+    *c = m_client->read();
+
+    return true;
+}
+
+/*
+ * @return Length of packet in buffer, 0: error or packet did not fit.
+ */
+uint32_t PubSubClient::readPacket(uint8_t *lengthLength)
+{
+    uint32_t len = 0;
+    uint32_t remaining = 0;
+    uint32_t multiplier = 1;
+    uint32_t i;
+    uint8_t c;
+
+    if (!readByte(&m_buffer[len++]))
+    {
+        return 0;
+    }
+    do
+    {
+        if (len == MQTT_MAX_HEADER_SIZE || !readByte(&c))
+        {
+            return 0;
+        }
+        m_buffer[len++] = c;
+        remaining += (c & 0x7F) * multiplier;
+        multiplier <<= 7;
+    } while (c & 0x80);
+    *lengthLength = len - 1;
+
+    for (i = 0; i < remaining; i++)
+    {
+        if (!readByte(&c))
+        {
+            return 0;
+        }
+        if (len < m_bufferSize)
+        {
+            m_buffer[len] = c;
+        }
+        len++;
+    }
+
+    return len <= m_bufferSize ? len : 0;
+}
+
+/*
+ * Packet is built from MQTT_MAX_HEADER_SIZE of buffer, fixed header is put
+ * in front of it.
+ */
+bool PubSubClient::writePacket(uint8_t header, uint16_t length)
+{
+    uint8_t lenBuf[4];
+    uint8_t lenLen = 0;
+    uint16_t len = length;
+    uint8_t digit;
+    size_t written;
+
+    do
+    {
+        digit = len & 0x7F;
+        len >>= 7;
+        if (len)
+        {
+            digit |= 0x80;
+        }
+        lenBuf[lenLen++] = digit;
+    } while (len && lenLen < 4);
+
+    m_buffer[MQTT_MAX_HEADER_SIZE - 1 - lenLen] = header;
+    memcpy(m_buffer + MQTT_MAX_HEADER_SIZE - lenLen, lenBuf, lenLen);
+    written = m_client->write(m_buffer + MQTT_MAX_HEADER_SIZE - 1 - lenLen, length + 1 + lenLen);
+    m_lastOutActivity = millis();
+
+    return written == length + 1u + lenLen;
+}
+
+uint16_t PubSubClient::writeString(const char *str, uint16_t pos)
+{
+    uint16_t start = pos;
+    uint16_t len = 0;
+
+    pos += 2;
+    while (*str && pos < m_bufferSize)
+    {
+        m_buffer[pos++] = *str++;
+        len++;
+    }
+    m_buffer[start] = len >> 8;
+    m_buffer[start + 1] = len & 0xFF;
+
+    return pos;
+}
+
+bool PubSubClient::hasSpace(uint16_t pos, const char *str) const
+{
+    return str && pos + 2 + strnlen(str, m_bufferSize) <= m_bufferSize;
+}
@@ -0,0 +1,116 @@
+/**
+ * @file        PubSubClient.h
+ * @brief       MQTT client for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * Same interface and blocking behaviour as PubSubClient 2.8 (QoS 0, MQTT
+ * 3.1.1): connect() waits for CONNACK up to the socket timeout, packets
+ * longer than the buffer are dropped, keep alive is sent by loop().
+ */
+
+#ifndef INCLUDE_PUBSUBCLIENT_H
+#define INCLUDE_PUBSUBCLIENT_H
+
+#include <functional>
+
+#include "Arduino.h"
+#include "Client.h"
+#include "IPAddress.h"
+
+#define MQTT_VERSION_3_1_1          4
+#define MQTT_VERSION                MQTT_VERSION_3_1_1
+#define MQTT_MAX_PACKET_SIZE        256
+#define MQTT_KEEPALIVE              15
+#define MQTT_SOCKET_TIMEOUT         15
+#define MQTT_MAX_HEADER_SIZE        5
+
+#define MQTT_CONNECTION_TIMEOUT     -4
+#define MQTT_CONNECTION_LOST        -3
+#define MQTT_CONNECT_FAILED         -2
+#define MQTT_DISCONNECTED           -1
+#define MQTT_CONNECTED              0
+#define MQTT_CONNECT_BAD_PROTOCOL   1
+#define MQTT_CONNECT_BAD_CLIENT_ID  2
+#define MQTT_CONNECT_UNAVAILABLE    3
+#define MQTT_CONNECT_BAD_CREDENTIALS 4
+#define MQTT_CONNECT_UNAUTHORIZED   5
+
+#define MQTTCONNECT                 (1 << 4)
+#define MQTTCONNACK                 (2 << 4)
+#define MQTTPUBLISH                 (3 << 4)
+#define MQTTPUBACK                  (4 << 4)
+#define MQTTSUBSCRIBE               (8 << 4)
+#define MQTTSUBACK                  (9 << 4)
+#define MQTTUNSUBSCRIBE             (10 << 4)
+#define MQTTUNSUBACK                (11 << 4)
+#define MQTTPINGREQ                 (12 << 4)
+#define MQTTPINGRESP                (13 << 4)
+#define MQTTDISCONNECT              (14 << 4)
+
+#define MQTTQOS0                    (0 << 1)
+#define MQTTQOS1                    (1 << 1)
+
+#define MQTT_CALLBACK_SIGNATURE     std::function<void(char *, uint8_t *, unsigned int)> callback
+
+class PubSubClient
+{
+public:
+    PubSubClient();
+    explicit PubSubClient(Client &client);
+    ~PubSubClient();
+
+    PubSubClient &setServer(IPAddress ip, uint16_t port);
+    PubSubClient &setServer(const char *domain, uint16_t port);
+    PubSubClient &setCallback(MQTT_CALLBACK_SIGNATURE);
+    PubSubClient &setClient(Client &client);
+    PubSubClient &setKeepAlive(uint16_t keepAlive);
+    PubSubClient &setSocketTimeout(uint16_t timeout);
+    bool setBufferSize(uint16_t size);
+    uint16_t getBufferSize() const { return m_bufferSize; }
+
+    bool connect(const char *id);
+    bool connect(const char *id, const char *user, const char *pass);
+    bool connect(const char *id, const char *willTopic, uint8_t willQos, bool willRetain, const char *willMessage);
+    bool connect(const char *id, const char *user, const char *pass, const char *willTopic, uint8_t willQos,
+                 bool willRetain, const char *willMessage, bool cleanSession = true);
+    void disconnect();
+
+    bool publish(const char *topic, const char *payload) { return publish(topic, payload, false); }
+    bool publish(const char *topic, const char *payload, bool retained);
+    bool publish(const char *topic, const uint8_t *payload, unsigned int length) { return publish(topic, payload, length, false); }
+    bool publish(const char *topic, const uint8_t *payload, unsigned int length, bool retained);
+    bool publish_P(const char *topic, const char *payload, bool retained) { return publish(topic, payload, retained); }
+    bool subscribe(const char *topic, uint8_t qos = 0);
+    bool unsubscribe(const char *topic);
+    bool loop();
+    bool connected();
+    int state() const { return m_state; }
+
+private:
+    bool readByte(uint8_t *c);
+    uint32_t readPacket(uint8_t *lengthLength);
+    bool writePacket(uint8_t header, uint16_t length);
+    uint16_t writeString(const char *str, uint16_t pos);
+    bool hasSpace(uint16_t pos, const char *str) const;
+
+    Client *m_client = NULL;
+    uint8_t *m_buffer = NULL;
+    uint16_t m_bufferSize = 0;
+    uint16_t m_keepAlive = MQTT_KEEPALIVE;
+    uint16_t m_socketTimeout = MQTT_SOCKET_TIMEOUT;
+    uint16_t m_nextMsgId = 1;
+    uint32_t m_lastOutActivity = 0;
+    uint32_t m_lastInActivity = 0;
+    bool m_pingOutstanding = false;
+    MQTT_CALLBACK_SIGNATURE;
+    IPAddress m_ip;
+    const char *m_domain = NULL;
+    uint16_t m_port = 0;
+    int m_state = MQTT_DISCONNECTED;
+};
+
+#endif /* INCLUDE_PUBSUBCLIENT_H */
@@ -0,0 +1,69 @@
+/**
+ * @file        Stream.cpp
+ * @brief       Arduino Stream for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#include "Arduino.h"
+#include "Stream.h"
+
+int Stream::timedRead()
+{
+    uint32_t start_ms = millis();
+    int c;
+
+    do
+    {
+        c = read();
+        if (c >= 0)
+        {
+            return c;
+        }
+        yield();
+    } while (millis() - start_ms < m_timeout_ms);
+
+    return -1;
+}
+
+size_t Stream::readBytes(char *buffer, size_t length)
+{
+    size_t cnt = 0;
+    int c;
+
+    while (cnt < length && (c = timedRead()) >= 0)
+    {
+        buffer[cnt++] = static_cast<char>(c);
+    }
+
+    return cnt;
+}
+
+String Stream::readString()
+{
+    String str;
+    int c;
+
+    while ((c = timedRead()) >= 0)
+    {
+        str += static_cast<char>(c);
+    }
+
+    return str;
+}
+
+String Stream::readStringUntil(char terminator)
+{
+    String str;
+    int c;
+
+    while ((c = timedRead()) >= 0 && c != terminator)
+    {
+        str += static_cast<char>(c);
+    }
+
+    return str;
+}
@@ -0,0 +1,40 @@
+/**
+ * @file        Stream.h
+ * @brief       Arduino Stream for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#ifndef INCLUDE_STREAM_H
+#define INCLUDE_STREAM_H
+
+#include <stdint.h>
+
+#include "Print.h"
+
+class Stream : public Print
+{
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    void setTimeout(unsigned long timeout_ms) { m_timeout_ms = timeout_ms; }
+    unsigned long getTimeout() const { return m_timeout_ms; }
+
+    virtual size_t readBytes(char *buffer, size_t length);
+    size_t readBytes(uint8_t *buffer, size_t length) { return readBytes(reinterpret_cast<char *>(buffer), length); }
+    String readString();
+    String readStringUntil(char terminator);
+
+protected:
+    /* Waits for a byte at most m_timeout_ms, like on the target */
+    int timedRead();
+
+    unsigned long m_timeout_ms = 1000;
+};
+
+#endif /* INCLUDE_STREAM_H */
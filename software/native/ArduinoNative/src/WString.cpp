@@ -0,0 +1,143 @@
+/**
+ * @file        WString.cpp
+ * @brief       Arduino String for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+
+#include "WString.h"
+
+void String::fromSigned(long long value, unsigned char base)
+{
+    if (value < 0 && base == 10)
+    {
+        fromUnsigned(-static_cast<unsigned long long>(value), base);
+        m_str.insert(m_str.begin(), '-');
+    }
+    else
+    {
+        fromUnsigned(static_cast<unsigned long long>(value), base);
+    }
+}
+
+void String::fromUnsigned(unsigned long long value, unsigned char base)
+{
+    char buf[66];
+    char *p = buf + sizeof(buf) - 1;
+
+    if (base < 2 || base > 36)
+    {
+        base = 10;
+    }
+    *p = 0;
+    do
+    {
+        *--p = "0123456789abcdefghijklmnopqrstuvwxyz"[value % base];
+        value /= base;
+    } while (value);
+    m_str = p;
+}
+
+void String::fromDouble(double value, unsigned char decimals)
+{
+    char buf[64];
+
+    snprintf(buf, sizeof(buf), "%.*f", decimals, value);
+    m_str = buf;
+}
+
+void String::replace(char find, char replace)
+{
+    for (char &c : m_str)
+    {
+        if (c == find)
+        {
+            c = replace;
+        }
+    }
+}
+
+void String::replace(const String &find, const String &replace)
+{
+    size_t pos = 0;
+
+    if (find.isEmpty())
+    {
+        return;
+    }
+    while ((pos = m_str.find(find.m_str, pos)) != std::string::npos)
+    {
+        m_str.replace(pos, find.length(), replace.m_str);
+        pos += replace.length();
+    }
+}
+
+void String::toLowerCase()
+{
+    for (char &c : m_str)
+    {
+        c = tolower(static_cast<unsigned char>(c));
+    }
+}
+
+void String::toUpperCase()
+{
+    for (char &c : m_str)
+    {
+        c = toupper(static_cast<unsigned char>(c));
+    }
+}
+
+void String::trim()
+{
+    size_t first = m_str.find_first_not_of(" \t\r\n");
+
+    if (first == std::string::npos)
+    {
+        m_str.clear();
+        return;
+    }
+    m_str.erase(m_str.find_last_not_of(" \t\r\n") + 1);
+    m_str.erase(0, first);
+}
+
+String operator+(const String &lhs, const String &rhs)
+{
+    String str = lhs;
+    str.concat(rhs);
+    return str;
+}
+
+String operator+(const String &lhs, const char *rhs)
+{
+    String str = lhs;
+    str.concat(rhs);
+    return str;
+}
+
+String operator+(const char *lhs, const String &rhs)
+{
+    String str = lhs;
+    str.concat(rhs);
+    return str;
+}
+
+String operator+(const String &lhs, char rhs)
+{
+    String str = lhs;
+    str.concat(rhs);
+    return str;
+}
+
+String operator+(const String &lhs, const __FlashStringHelper *rhs)
+{
+    String str = lhs;
+    str.concat(rhs);
+    return str;
+}
@@ -0,0 +1,162 @@
+/**
+ * @file        WString.h
+ * @brief       Arduino String for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * Content is kept in std::string, so heap usage of strings is seen by the
+ * allocation counters of Arduino.cpp like on the target.
+ */
+
+#ifndef INCLUDE_WSTRING_H
+#define INCLUDE_WSTRING_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include <string>
+#include <type_traits>
+
+class __FlashStringHelper;
+
+class String
+{
+public:
+    String() {}
+    String(const char *str) { if (str) { m_str = str; } }
+    String(const char *str, size_t len) : m_str(str, len) {}
+    String(const String &str) = default;
+    String(String &&str) = default;
+    String(const __FlashStringHelper *str) : String(reinterpret_cast<const char *>(str)) {}
+    explicit String(char c) : m_str(1, c) {}
+    explicit String(unsigned char value, unsigned char base = 10) { fromUnsigned(value, base); }
+    explicit String(int value, unsigned char base = 10) { fromSigned(value, base); }
+    explicit String(unsigned int value, unsigned char base = 10) { fromUnsigned(value, base); }
+    explicit String(long value, unsigned char base = 10) { fromSigned(value, base); }
+    explicit String(unsigned long value, unsigned char base = 10) { fromUnsigned(value, base); }
+    explicit String(long long value, unsigned char base = 10) { fromSigned(value, base); }
+    explicit String(unsigned long long value, unsigned char base = 10) { fromUnsigned(value, base); }
+    explicit String(float value, unsigned char decimals = 2) { fromDouble(value, decimals); }
+    explicit String(double value, unsigned char decimals = 2) { fromDouble(value, decimals); }
+
+    String &operator=(const String &str) = default;
+    String &operator=(String &&str) = default;
+    String &operator=(const char *str) { m_str = str ? str : ""; return *this; }
+    String &operator=(const __FlashStringHelper *str) { return *this = reinterpret_cast<const char *>(str); }
+
+    const char *c_str() const { return m_str.c_str(); }
+    unsigned int length() const { return m_str.length(); }
+    bool isEmpty() const { return m_str.empty(); }
+    bool reserve(unsigned int size) { m_str.reserve(size); return true; }
+    void clear() { m_str.clear(); }
+    const char *begin() const { return m_str.c_str(); }
+    const char *end() const { return m_str.c_str() + m_str.length(); }
+
+    bool concat(const String &str) { m_str += str.m_str; return true; }
+    bool concat(const char *str) { if (str) { m_str += str; } return true; }
+    bool concat(const char *str, unsigned int len) { m_str.append(str, len); return true; }
+    bool concat(const __FlashStringHelper *str) { return concat(reinterpret_cast<const char *>(str)); }
+    bool concat(char c) { m_str += c; return true; }
+    template <typename T, typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+    bool concat(T value) { return concat(String(value)); }
+
+    template <typename T>
+    String &operator+=(const T &value) { concat(value); return *this; }
+    String &operator+=(const char *str) { concat(str); return *this; }
+
+    bool equals(const String &str) const { return m_str == str.m_str; }
+    bool equals(const char *str) const { return m_str == (str ? str : ""); }
+    bool equalsIgnoreCase(const String &str) const { return !strcasecmp(c_str(), str.c_str()); }
+    int compareTo(const String &str) const { return m_str.compare(str.m_str); }
+    bool operator==(const String &str) const { return equals(str); }
+    bool operator==(const char *str) const { return equals(str); }
+    bool operator!=(const String &str) const { return !equals(str); }
+    bool operator!=(const char *str) const { return !equals(str); }
+    bool operator<(const String &str) const { return m_str < str.m_str; }
+    bool startsWith(const String &prefix, unsigned int offset = 0) const
+    {
+        return offset <= m_str.length() && !m_str.compare(offset, prefix.length(), prefix.m_str);
+    }
+    bool endsWith(const String &suffix) const
+    {
+        return m_str.length() >= suffix.length()
+               && !m_str.compare(m_str.length() - suffix.length(), suffix.length(), suffix.m_str);
+    }
+
+    char charAt(unsigned int idx) const { return idx < m_str.length() ? m_str[idx] : 0; }
+    void setCharAt(unsigned int idx, char c) { if (idx < m_str.length()) { m_str[idx] = c; } }
+    char operator[](unsigned int idx) const { return charAt(idx); }
+    char &operator[](unsigned int idx) { return m_str[idx]; }
+    void getBytes(unsigned char *buf, unsigned int size, unsigned int idx = 0) const { toCharArray(reinterpret_cast<char *>(buf), size, idx); }
+    void toCharArray(char *buf, unsigned int size, unsigned int idx = 0) const
+    {
+        if (size)
+        {
+            strncpy(buf, idx < m_str.length() ? c_str() + idx : "", size - 1);
+            buf[size - 1] = 0;
+        }
+    }
+
+    int indexOf(char c, unsigned int from = 0) const { return position(m_str.find(c, from)); }
+    int indexOf(const char *str, unsigned int from = 0) const { return position(m_str.find(str, from)); }
+    int indexOf(const String &str, unsigned int from = 0) const { return position(m_str.find(str.m_str, from)); }
+    int lastIndexOf(char c) const { return position(m_str.rfind(c)); }
+    int lastIndexOf(const String &str) const { return position(m_str.rfind(str.m_str)); }
+    String substring(unsigned int from) const { return substring(from, m_str.length()); }
+    String substring(unsigned int from, unsigned int to) const
+    {
+        if (from > to)
+        {
+            unsigned int tmp = from;
+            from = to;
+            to = tmp;
+        }
+        if (from >= m_str.length())
+        {
+            return String();
+        }
+        return String(m_str.c_str() + from, minLength(to, m_str.length()) - from);
+    }
+
+    void replace(char find, char replace);
+    void replace(const String &find, const String &replace);
+    void remove(unsigned int idx) { if (idx < m_str.length()) { m_str.erase(idx); } }
+    void remove(unsigned int idx, unsigned int cnt) { if (idx < m_str.length()) { m_str.erase(idx, cnt); } }
+    void toLowerCase();
+    void toUpperCase();
+    void trim();
+
+    long toInt() const { return atol(c_str()); }
+    float toFloat() const { return atof(c_str()); }
+    double toDouble() const { return atof(c_str()); }
+
+private:
+    static unsigned int minLength(size_t a, size_t b) { return a < b ? a : b; }
+    static int position(size_t pos) { return pos == std::string::npos ? -1 : static_cast<int>(pos); }
+    void fromSigned(long long value, unsigned char base);
+    void fromUnsigned(unsigned long long value, unsigned char base);
+    void fromDouble(double value, unsigned char decimals);
+
+    std::string m_str;
+};
+
+String operator+(const String &lhs, const String &rhs);
+String operator+(const String &lhs, const char *rhs);
+String operator+(const char *lhs, const String &rhs);
+String operator+(const String &lhs, char rhs);
+String operator+(const String &lhs, const __FlashStringHelper *rhs);
+
+template <typename T, typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+String operator+(const String &lhs, T rhs)
+{
+    String str = lhs;
+    str.concat(rhs);
+    return str;
+}
+
+#endif /* INCLUDE_WSTRING_H */
@@ -0,0 +1,199 @@
+/**
+ * @file        WiFiUdp.cpp
+ * @brief       UDP of the ESP8266 core for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "WiFiUdp.h"
+
+#define NATIVE_UDP_MAX_PACKET_SIZE  1472    /* MTU of WiFi - headers */
+
+/*
+ * Devices of the same host share the port like devices of a network share
+ * the multicast address.
+ */
+uint8_t WiFiUDP::bind(uint16_t port)
+{
+    struct sockaddr_in addr;
+    int flag = 1;
+
+    stop();
+    m_fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m_fd < 0)
+    {
+        return 0;
+    }
+    setsockopt(m_fd, SOL_SOCKET, SO_REUSEADDR, &flag, sizeof(flag));
+    setsockopt(m_fd, SOL_SOCKET, SO_REUSEPORT, &flag, sizeof(flag));
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (::bind(m_fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)))
+    {
+        stop();
+        return 0;
+    }
+
+    return 1;
+}
+
+uint8_t WiFiUDP::begin(uint16_t port)
+{
+    return bind(port);
+}
+
+uint8_t WiFiUDP::beginMulticast(IPAddress interfaceAddr, IPAddress multicast, uint16_t port)
+{
+    struct ip_mreq mreq;
+
+    if (!bind(port))
+    {
+        return 0;
+    }
+    mreq.imr_multiaddr.s_addr = static_cast<uint32_t>(multicast);
+    mreq.imr_interface.s_addr = static_cast<uint32_t>(interfaceAddr);
+    if (setsockopt(m_fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)))
+    {
+        stop();
+        return 0;
+    }
+
+    return 1;
+}
+
+void WiFiUDP::stop()
+{
+    if (m_fd >= 0)
+    {
+        close(m_fd);
+        m_fd = -1;
+    }
+    m_rx.clear();
+    m_rxPos = 0;
+}
+
+int WiFiUDP::beginPacket(IPAddress ip, uint16_t port)
+{
+    m_tx.clear();
+    m_txIp = ip;
+    m_txPort = port;
+    m_txMulticast = false;
+
+    return 1;
+}
+
+int WiFiUDP::beginPacketMulticast(IPAddress multicastAddress, uint16_t port, IPAddress interfaceAddress, int ttl)
+{
+    struct in_addr ifAddr;
+    unsigned char mcTtl = ttl;
+    unsigned char loop = 1;
+
+    if (m_fd < 0 && !bind(0))
+    {
+        return 0;
+    }
+    ifAddr.s_addr = static_cast<uint32_t>(interfaceAddress);
+    if (setsockopt(m_fd, IPPROTO_IP, IP_MULTICAST_IF, &ifAddr, sizeof(ifAddr))
+        || setsockopt(m_fd, IPPROTO_IP, IP_MULTICAST_TTL, &mcTtl, sizeof(mcTtl))
+        || setsockopt(m_fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop)))
+    {
+        return 0;
+    }
+    beginPacket(multicastAddress, port);
+    m_txMulticast = true;
+
+    return 1;
+}
+
+size_t WiFiUDP::write(const uint8_t *buffer, size_t size)
+{
+    if (m_tx.size() + size > NATIVE_UDP_MAX_PACKET_SIZE)
+    {
+        return 0;
+    }
+    m_tx.append(reinterpret_cast<const char *>(buffer), size);
+
+    return size;
+}
+
+int WiFiUDP::endPacket()
+{
+    struct sockaddr_in addr;
+    ssize_t len;
+
+    if (m_fd < 0 && !bind(0))
+    {
+        return 0;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = static_cast<uint32_t>(m_txIp);
+    addr.sin_port = htons(m_txPort);
+    len = sendto(m_fd, m_tx.data(), m_tx.size(), 0, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr));
+    m_tx.clear();
+
+    return len >= 0;
+}
+
+/*
+ * Never waits, like on the target: 0 is returned when there is no packet.
+ */
+int WiFiUDP::parsePacket()
+{
+    char buf[NATIVE_UDP_MAX_PACKET_SIZE];
+    struct sockaddr_in addr;
+    socklen_t addrLen = sizeof(addr);
+    ssize_t len;
+
+    m_rx.clear();
+    m_rxPos = 0;
+    if (m_fd < 0)
+    {
+        return 0;
+    }
+    len = recvfrom(m_fd, buf, sizeof(buf), MSG_DONTWAIT, reinterpret_cast<struct sockaddr *>(&addr), &addrLen);
+    if (len <= 0)
+    {
+        return 0;
+    }
+    m_rx.assign(buf, len);
+    m_remoteIp = IPAddress(static_cast<uint32_t>(addr.sin_addr.s_addr));
+    m_remotePort = ntohs(addr.sin_port);
+
+    return len;
+}
+
+int WiFiUDP::read()
+{
+    return m_rxPos < m_rx.size() ? static_cast<uint8_t>(m_rx[m_rxPos++]) : -1;
+}
+
+int WiFiUDP::read(uint8_t *buffer, size_t size)
+{
+    size_t len = m_rx.size() - m_rxPos;
+
+    if (len > size)
+    {
+        len = size;
+    }
+    memcpy(buffer, m_rx.data() + m_rxPos, len);
+    m_rxPos += len;
+
+    return len;
+}
+
+int WiFiUDP::peek()
+{
+    return m_rxPos < m_rx.size() ? static_cast<uint8_t>(m_rx[m_rxPos]) : -1;
+}
@@ -0,0 +1,65 @@
+/**
+ * @file        WiFiUdp.h
+ * @brief       UDP of the ESP8266 core for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * UDP socket of the host. Multicast goes through the loopback interface
+ * with loop enabled, so several simulated devices (processes) on the same
+ * host receive the packets of each other.
+ */
+
+#ifndef INCLUDE_WIFIUDP_H
+#define INCLUDE_WIFIUDP_H
+
+#include <string>
+
+#include "Arduino.h"
+
+class WiFiUDP : public Stream
+{
+public:
+    WiFiUDP() {}
+    WiFiUDP(const WiFiUDP &) = delete;
+    WiFiUDP &operator=(const WiFiUDP &) = delete;
+    ~WiFiUDP() { stop(); }
+
+    uint8_t begin(uint16_t port);
+    uint8_t beginMulticast(IPAddress interfaceAddr, IPAddress multicast, uint16_t port);
+    void stop();
+
+    int beginPacket(IPAddress ip, uint16_t port);
+    int beginPacketMulticast(IPAddress multicastAddress, uint16_t port, IPAddress interfaceAddress, int ttl = 1);
+    int endPacket();
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+
+    int parsePacket();
+    int available() override { return m_rx.size() - m_rxPos; }
+    int read() override;
+    int read(uint8_t *buffer, size_t size);
+    int read(char *buffer, size_t size) { return read(reinterpret_cast<uint8_t *>(buffer), size); }
+    int peek() override;
+    void flush() override {}
+    IPAddress remoteIP() const { return m_remoteIp; }
+    uint16_t remotePort() const { return m_remotePort; }
+
+private:
+    uint8_t bind(uint16_t port);
+
+    int m_fd = -1;
+    std::string m_tx;
+    IPAddress m_txIp;
+    uint16_t m_txPort = 0;
+    bool m_txMulticast = false;
+    std::string m_rx;
+    size_t m_rxPos = 0;
+    IPAddress m_remoteIp;
+    uint16_t m_remotePort = 0;
+};
+
+#endif /* INCLUDE_WIFIUDP_H */
@@ -0,0 +1,70 @@
+/**
+ * @file        mimetable.h
+ * @brief       MIME types of the ESP8266 core for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#ifndef INCLUDE_MIMETABLE_H
+#define INCLUDE_MIMETABLE_H
+
+#include "WString.h"
+
+namespace mime
+{
+
+typedef struct
+{
+    const char *endsWith;
+    const char *mimeType;
+} Entry;
+
+/* Same order as in the core: first match wins, last is the default */
+static const Entry mimeTable[] =
+{
+    { ".html", "text/html" },
+    { ".htm", "text/html" },
+    { ".css", "text/css" },
+    { ".txt", "text/plain" },
+    { ".js", "application/javascript" },
+    { ".json", "application/json" },
+    { ".png", "image/png" },
+    { ".gif", "image/gif" },
+    { ".jpg", "image/jpeg" },
+    { ".ico", "image/x-icon" },
+    { ".svg", "image/svg+xml" },
+    { ".ttf", "application/x-font-ttf" },
+    { ".otf", "application/x-font-opentype" },
+    { ".woff", "application/font-woff" },
+    { ".woff2", "application/font-woff2" },
+    { ".eot", "application/vnd.ms-fontobject" },
+    { ".sfnt", "application/font-sfnt" },
+    { ".xml", "text/xml" },
+    { ".pdf", "application/pdf" },
+    { ".zip", "application/zip" },
+    { ".gz", "application/x-gzip" },
+    { ".appcache", "text/cache-manifest" },
+    { "", "application/octet-stream" }
+};
+
+inline String getContentType(const String &path)
+{
+    size_t i;
+
+    for (i = 0; i < sizeof(mimeTable) / sizeof(mimeTable[0]) - 1; i++)
+    {
+        if (path.endsWith(mimeTable[i].endsWith))
+        {
+            return String(mimeTable[i].mimeType);
+        }
+    }
+
+    return String(mimeTable[i].mimeType);
+}
+
+} /* namespace mime */
+
+#endif /* INCLUDE_MIMETABLE_H */
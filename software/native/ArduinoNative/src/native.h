@@ -0,0 +1,73 @@
+/**
+ * @file        native.h
+ * @brief       Control of the simulated device in the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * Tests use these functions to drive the inputs of the firmware (switch,
+ * clock, network) and to read what it cost (time, heap, file system).
+ * The firmware itself never includes this file.
+ */
+
+#ifndef INCLUDE_NATIVE_H
+#define INCLUDE_NATIVE_H
+
+#include <stdint.h>
+
+#include "Arduino.h"
+
+#ifndef NATIVE_HEAP_SIZE
+#define NATIVE_HEAP_SIZE            (48 * 1024)     /* Free heap of ESP8266 after boot of an empty sketch */
+#endif
+
+typedef struct
+{
+    uint32_t allocCntr;         /* Number of allocations */
+    uint64_t allocBytes;        /* Sum of allocated bytes */
+    int64_t usedBytes;          /* Currently allocated bytes */
+    int64_t peakUsedBytes;      /* Since native_heap_reset_peak() */
+} nativeHeapStats_t;
+
+typedef struct
+{
+    uint32_t openCntr;          /* Successful LittleFS.open() calls */
+    uint64_t readBytes;
+    uint64_t writeBytes;
+} nativeFsStats_t;
+
+/* Clock: monotonic time of the host plus an offset moved by the test and
+ * by delay(), so waits of the firmware do not take real time. time() and
+ * gettimeofday() follow the same offset */
+extern uint64_t native_clock_us();
+extern void native_clock_advance(uint32_t us);
+
+/* GPIO: level of an input driven from outside, interrupt is called like
+ * on the target */
+extern void native_gpio_input(uint8_t pin, int level);
+extern int native_gpio_output(uint8_t pin);
+
+/* Heap: allocations by new and String of the calling thread are counted,
+ * ESP.getFreeHeap() is NATIVE_HEAP_SIZE minus used bytes */
+extern nativeHeapStats_t native_heap_stats();
+extern void native_heap_reset_peak();
+extern void native_heap_track_thread(bool track);
+
+/* File system: LittleFS is a directory of the host */
+extern bool native_fs_mount(const char *dir);
+extern bool native_fs_mount_copy(const char *srcDir);     /* NULL: empty */
+extern const char *native_fs_root();
+extern nativeFsStats_t native_fs_stats();
+extern uint32_t native_fs_open_cntr(const char *path);   /* Successful opens of a file */
+
+/* Device */
+extern void native_set_chip_id(uint32_t chipId);
+extern void native_serial_echo(bool echo);
+
+/* Network: connections to ip:port go to 127.0.0.1:localPort instead */
+extern void native_net_redirect(IPAddress ip, uint16_t port, uint16_t localPort);
+extern void native_wifi_set_status(int status);
+
+#endif /* INCLUDE_NATIVE_H */
@@ -0,0 +1,370 @@
+/**
+ * @file        native_mqtt_broker.cpp
+ * @brief       MQTT broker for tests in the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "native.h"
+#include "native_mqtt_broker.h"
+
+#define BROKER_POLL_MS          5
+
+typedef std::chrono::steady_clock brokerClock_t;
+
+static std::thread brokerThread;
+static std::atomic<bool> brokerRunning(false);
+static std::mutex brokerMutex;
+static int listenFd = -1;
+static int clientFd = -1;
+static std::string rxBuf;
+static std::vector<std::string> subscriptions;
+static std::vector<nativeMqttMessage_t> messages;
+static uint32_t connectCntr = 0;
+static bool connackAnswer = true;
+static uint32_t connackDelay_ms = 0;
+static bool connackPending = false;
+static brokerClock_t::time_point connackTime;
+
+/*
+ * MQTT topic filter match with '+' and '#' wildcards.
+ */
+static bool broker_topic_match(const std::string &filter, const std::string &topic)
+{
+    size_t f = 0;
+    size_t t = 0;
+
+    while (f < filter.size())
+    {
+        if (filter[f] == '#')
+        {
+            return true;
+        }
+        if (filter[f] == '+')
+        {
+            while (t < topic.size() && topic[t] != '/')
+            {
+                t++;
+            }
+            f++;
+            continue;
+        }
+        if (t >= topic.size() || filter[f] != topic[t])
+        {
+            return false;
+        }
+        f++;
+        t++;
+    }
+
+    return t == topic.size();
+}
+
+static void broker_close_client()
+{
+    if (clientFd >= 0)
+    {
+        close(clientFd);
+        clientFd = -1;
+    }
+    rxBuf.clear();
+    subscriptions.clear();
+    connackPending = false;
+}
+
+static void broker_send(const std::string &packet)
+{
+    if (clientFd >= 0 && send(clientFd, packet.data(), packet.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(packet.size()))
+    {
+        broker_close_client();
+    }
+}
+
+static std::string broker_packet(uint8_t header, const std::string &body)
+{
+    std::string packet(1, static_cast<char>(header));
+    size_t len = body.size();
+    uint8_t digit;
+
+    do
+    {
+        digit = len & 0x7F;
+        len >>= 7;
+        packet += static_cast<char>(len ? digit | 0x80 : digit);
+    } while (len);
+
+    return packet + body;
+}
+
+static std::string broker_string(const std::string &str)
+{
+    std::string encoded;
+
+    encoded += static_cast<char>(str.size() >> 8);
+    encoded += static_cast<char>(str.size() & 0xFF);
+
+    return encoded + str;
+}
+
+static void broker_handle_packet(uint8_t header, const std::string &body)
+{
+    size_t pos;
+    size_t len;
+
+    switch (header & 0xF0)
+    {
+        case 0x10:  /* CONNECT */
+            connectCntr++;
+            connackPending = connackAnswer;
+            connackTime = brokerClock_t::now() + std::chrono::milliseconds(connackDelay_ms);
+            break;
+        case 0x30:  /* PUBLISH */
+            if (body.size() >= 2)
+            {
+                nativeMqttMessage_t msg;
+
+                len = (static_cast<uint8_t>(body[0]) << 8) | static_cast<uint8_t>(body[1]);
+                pos = 2 + len + ((header & 0x06) ? 2 : 0);
+                msg.topic = body.substr(2, len);
+                msg.payload = pos < body.size() ? body.substr(pos) : std::string();
+                msg.time_us = native_clock_us();
+                messages.push_back(msg);
+                for (const std::string &filter : subscriptions)
+                {
+                    if (broker_topic_match(filter, msg.topic))
+                    {
+                        broker_send(broker_packet(0x30, broker_string(msg.topic) + msg.payload));
+                        break;
+                    }
+                }
+            }
+            break;
+        case 0x80:  /* SUBSCRIBE */
+            if (body.size() >= 2)
+            {
+                std::string suback = body.substr(0, 2);
+
+                for (pos = 2; pos + 2 < body.size(); pos += 2 + len + 1)
+                {
+                    len = (static_cast<uint8_t>(body[pos]) << 8) | static_cast<uint8_t>(body[pos + 1]);
+                    subscriptions.push_back(body.substr(pos + 2, len));
+                    suback += '\0';
+                }
+                broker_send(broker_packet(0x90, suback));
+            }
+            break;
+        case 0xC0:  /* PINGREQ */
+            broker_send(broker_packet(0xD0, std::string()));
+            break;
+        case 0xE0:  /* DISCONNECT */
+            broker_close_client();
+            break;
+        default:
+            break;
+    }
+}
+
+/*
+ * Complete packets of receive buffer are handled.
+ */
+static void broker_parse()
+{
+    size_t len;
+    size_t pos;
+    uint32_t multiplier;
+    uint8_t c;
+
+    while (rxBuf.size() >= 2)
+    {
+        len = 0;
+        multiplier = 1;
+        pos = 1;
+        do
+        {
+            if (pos >= rxBuf.size())
+            {
+                return;
+            }
+            c = rxBuf[pos++];
+            len += (c & 0x7F) * multiplier;
+            multiplier <<= 7;
+        } while (c & 0x80);
+        if (rxBuf.size() < pos + len)
+        {
+            return;
+        }
+        std::string body = rxBuf.substr(pos, len);
+        uint8_t header = rxBuf[0];
+        rxBuf.erase(0, pos + len);
+        broker_handle_packet(header, body);
+        if (clientFd < 0)
+        {
+            return;
+        }
+    }
+}
+
+static void broker_thread()
+{
+    struct pollfd pfds[2];
+    char buf[1024];
+    ssize_t len;
+    int fd;
+
+    native_heap_track_thread(false);
+    while (brokerRunning)
+    {
+        pfds[0] = { listenFd, POLLIN, 0 };
+        {
+            std::lock_guard<std::mutex> lock(brokerMutex);
+            pfds[1] = { clientFd, POLLIN, 0 };
+        }
+        poll(pfds, pfds[1].fd >= 0 ? 2 : 1, BROKER_POLL_MS);
+
+        std::lock_guard<std::mutex> lock(brokerMutex);
+        if (pfds[0].revents & POLLIN)
+        {
+            fd = accept4(listenFd, NULL, NULL, SOCK_CLOEXEC);
+            if (fd >= 0)
+            {
+                /* New connection of the device replaces the old one */
+                broker_close_client();
+                clientFd = fd;
+            }
+        }
+        else if (clientFd >= 0 && pfds[1].fd == clientFd && (pfds[1].revents & (POLLIN | POLLHUP | POLLERR)))
+        {
+            len = recv(clientFd, buf, sizeof(buf), MSG_DONTWAIT);
+            if (len <= 0)
+            {
+                broker_close_client();
+            }
+            else
+            {
+                rxBuf.append(buf, len);
+                broker_parse();
+            }
+        }
+        if (clientFd >= 0 && connackPending && brokerClock_t::now() >= connackTime)
+        {
+            connackPending = false;
+            broker_send(broker_packet(0x20, std::string("\0\0", 2)));
+        }
+    }
+}
+
+uint16_t native_broker_start()
+{
+    struct sockaddr_in addr;
+    socklen_t addrLen = sizeof(addr);
+
+    native_broker_stop();
+    listenFd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listenFd < 0)
+    {
+        return 0;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    if (bind(listenFd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) || listen(listenFd, 4)
+        || getsockname(listenFd, reinterpret_cast<struct sockaddr *>(&addr), &addrLen))
+    {
+        close(listenFd);
+        listenFd = -1;
+        return 0;
+    }
+    brokerRunning = true;
+    brokerThread = std::thread(broker_thread);
+
+    return ntohs(addr.sin_port);
+}
+
+void native_broker_stop()
+{
+    if (brokerRunning)
+    {
+        brokerRunning = false;
+        brokerThread.join();
+    }
+    broker_close_client();
+    if (listenFd >= 0)
+    {
+        close(listenFd);
+        listenFd = -1;
+    }
+}
+
+void native_broker_set_connack(bool answer, uint32_t delay_ms)
+{
+    std::lock_guard<std::mutex> lock(brokerMutex);
+
+    connackAnswer = answer;
+    connackDelay_ms = delay_ms;
+}
+
+void native_broker_drop_client()
+{
+    std::lock_guard<std::mutex> lock(brokerMutex);
+
+    broker_close_client();
+}
+
+bool native_broker_client_connected()
+{
+    std::lock_guard<std::mutex> lock(brokerMutex);
+
+    return clientFd >= 0;
+}
+
+uint32_t native_broker_connect_cntr()
+{
+    std::lock_guard<std::mutex> lock(brokerMutex);
+
+    return connectCntr;
+}
+
+bool native_broker_publish(const char *topic, const char *payload)
+{
+    std::lock_guard<std::mutex> lock(brokerMutex);
+
+    for (const std::string &filter : subscriptions)
+    {
+        if (broker_topic_match(filter, topic))
+        {
+            broker_send(broker_packet(0x30, broker_string(topic) + payload));
+            return clientFd >= 0;
+        }
+    }
+
+    return false;
+}
+
+std::vector<nativeMqttMessage_t> native_broker_messages()
+{
+    std::lock_guard<std::mutex> lock(brokerMutex);
+
+    return messages;
+}
+
+void native_broker_clear_messages()
+{
+    std::lock_guard<std::mutex> lock(brokerMutex);
+
+    messages.clear();
+}
@@ -0,0 +1,44 @@
+/**
+ * @file        native_mqtt_broker.h
+ * @brief       MQTT broker for tests in the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * Minimal MQTT 3.1.1 broker (QoS 0) in a thread of the test, listening on
+ * a free port of 127.0.0.1. One client is served at a time. Messages
+ * published by the client are recorded and forwarded to it if it
+ * subscribed. CONNACK can be delayed or withheld to simulate a broker
+ * which does not answer.
+ */
+
+#ifndef INCLUDE_NATIVE_MQTT_BROKER_H
+#define INCLUDE_NATIVE_MQTT_BROKER_H
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+typedef struct
+{
+    std::string topic;
+    std::string payload;
+    uint64_t time_us;           /* native_clock_us() at receive */
+} nativeMqttMessage_t;
+
+/* @return Port of broker, 0: error */
+extern uint16_t native_broker_start();
+extern void native_broker_stop();
+extern void native_broker_set_connack(bool answer, uint32_t delay_ms);
+extern void native_broker_drop_client();
+extern bool native_broker_client_connected();
+extern uint32_t native_broker_connect_cntr();
+/* Sent to client if it subscribed to a matching filter */
+extern bool native_broker_publish(const char *topic, const char *payload);
+extern std::vector<nativeMqttMessage_t> native_broker_messages();
+extern void native_broker_clear_messages();
+
+#endif /* INCLUDE_NATIVE_MQTT_BROKER_H */
@@ -0,0 +1,40 @@
+/**
+ * @file        AudioFileSource.h
+ * @brief       Audio source interface of ESP8266Audio for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#ifndef INCLUDE_AUDIOFILESOURCE_H
+#define INCLUDE_AUDIOFILESOURCE_H
+
+#include <Arduino.h>
+
+#include "AudioStatus.h"
+
+class AudioFileSource
+{
+public:
+    AudioFileSource() {}
+    virtual ~AudioFileSource() {}
+    virtual bool open(const char *filename) { (void)filename; return false; }
+    virtual uint32_t read(void *data, uint32_t len) { (void)data; (void)len; return 0; }
+    virtual uint32_t readNonBlock(void *data, uint32_t len) { return read(data, len); }
+    virtual bool seek(int32_t pos, int dir) { (void)pos; (void)dir; return false; }
+    virtual bool close() { return false; }
+    virtual bool isOpen() { return false; }
+    virtual uint32_t getSize() { return 0; }
+    virtual uint32_t getPos() { return 0; }
+    virtual bool loop() { return true; }
+
+    virtual bool RegisterMetadataCB(AudioStatus::metadataCBFn fn, void *data) { return cb.RegisterMetadataCB(fn, data); }
+    virtual bool RegisterStatusCB(AudioStatus::statusCBFn fn, void *data) { return cb.RegisterStatusCB(fn, data); }
+
+protected:
+    AudioStatus cb;
+};
+
+#endif /* INCLUDE_AUDIOFILESOURCE_H */
@@ -0,0 +1,45 @@
+/**
+ * @file        AudioFileSourceFS.cpp
+ * @brief       File system audio source of ESP8266Audio for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#include "AudioFileSourceFS.h"
+
+bool AudioFileSourceFS::open(const char *filename)
+{
+    m_file = m_fs->open(filename, "r");
+
+    return static_cast<bool>(m_file);
+}
+
+uint32_t AudioFileSourceFS::read(void *data, uint32_t len)
+{
+    return m_file.read(reinterpret_cast<uint8_t *>(data), len);
+}
+
+bool AudioFileSourceFS::seek(int32_t pos, int dir)
+{
+    switch (dir)
+    {
+        case SEEK_SET:
+            return m_file.seek(pos, SeekSet);
+        case SEEK_CUR:
+            return m_file.seek(pos, SeekCur);
+        case SEEK_END:
+            return m_file.seek(pos, SeekEnd);
+        default:
+            return false;
+    }
+}
+
+bool AudioFileSourceFS::close()
+{
+    m_file.close();
+
+    return true;
+}
@@ -0,0 +1,39 @@
+/**
+ * @file        AudioFileSourceFS.h
+ * @brief       File system audio source of ESP8266Audio for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#ifndef INCLUDE_AUDIOFILESOURCEFS_H
+#define INCLUDE_AUDIOFILESOURCEFS_H
+
+#include <Arduino.h>
+#include <FS.h>
+
+#include "AudioFileSource.h"
+
+class AudioFileSourceFS : public AudioFileSource
+{
+public:
+    explicit AudioFileSourceFS(fs::FS &fs) : m_fs(&fs) {}
+    AudioFileSourceFS(fs::FS &fs, const char *filename) : m_fs(&fs) { open(filename); }
+    virtual ~AudioFileSourceFS() override { close(); }
+
+    virtual bool open(const char *filename) override;
+    virtual uint32_t read(void *data, uint32_t len) override;
+    virtual bool seek(int32_t pos, int dir) override;
+    virtual bool close() override;
+    virtual bool isOpen() override { return static_cast<bool>(m_file); }
+    virtual uint32_t getSize() override { return m_file ? m_file.size() : 0; }
+    virtual uint32_t getPos() override { return m_file ? m_file.position() : 0; }
+
+private:
+    fs::FS *m_fs;
+    fs::File m_file;
+};
+
+#endif /* INCLUDE_AUDIOFILESOURCEFS_H */
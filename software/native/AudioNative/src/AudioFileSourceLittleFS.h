@@ -0,0 +1,25 @@
+/**
+ * @file        AudioFileSourceLittleFS.h
+ * @brief       LittleFS audio source of ESP8266Audio for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#ifndef INCLUDE_AUDIOFILESOURCELITTLEFS_H
+#define INCLUDE_AUDIOFILESOURCELITTLEFS_H
+
+#include <LittleFS.h>
+
+#include "AudioFileSourceFS.h"
+
+class AudioFileSourceLittleFS : public AudioFileSourceFS
+{
+public:
+    AudioFileSourceLittleFS() : AudioFileSourceFS(LittleFS) {}
+    explicit AudioFileSourceLittleFS(const char *filename) : AudioFileSourceFS(LittleFS, filename) {}
+};
+
+#endif /* INCLUDE_AUDIOFILESOURCELITTLEFS_H */
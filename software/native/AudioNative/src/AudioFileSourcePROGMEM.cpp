@@ -0,0 +1,82 @@
+/**
+ * @file        AudioFileSourcePROGMEM.cpp
+ * @brief       Memory audio source of ESP8266Audio for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#include "AudioFileSourcePROGMEM.h"
+
+bool AudioFileSourcePROGMEM::open(const void *data, uint32_t len)
+{
+    if (!data || !len)
+    {
+        return false;
+    }
+    m_opened = true;
+    m_data = reinterpret_cast<const uint8_t *>(data);
+    m_len = len;
+    m_pos = 0;
+
+    return true;
+}
+
+uint32_t AudioFileSourcePROGMEM::read(void *data, uint32_t len)
+{
+    if (!m_opened || m_pos >= m_len)
+    {
+        return 0;
+    }
+    if (len > m_len - m_pos)
+    {
+        len = m_len - m_pos;
+    }
+    memcpy(data, m_data + m_pos, len);
+    m_pos += len;
+
+    return len;
+}
+
+bool AudioFileSourcePROGMEM::seek(int32_t pos, int dir)
+{
+    int32_t newPos;
+
+    if (!m_opened)
+    {
+        return false;
+    }
+    switch (dir)
+    {
+        case SEEK_SET:
+            newPos = pos;
+            break;
+        case SEEK_CUR:
+            newPos = m_pos + pos;
+            break;
+        case SEEK_END:
+            newPos = m_len + pos;
+            break;
+        default:
+            return false;
+    }
+    if (newPos < 0 || newPos > static_cast<int32_t>(m_len))
+    {
+        return false;
+    }
+    m_pos = newPos;
+
+    return true;
+}
+
+bool AudioFileSourcePROGMEM::close()
+{
+    m_opened = false;
+    m_data = NULL;
+    m_len = 0;
+    m_pos = 0;
+
+    return true;
+}
@@ -0,0 +1,37 @@
+/**
+ * @file        AudioFileSourcePROGMEM.h
+ * @brief       Memory audio source of ESP8266Audio for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#ifndef INCLUDE_AUDIOFILESOURCEPROGMEM_H
+#define INCLUDE_AUDIOFILESOURCEPROGMEM_H
+
+#include "AudioFileSource.h"
+
+class AudioFileSourcePROGMEM : public AudioFileSource
+{
+public:
+    AudioFileSourcePROGMEM() {}
+    AudioFileSourcePROGMEM(const void *data, uint32_t len) { open(data, len); }
+
+    bool open(const void *data, uint32_t len);
+    virtual uint32_t read(void *data, uint32_t len) override;
+    virtual bool seek(int32_t pos, int dir) override;
+    virtual bool close() override;
+    virtual bool isOpen() override { return m_opened; }
+    virtual uint32_t getSize() override { return m_opened ? m_len : 0; }
+    virtual uint32_t getPos() override { return m_opened ? m_pos : 0; }
+
+private:
+    bool m_opened = false;
+    const uint8_t *m_data = NULL;
+    uint32_t m_len = 0;
+    uint32_t m_pos = 0;
+};
+
+#endif /* INCLUDE_AUDIOFILESOURCEPROGMEM_H */
@@ -0,0 +1,63 @@
+/**
+ * @file        AudioGenerator.h
+ * @brief       Audio generator interface of ESP8266Audio for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#ifndef INCLUDE_AUDIOGENERATOR_H
+#define INCLUDE_AUDIOGENERATOR_H
+
+#include <Arduino.h>
+
+#include "AudioStatus.h"
+#include "AudioFileSource.h"
+#include "AudioOutput.h"
+#include "AudioLogger.h"
+
+class AudioGenerator
+{
+public:
+    AudioGenerator() { lastSample[0] = 0; lastSample[1] = 0; }
+    virtual ~AudioGenerator() {}
+    virtual bool begin(AudioFileSource *source, AudioOutput *output) { (void)source; (void)output; return false; }
+    virtual bool loop() { return false; }
+    virtual bool stop() { return false; }
+    virtual bool isRunning() { return false; }
+    virtual void desync() {}
+
+    virtual bool RegisterMetadataCB(AudioStatus::metadataCBFn fn, void *data) { return cb.RegisterMetadataCB(fn, data); }
+    virtual bool RegisterStatusCB(AudioStatus::statusCBFn fn, void *data) { return cb.RegisterStatusCB(fn, data); }
+
+protected:
+    bool running = false;
+    AudioFileSource *file = NULL;
+    AudioOutput *output = NULL;
+    int16_t lastSample[2];
+    AudioStatus cb;
+};
+
+/*
+ * Decoders which are not simulated: begin() fails like for a corrupt file,
+ * so the firmware takes the same error path as on the target.
+ */
+class AudioGeneratorUnsupported : public AudioGenerator
+{
+public:
+    explicit AudioGeneratorUnsupported(const char *name) : m_name(name) {}
+    virtual bool begin(AudioFileSource *source, AudioOutput *output) override
+    {
+        (void)source;
+        (void)output;
+        audioLogger->printf("%s: not available in native environment\n", m_name);
+        return false;
+    }
+
+private:
+    const char *m_name;
+};
+
+#endif /* INCLUDE_AUDIOGENERATOR_H */
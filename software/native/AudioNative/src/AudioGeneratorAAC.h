@@ -0,0 +1,22 @@
+/**
+ * @file        AudioGeneratorAAC.h
+ * @brief       AAC decoder of ESP8266Audio for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#ifndef INCLUDE_AUDIOGENERATORAAC_H
+#define INCLUDE_AUDIOGENERATORAAC_H
+
+#include "AudioGenerator.h"
+
+class AudioGeneratorAAC : public AudioGeneratorUnsupported
+{
+public:
+    AudioGeneratorAAC() : AudioGeneratorUnsupported("AudioGeneratorAAC") {}
+};
+
+#endif /* INCLUDE_AUDIOGENERATORAAC_H */
@@ -0,0 +1,22 @@
+/**
+ * @file        AudioGeneratorMOD.h
+ * @brief       MOD decoder of ESP8266Audio for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#ifndef INCLUDE_AUDIOGENERATORMOD_H
+#define INCLUDE_AUDIOGENERATORMOD_H
+
+#include "AudioGenerator.h"
+
+class AudioGeneratorMOD : public AudioGeneratorUnsupported
+{
+public:
+    AudioGeneratorMOD() : AudioGeneratorUnsupported("AudioGeneratorMOD") {}
+};
+
+#endif /* INCLUDE_AUDIOGENERATORMOD_H */
@@ -0,0 +1,22 @@
+/**
+ * @file        AudioGeneratorMP3.h
+ * @brief       MP3 decoder of ESP8266Audio for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#ifndef INCLUDE_AUDIOGENERATORMP3_H
+#define INCLUDE_AUDIOGENERATORMP3_H
+
+#include "AudioGenerator.h"
+
+class AudioGeneratorMP3 : public AudioGeneratorUnsupported
+{
+public:
+    AudioGeneratorMP3() : AudioGeneratorUnsupported("AudioGeneratorMP3") {}
+};
+
+#endif /* INCLUDE_AUDIOGENERATORMP3_H */
@@ -0,0 +1,176 @@
+/**
+ * @file        AudioGeneratorWAV.cpp
+ * @brief       PCM WAV decoder of ESP8266Audio for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#include "AudioGeneratorWAV.h"
+
+bool AudioGeneratorWAV::readU32(uint32_t *val)
+{
+    uint8_t buf[4];
+
+    if (file->read(buf, sizeof(buf)) != sizeof(buf))
+    {
+        return false;
+    }
+    *val = buf[0] | (buf[1] << 8) | (buf[2] << 16) | (static_cast<uint32_t>(buf[3]) << 24);
+
+    return true;
+}
+
+bool AudioGeneratorWAV::readU16(uint16_t *val)
+{
+    uint8_t buf[2];
+
+    if (file->read(buf, sizeof(buf)) != sizeof(buf))
+    {
+        return false;
+    }
+    *val = buf[0] | (buf[1] << 8);
+
+    return true;
+}
+
+/*
+ * RIFF header is parsed until data chunk, file is left at first sample.
+ */
+bool AudioGeneratorWAV::readHeader()
+{
+    uint32_t id;
+    uint32_t size;
+    uint16_t format;
+    uint16_t u16;
+    uint32_t u32;
+    bool fmtFound = false;
+
+    if (!readU32(&id) || id != 0x46464952u || !readU32(&size) || !readU32(&id) || id != 0x45564157u)
+    {
+        audioLogger->printf("AudioGeneratorWAV::readHeader: not a WAV file\n");
+        return false;
+    }
+    for (;;)
+    {
+        if (!readU32(&id) || !readU32(&size))
+        {
+            audioLogger->printf("AudioGeneratorWAV::readHeader: no data chunk\n");
+            return false;
+        }
+        if (id == 0x20746d66u)  /* "fmt " */
+        {
+            if (size < 16 || !readU16(&format) || !readU16(&channels) || !readU32(&sampleRate)
+                || !readU32(&u32) || !readU16(&u16) || !readU16(&bitsPerSample))
+            {
+                return false;
+            }
+            if (format != 1 || channels < 1 || channels > 2 || (bitsPerSample != 8 && bitsPerSample != 16))
+            {
+                audioLogger->printf("AudioGeneratorWAV::readHeader: unsupported format %u\n", format);
+                return false;
+            }
+            size -= 16;
+            fmtFound = true;
+        }
+        else if (id == 0x61746164u)  /* "data" */
+        {
+            availBytes = size;
+            return fmtFound;
+        }
+        if (!file->seek(size + (size & 1), SEEK_CUR))
+        {
+            return false;
+        }
+    }
+}
+
+bool AudioGeneratorWAV::begin(AudioFileSource *source, AudioOutput *output)
+{
+    if (!source || !output)
+    {
+        return false;
+    }
+    file = source;
+    this->output = output;
+    if (!file->isOpen() || !readHeader())
+    {
+        return false;
+    }
+    if (!output->SetRate(sampleRate) || !output->SetBitsPerSample(bitsPerSample)
+        || !output->SetChannels(channels) || !output->begin())
+    {
+        return false;
+    }
+    running = true;
+
+    return true;
+}
+
+bool AudioGeneratorWAV::getSample(int16_t *sample)
+{
+    uint8_t buf[2];
+    uint8_t len = bitsPerSample / 8;
+
+    if (availBytes < len || file->read(buf, len) != len)
+    {
+        return false;
+    }
+    availBytes -= len;
+    *sample = len == 1 ? buf[0] : static_cast<int16_t>(buf[0] | (buf[1] << 8));
+
+    return true;
+}
+
+/*
+ * Samples are given to output until it is full or the file ends.
+ */
+bool AudioGeneratorWAV::loop()
+{
+    if (!running)
+    {
+        return false;
+    }
+    for (;;)
+    {
+        if (!output->ConsumeSample(lastSample))
+        {
+            break;
+        }
+        if (!getSample(&lastSample[AudioOutput::LEFTCHANNEL]))
+        {
+            stop();
+            break;
+        }
+        if (channels == 2)
+        {
+            if (!getSample(&lastSample[AudioOutput::RIGHTCHANNEL]))
+            {
+                stop();
+                break;
+            }
+        }
+        else
+        {
+            lastSample[AudioOutput::RIGHTCHANNEL] = lastSample[AudioOutput::LEFTCHANNEL];
+        }
+    }
+    file->loop();
+    output->loop();
+
+    return running;
+}
+
+bool AudioGeneratorWAV::stop()
+{
+    if (!running)
+    {
+        return true;
+    }
+    running = false;
+    output->stop();
+
+    return file->close();
+}
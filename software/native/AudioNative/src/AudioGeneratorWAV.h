@@ -0,0 +1,41 @@
+/**
+ * @file        AudioGeneratorWAV.h
+ * @brief       PCM WAV decoder of ESP8266Audio for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * 8 and 16 bit PCM, mono or stereo, like the generator of the library.
+ */
+
+#ifndef INCLUDE_AUDIOGENERATORWAV_H
+#define INCLUDE_AUDIOGENERATORWAV_H
+
+#include "AudioGenerator.h"
+
+class AudioGeneratorWAV : public AudioGenerator
+{
+public:
+    AudioGeneratorWAV() {}
+    virtual ~AudioGeneratorWAV() override {}
+    virtual bool begin(AudioFileSource *source, AudioOutput *output) override;
+    virtual bool loop() override;
+    virtual bool stop() override;
+    virtual bool isRunning() override { return running; }
+    void SetBufferSize(int sz) { (void)sz; }
+
+private:
+    bool readHeader();
+    bool readU32(uint32_t *val);
+    bool readU16(uint16_t *val);
+    bool getSample(int16_t *sample);
+
+    uint16_t channels = 0;
+    uint32_t sampleRate = 0;
+    uint16_t bitsPerSample = 0;
+    uint32_t availBytes = 0;
+};
+
+#endif /* INCLUDE_AUDIOGENERATORWAV_H */
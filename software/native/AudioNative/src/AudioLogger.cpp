@@ -0,0 +1,23 @@
+/**
+ * @file        AudioLogger.cpp
+ * @brief       Log output of ESP8266Audio for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#include "AudioLogger.h"
+
+class AudioLoggerSilent : public Print
+{
+public:
+    size_t write(uint8_t c) override { (void)c; return 1; }
+    size_t write(const uint8_t *buffer, size_t size) override { (void)buffer; return size; }
+};
+
+static AudioLoggerSilent silentLogger;
+
+/* Silent until the firmware sets it, like in the library */
+Print *audioLogger = &silentLogger;
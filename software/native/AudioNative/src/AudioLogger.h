@@ -0,0 +1,18 @@
+/**
+ * @file        AudioLogger.h
+ * @brief       Log output of ESP8266Audio for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#ifndef INCLUDE_AUDIOLOGGER_H
+#define INCLUDE_AUDIOLOGGER_H
+
+#include <Arduino.h>
+
+extern Print *audioLogger;
+
+#endif /* INCLUDE_AUDIOLOGGER_H */
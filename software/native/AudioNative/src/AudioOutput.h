@@ -0,0 +1,89 @@
+/**
+ * @file        AudioOutput.h
+ * @brief       Audio output interface of ESP8266Audio for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#ifndef INCLUDE_AUDIOOUTPUT_H
+#define INCLUDE_AUDIOOUTPUT_H
+
+#include <Arduino.h>
+
+#include "AudioStatus.h"
+
+class AudioOutput
+{
+public:
+    typedef enum
+    {
+        LEFTCHANNEL = 0,
+        RIGHTCHANNEL = 1
+    } SampleIndex;
+
+    AudioOutput() {}
+    virtual ~AudioOutput() {}
+    virtual bool SetRate(int hz) { hertz = hz; return true; }
+    virtual bool SetBitsPerSample(int bits) { bps = bits; return true; }
+    virtual bool SetChannels(int chan) { channels = chan; return true; }
+    virtual bool SetGain(float f)
+    {
+        f = f > 4.0f ? 4.0f : (f < 0.0f ? 0.0f : f);
+        gainF2P6 = static_cast<uint8_t>(f * (1 << 6));
+        return true;
+    }
+    virtual bool begin() { return false; }
+    virtual bool ConsumeSample(int16_t sample[2]) { (void)sample; return false; }
+    virtual uint16_t ConsumeSamples(int16_t *samples, uint16_t count)
+    {
+        uint16_t i;
+
+        for (i = 0; i < count; i++)
+        {
+            if (!ConsumeSample(samples))
+            {
+                return i;
+            }
+            samples += 2;
+        }
+        return count;
+    }
+    virtual bool stop() { return false; }
+    virtual void flush() {}
+    virtual bool loop() { return true; }
+
+    virtual bool RegisterMetadataCB(AudioStatus::metadataCBFn fn, void *data) { return cb.RegisterMetadataCB(fn, data); }
+    virtual bool RegisterStatusCB(AudioStatus::statusCBFn fn, void *data) { return cb.RegisterStatusCB(fn, data); }
+
+protected:
+    void MakeSampleStereo16(int16_t sample[2])
+    {
+        if (bps == 8)
+        {
+            sample[LEFTCHANNEL] = (static_cast<int16_t>(sample[LEFTCHANNEL] & 0xFF) - 128) << 8;
+            sample[RIGHTCHANNEL] = (static_cast<int16_t>(sample[RIGHTCHANNEL] & 0xFF) - 128) << 8;
+        }
+        if (channels == 1)
+        {
+            sample[RIGHTCHANNEL] = sample[LEFTCHANNEL];
+        }
+    }
+
+    int16_t Amplify(int16_t s)
+    {
+        int32_t v = (s * gainF2P6) >> 6;
+
+        return v < -32767 ? -32767 : (v > 32767 ? 32767 : v);
+    }
+
+    uint16_t hertz = 44100;
+    uint8_t bps = 16;
+    uint8_t channels = 2;
+    uint8_t gainF2P6 = 1 << 6;
+    AudioStatus cb;
+};
+
+#endif /* INCLUDE_AUDIOOUTPUT_H */
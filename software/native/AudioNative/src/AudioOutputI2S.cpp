@@ -0,0 +1,98 @@
+/**
+ * @file        AudioOutputI2S.cpp
+ * @brief       I2S audio output of ESP8266Audio for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#include "AudioOutputI2S.h"
+#include "native.h"
+#include "native_audio.h"
+
+static nativeI2sStats_t i2sStats;
+static bool i2sPaced = true;
+
+nativeI2sStats_t native_i2s_stats()
+{
+    return i2sStats;
+}
+
+void native_i2s_reset()
+{
+    memset(&i2sStats, 0, sizeof(i2sStats));
+}
+
+void native_i2s_paced(bool paced)
+{
+    i2sPaced = paced;
+}
+
+AudioOutputI2S::AudioOutputI2S(int port, int outputMode, int dmaBufCount, int useApll)
+{
+    (void)port;
+    (void)outputMode;
+    (void)dmaBufCount;
+    (void)useApll;
+}
+
+bool AudioOutputI2S::SetRate(int hz)
+{
+    hertz = hz;
+    i2sStats.rate = hz;
+
+    return true;
+}
+
+bool AudioOutputI2S::begin()
+{
+    m_started = true;
+    m_sampleCntr = 0;
+    m_start_us = 0;
+    i2sStats.beginCntr++;
+    i2sStats.sampleCntr = 0;
+    i2sStats.firstSample_us = 0;
+
+    return true;
+}
+
+/*
+ * Sample is refused while the simulated DMA buffer is full.
+ */
+bool AudioOutputI2S::ConsumeSample(int16_t sample[2])
+{
+    uint64_t now_us = native_clock_us();
+    int16_t ms[2];
+
+    if (!m_started)
+    {
+        return false;
+    }
+    if (!m_sampleCntr)
+    {
+        m_start_us = now_us;
+        i2sStats.firstSample_us = now_us;
+    }
+    else if (i2sPaced && m_sampleCntr >= (now_us - m_start_us) * hertz / 1000000u + AUDIO_OUTPUT_I2S_DMA_SAMPLES)
+    {
+        return false;
+    }
+    ms[LEFTCHANNEL] = sample[LEFTCHANNEL];
+    ms[RIGHTCHANNEL] = sample[RIGHTCHANNEL];
+    MakeSampleStereo16(ms);
+    m_sampleCntr++;
+    i2sStats.sampleCntr++;
+    i2sStats.totalSampleCntr++;
+    i2sStats.sampleSum += Amplify(ms[LEFTCHANNEL]);
+
+    return true;
+}
+
+bool AudioOutputI2S::stop()
+{
+    m_started = false;
+
+    return true;
+}
@@ -0,0 +1,51 @@
+/**
+ * @file        AudioOutputI2S.h
+ * @brief       I2S audio output of ESP8266Audio for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * Samples are not played but counted. Like the DMA of the target, the
+ * output takes samples at the sample rate by the clock of the simulated
+ * device and keeps at most AUDIO_OUTPUT_I2S_DMA_SAMPLES in advance, so the
+ * generator has to be served as often as on the target.
+ */
+
+#ifndef INCLUDE_AUDIOOUTPUTI2S_H
+#define INCLUDE_AUDIOOUTPUTI2S_H
+
+#include "AudioOutput.h"
+
+#define AUDIO_OUTPUT_I2S_DMA_SAMPLES    (8 * 64)    /* SLC_BUF_CNT * SLC_BUF_LEN of the core */
+
+class AudioOutputI2S : public AudioOutput
+{
+public:
+    enum
+    {
+        EXTERNAL_I2S = 0,
+        INTERNAL_DAC = 1,
+        INTERNAL_PDM = 2
+    };
+
+    AudioOutputI2S(int port = 0, int outputMode = EXTERNAL_I2S, int dmaBufCount = 8, int useApll = 0);
+    virtual ~AudioOutputI2S() override { stop(); }
+
+    bool SetPinout(int bclkPin, int wclkPin, int doutPin) { (void)bclkPin; (void)wclkPin; (void)doutPin; return true; }
+    virtual bool SetRate(int hz) override;
+    virtual bool begin() override;
+    virtual bool ConsumeSample(int16_t sample[2]) override;
+    virtual void flush() override {}
+    virtual bool stop() override;
+    bool SetOutputModeMono(bool mono) { m_mono = mono; return true; }
+
+protected:
+    bool m_started = false;
+    bool m_mono = false;
+    uint64_t m_start_us = 0;    /* Time of first sample */
+    uint32_t m_sampleCntr = 0;  /* Samples taken since begin() */
+};
+
+#endif /* INCLUDE_AUDIOOUTPUTI2S_H */
@@ -0,0 +1,23 @@
+/**
+ * @file        AudioOutputI2SNoDAC.h
+ * @brief       Sigma-delta audio output of ESP8266Audio for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#ifndef INCLUDE_AUDIOOUTPUTI2SNODAC_H
+#define INCLUDE_AUDIOOUTPUTI2SNODAC_H
+
+#include "AudioOutputI2S.h"
+
+class AudioOutputI2SNoDAC : public AudioOutputI2S
+{
+public:
+    explicit AudioOutputI2SNoDAC(int port = 0) : AudioOutputI2S(port) {}
+    void SetOversampling(int os) { (void)os; }
+};
+
+#endif /* INCLUDE_AUDIOOUTPUTI2SNODAC_H */
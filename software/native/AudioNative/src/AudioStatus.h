@@ -0,0 +1,48 @@
+/**
+ * @file        AudioStatus.h
+ * @brief       Status callbacks of ESP8266Audio for the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#ifndef INCLUDE_AUDIOSTATUS_H
+#define INCLUDE_AUDIOSTATUS_H
+
+#include <Arduino.h>
+
+class AudioStatus
+{
+public:
+    typedef void (*metadataCBFn)(void *cbData, const char *type, bool isUnicode, const char *str);
+    typedef void (*statusCBFn)(void *cbData, int code, const char *string);
+
+    bool RegisterMetadataCB(metadataCBFn fn, void *data) { m_mdFn = fn; m_mdData = data; return true; }
+    bool RegisterStatusCB(statusCBFn fn, void *data) { m_stFn = fn; m_stData = data; return true; }
+
+    void md(const char *type, bool isUnicode, const char *str)
+    {
+        if (m_mdFn)
+        {
+            m_mdFn(m_mdData, type, isUnicode, str);
+        }
+    }
+
+    void st(int code, const char *str)
+    {
+        if (m_stFn)
+        {
+            m_stFn(m_stData, code, str);
+        }
+    }
+
+private:
+    metadataCBFn m_mdFn = NULL;
+    void *m_mdData = NULL;
+    statusCBFn m_stFn = NULL;
+    void *m_stData = NULL;
+};
+
+#endif /* INCLUDE_AUDIOSTATUS_H */
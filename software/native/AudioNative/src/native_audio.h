@@ -0,0 +1,35 @@
+/**
+ * @file        native_audio.h
+ * @brief       Control of the simulated I2S output in the native environment
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * Tests use these functions to see when and how much audio was played.
+ * The firmware itself never includes this file.
+ */
+
+#ifndef INCLUDE_NATIVE_AUDIO_H
+#define INCLUDE_NATIVE_AUDIO_H
+
+#include <stdint.h>
+
+typedef struct
+{
+    uint32_t beginCntr;         /* Calls of AudioOutputI2S::begin() */
+    uint32_t sampleCntr;        /* Samples consumed since begin() */
+    uint32_t totalSampleCntr;   /* Samples consumed since native_i2s_reset() */
+    uint32_t rate;              /* Sample rate set by generator */
+    uint64_t firstSample_us;    /* native_clock_us() of first sample after begin(), 0: none yet */
+    int64_t sampleSum;          /* Sum of left channel samples, a simple check of content */
+} nativeI2sStats_t;
+
+extern nativeI2sStats_t native_i2s_stats();
+extern void native_i2s_reset();
+/* true: samples are taken at the sample rate through a DMA buffer like on
+ * the target (default), false: every sample is taken immediately */
+extern void native_i2s_paced(bool paced);
+
+#endif /* INCLUDE_NATIVE_AUDIO_H */
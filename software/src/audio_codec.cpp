@@ -0,0 +1,424 @@
+/**
+ * @file        audio_codec.cpp
+ * @brief       Registry of audio decoders
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 19:58:03
+ * Last modify: 2026-10-16 19:58:03 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * The format of the audio file is detected from its first bytes when the
+ * configuration is loaded or the file is uploaded, the doorbell keeps the
+ * result, so nothing is sniffed when the bell rings. Only enabled codecs
+ * (ENABLE_CODEC_...) are linked and only the generator of the detected one
+ * is constructed, in a static buffer which fits the largest enabled one.
+ *
+ * Decode cost is measured per codec: CPU time of loop() per second of
+ * played audio and heap used while playing, so the cheapest format of a
+ * unit can be chosen.
+ */
+
+#include <new>
+
+#include <Arduino.h>
+#include "AudioGenerator.h"
+
+#include "common.h"
+#include "config.h"
+#include "trace.h"
+#include "audio_codec.h"
+
+#if ENABLE_CODEC_WAV
+#include "AudioGeneratorWAV.h"
+#endif
+#if ENABLE_CODEC_MP3
+#include "AudioGeneratorMP3.h"
+#endif
+#if ENABLE_CODEC_AAC
+#include "AudioGeneratorAAC.h"
+#endif
+#if ENABLE_CODEC_MOD
+#include "AudioGeneratorMOD.h"
+#endif
+#include "audio_wav_compressed.h"
+
+#include <FS.h>       // File System for Web Server Files
+#include <LittleFS.h> // This file system is used.
+
+#if ENABLE_DOORBELL
+typedef struct
+{
+    uint32_t playCntr;
+    uint32_t maxBeginTime_us;   /* Longest begin() of generator */
+    uint64_t decodeTime_us;     /* Time spent in loop() of generator */
+    uint64_t audioTime_us;      /* Length of played audio */
+    uint32_t peakHeapUsage;     /* Free heap before begin() - smallest free heap while playing */
+} audioCodecStats_t;
+
+/* Generator is not allocated on heap to avoid fragmentation */
+typedef union
+{
+    uint64_t align;
+#if ENABLE_CODEC_WAV
+    uint8_t wav[sizeof(AudioGeneratorWAV)];
+#endif
+#if ENABLE_CODEC_MP3
+    uint8_t mp3[sizeof(AudioGeneratorMP3)];
+#endif
+#if ENABLE_CODEC_AAC
+    uint8_t aac[sizeof(AudioGeneratorAAC)];
+#endif
+#if ENABLE_CODEC_MOD
+    uint8_t mod[sizeof(AudioGeneratorMOD)];
+#endif
+#if ENABLE_CODEC_ULAW || ENABLE_CODEC_ADPCM
+    uint8_t wavCompressed[sizeof(AudioGeneratorWAVCompressed)];
+#endif
+} audioCodecGeneratorBuffer_t;
+
+static audioCodecGeneratorBuffer_t generatorBuffer;
+static AudioGenerator *generator = NULL;
+static audioCodec_t generatorCodec = AUDIO_CODEC_UNKNOWN;
+
+static const char *codecNames[AUDIO_CODEC_COUNT] = { "unknown", "wav", "mp3", "aac", "mod", "ulaw", "ima-adpcm" };
+static audioCodecStats_t codecStats[AUDIO_CODEC_COUNT];
+static audioCodec_t statsCodec = AUDIO_CODEC_UNKNOWN;  /* Codec of current play, UNKNOWN: not playing */
+static bool statsAudioStarted = false;  /* First loop() was called */
+static uint32_t statsAudioStart_us = 0;
+static uint32_t statsFreeHeapBefore = 0;
+static uint32_t statsMinFreeHeap = 0;
+
+/*
+ * Signatures of ProTracker compatible modules: "M.K.", "M!K!", "FLT4",
+ * "FLT8", "<n>CHN", "<nn>CH".
+ */
+static bool audio_codec_is_mod_signature(const uint8_t *sig)
+{
+    if (!memcmp(sig, "M.K.", 4) || !memcmp(sig, "M!K!", 4) || !memcmp(sig, "FLT4", 4) || !memcmp(sig, "FLT8", 4))
+    {
+        return true;
+    }
+    if (isdigit(sig[0]) && !memcmp(sig + 1, "CHN", 3))
+    {
+        return true;
+    }
+    if (isdigit(sig[0]) && isdigit(sig[1]) && !memcmp(sig + 2, "CH", 2))
+    {
+        return true;
+    }
+
+    return false;
+}
+
+/*
+ * Find format tag in fmt chunk of WAV header.
+ *
+ * @return Codec of format tag, AUDIO_CODEC_WAV if fmt chunk is not in header.
+ */
+static audioCodec_t audio_codec_sniff_wav(const uint8_t *header, uint32_t headerLen)
+{
+    uint32_t pos = 12;
+    uint32_t chunkSize;
+    uint16_t formatTag;
+
+    while (pos + 10 <= headerLen)
+    {
+        chunkSize = header[pos + 4] | (header[pos + 5] << 8) | (header[pos + 6] << 16)
+                    | (static_cast<uint32_t>(header[pos + 7]) << 24);
+        if (!memcmp(header + pos, "fmt ", 4))
+        {
+            formatTag = header[pos + 8] | (header[pos + 9] << 8);
+            switch (formatTag)
+            {
+                case WAV_FORMAT_PCM:
+                    return AUDIO_CODEC_WAV;
+                case WAV_FORMAT_MULAW:
+                    return AUDIO_CODEC_ULAW;
+                case WAV_FORMAT_IMA_ADPCM:
+                    return AUDIO_CODEC_ADPCM;
+                default:
+                    return AUDIO_CODEC_UNKNOWN;
+            }
+        }
+        if (chunkSize >= headerLen)
+        {
+            break;
+        }
+        /* Chunks are word aligned */
+        pos += 8 + chunkSize + (chunkSize & 1);
+    }
+
+    return AUDIO_CODEC_WAV;
+}
+
+/*
+ * Detect format from magic bytes.
+ *
+ * @param[in] header        Beginning of file.
+ * @param[in] headerLen     Length of header, AUDIO_CODEC_SNIFF_SIZE is enough.
+ * @param[in] modSignature  4 bytes at AUDIO_CODEC_MOD_SIGNATURE_POS, NULL if
+ *                          file is shorter.
+ *
+ * @return Codec of file, AUDIO_CODEC_UNKNOWN if it is not recognized.
+ */
+audioCodec_t audio_codec_sniff(const uint8_t *header, uint32_t headerLen, const uint8_t *modSignature)
+{
+    if (headerLen >= 12 && !memcmp(header, "RIFF", 4) && !memcmp(header + 8, "WAVE", 4))
+    {
+        return audio_codec_sniff_wav(header, headerLen);
+    }
+    if (headerLen >= 3 && !memcmp(header, "ID3", 3))
+    {
+        return AUDIO_CODEC_MP3;
+    }
+    if (headerLen >= 2 && header[0] == 0xFF)
+    {
+        /* ADTS: 12 bit sync, layer is 0 */
+        if ((header[1] & 0xF6) == 0xF0)
+        {
+            return AUDIO_CODEC_AAC;
+        }
+        /* MPEG audio: 11 bit sync, version is not reserved, layer is not 0 */
+        if ((header[1] & 0xE0) == 0xE0 && (header[1] & 0x18) != 0x08 && (header[1] & 0x06))
+        {
+            return AUDIO_CODEC_MP3;
+        }
+    }
+    if (modSignature && audio_codec_is_mod_signature(modSignature))
+    {
+        return AUDIO_CODEC_MOD;
+    }
+
+    return AUDIO_CODEC_UNKNOWN;
+}
+
+audioCodec_t audio_codec_sniff_buffer(const uint8_t *data, uint32_t size)
+{
+    return audio_codec_sniff(data, MIN(size, AUDIO_CODEC_SNIFF_SIZE),
+                             size >= AUDIO_CODEC_MOD_SIGNATURE_POS + 4 ? data + AUDIO_CODEC_MOD_SIGNATURE_POS : NULL);
+}
+
+audioCodec_t audio_codec_sniff_file(const String &fileName)
+{
+    uint8_t header[AUDIO_CODEC_SNIFF_SIZE];
+    uint8_t modSignature[4];
+    bool hasModSignature = false;
+    uint32_t len;
+    audioCodec_t codec;
+
+    File file = LittleFS.open(fileName, "r");
+    if (!file)
+    {
+        ERROR("Cannot open audio file %s!\n", fileName.c_str());
+        return AUDIO_CODEC_UNKNOWN;
+    }
+    len = file.read(header, sizeof(header));
+    if (file.size() >= AUDIO_CODEC_MOD_SIGNATURE_POS + sizeof(modSignature)
+        && file.seek(AUDIO_CODEC_MOD_SIGNATURE_POS))
+    {
+        hasModSignature = file.read(modSignature, sizeof(modSignature)) == sizeof(modSignature);
+    }
+    file.close();
+
+    codec = audio_codec_sniff(header, len, hasModSignature ? modSignature : NULL);
+    TRACE("Audio file %s codec: %s\n", fileName.c_str(), audio_codec_name(codec));
+
+    return codec;
+}
+
+/*
+ * @return true if codec is linked.
+ */
+bool audio_codec_is_enabled(audioCodec_t codec)
+{
+    switch (codec)
+    {
+        case AUDIO_CODEC_WAV:
+            return ENABLE_CODEC_WAV;
+        case AUDIO_CODEC_MP3:
+            return ENABLE_CODEC_MP3;
+        case AUDIO_CODEC_AAC:
+            return ENABLE_CODEC_AAC;
+        case AUDIO_CODEC_MOD:
+            return ENABLE_CODEC_MOD;
+        case AUDIO_CODEC_ULAW:
+            return ENABLE_CODEC_ULAW;
+        case AUDIO_CODEC_ADPCM:
+            return ENABLE_CODEC_ADPCM;
+        default:
+            return false;
+    }
+}
+
+/*
+ * u-law and IMA ADPCM are decoded by the same generator.
+ */
+static bool audio_codec_same_generator(audioCodec_t codec1, audioCodec_t codec2)
+{
+    return codec1 == codec2 || (audio_codec_is_wav(codec1) && audio_codec_is_wav(codec2)
+                                && codec1 != AUDIO_CODEC_WAV && codec2 != AUDIO_CODEC_WAV);
+}
+
+/*
+ * Construct generator of codec. Generator of the previous codec is
+ * destroyed, it shall not be running.
+ *
+ * @return Generator of codec, NULL if codec is unknown or not enabled.
+ */
+AudioGenerator *audio_codec_generator(audioCodec_t codec)
+{
+    if (!audio_codec_is_enabled(codec))
+    {
+        return NULL;
+    }
+    if (generator && audio_codec_same_generator(generatorCodec, codec))
+    {
+        generatorCodec = codec;
+        return generator;
+    }
+    if (generator)
+    {
+        generator->~AudioGenerator();
+        generator = NULL;
+    }
+
+    switch (codec)
+    {
+#if ENABLE_CODEC_WAV
+        case AUDIO_CODEC_WAV:
+            generator = new (&generatorBuffer) AudioGeneratorWAV();
+            break;
+#endif
+#if ENABLE_CODEC_MP3
+        case AUDIO_CODEC_MP3:
+            generator = new (&generatorBuffer) AudioGeneratorMP3();
+            break;
+#endif
+#if ENABLE_CODEC_AAC
+        case AUDIO_CODEC_AAC:
+            generator = new (&generatorBuffer) AudioGeneratorAAC();
+            break;
+#endif
+#if ENABLE_CODEC_MOD
+        case AUDIO_CODEC_MOD:
+            generator = new (&generatorBuffer) AudioGeneratorMOD();
+            break;
+#endif
+#if ENABLE_CODEC_ULAW || ENABLE_CODEC_ADPCM
+        case AUDIO_CODEC_ULAW:
+        case AUDIO_CODEC_ADPCM:
+            generator = new (&generatorBuffer) AudioGeneratorWAVCompressed();
+            break;
+#endif
+        default:
+            break;
+    }
+    generatorCodec = codec;
+
+    return generator;
+}
+
+const char *audio_codec_name(audioCodec_t codec)
+{
+    return codecNames[codec < AUDIO_CODEC_COUNT ? codec : AUDIO_CODEC_UNKNOWN];
+}
+
+/*
+ * @return true if files of codec have a RIFF WAVE header.
+ */
+bool audio_codec_is_wav(audioCodec_t codec)
+{
+    return codec == AUDIO_CODEC_WAV || codec == AUDIO_CODEC_ULAW || codec == AUDIO_CODEC_ADPCM;
+}
+
+/*
+ * Generator was started.
+ *
+ * @param[in] codec             Codec of generator.
+ * @param[in] beginTime_us      Duration of begin().
+ * @param[in] freeHeapBefore    Free heap before begin().
+ */
+void audio_codec_stats_start(audioCodec_t codec, uint32_t beginTime_us, uint32_t freeHeapBefore)
+{
+    audioCodecStats_t &stats = codecStats[codec];
+
+    stats.playCntr++;
+    stats.maxBeginTime_us = MAX(stats.maxBeginTime_us, beginTime_us);
+    statsCodec = codec;
+    statsAudioStarted = false;
+    statsFreeHeapBefore = freeHeapBefore;
+    statsMinFreeHeap = ESP.getFreeHeap();
+}
+
+/*
+ * loop() of generator was called. Audio time starts at the first call.
+ *
+ * @param[in] loopTime_us   Duration of loop().
+ */
+void audio_codec_stats_loop(uint32_t loopTime_us)
+{
+    if (statsCodec == AUDIO_CODEC_UNKNOWN)
+    {
+        return;
+    }
+    if (!statsAudioStarted)
+    {
+        statsAudioStarted = true;
+        statsAudioStart_us = micros() - loopTime_us;
+    }
+    codecStats[statsCodec].decodeTime_us += loopTime_us;
+    statsMinFreeHeap = MIN(statsMinFreeHeap, ESP.getFreeHeap());
+}
+
+/*
+ * Generator has finished or it was stopped.
+ */
+void audio_codec_stats_stop()
+{
+    audioCodecStats_t &stats = codecStats[statsCodec];
+
+    if (statsCodec == AUDIO_CODEC_UNKNOWN)
+    {
+        return;
+    }
+    if (statsAudioStarted)
+    {
+        stats.audioTime_us += micros() - statsAudioStart_us;
+    }
+    if (statsFreeHeapBefore > statsMinFreeHeap)
+    {
+        stats.peakHeapUsage = MAX(stats.peakHeapUsage, statsFreeHeapBefore - statsMinFreeHeap);
+    }
+    statsCodec = AUDIO_CODEC_UNKNOWN;
+}
+
+void audio_codec_generate_sysinfo_json(Print &out)
+{
+    uint8_t codec;
+    bool first = true;
+
+    out.print("  , \"audioCodecs\": [");
+    for (codec = AUDIO_CODEC_UNKNOWN + 1; codec < AUDIO_CODEC_COUNT; codec++)
+    {
+        const audioCodecStats_t &stats = codecStats[codec];
+
+        if (!audio_codec_is_enabled(static_cast<audioCodec_t>(codec)))
+        {
+            continue;
+        }
+        out.print(first ? "{\"codec\": \"" : ", {\"codec\": \"");
+        out.print(codecNames[codec]);
+        out.print("\", \"playCntr\": " + String(stats.playCntr));
+        out.print(", \"maxBeginTime_us\": " + String(stats.maxBeginTime_us));
+        if (stats.audioTime_us)
+        {
+            /* CPU time needed to decode one second of audio */
+            out.print(", \"decodeTimePerSec_us\": "
+                      + String(static_cast<uint32_t>(stats.decodeTime_us * 1000000u / stats.audioTime_us)));
+        }
+        out.print(", \"peakHeapUsage\": " + String(stats.peakHeapUsage) + "}");
+        first = false;
+    }
+    out.print("]\n");
+}
+#endif /* ENABLE_DOORBELL */
@@ -0,0 +1,71 @@
+/**
+ * @file        audio_codec.h
+ * @brief       Definitions of audio_codec.cpp
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 19:58:03
+ * Last modify: 2026-10-16 19:58:03 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#ifndef INCLUDE_AUDIO_CODEC_H
+#define INCLUDE_AUDIO_CODEC_H
+
+#include <stdint.h>
+
+#include <Arduino.h>
+#include "AudioGenerator.h"
+
+#include "common.h"
+#include "config.h"
+
+/* Only enabled codecs are linked, see config.h */
+#ifndef ENABLE_CODEC_WAV
+#define ENABLE_CODEC_WAV                1
+#endif
+#ifndef ENABLE_CODEC_MP3
+#define ENABLE_CODEC_MP3                0
+#endif
+#ifndef ENABLE_CODEC_AAC
+#define ENABLE_CODEC_AAC                0
+#endif
+#ifndef ENABLE_CODEC_MOD
+#define ENABLE_CODEC_MOD                0
+#endif
+#ifndef ENABLE_CODEC_ULAW
+#define ENABLE_CODEC_ULAW               0
+#endif
+#ifndef ENABLE_CODEC_ADPCM
+#define ENABLE_CODEC_ADPCM              0
+#endif
+
+/* Bytes needed from the beginning of file (WAV fmt chunk can follow other
+ * chunks) and position of MOD signature */
+#define AUDIO_CODEC_SNIFF_SIZE          64
+#define AUDIO_CODEC_MOD_SIGNATURE_POS   1080
+
+typedef enum
+{
+    AUDIO_CODEC_UNKNOWN = 0,
+    AUDIO_CODEC_WAV,            /* "RIFF" .... "WAVE", PCM */
+    AUDIO_CODEC_MP3,            /* "ID3" tag or MPEG audio frame sync */
+    AUDIO_CODEC_AAC,            /* ADTS frame sync */
+    AUDIO_CODEC_MOD,            /* "M.K." etc. at AUDIO_CODEC_MOD_SIGNATURE_POS */
+    AUDIO_CODEC_ULAW,           /* WAV, format tag is WAV_FORMAT_MULAW */
+    AUDIO_CODEC_ADPCM,          /* WAV, format tag is WAV_FORMAT_IMA_ADPCM */
+    AUDIO_CODEC_COUNT
+} audioCodec_t;
+
+extern audioCodec_t audio_codec_sniff(const uint8_t *header, uint32_t headerLen, const uint8_t *modSignature);
+extern audioCodec_t audio_codec_sniff_buffer(const uint8_t *data, uint32_t size);
+extern audioCodec_t audio_codec_sniff_file(const String &fileName);
+extern bool audio_codec_is_enabled(audioCodec_t codec);
+extern AudioGenerator *audio_codec_generator(audioCodec_t codec);
+extern const char *audio_codec_name(audioCodec_t codec);
+extern bool audio_codec_is_wav(audioCodec_t codec);
+extern void audio_codec_stats_start(audioCodec_t codec, uint32_t beginTime_us, uint32_t freeHeapBefore);
+extern void audio_codec_stats_loop(uint32_t loopTime_us);
+extern void audio_codec_stats_stop();
+extern void audio_codec_generate_sysinfo_json(Print &out);
+
+#endif /* INCLUDE_AUDIO_CODEC_H */
@@ -0,0 +1,210 @@
+/**
+ * @file        audio_source.cpp
+ * @brief       Rewindable audio source
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 10:12:41
+ * Last modify: 2026-10-16 10:12:41 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#include <Arduino.h>
+
+#include "common.h"
+#include "config.h"
+#include "audio_source.h"
+
+AudioFileSourceRewind::AudioFileSourceRewind()
+{
+    m_source = NULL;
+    m_headerSize = 0;
+    m_pos = 0;
+    m_sourcePos = 0;
+}
+
+/*
+ * Find the beginning of audio data in the cached header.
+ *
+ * @param[in] len   Number of valid bytes in m_header.
+ *
+ * @return Offset of the data chunk's content, 0 if it is not a WAV file or
+ *         the header does not fit into the buffer.
+ */
+uint32_t AudioFileSourceRewind::parseHeader(uint32_t len)
+{
+    uint32_t offset = 12;   /* Skip RIFF header: "RIFF", size, "WAVE" */
+    uint32_t chunkSize;
+
+    if (len < offset || memcmp(m_header, "RIFF", 4) || memcmp(m_header + 8, "WAVE", 4))
+    {
+        return 0;
+    }
+
+    while (offset + 8 <= len)
+    {
+        chunkSize = m_header[offset + 4]
+                  | (m_header[offset + 5] << 8)
+                  | (m_header[offset + 6] << 16)
+                  | (static_cast<uint32_t>(m_header[offset + 7]) << 24);
+        if (!memcmp(m_header + offset, "data", 4))
+        {
+            return offset + 8;
+        }
+        /* Chunks are word aligned */
+        offset += 8 + chunkSize + (chunkSize & 1);
+    }
+
+    return 0;
+}
+
+/*
+ * Start using an opened audio source.
+ *
+ * @param[in] source        Opened audio source.
+ * @param[in] cacheHeader   true: WAV header of the file is read into RAM,
+ *                          false: nothing is read, the file has no header
+ *                          to cache (MP3, MOD...).
+ *
+ * @return true if source can be used.
+ */
+bool AudioFileSourceRewind::attach(AudioFileSource *source, bool cacheHeader)
+{
+    uint32_t len;
+
+    m_source = NULL;
+    m_headerSize = 0;
+    m_pos = 0;
+    m_sourcePos = 0;
+
+    if (!source || !source->isOpen())
+    {
+        return false;
+    }
+
+    m_source = source;
+    if (cacheHeader)
+    {
+        len = m_source->read(m_header, sizeof(m_header));
+        m_sourcePos = len;
+        m_headerSize = parseHeader(len);
+    }
+
+    return true;
+}
+
+/*
+ * Start reading from the beginning. It does not access the wrapped source,
+ * it is positioned to the audio data when the header was consumed.
+ */
+void AudioFileSourceRewind::rewind()
+{
+    m_pos = 0;
+}
+
+/*
+ * Really close the wrapped source.
+ */
+void AudioFileSourceRewind::release()
+{
+    if (m_source)
+    {
+        m_source->close();
+        m_source = NULL;
+    }
+}
+
+uint32_t AudioFileSourceRewind::read(void *data, uint32_t len)
+{
+    uint8_t *dst = reinterpret_cast<uint8_t *>(data);
+    uint32_t cnt = 0;
+    uint32_t n;
+
+    if (!m_source)
+    {
+        return 0;
+    }
+
+    if (m_pos < m_headerSize)
+    {
+        n = MIN(len, m_headerSize - m_pos);
+        memcpy(dst, m_header + m_pos, n);
+        m_pos += n;
+        cnt = n;
+    }
+    if (cnt < len)
+    {
+        if (m_sourcePos != m_pos)
+        {
+            if (!m_source->seek(m_pos, SEEK_SET))
+            {
+                return cnt;
+            }
+            m_sourcePos = m_pos;
+        }
+        n = m_source->read(dst + cnt, len - cnt);
+        m_pos += n;
+        m_sourcePos += n;
+        cnt += n;
+    }
+
+    return cnt;
+}
+
+bool AudioFileSourceRewind::seek(int32_t pos, int dir)
+{
+    int32_t newPos;
+
+    if (dir == SEEK_SET)
+    {
+        newPos = pos;
+    }
+    else if (dir == SEEK_CUR)
+    {
+        newPos = m_pos + pos;
+    }
+    else if (dir == SEEK_END)
+    {
+        newPos = getSize() + pos;
+    }
+    else
+    {
+        return false;
+    }
+    if (newPos < 0)
+    {
+        return false;
+    }
+    /* Wrapped source is positioned when data is read */
+    m_pos = newPos;
+
+    return true;
+}
+
+/*
+ * Generators close the source when playing has finished. Wrapped source
+ * remains open to be able to replay it, use release() to close it.
+ */
+bool AudioFileSourceRewind::close()
+{
+    return true;
+}
+
+bool AudioFileSourceRewind::isOpen()
+{
+    return m_source && m_source->isOpen();
+}
+
+uint32_t AudioFileSourceRewind::getSize()
+{
+    return m_source ? m_source->getSize() : 0;
+}
+
+uint32_t AudioFileSourceRewind::getPos()
+{
+    return m_pos;
+}
+
+bool AudioFileSourceRewind::loop()
+{
+    return m_source ? m_source->loop() : true;
+}
@@ -0,0 +1,60 @@
+/**
+ * @file        audio_source.h
+ * @brief       Definitions of audio_source.cpp
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 10:12:41
+ * Last modify: 2026-10-16 10:12:41 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#ifndef INCLUDE_AUDIO_SOURCE_H
+#define INCLUDE_AUDIO_SOURCE_H
+
+#include <stdint.h>
+
+#include <Arduino.h>
+#include "AudioFileSource.h"
+
+#include "common.h"
+#include "config.h"
+
+/* Maximum size of audio file header which is kept in RAM */
+#define AUDIO_SOURCE_HEADER_MAX_SIZE    128
+
+/*
+ * Audio source which wraps an opened audio file source and keeps it open
+ * when the generator closes it. The header of WAV files (up to the data
+ * chunk) is kept in RAM, so replaying the file needs only one seek instead of
+ * opening the file and reading the header again. Other formats are read
+ * through from the beginning.
+ */
+class AudioFileSourceRewind : public AudioFileSource
+{
+public:
+    AudioFileSourceRewind();
+
+    bool attach(AudioFileSource *source, bool cacheHeader);
+    void rewind();
+    void release();
+    uint32_t getDataOffset() { return m_headerSize; }
+
+    virtual uint32_t read(void *data, uint32_t len) override;
+    virtual bool seek(int32_t pos, int dir) override;
+    virtual bool close() override;
+    virtual bool isOpen() override;
+    virtual uint32_t getSize() override;
+    virtual uint32_t getPos() override;
+    virtual bool loop() override;
+
+protected:
+    uint32_t parseHeader(uint32_t len);
+
+    AudioFileSource *m_source;
+    uint8_t m_header[AUDIO_SOURCE_HEADER_MAX_SIZE];
+    uint32_t m_headerSize;  /* Number of bytes kept in RAM, offset of audio data */
+    uint32_t m_pos;         /* Read position seen by the generator */
+    uint32_t m_sourcePos;   /* Read position of the wrapped source */
+};
+
+#endif /* INCLUDE_AUDIO_SOURCE_H */
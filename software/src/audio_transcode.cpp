@@ -0,0 +1,584 @@
+/**
+ * @file        audio_transcode.cpp
+ * @brief       Convert uploaded WAV files to the playback format
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 21:02:47
+ * Last modify: 2026-10-16 21:02:47 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * PCM WAV files (8..32 bit, 1..8 channels, any sample rate) are converted
+ * while they are uploaded to 16 bit mono at the sample rate of
+ * audio_transcode.txt, so the decoder and I2S output do not convert them
+ * at every ring. Leading samples under the silence threshold are dropped,
+ * sound starts without delay.
+ *
+ * Upload data is processed as it arrives, only a few hundred bytes of RAM
+ * are used. Channels are averaged, samples are reduced to their upper 16
+ * bits and resampled by linear interpolation in fixed point. When sample
+ * rate is reduced a second order Butterworth low-pass filter (biquad) at
+ * AUDIO_TRANSCODE_LOWPASS_PERCENT of the output sample rate is applied
+ * before interpolation against aliasing. Its coefficients are calculated
+ * once per file. Header of output is written with zero length and it is
+ * patched at the end of upload.
+ *
+ * Other files, and WAV files already in playback format without silence
+ * trimming are stored as they are.
+ */
+
+#include <math.h>
+
+#include <Arduino.h>
+#include <FS.h>       // File System for Web Server Files
+#include <LittleFS.h> // This file system is used.
+
+#include "common.h"
+#include "config.h"
+#include "trace.h"
+#include "config_store.h"
+#include "audio_transcode.h"
+
+#if ENABLE_AUDIO_TRANSCODE
+#define WAV_HEADER_SIZE                 44
+#define WAV_FORMAT_PCM                  0x0001
+#define WAV_FORMAT_EXTENSIBLE           0xFFFE
+#define LOWPASS_COEF_SHIFT              24      /* Coefficients of biquad are Q24 */
+
+typedef enum
+{
+    TRANSCODE_STATE_RIFF,           /* "RIFF" <size> "WAVE" */
+    TRANSCODE_STATE_CHUNK,          /* Chunk ID and size */
+    TRANSCODE_STATE_FMT,            /* Beginning of fmt chunk */
+    TRANSCODE_STATE_SKIP,           /* Rest of chunk is not used */
+    TRANSCODE_STATE_DATA,           /* Samples */
+    TRANSCODE_STATE_TRAILER,        /* Chunks after data are dropped */
+    TRANSCODE_STATE_PASSTHROUGH     /* File is stored as it is */
+} transcodeState_t;
+
+/* Direct form I, y = b0 x + b1 x1 + b2 x2 - a1 y1 - a2 y2 */
+typedef struct
+{
+    int32_t b0_q24;                 /* 0: no filter */
+    int32_t b1_q24;
+    int32_t b2_q24;
+    int32_t a1_q24;
+    int32_t a2_q24;
+    int32_t x1;
+    int32_t x2;
+    int32_t y1;
+    int32_t y2;
+} transcodeBiquad_t;
+
+typedef struct
+{
+    uint32_t transcodeCntr;
+    uint32_t passthroughCntr;
+    uint32_t lastInSampleRate;
+    uint16_t lastInChannels;
+    uint16_t lastInBitsPerSample;
+    uint32_t lastOutSamples;
+    uint32_t lastTrimmedSamples;
+    uint32_t lastTime_us;           /* CPU time of conversion during upload */
+} audioTranscodeStats_t;
+
+static transcodeState_t state = TRANSCODE_STATE_PASSTHROUGH;
+static bool fmtFound = false;
+/* Input is stored unchanged if it turns out not to be PCM WAV before the end of fmt chunk */
+static uint8_t rawHeader[AUDIO_TRANSCODE_HEADER_MAX];
+static uint16_t rawHeaderLen = 0;
+static uint8_t field[26];           /* RIFF header, chunk header or fmt chunk */
+static uint8_t fieldLen = 0;
+static uint8_t fieldSize = 0;
+static uint32_t chunkLeft = 0;
+static size_t fileWritten = 0;      /* Bytes written to file in current call */
+
+static uint8_t inChannels = 0;
+static uint8_t inBytesPerSample = 0;
+static uint32_t inSampleRate = 0;
+static uint32_t outSampleRate = 0;
+static uint8_t frame[AUDIO_TRANSCODE_MAX_CHANNELS * 4];
+static uint8_t frameLen = 0;
+static uint8_t frameSize = 0;
+
+static uint32_t step_q16 = 0;       /* Input samples per output sample */
+static uint32_t pos_q16 = 0;        /* Position of next output sample after prevSample */
+static bool havePrevSample = false;
+static int32_t prevSample = 0;
+static transcodeBiquad_t lowPass;
+
+static int32_t silenceThreshold = 0;
+static bool soundStarted = false;
+static int16_t outBuf[AUDIO_TRANSCODE_OUT_BUF_SIZE];
+static uint16_t outLen = 0;
+static uint32_t outSamples = 0;
+static uint32_t trimmedSamples = 0;
+
+static audioTranscodeStats_t stats;
+
+static uint16_t get_le16(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+static uint32_t get_le32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static void put_le16(uint8_t *p, uint16_t value)
+{
+    p[0] = value;
+    p[1] = value >> 8;
+}
+
+static void put_le32(uint8_t *p, uint32_t value)
+{
+    put_le16(p, value);
+    put_le16(p + 2, value >> 16);
+}
+
+static void transcode_write_header(File &file, uint32_t dataSize)
+{
+    uint8_t header[WAV_HEADER_SIZE];
+
+    memcpy(header, "RIFF", 4);
+    put_le32(header + 4, WAV_HEADER_SIZE - 8 + dataSize);
+    memcpy(header + 8, "WAVEfmt ", 8);
+    put_le32(header + 16, 16);
+    put_le16(header + 20, WAV_FORMAT_PCM);
+    put_le16(header + 22, 1);
+    put_le32(header + 24, outSampleRate);
+    put_le32(header + 28, outSampleRate * sizeof(int16_t));
+    put_le16(header + 32, sizeof(int16_t));
+    put_le16(header + 34, 16);
+    memcpy(header + 36, "data", 4);
+    put_le32(header + 40, dataSize);
+    fileWritten += file.write(header, sizeof(header));
+}
+
+static void transcode_passthrough(File &file)
+{
+    state = TRANSCODE_STATE_PASSTHROUGH;
+    fileWritten += file.write(rawHeader, rawHeaderLen);
+    stats.passthroughCntr++;
+}
+
+static void transcode_expect_field(transcodeState_t newState, uint8_t size)
+{
+    state = newState;
+    fieldLen = 0;
+    fieldSize = size;
+}
+
+static void transcode_flush(File &file)
+{
+    fileWritten += file.write(reinterpret_cast<const uint8_t *>(outBuf), outLen * sizeof(int16_t));
+    outSamples += outLen;
+    outLen = 0;
+}
+
+static void transcode_output(File &file, int32_t sample)
+{
+    if (!soundStarted)
+    {
+        if (abs(sample) < silenceThreshold)
+        {
+            trimmedSamples++;
+            return;
+        }
+        soundStarted = true;
+    }
+    outBuf[outLen++] = sample;
+    if (outLen == AUDIO_TRANSCODE_OUT_BUF_SIZE)
+    {
+        transcode_flush(file);
+    }
+}
+
+/*
+ * Calculate low-pass filter of input sample rate (bilinear transform of
+ * analog Butterworth filter, Q = 1/sqrt(2)).
+ *
+ * @param[in] cutoff    Cut-off frequency [Hz], it shall be below half of
+ *                      input sample rate.
+ */
+static void transcode_lowpass_init(uint32_t cutoff)
+{
+    const float scale = 1 << LOWPASS_COEF_SHIFT;
+    float w0 = 2.0f * static_cast<float>(M_PI) * cutoff / inSampleRate;
+    float cosW0 = cosf(w0);
+    float alpha = sinf(w0) / (2.0f * static_cast<float>(M_SQRT1_2));
+    float a0 = 1.0f + alpha;
+
+    lowPass.b0_q24 = lroundf((1.0f - cosW0) / 2.0f / a0 * scale);
+    lowPass.b1_q24 = lroundf((1.0f - cosW0) / a0 * scale);
+    lowPass.b2_q24 = lowPass.b0_q24;
+    lowPass.a1_q24 = lroundf(-2.0f * cosW0 / a0 * scale);
+    lowPass.a2_q24 = lroundf((1.0f - alpha) / a0 * scale);
+}
+
+static int32_t transcode_lowpass(int32_t sample)
+{
+    int64_t acc;
+    int32_t out;
+
+    if (!havePrevSample)
+    {
+        /* Start in steady state, gain is 1 at 0 Hz */
+        lowPass.x1 = lowPass.x2 = lowPass.y1 = lowPass.y2 = sample;
+    }
+    acc = static_cast<int64_t>(lowPass.b0_q24) * sample + static_cast<int64_t>(lowPass.b1_q24) * lowPass.x1
+          + static_cast<int64_t>(lowPass.b2_q24) * lowPass.x2 - static_cast<int64_t>(lowPass.a1_q24) * lowPass.y1
+          - static_cast<int64_t>(lowPass.a2_q24) * lowPass.y2;
+    out = (acc + (1 << (LOWPASS_COEF_SHIFT - 1))) >> LOWPASS_COEF_SHIFT;
+    lowPass.x2 = lowPass.x1;
+    lowPass.x1 = sample;
+    lowPass.y2 = lowPass.y1;
+    lowPass.y1 = out;
+
+    /* Overshoot of full scale input */
+    return MAX(MIN(out, INT16_MAX), INT16_MIN);
+}
+
+static void transcode_resample(File &file, int32_t sample)
+{
+    if (lowPass.b0_q24)
+    {
+        sample = transcode_lowpass(sample);
+    }
+    if (!havePrevSample)
+    {
+        prevSample = sample;
+        havePrevSample = true;
+        return;
+    }
+    while (pos_q16 < 0x10000)
+    {
+        /* Position is reduced to 15 bits, product fits in 32 bits */
+        transcode_output(file, prevSample + (((sample - prevSample) * static_cast<int32_t>(pos_q16 >> 1)) >> 15));
+        pos_q16 += step_q16;
+    }
+    pos_q16 -= 0x10000;
+    prevSample = sample;
+}
+
+static void transcode_frame(File &file)
+{
+    const uint8_t *p = frame;
+    int32_t sum = 0;
+    uint8_t ch;
+
+    for (ch = 0; ch < inChannels; ch++)
+    {
+        if (inBytesPerSample == 1)
+        {
+            /* 8 bit samples are unsigned */
+            sum += (p[0] - 128) << 8;
+        }
+        else
+        {
+            /* Upper 16 bits of little endian sample */
+            sum += static_cast<int16_t>(get_le16(p + inBytesPerSample - 2));
+        }
+        p += inBytesPerSample;
+    }
+    transcode_resample(file, sum / inChannels);
+}
+
+/*
+ * Check format of fmt chunk.
+ *
+ * @return true if file shall be converted.
+ */
+static bool transcode_parse_fmt()
+{
+    uint16_t format = get_le16(field);
+    uint16_t channels = get_le16(field + 2);
+    uint16_t blockAlign = get_le16(field + 12);
+    uint16_t bitsPerSample = get_le16(field + 14);
+
+    inSampleRate = get_le32(field + 4);
+    if (format == WAV_FORMAT_EXTENSIBLE && fieldSize >= 26)
+    {
+        /* First two bytes of sub format GUID */
+        format = get_le16(field + 24);
+    }
+    if (format != WAV_FORMAT_PCM || !channels || channels > AUDIO_TRANSCODE_MAX_CHANNELS || !inSampleRate
+        || blockAlign % channels)
+    {
+        return false;
+    }
+    inChannels = channels;
+    inBytesPerSample = blockAlign / channels;
+    if (!inBytesPerSample || inBytesPerSample > 4 || bitsPerSample > inBytesPerSample * 8)
+    {
+        return false;
+    }
+    stats.lastInSampleRate = inSampleRate;
+    stats.lastInChannels = channels;
+    stats.lastInBitsPerSample = bitsPerSample;
+    if (inChannels == 1 && inBytesPerSample == 2 && inSampleRate == outSampleRate && !silenceThreshold)
+    {
+        /* Already in playback format */
+        return false;
+    }
+    frameSize = blockAlign;
+    step_q16 = (static_cast<uint64_t>(inSampleRate) << 16) / outSampleRate;
+    lowPass.b0_q24 = 0;
+    if (inSampleRate > outSampleRate)
+    {
+        transcode_lowpass_init(outSampleRate * AUDIO_TRANSCODE_LOWPASS_PERCENT / 100u);
+    }
+
+    return true;
+}
+
+static void transcode_field_done(File &file)
+{
+    uint32_t chunkSize;
+
+    switch (state)
+    {
+        case TRANSCODE_STATE_RIFF:
+            if (memcmp(field, "RIFF", 4) || memcmp(field + 8, "WAVE", 4))
+            {
+                transcode_passthrough(file);
+                break;
+            }
+            transcode_expect_field(TRANSCODE_STATE_CHUNK, 8);
+            break;
+        case TRANSCODE_STATE_CHUNK:
+            chunkSize = get_le32(field + 4);
+            if (!memcmp(field, "fmt ", 4) && !fmtFound)
+            {
+                if (chunkSize < 16)
+                {
+                    transcode_passthrough(file);
+                    break;
+                }
+                transcode_expect_field(TRANSCODE_STATE_FMT, MIN(chunkSize, sizeof(field)));
+                /* Chunks are word aligned */
+                chunkLeft = chunkSize - fieldSize + (chunkSize & 1);
+            }
+            else if (!memcmp(field, "data", 4))
+            {
+                if (!fmtFound)
+                {
+                    transcode_passthrough(file);
+                    break;
+                }
+                state = chunkSize ? TRANSCODE_STATE_DATA : TRANSCODE_STATE_TRAILER;
+                chunkLeft = chunkSize;
+                frameLen = 0;
+            }
+            else
+            {
+                state = TRANSCODE_STATE_SKIP;
+                chunkLeft = chunkSize + (chunkSize & 1);
+            }
+            break;
+        case TRANSCODE_STATE_FMT:
+            if (!transcode_parse_fmt())
+            {
+                transcode_passthrough(file);
+                break;
+            }
+            fmtFound = true;
+            stats.transcodeCntr++;
+            /* Patched at the end */
+            transcode_write_header(file, 0);
+            state = TRANSCODE_STATE_SKIP;
+            break;
+        default:
+            break;
+    }
+    if (state == TRANSCODE_STATE_SKIP && !chunkLeft)
+    {
+        transcode_expect_field(TRANSCODE_STATE_CHUNK, 8);
+    }
+}
+
+/*
+ * Process bytes of input.
+ *
+ * @return Number of bytes consumed.
+ */
+static uint32_t transcode_consume(File &file, const uint8_t *data, uint32_t len)
+{
+    uint32_t n = 0;
+    uint32_t i;
+
+    switch (state)
+    {
+        case TRANSCODE_STATE_RIFF:
+        case TRANSCODE_STATE_CHUNK:
+        case TRANSCODE_STATE_FMT:
+            n = MIN(len, static_cast<uint32_t>(fieldSize - fieldLen));
+            memcpy(field + fieldLen, data, n);
+            fieldLen += n;
+            if (fieldLen == fieldSize)
+            {
+                transcode_field_done(file);
+            }
+            break;
+        case TRANSCODE_STATE_SKIP:
+            n = MIN(len, chunkLeft);
+            chunkLeft -= n;
+            if (!chunkLeft)
+            {
+                transcode_expect_field(TRANSCODE_STATE_CHUNK, 8);
+            }
+            break;
+        case TRANSCODE_STATE_DATA:
+            n = MIN(len, chunkLeft);
+            for (i = 0; i < n; i++)
+            {
+                frame[frameLen++] = data[i];
+                if (frameLen == frameSize)
+                {
+                    transcode_frame(file);
+                    frameLen = 0;
+                }
+            }
+            chunkLeft -= n;
+            if (!chunkLeft)
+            {
+                state = TRANSCODE_STATE_TRAILER;
+            }
+            break;
+        default:
+            n = len;
+            break;
+    }
+
+    return n;
+}
+
+/*
+ * Upload of a file is started.
+ *
+ * @return true if file can be converted, audio_transcode_write() and
+ *         audio_transcode_end() shall be used for writing it.
+ */
+bool audio_transcode_begin(const String &fileName)
+{
+    String name = fileName;
+
+    outSampleRate = config_get_int(CONFIG_AUDIO_TRANSCODE_SAMPLE_RATE);
+    name.toLowerCase();
+    if (outSampleRate < AUDIO_TRANSCODE_MIN_SAMPLE_RATE || outSampleRate > AUDIO_TRANSCODE_MAX_SAMPLE_RATE
+        || !name.endsWith(".wav"))
+    {
+        return false;
+    }
+    silenceThreshold = config_get_int(CONFIG_AUDIO_TRANSCODE_SILENCE_THRESHOLD);
+    transcode_expect_field(TRANSCODE_STATE_RIFF, 12);
+    fmtFound = false;
+    rawHeaderLen = 0;
+    pos_q16 = 0;
+    havePrevSample = false;
+    soundStarted = false;
+    outLen = 0;
+    outSamples = 0;
+    trimmedSamples = 0;
+    stats.lastTime_us = 0;
+
+    return true;
+}
+
+/*
+ * Convert received part of file.
+ *
+ * @return Number of bytes written to file.
+ */
+size_t audio_transcode_write(File &file, const uint8_t *data, size_t len)
+{
+    uint32_t start_us = micros();
+    uint32_t n;
+
+    fileWritten = 0;
+    while (len)
+    {
+        if (state == TRANSCODE_STATE_PASSTHROUGH)
+        {
+            fileWritten += file.write(data, len);
+            break;
+        }
+        n = len;
+        if (!fmtFound)
+        {
+            /* Keep header byte by byte until it is known that file is converted */
+            if (rawHeaderLen >= sizeof(rawHeader))
+            {
+                transcode_passthrough(file);
+                continue;
+            }
+            rawHeader[rawHeaderLen++] = *data;
+            n = 1;
+        }
+        n = transcode_consume(file, data, n);
+        data += n;
+        len -= n;
+    }
+    stats.lastTime_us += micros() - start_us;
+
+    return fileWritten;
+}
+
+/*
+ * Upload is finished or aborted, header is patched with length of samples.
+ * File shall be closed after this.
+ *
+ * @return Number of bytes written to file.
+ */
+size_t audio_transcode_end(File &file)
+{
+    uint32_t start_us = micros();
+
+    fileWritten = 0;
+    if (!fmtFound)
+    {
+        if (state != TRANSCODE_STATE_PASSTHROUGH)
+        {
+            /* File is shorter than a WAV header */
+            transcode_passthrough(file);
+        }
+        return fileWritten;
+    }
+    if (havePrevSample && !pos_q16)
+    {
+        /* Output sample at the last input sample */
+        transcode_output(file, prevSample);
+    }
+    transcode_flush(file);
+    if (file.seek(0))
+    {
+        transcode_write_header(file, outSamples * sizeof(int16_t));
+    }
+    else
+    {
+        ERROR("Cannot patch header of converted audio file!\n");
+    }
+    state = TRANSCODE_STATE_PASSTHROUGH;
+    stats.lastOutSamples = outSamples;
+    stats.lastTrimmedSamples = trimmedSamples;
+    stats.lastTime_us += micros() - start_us;
+    TRACE("Audio converted: %i Hz %i ch %i bit -> %i Hz mono 16 bit, %i samples, %i silent samples dropped, %i us\n",
+          stats.lastInSampleRate, stats.lastInChannels, stats.lastInBitsPerSample, outSampleRate,
+          outSamples, trimmedSamples, stats.lastTime_us);
+
+    return fileWritten;
+}
+
+void audio_transcode_generate_sysinfo_json(Print &out)
+{
+    out.print("  , \"audioTranscodeCntr\": " + String(stats.transcodeCntr) + "\n");
+    out.print("  , \"audioTranscodePassthroughCntr\": " + String(stats.passthroughCntr) + "\n");
+    out.print("  , \"audioTranscodeLastInSampleRate\": " + String(stats.lastInSampleRate) + "\n");
+    out.print("  , \"audioTranscodeLastInChannels\": " + String(stats.lastInChannels) + "\n");
+    out.print("  , \"audioTranscodeLastInBitsPerSample\": " + String(stats.lastInBitsPerSample) + "\n");
+    out.print("  , \"audioTranscodeLastOutSamples\": " + String(stats.lastOutSamples) + "\n");
+    out.print("  , \"audioTranscodeLastTrimmedSamples\": " + String(stats.lastTrimmedSamples) + "\n");
+    out.print("  , \"audioTranscodeLastTime_us\": " + String(stats.lastTime_us) + "\n");
+}
+#endif /* ENABLE_AUDIO_TRANSCODE */
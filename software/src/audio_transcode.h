@@ -0,0 +1,49 @@
+/**
+ * @file        audio_transcode.h
+ * @brief       Definitions of audio_transcode.cpp
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 21:02:47
+ * Last modify: 2026-10-16 21:02:47 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#ifndef INCLUDE_AUDIO_TRANSCODE_H
+#define INCLUDE_AUDIO_TRANSCODE_H
+
+#include <stdint.h>
+
+#include <Arduino.h>
+#include <FS.h>
+
+#include "common.h"
+#include "config.h"
+
+#ifndef ENABLE_AUDIO_TRANSCODE
+#define ENABLE_AUDIO_TRANSCODE          0
+#endif
+#ifndef AUDIO_TRANSCODE_SAMPLE_RATE
+#define AUDIO_TRANSCODE_SAMPLE_RATE     0
+#endif
+#ifndef AUDIO_TRANSCODE_SILENCE_THRESHOLD
+#define AUDIO_TRANSCODE_SILENCE_THRESHOLD 0
+#endif
+
+#ifndef AUDIO_TRANSCODE_LOWPASS_PERCENT
+#define AUDIO_TRANSCODE_LOWPASS_PERCENT 45      /* Cut-off of anti-aliasing filter in percent of output sample rate */
+#endif
+
+#define AUDIO_TRANSCODE_MIN_SAMPLE_RATE 8000
+#define AUDIO_TRANSCODE_MAX_SAMPLE_RATE 48000
+#define AUDIO_TRANSCODE_MAX_CHANNELS    8
+#define AUDIO_TRANSCODE_HEADER_MAX      128     /* Bytes before end of fmt chunk, passed through if more */
+#define AUDIO_TRANSCODE_OUT_BUF_SIZE    128     /* Output samples written at once */
+
+#if ENABLE_AUDIO_TRANSCODE
+extern bool audio_transcode_begin(const String &fileName);
+extern size_t audio_transcode_write(File &file, const uint8_t *data, size_t len);
+extern size_t audio_transcode_end(File &file);
+extern void audio_transcode_generate_sysinfo_json(Print &out);
+#endif
+
+#endif /* INCLUDE_AUDIO_TRANSCODE_H */
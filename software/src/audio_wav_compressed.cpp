@@ -0,0 +1,390 @@
+/**
+ * @file        audio_wav_compressed.cpp
+ * @brief       Generator of u-law and IMA ADPCM WAV files
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 20:31:26
+ * Last modify: 2026-10-16 20:31:26 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * Compressed WAV files need 2 (u-law) or 4 (IMA ADPCM) times less flash and
+ * file system reads than 16 bit PCM. They can be made by
+ *   ffmpeg -i doorbell.wav -ac 1 -acodec pcm_mulaw doorbell_ulaw.wav
+ *   ffmpeg -i doorbell.wav -ac 1 -acodec adpcm_ima_wav doorbell_adpcm.wav
+ *
+ * IMA ADPCM blocks start with the first sample and step index of every
+ * channel, followed by groups of 4 bytes (8 samples, low nibble first) of
+ * each channel.
+ */
+
+#include <Arduino.h>
+#include "AudioGenerator.h"
+
+#include "common.h"
+#include "config.h"
+#include "audio_codec.h"
+#include "audio_wav_compressed.h"
+
+#if ENABLE_CODEC_ULAW || ENABLE_CODEC_ADPCM
+#define ADPCM_STEP_INDEX_MAX    88
+
+static const int16_t adpcmStepTable[ADPCM_STEP_INDEX_MAX + 1] =
+{
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+    253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+    1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+    3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442,
+    11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794,
+    32767
+};
+
+static const int8_t adpcmIndexTable[16] =
+{
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+/* Filled at first begin() */
+static int16_t ulawTable[256];
+static bool ulawTableReady = false;
+
+static void ulaw_table_init()
+{
+    uint16_t i;
+    uint8_t u;
+    int16_t magnitude;
+
+    for (i = 0; i < 256; i++)
+    {
+        u = ~i;
+        magnitude = ((((u & 0x0F) << 3) + 0x84) << ((u & 0x70) >> 4)) - 0x84;
+        ulawTable[i] = (u & 0x80) ? -magnitude : magnitude;
+    }
+    ulawTableReady = true;
+}
+
+static uint16_t get_le16(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+static uint32_t get_le32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+AudioGeneratorWAVCompressed::AudioGeneratorWAVCompressed()
+{
+    running = false;
+    m_format = 0;
+    m_channels = 1;
+    m_sampleRate = 0;
+    m_blockAlign = 0;
+    m_dataLeft = 0;
+    m_blockLeft = 0;
+    m_frameCnt = 0;
+    m_frameIdx = 0;
+    m_bufLen = 0;
+    m_bufPos = 0;
+}
+
+/*
+ * Parse chunks up to the data chunk.
+ *
+ * @return true if format is supported.
+ */
+bool AudioGeneratorWAVCompressed::readHeader()
+{
+    uint8_t chunk[20];
+    uint32_t chunkSize;
+    uint32_t len;
+    bool fmtFound = false;
+    uint16_t bitsPerSample = 0;
+
+    m_format = 0;
+    m_dataLeft = 0;
+    if (file->read(chunk, 12) != 12 || memcmp(chunk, "RIFF", 4) || memcmp(chunk + 8, "WAVE", 4))
+    {
+        return false;
+    }
+    while (file->read(chunk, 8) == 8)
+    {
+        chunkSize = get_le32(chunk + 4);
+        if (!memcmp(chunk, "data", 4))
+        {
+            m_dataLeft = chunkSize;
+            break;
+        }
+        len = 0;
+        if (!memcmp(chunk, "fmt ", 4))
+        {
+            len = MIN(chunkSize, sizeof(chunk));
+            if (len < 16 || file->read(chunk, len) != len)
+            {
+                return false;
+            }
+            m_format = get_le16(chunk);
+            m_channels = get_le16(chunk + 2);
+            m_sampleRate = get_le32(chunk + 4);
+            m_blockAlign = get_le16(chunk + 12);
+            bitsPerSample = get_le16(chunk + 14);
+            fmtFound = true;
+        }
+        /* Chunks are word aligned */
+        if (!file->seek(chunkSize - len + (chunkSize & 1), SEEK_CUR))
+        {
+            return false;
+        }
+    }
+
+    if (!fmtFound || !m_dataLeft || m_channels < 1 || m_channels > 2)
+    {
+        return false;
+    }
+    if (m_format == WAV_FORMAT_MULAW)
+    {
+        return bitsPerSample == 8;
+    }
+    if (m_format == WAV_FORMAT_IMA_ADPCM)
+    {
+        /* Block: header and at least one group of 4 bytes per channel */
+        return bitsPerSample == 4 && m_blockAlign >= 8 * m_channels && !(m_blockAlign % (4 * m_channels));
+    }
+
+    return false;
+}
+
+/*
+ * Read bytes of data chunk through the buffer.
+ *
+ * @return false if data chunk is shorter than len.
+ */
+bool AudioGeneratorWAVCompressed::readBytes(uint8_t *data, uint32_t len)
+{
+    uint32_t n;
+
+    while (len)
+    {
+        if (m_bufPos >= m_bufLen)
+        {
+            n = MIN(sizeof(m_buf), m_dataLeft);
+            m_bufLen = n ? file->read(m_buf, n) : 0;
+            m_bufPos = 0;
+            m_dataLeft -= m_bufLen;
+            if (!m_bufLen)
+            {
+                return false;
+            }
+        }
+        n = MIN(len, static_cast<uint32_t>(m_bufLen - m_bufPos));
+        memcpy(data, m_buf + m_bufPos, n);
+        m_bufPos += n;
+        data += n;
+        len -= n;
+    }
+
+    return true;
+}
+
+int16_t AudioGeneratorWAVCompressed::decodeAdpcmNibble(uint8_t channel, uint8_t nibble)
+{
+    int32_t step = adpcmStepTable[m_stepIndex[channel]];
+    int32_t diff = step >> 3;
+    int32_t predictor = m_predictor[channel];
+    int8_t stepIndex;
+
+    if (nibble & 1)
+    {
+        diff += step >> 2;
+    }
+    if (nibble & 2)
+    {
+        diff += step >> 1;
+    }
+    if (nibble & 4)
+    {
+        diff += step;
+    }
+    predictor += (nibble & 8) ? -diff : diff;
+    predictor = MAX(MIN(predictor, INT16_MAX), INT16_MIN);
+    m_predictor[channel] = predictor;
+    stepIndex = m_stepIndex[channel] + adpcmIndexTable[nibble];
+    m_stepIndex[channel] = MAX(MIN(stepIndex, ADPCM_STEP_INDEX_MAX), 0);
+
+    return predictor;
+}
+
+/*
+ * Decode header of a block (one frame) or a group of 4 bytes per channel
+ * (8 frames).
+ */
+bool AudioGeneratorWAVCompressed::decodeAdpcmGroup()
+{
+    uint8_t bytes[4];
+    uint8_t ch;
+    uint8_t i;
+
+    if (m_blockLeft < 4 * m_channels)
+    {
+        /* Next block */
+        for (ch = 0; ch < m_channels; ch++)
+        {
+            if (!readBytes(bytes, 4))
+            {
+                return false;
+            }
+            m_predictor[ch] = static_cast<int16_t>(get_le16(bytes));
+            m_stepIndex[ch] = MIN(bytes[2], ADPCM_STEP_INDEX_MAX);
+            m_frames[0][ch] = m_predictor[ch];
+        }
+        m_blockLeft = m_blockAlign - 4 * m_channels;
+        m_frameCnt = 1;
+        return true;
+    }
+
+    for (ch = 0; ch < m_channels; ch++)
+    {
+        if (!readBytes(bytes, 4))
+        {
+            return false;
+        }
+        for (i = 0; i < 4; i++)
+        {
+            m_frames[2 * i][ch] = decodeAdpcmNibble(ch, bytes[i] & 0x0F);
+            m_frames[2 * i + 1][ch] = decodeAdpcmNibble(ch, bytes[i] >> 4);
+        }
+    }
+    m_blockLeft -= 4 * m_channels;
+    m_frameCnt = 8;
+
+    return true;
+}
+
+/*
+ * Fill m_frames.
+ *
+ * @return false at the end of data.
+ */
+bool AudioGeneratorWAVCompressed::decodeFrames()
+{
+    uint8_t bytes[2];
+    uint8_t i;
+
+    m_frameIdx = 0;
+    m_frameCnt = 0;
+    if (m_format == WAV_FORMAT_IMA_ADPCM)
+    {
+        if (!decodeAdpcmGroup())
+        {
+            return false;
+        }
+    }
+    else
+    {
+        for (i = 0; i < 8 && readBytes(bytes, m_channels); i++)
+        {
+            m_frames[i][0] = ulawTable[bytes[0]];
+            m_frames[i][1] = ulawTable[bytes[m_channels - 1]];
+        }
+        m_frameCnt = i;
+    }
+    if (m_channels == 1)
+    {
+        for (i = 0; i < m_frameCnt; i++)
+        {
+            m_frames[i][AudioOutput::RIGHTCHANNEL] = m_frames[i][AudioOutput::LEFTCHANNEL];
+        }
+    }
+
+    return m_frameCnt > 0;
+}
+
+bool AudioGeneratorWAVCompressed::begin(AudioFileSource *source, AudioOutput *output)
+{
+    if (!source || !output)
+    {
+        return false;
+    }
+    file = source;
+    this->output = output;
+    if (!file->isOpen() || !readHeader())
+    {
+        audioLogger->printf_P(PSTR("AudioGeneratorWAVCompressed::begin: unsupported file\n"));
+        return false;
+    }
+    if (m_format == WAV_FORMAT_MULAW && !ulawTableReady)
+    {
+        ulaw_table_init();
+    }
+    m_blockLeft = 0;
+    m_bufLen = 0;
+    m_bufPos = 0;
+    if (!decodeFrames())
+    {
+        return false;
+    }
+    lastSample[AudioOutput::LEFTCHANNEL] = m_frames[0][AudioOutput::LEFTCHANNEL];
+    lastSample[AudioOutput::RIGHTCHANNEL] = m_frames[0][AudioOutput::RIGHTCHANNEL];
+    m_frameIdx = 1;
+
+    if (!output->SetRate(m_sampleRate) || !output->SetBitsPerSample(16)
+        || !output->SetChannels(m_channels) || !output->begin())
+    {
+        return false;
+    }
+    running = true;
+
+    return true;
+}
+
+bool AudioGeneratorWAVCompressed::loop()
+{
+    if (!running)
+    {
+        goto done;
+    }
+
+    /* Last sample could not be sent in previous call */
+    while (output->ConsumeSample(lastSample))
+    {
+        if (m_frameIdx >= m_frameCnt && !decodeFrames())
+        {
+            stop();
+            goto done;
+        }
+        lastSample[AudioOutput::LEFTCHANNEL] = m_frames[m_frameIdx][AudioOutput::LEFTCHANNEL];
+        lastSample[AudioOutput::RIGHTCHANNEL] = m_frames[m_frameIdx][AudioOutput::RIGHTCHANNEL];
+        m_frameIdx++;
+    }
+
+done:
+    if (file)
+    {
+        file->loop();
+    }
+    if (output)
+    {
+        output->loop();
+    }
+
+    return running;
+}
+
+bool AudioGeneratorWAVCompressed::stop()
+{
+    if (!running)
+    {
+        return true;
+    }
+    running = false;
+    output->stop();
+
+    return file->close();
+}
+
+bool AudioGeneratorWAVCompressed::isRunning()
+{
+    return running;
+}
+#endif /* ENABLE_CODEC_ULAW || ENABLE_CODEC_ADPCM */
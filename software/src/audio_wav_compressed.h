@@ -0,0 +1,67 @@
+/**
+ * @file        audio_wav_compressed.h
+ * @brief       Definitions of audio_wav_compressed.cpp
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 20:31:26
+ * Last modify: 2026-10-16 20:31:26 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#ifndef INCLUDE_AUDIO_WAV_COMPRESSED_H
+#define INCLUDE_AUDIO_WAV_COMPRESSED_H
+
+#include <stdint.h>
+
+#include <Arduino.h>
+#include "AudioGenerator.h"
+
+#include "common.h"
+#include "config.h"
+
+/* Format tags of WAV fmt chunk */
+#define WAV_FORMAT_PCM                  0x0001
+#define WAV_FORMAT_MULAW                0x0007
+#define WAV_FORMAT_IMA_ADPCM            0x0011
+
+/* Bytes read from audio source at once */
+#define AUDIO_WAV_COMPRESSED_BUF_SIZE   64
+
+/*
+ * Generator of G.711 u-law (2:1) and IMA ADPCM (4:1) WAV files, mono or
+ * stereo. Both are decoded by table lookups and integer arithmetic.
+ */
+class AudioGeneratorWAVCompressed : public AudioGenerator
+{
+public:
+    AudioGeneratorWAVCompressed();
+
+    virtual bool begin(AudioFileSource *source, AudioOutput *output) override;
+    virtual bool loop() override;
+    virtual bool stop() override;
+    virtual bool isRunning() override;
+
+protected:
+    bool readHeader();
+    bool readBytes(uint8_t *data, uint32_t len);
+    bool decodeFrames();
+    bool decodeAdpcmGroup();
+    int16_t decodeAdpcmNibble(uint8_t channel, uint8_t nibble);
+
+    uint16_t m_format;          /* WAV_FORMAT_... */
+    uint8_t m_channels;
+    uint32_t m_sampleRate;
+    uint16_t m_blockAlign;      /* Bytes per ADPCM block */
+    uint32_t m_dataLeft;        /* Bytes of data chunk not read yet */
+    uint16_t m_blockLeft;       /* Bytes of current ADPCM block not read yet */
+    int32_t m_predictor[2];     /* ADPCM state of channels */
+    int8_t m_stepIndex[2];
+    int16_t m_frames[8][2];     /* Decoded samples, left and right */
+    uint8_t m_frameCnt;
+    uint8_t m_frameIdx;
+    uint8_t m_buf[AUDIO_WAV_COMPRESSED_BUF_SIZE];
+    uint8_t m_bufLen;
+    uint8_t m_bufPos;
+};
+
+#endif /* INCLUDE_AUDIO_WAV_COMPRESSED_H */
@@ -21,26 +21,54 @@
 
 #define ENABLE_HTTP_SERVER      1   /* 1: enable HTTP server, 0: disable HTTP server */
 #define ENABLE_NTP_CLIENT       1   /* 1: enable NTP client, 0: disable NTP client */
+#ifndef ENABLE_MQTT_CLIENT
 #define ENABLE_MQTT_CLIENT      0   /* 1: enable MQTT client, 0: disable MQTT client */
+#endif
 #define ENABLE_FIRMWARE_UPDATE  1   /* 1: enable firmware update through HTTP, 0: disable firmware update */
 #define ENABLE_RESET            1   /* 1: enable reset through HTTP, 0: disable reset */
 #define ENABLE_HTTP_AUTH        1   /* 1: enable user authentication through HTTP, 0: disable authentication */
+#define ENABLE_HTTP_EVENTS      1   /* 1: index page is updated by Server-Sent Events, 0: index page is reloaded periodically */
+#define ENABLE_HTTP_STATIC_GZIP 1   /* 1: serve pre-gzipped assets of gz_manifest.txt with content hash ETag, 0: plain static files */
+#define ENABLE_RING_MULTICAST   1   /* 1: ring doorbells of the same group by UDP multicast (ring_multicast.txt), 0: disable */
 
 #define ENABLE_DOORBELL         1
+#define ENABLE_PROFILE          1   /* 1: measure cost of ring, page load, MQTT message and upload */
 
 #define DISABLE_SERIAL_TRACE    0
 
 // name of the server. You reach it using http://doorbell<MAC>
 #define DEFAULT_HOSTNAME "doorbell"
 
+// default title of homepage
+#define TITLE_STR "Doorbell"
+
 // TODO define time zone in file!
 // local time zone definition (Berlin, Belgrade, Budapest, Oslo, Paris, etc.)
 #define TIMEZONE "CET-1CEST,M3.5.0,M10.5.0/3"
 
-#define MQTT_CONNECT_RETRY_SEC                  5
+#define MQTT_CONNECT_RETRY_MIN_MS               1000    /* First retry delay, it is doubled after every failure */
+#define MQTT_CONNECT_RETRY_MAX_MS               60000
+#define MQTT_DNS_TIMEOUT_MS                     200
+#define MQTT_TCP_CONNECT_TIMEOUT_MS             200
+#define MQTT_SOCKET_TIMEOUT_SEC                 1
 #define MQTT_PUBLISH_INTERVAL_SEC               10
 #define HTTP_SERVER_PORT                        80
+
+/* Scheduler: runtime budget and period of tasks, runs over budget are counted */
+#define TASK_AUDIO_BUDGET_US                    2000
+#define TASK_HTTP_BUDGET_US                     50000
+#define TASK_MQTT_BUDGET_US                     20000
+#define TASK_DOORBELL_PERIOD_MS                 100
+#define TASK_DOORBELL_BUDGET_US                 20000
+#define TASK_RESET_PERIOD_MS                    100
+#define TASK_RESET_BUDGET_US                    1000
+#define TASK_TRACE_BUDGET_US                    2000
+#define TASK_HTTP_EVENTS_BUDGET_US              5000
+#define TASK_MQTT_QUEUE_PERIOD_MS               50
+#define TASK_MQTT_QUEUE_BUDGET_US               10000
+#define TASK_RING_MULTICAST_BUDGET_US           2000
 #define DEFAULT_HOMEPAGE_REFRESH_INTERVAL_SEC   60
+#define HTTP_EVENTS_MAX_SUBSCRIBERS             2
 
 #if HW_TYPE == HW_TYPE_WEMOS_D1_MINI
 #define LED_PIN                         2   /* GPIO2 */
@@ -52,16 +80,68 @@
 #define DOORBELL_AUDIO_PLAY_COUNT       1               /* Play audio file multiple times */
 #define DOORBELL_AUDIO_PLAY_DELAY_MS    1000            /* Play audio file multiple times with delay */
 #define DOORBELL_AUDIO_GAIN             1.0f
+/* Doorbells of the multicast group start playing this time after the switch
+ * was pressed, 0: immediately. It shall be longer than delay of network and
+ * opening audio file. */
+#define DOORBELL_PLAY_AT_DELAY_MS       0
 #define DOORBELL_SWITCH_PIN             13              /* GPIO pin or -1 to disable switch input */
 #define ENABLE_DOORBELL_I2S_DAC         1
-#define DOORBELL_HISTORY_LENGTH         32             /* Last 32 button press will be stored and displayed on index page */
+/* Decoders which are linked, format of audio file is detected at start and upload.
+ * Only the generator of the detected format is constructed. */
+#define ENABLE_CODEC_WAV                1
+#ifndef ENABLE_CODEC_MP3
+#define ENABLE_CODEC_MP3                0
+#endif
+#ifndef ENABLE_CODEC_AAC
+#define ENABLE_CODEC_AAC                0
+#endif
+#ifndef ENABLE_CODEC_MOD
+#define ENABLE_CODEC_MOD                0
+#endif
+#ifndef ENABLE_CODEC_ULAW
+#define ENABLE_CODEC_ULAW               0
+#endif
+#ifndef ENABLE_CODEC_ADPCM
+#define ENABLE_CODEC_ADPCM              0
+#endif
+/* Uploaded PCM WAV files are converted to 16 bit mono (audio_transcode.txt) */
+#define ENABLE_AUDIO_TRANSCODE          1
+#define AUDIO_TRANSCODE_SAMPLE_RATE     0               /* Sample rate of converted files, 0: store files as uploaded */
+#define AUDIO_TRANSCODE_SILENCE_THRESHOLD 256           /* Leading samples below this are dropped, 0: keep silence */
+#define DOORBELL_HISTORY_LENGTH         1000           /* At least the last 1000 events will be stored, 0: disable history */
+#define DOORBELL_HISTORY_DISPLAY_LENGTH 32             /* Last 32 events will be displayed on index page */
+#define DOORBELL_AUDIO_CACHE_MAX_SIZE   8192           /* Audio file is loaded into RAM if it is not larger than this, 0: always play from file */
+#define DOORBELL_AUDIO_CACHE_HEAP_MARGIN 16384         /* Largest free heap block after loading audio cache, for WiFi, HTTP and decoder */
 #endif
 
 #if ENABLE_MQTT_CLIENT
 #define MQTT_SWITCHES_TOPIC_PREFIX      "/switches/"
 #endif
 
+#if ENABLE_RING_MULTICAST
+#define RING_MULTICAST_ADDRESS          239, 255, 68, 66    /* Arguments of IPAddress() */
+#define RING_MULTICAST_PORT             4366
+#endif
+#if ENABLE_MQTT_CLIENT || ENABLE_RING_MULTICAST
+/* Ring of another doorbell arriving through both multicast and MQTT is played once */
+#define DOORBELL_REMOTE_RING_HOLDOFF_MS 3000
+#endif
+
+#if ENABLE_MQTT_CLIENT
+/* Events are queued while broker is not available and published to
+ * "<topic>/offline" after reconnection */
+#define MQTT_QUEUE_SIZE                 16      /* Events kept in RAM */
+#define MQTT_QUEUE_SPILL_MAX_RECORDS    64      /* Events kept in file while disconnected, 0: no spill */
+#define MQTT_QUEUE_COALESCE_S           60      /* Events of a topic within this time are counted in one record */
+#define MQTT_QUEUE_FLUSH_BATCH          4       /* Max. publishes per call of queue task */
+#define MQTT_QUEUE_FLUSH_BUDGET_US      5000    /* Max. time of publishing per call of queue task */
+#endif
+
 #define ENABLE_TIMESTAMP_ON_SERIAL_TRACE    0
+/* 1: TRACE() stores format string address and arguments in RAM instead of
+ * printing, they are formatted at /trace_bin.txt or by tools/trace_decode.py
+ * from /trace_bin.bin. ERROR() is printed as before. */
+#define ENABLE_BINARY_TRACE                 0
 
 #define ENABLE_FILE_TRACE               1
 #if ENABLE_FILE_TRACE
@@ -73,8 +153,12 @@
 #define TRACE_PREV_FILE_NAME            "trace_prev.txt"
 #define TRACE_LINE_COUNT_TO_FLUSH       100                 /* flush file after every 100th line */
 #define TRACE_ELAPSED_TIME_TO_FLUSH_MS  5000                /* flush file after 5 seconds */
+#define TRACE_FILE_BUF_SIZE             1024                /* Output waiting for trace file */
 #define ENABLE_TRACE_MS_TIMESAMP        1
 #endif /* ENABLE_FILE_TRACE */
+#define TRACE_SERIAL_BUF_SIZE           1024                /* Output waiting for serial port */
+#define TRACE_ERROR_BUF_SIZE            512                 /* Output waiting for error file */
+#define TRACE_DRAIN_BUDGET_BYTES        256                 /* Bytes written to a file by one trace_task() call */
 /* Current error output is saved to this file too */
 #define ERROR_FILE_NAME                 "error.txt"
 /* Previous error output is renamed to this file */
@@ -0,0 +1,219 @@
+/**
+ * @file        config_store.cpp
+ * @brief       Configuration read from files
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 14:05:31
+ * Last modify: 2026-10-16 14:05:31 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * Every configuration file is read once at start-up, its lines are converted
+ * to the type given in CONFIG_ITEMS. Values are stored in an array indexed
+ * by configItem_t, so getting a value does not access the file system.
+ */
+
+#include <Arduino.h>
+
+#include "common.h"
+#include "config.h"
+#include "trace.h"
+#include "fileutils.h"
+#include "config_store.h"
+
+#include <FS.h>       // File System for Web Server Files
+#include <LittleFS.h> // This file system is used.
+
+#define CONFIG_FILE_NAME(id, fileName)                                  fileName,
+#define CONFIG_ITEM_DESC(id, name, file, line, type, defValue)          { name, file, line, type, defValue },
+
+typedef struct
+{
+    const char *name;           /* Name in /config.json */
+    uint8_t file;               /* CONFIG_FILE_... */
+    uint8_t line;               /* Line index in file */
+    uint8_t type;               /* CONFIG_TYPE_... */
+    const char *defaultValue;
+} configItemDesc_t;
+
+typedef struct
+{
+    String str;
+    union
+    {
+        int32_t i;
+        float f;
+    };
+    bool isSet;                 /* true: value was read from file */
+} configValue_t;
+
+static const char *configFileNames[CONFIG_FILE_COUNT] =
+{
+    CONFIG_FILES(CONFIG_FILE_NAME)
+};
+
+static const configItemDesc_t configItemDescs[CONFIG_ITEM_COUNT] =
+{
+    CONFIG_ITEMS(CONFIG_ITEM_DESC)
+};
+
+static configValue_t configValues[CONFIG_ITEM_COUNT];
+static uint32_t configFileOpenCntr = 0;
+
+static void config_set(configItem_t item, const String &str, bool isSet)
+{
+    configValue_t *value = &configValues[item];
+
+    value->str = str;
+    value->isSet = isSet;
+    switch (configItemDescs[item].type)
+    {
+        case CONFIG_TYPE_INT:
+            value->i = str.toInt();
+            break;
+        case CONFIG_TYPE_FLOAT:
+            value->f = str.toFloat();
+            break;
+        default:
+            break;
+    }
+}
+
+/*
+ * Read a configuration file and store values of its items.
+ */
+static void config_read_file(uint8_t fileIdx)
+{
+    uint8_t lastLine = 0;
+    uint8_t lineIdx;
+    uint8_t item;
+    String line;
+
+    for (item = 0; item < CONFIG_ITEM_COUNT; item++)
+    {
+        if (configItemDescs[item].file == fileIdx)
+        {
+            lastLine = MAX(lastLine, configItemDescs[item].line);
+        }
+    }
+
+    File file = LittleFS.open(configFileNames[fileIdx], "r");
+    if (!file)
+    {
+        TRACE("Failed to open file %s for reading\n", configFileNames[fileIdx]);
+        return;
+    }
+    configFileOpenCntr++;
+
+    for (lineIdx = 0; lineIdx <= lastLine && file.available(); lineIdx++)
+    {
+        line = file.readStringUntil('\n');
+        trimLine(line);
+        if (line.isEmpty())
+        {
+            continue;
+        }
+        for (item = 0; item < CONFIG_ITEM_COUNT; item++)
+        {
+            if (configItemDescs[item].file == fileIdx && configItemDescs[item].line == lineIdx)
+            {
+                TRACE("%s: '%s'\n", configItemDescs[item].name, line.c_str());
+                config_set(static_cast<configItem_t>(item), line, true);
+            }
+        }
+    }
+    file.close();
+}
+
+/*
+ * Load default values and read all configuration files.
+ */
+void config_store_init()
+{
+    uint8_t idx;
+
+    for (idx = 0; idx < CONFIG_ITEM_COUNT; idx++)
+    {
+        config_set(static_cast<configItem_t>(idx), configItemDescs[idx].defaultValue, false);
+    }
+    for (idx = 0; idx < CONFIG_FILE_COUNT; idx++)
+    {
+        config_read_file(idx);
+    }
+}
+
+/*
+ * @return true if value was read from file, false if default value is used.
+ */
+bool config_is_set(configItem_t item)
+{
+    return configValues[item].isSet;
+}
+
+const String &config_get_str(configItem_t item)
+{
+    return configValues[item].str;
+}
+
+int32_t config_get_int(configItem_t item)
+{
+    return configValues[item].i;
+}
+
+float config_get_float(configItem_t item)
+{
+    return configValues[item].f;
+}
+
+/*
+ * Set effective value of an item which is computed at run-time,
+ * for example hostname derived from MAC address.
+ */
+void config_set_str(configItem_t item, const String &value)
+{
+    config_set(item, value, configValues[item].isSet);
+}
+
+uint32_t config_store_file_open_cntr()
+{
+    return configFileOpenCntr;
+}
+
+/*
+ * It generates /config.json
+ */
+void config_generate_json(Print &out)
+{
+    uint8_t item;
+    const char *s;
+
+    out.print("{\n");
+    for (item = 0; item < CONFIG_ITEM_COUNT; item++)
+    {
+        out.print(item ? "  , \"" : "    \"");
+        out.print(configItemDescs[item].name);
+        out.print("\": ");
+        switch (configItemDescs[item].type)
+        {
+            case CONFIG_TYPE_INT:
+                out.print(configValues[item].i);
+                break;
+            case CONFIG_TYPE_FLOAT:
+                out.print(configValues[item].f);
+                break;
+            default:
+                out.print('"');
+                for (s = configValues[item].str.c_str(); *s; s++)
+                {
+                    if (*s == '"' || *s == '\\')
+                    {
+                        out.print('\\');
+                    }
+                    out.print(*s);
+                }
+                out.print('"');
+                break;
+        }
+        out.print("\n");
+    }
+    out.print("}");
+}
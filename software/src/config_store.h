@@ -0,0 +1,82 @@
+/**
+ * @file        config_store.h
+ * @brief       Definitions of config_store.cpp
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 14:05:31
+ * Last modify: 2026-10-16 14:05:31 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#ifndef INCLUDE_CONFIG_STORE_H
+#define INCLUDE_CONFIG_STORE_H
+
+#include <stdint.h>
+
+#include <Arduino.h>
+
+#include "common.h"
+#include "config.h"
+
+#define CONFIG_TYPE_STRING      0
+#define CONFIG_TYPE_INT         1
+#define CONFIG_TYPE_FLOAT       2
+
+/*
+ * Configuration files.
+ *     Identifier, file name
+ */
+#define CONFIG_FILES(X) \
+    X(CONFIG_FILE_HOSTNAME,         "/hostname.txt") \
+    X(CONFIG_FILE_MQTT_TOPIC,       "/mqtt_topic.txt") \
+    X(CONFIG_FILE_DOORBELL,         "/doorbell.txt") \
+    X(CONFIG_FILE_HOMEPAGE_REFRESH, "/homepage_refresh_interval.txt") \
+    X(CONFIG_FILE_HOMEPAGE_TEXTS,   "/homepage_texts.txt") \
+    X(CONFIG_FILE_RING_MULTICAST,   "/ring_multicast.txt") \
+    X(CONFIG_FILE_AUDIO_TRANSCODE,  "/audio_transcode.txt")
+
+/*
+ * Configuration items. Empty line or missing file means default value.
+ *     Identifier, JSON name, file, line index, type, default value
+ */
+#define CONFIG_ITEMS(X) \
+    X(CONFIG_HOSTNAME,                   "hostname",                   CONFIG_FILE_HOSTNAME,         0, CONFIG_TYPE_STRING, "") \
+    X(CONFIG_MQTT_TOPIC,                 "mqttTopic",                  CONFIG_FILE_MQTT_TOPIC,       0, CONFIG_TYPE_STRING, "") \
+    X(CONFIG_MQTT_SWITCHES_TOPIC_PREFIX, "mqttSwitchesTopicPrefix",    CONFIG_FILE_MQTT_TOPIC,       2, CONFIG_TYPE_STRING, "") \
+    X(CONFIG_DOORBELL_AUDIO_FILE_NAME,   "doorbellAudioFileName",      CONFIG_FILE_DOORBELL,         0, CONFIG_TYPE_STRING, DOORBELL_AUDIO_FILE_NAME) \
+    X(CONFIG_DOORBELL_AUDIO_PLAY_COUNT,  "doorbellAudioPlayCount",     CONFIG_FILE_DOORBELL,         1, CONFIG_TYPE_INT,    TOSTR(DOORBELL_AUDIO_PLAY_COUNT)) \
+    X(CONFIG_DOORBELL_AUDIO_PLAY_DELAY,  "doorbellAudioPlayDelay_ms",  CONFIG_FILE_DOORBELL,         2, CONFIG_TYPE_INT,    TOSTR(DOORBELL_AUDIO_PLAY_DELAY_MS)) \
+    X(CONFIG_DOORBELL_AUDIO_GAIN,        "doorbellAudioGain",          CONFIG_FILE_DOORBELL,         3, CONFIG_TYPE_FLOAT,  TOSTR(DOORBELL_AUDIO_GAIN)) \
+    X(CONFIG_DOORBELL_PLAY_AT_DELAY,     "doorbellPlayAtDelay_ms",     CONFIG_FILE_DOORBELL,         4, CONFIG_TYPE_INT,    TOSTR(DOORBELL_PLAY_AT_DELAY_MS)) \
+    X(CONFIG_HOMEPAGE_REFRESH_INTERVAL,  "homepageRefreshInterval_sec", CONFIG_FILE_HOMEPAGE_REFRESH, 0, CONFIG_TYPE_INT,   TOSTR(DEFAULT_HOMEPAGE_REFRESH_INTERVAL_SEC)) \
+    X(CONFIG_HOMEPAGE_TITLE,             "homepageTitle",              CONFIG_FILE_HOMEPAGE_TEXTS,   0, CONFIG_TYPE_STRING, TITLE_STR) \
+    X(CONFIG_RING_MULTICAST_GROUP,       "ringMulticastGroup",         CONFIG_FILE_RING_MULTICAST,   0, CONFIG_TYPE_INT,    "0") \
+    X(CONFIG_RING_MULTICAST_FOLLOW,      "ringMulticastFollow",        CONFIG_FILE_RING_MULTICAST,   1, CONFIG_TYPE_INT,    "1") \
+    X(CONFIG_AUDIO_TRANSCODE_SAMPLE_RATE, "audioTranscodeSampleRate",  CONFIG_FILE_AUDIO_TRANSCODE,  0, CONFIG_TYPE_INT,    TOSTR(AUDIO_TRANSCODE_SAMPLE_RATE)) \
+    X(CONFIG_AUDIO_TRANSCODE_SILENCE_THRESHOLD, "audioTranscodeSilenceThreshold", CONFIG_FILE_AUDIO_TRANSCODE, 1, CONFIG_TYPE_INT, TOSTR(AUDIO_TRANSCODE_SILENCE_THRESHOLD))
+
+#define CONFIG_FILE_ENUM(id, fileName)                          id,
+#define CONFIG_ITEM_ENUM(id, name, file, line, type, defValue)  id,
+
+typedef enum
+{
+    CONFIG_FILES(CONFIG_FILE_ENUM)
+    CONFIG_FILE_COUNT
+} configFile_t;
+
+typedef enum
+{
+    CONFIG_ITEMS(CONFIG_ITEM_ENUM)
+    CONFIG_ITEM_COUNT
+} configItem_t;
+
+extern void config_store_init();
+extern bool config_is_set(configItem_t item);
+extern const String &config_get_str(configItem_t item);
+extern int32_t config_get_int(configItem_t item);
+extern float config_get_float(configItem_t item);
+extern void config_set_str(configItem_t item, const String &value);
+extern uint32_t config_store_file_open_cntr();
+extern void config_generate_json(Print &out);
+
+#endif /* INCLUDE_CONFIG_STORE_H */
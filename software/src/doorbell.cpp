@@ -10,12 +10,10 @@
 
 #include <Arduino.h>
 
-#include "AudioGeneratorWAV.h"
-#include "AudioGeneratorAAC.h"
-#include "AudioGeneratorMP3.h"
-#include "AudioGeneratorMOD.h"
+#include "AudioGenerator.h"
 #include "AudioOutputI2SNoDAC.h"
 #include "AudioFileSourceLittleFS.h"
+#include "AudioFileSourcePROGMEM.h"
 
 #include "main.h"
 #include "common.h"
@@ -23,76 +21,285 @@
 #include "doorbell.h"
 #include "http_server.h"
 #include "fileutils.h"
+#include "audio_source.h"
+#include "doorbell_history.h"
+#include "profile.h"
+#include "config_store.h"
+#include "http_events.h"
+#include "mqtt_topics.h"
+#include "mqtt_queue.h"
+#include "ring_multicast.h"
+#include "audio_codec.h"
+#include "scheduler.h"
 
-#define WAV                             1
-#define AAC                             2
-#define MP3                             3
-#define MOD                             4
-
-#define EVENT_DOORBELL                  0
-#define EVENT_COURTYARD_LAMP            1
-#define EVENT_DOORBELL_WEB              2
-#define EVENT_DOORBELL_MQTT             3
-
-#define DOORBELL_FILE_TYPE                  WAV
 #define DOORBELL_SOFTWARE_DEBOUNCE_TIME_MS  100
 #define DOORBELL_LONG_PRESS_TIME_MS         5000
+#define DOORBELL_SWITCH_EDGE_BUF_SIZE       16      /* Must be power of 2 */
 #define DOORBELL_MQTT_FOLLOW_TOPIC_FILENAME "doorbell_mqtt_follow.txt"
-#define DOORBELL_CONFIG_FILENAME            "doorbell.txt"
 #define DOORBELL_MAX_MQTT_FOLLOW_TOPICS     8
-#define DOORBELL_HISTORY_FILENAME           "doorbell_history.txt"
+
+#ifndef DOORBELL_AUDIO_CACHE_MAX_SIZE
+#define DOORBELL_AUDIO_CACHE_MAX_SIZE       0
+#endif
+#ifndef DOORBELL_AUDIO_CACHE_HEAP_MARGIN
+#define DOORBELL_AUDIO_CACHE_HEAP_MARGIN    16384
+#endif
 
 #if ENABLE_DOORBELL
-static AudioFileSourceLittleFS *in = NULL;
-static AudioGenerator *audio_gen = NULL;
+/* Audio sources and generator are allocated only once and they are re-opened
+ * on every play to avoid heap fragmentation */
+static AudioFileSourceLittleFS audioFileSource;
+#if DOORBELL_AUDIO_CACHE_MAX_SIZE > 0
+static AudioFileSourcePROGMEM audioMemorySource;
+#endif
+/* Used when the codec of audio file is unknown or not enabled, it does not play */
+static AudioGenerator noAudioGenerator;
+static AudioFileSource *in = &audioFileSource;
+/* Generator reads through this, so replay does not re-open the file */
+static AudioFileSourceRewind audioSource;
+static AudioGenerator *audio_gen = &noAudioGenerator;
+static audioCodec_t audioCodec = AUDIO_CODEC_UNKNOWN;   /* Detected when audio file is loaded */
 static AudioOutputI2S *out;
+static uint32_t audioPlayCntr = 0;          /* Number of plays since boot */
+static uint32_t minMaxFreeBlockSize = UINT32_MAX; /* Smallest largest free heap block seen at play */
+static uint32_t audioFileOpenCntr = 0;      /* Number of audio file opens since boot */
 static uint8_t replay_cntr = 0;
-static uint32_t replay_timestamp_ms = 0;
-static uint32_t switch_press_timestamp_ms = 0;
+static bool replay_pending = false;
+static uint32_t replay_timestamp_us = 0;
+static bool audioLoopActive = false;        /* true: audio is playing, audioLoopTimestamp_us is valid */
+static uint32_t audioLoopTimestamp_us = 0;  /* Last call of audio_gen->loop() */
+static uint32_t maxAudioLoopGap_us = 0;     /* Longest time between two audio_gen->loop() calls */
+static bool playAtPending = false;          /* Decoder is ready, first samples are sent at playAt_us */
+static uint32_t playAt_us = 0;
+static uint32_t playAtCntr = 0;             /* Plays started at deadline */
+static int32_t playAtLastSkew_us = 0;       /* Start of last play minus deadline */
+static int32_t playAtMaxSkew_us = 0;
+#if DOORBELL_SWITCH_PIN != -1
+typedef struct
+{
+    uint32_t timestamp_us;
+    uint8_t level;
+} switchEdge_t;
+/* Single producer (interrupt), single consumer (doorbell_switch_task) buffer */
+static volatile switchEdge_t switchEdges[DOORBELL_SWITCH_EDGE_BUF_SIZE];
+static volatile uint8_t switchEdgeHead = 0;     /* Written by interrupt only */
+static volatile uint8_t switchEdgeTail = 0;     /* Written by task only */
+static volatile uint32_t switchEdgeDropCntr = 0;
+static uint32_t switchEdgeCntr = 0;
+static bool switch_pressed = false;
+static uint32_t switch_press_timestamp_us = 0;
+#endif
 static String audioFileName = DOORBELL_AUDIO_FILE_NAME;
 static uint8_t audioPlayCount = DOORBELL_AUDIO_PLAY_COUNT;
 static uint32_t audioPlayDelay_ms = DOORBELL_AUDIO_PLAY_DELAY_MS;
+static uint32_t playAtDelay_ms = DOORBELL_PLAY_AT_DELAY_MS;
 static float audioGain = DOORBELL_AUDIO_GAIN;
-#if DOORBELL_HISTORY_LENGTH > 0
-static String doorbell_history[DOORBELL_HISTORY_LENGTH];
+#if DOORBELL_AUDIO_CACHE_MAX_SIZE > 0
+static uint8_t *audioCache = NULL;          /* Content of audio file if it fits, NULL: play from file */
+static uint32_t audioCacheSize = 0;
+static uint32_t audioCacheLoadTime_ms = 0;
+static uint32_t audioCacheHitCntr = 0;      /* Number of plays from audio cache */
+static uint32_t audioCacheMissCntr = 0;     /* Number of plays from file system */
 #endif
 #if ENABLE_MQTT_CLIENT
 static String mqttTopicPlayAudio;
 static String mqttTopicPress;
 static String mqttTopicLongPress;
+static uint8_t mqttTopicPlayAudioId = MQTT_QUEUE_TOPIC_NONE;
+static uint8_t mqttTopicPressId = MQTT_QUEUE_TOPIC_NONE;
+static uint8_t mqttTopicLongPressId = MQTT_QUEUE_TOPIC_NONE;
 static const char *mqttMsg = "1";
 
 typedef struct
 {
-    String topic;
+    String topic;   /* Topic filter, '+' and '#' wildcards are accepted */
     String value;
 } followedMqttTopics_t;
 static followedMqttTopics_t followedMqttTopics[DOORBELL_MAX_MQTT_FOLLOW_TOPICS];
+static mqttTopicTrie_t followedMqttTopicTrie;   /* Filters of followedMqttTopics */
 static bool subscribedToMqttTopics = false;
+static uint32_t mqttMessageCntr = 0;
+static uint32_t mqttFollowMatchCntr = 0;
 #endif /* ENABLE_MQTT_CLIENT */
+#if ENABLE_MQTT_CLIENT || ENABLE_RING_MULTICAST
+static uint32_t remoteRingCntr = 0;         /* Rings for events of other doorbells */
+static uint32_t remoteRingDupCntr = 0;      /* Same event through the other path */
+static uint32_t remoteRingTimestamp_ms = 0;
+#endif
 #endif /* ENABLE_DOORBELL */
 
 #if ENABLE_DOORBELL
-static void prepare_audio()
+#if DOORBELL_AUDIO_CACHE_MAX_SIZE > 0
+/*
+ * Load the whole audio file into RAM if it is small enough. Playing from RAM
+ * does not need to open and read the file when the bell is rang. The file
+ * is not loaded if the largest free heap block would be less than
+ * DOORBELL_AUDIO_CACHE_HEAP_MARGIN after it.
+ */
+static void audio_cache_load()
 {
-    delete in;
-    delete audio_gen;
-
-#if DOORBELL_FILE_TYPE == WAV
-    in = new AudioFileSourceLittleFS(audioFileName.c_str());
-    audio_gen = new AudioGeneratorWAV();
-#elif DOORBELL_FILE_TYPE == AAC
-    in = new AudioFileSourceLittleFS(audioFileName.c_str());
-    audio_gen = new AudioGeneratorAAC();
-#elif DOORBELL_FILE_TYPE == MP3
-    in = new AudioFileSourceLittleFS(audioFileName.c_str());
-    audio_gen = new AudioGeneratorMP3();
-#elif DOORBELL_FILE_TYPE == MOD
-    in = new AudioFileSourceLittleFS(audioFileName.c_str());
-    audio_gen = new AudioGeneratorMOD();
-#else
-#error Unsupported file type!
+    uint32_t startTime_ms = millis();
+    uint32_t size;
+
+    free(audioCache);
+    audioCache = NULL;
+    audioCacheSize = 0;
+
+    File file = LittleFS.open(audioFileName, "r");
+    if (file)
+    {
+        size = file.size();
+        if (!size || size > DOORBELL_AUDIO_CACHE_MAX_SIZE)
+        {
+            TRACE("Audio file %s is not cached (%i bytes), it will be played from file system\n",
+                  audioFileName.c_str(), size);
+        }
+        else if (ESP.getMaxFreeBlockSize() < size + DOORBELL_AUDIO_CACHE_HEAP_MARGIN)
+        {
+            TRACE("Audio file %s is not cached (%i bytes), largest free heap block is %i bytes\n",
+                  audioFileName.c_str(), size, ESP.getMaxFreeBlockSize());
+        }
+        else
+        {
+            audioCache = reinterpret_cast<uint8_t *>(malloc(size));
+            if (audioCache)
+            {
+                if (file.read(audioCache, size) == size)
+                {
+                    audioCacheSize = size;
+                }
+                else
+                {
+                    ERROR("Cannot read %s into audio cache!\n", audioFileName.c_str());
+                    free(audioCache);
+                    audioCache = NULL;
+                }
+            }
+            else
+            {
+                ERROR("Cannot allocate %i bytes for audio cache!\n", size);
+            }
+        }
+        file.close();
+    }
+    else
+    {
+        ERROR("Cannot open audio file %s!\n", audioFileName.c_str());
+    }
+    audioCacheLoadTime_ms = millis() - startTime_ms;
+    if (audioCache)
+    {
+        TRACE("Audio file %s (%i bytes) cached in %i ms\n", audioFileName.c_str(),
+              audioCacheSize, audioCacheLoadTime_ms);
+    }
+}
+#endif
+
+/*
+ * Open audio source to play audio file from the beginning.
+ *
+ * @return true if audio source is ready to play.
+ */
+static bool prepare_audio()
+{
+    bool ok = false;
+
+    if (audio_gen->isRunning())
+    {
+        audio_gen->stop();
+        audio_codec_stats_stop();
+    }
+    if (audioCodec == AUDIO_CODEC_UNKNOWN)
+    {
+        return false;
+    }
+
+#if DOORBELL_AUDIO_CACHE_MAX_SIZE > 0
+    if (audioCache)
+    {
+        ok = audioMemorySource.open(audioCache, audioCacheSize);
+        in = &audioMemorySource;
+        audioCacheHitCntr++;
+    }
+    else
+#endif
+    {
+        if (audioFileSource.isOpen())
+        {
+            audioFileSource.close();
+        }
+        ok = audioFileSource.open(audioFileName.c_str());
+        audioFileOpenCntr++;
+        in = &audioFileSource;
+#if DOORBELL_AUDIO_CACHE_MAX_SIZE > 0
+        audioCacheMissCntr++;
 #endif
+    }
+    if (ok)
+    {
+        ok = audioSource.attach(in, audio_codec_is_wav(audioCodec));
+    }
+
+    return ok;
+}
+
+/*
+ * Select generator by the format of audio file. It is called when the file
+ * is loaded, so nothing is detected when the bell rings.
+ */
+static void audio_codec_select()
+{
+    AudioGenerator *generator;
+
+#if DOORBELL_AUDIO_CACHE_MAX_SIZE > 0
+    if (audioCache)
+    {
+        audioCodec = audio_codec_sniff_buffer(audioCache, audioCacheSize);
+    }
+    else
+#endif
+    {
+        audioCodec = audio_codec_sniff_file(audioFileName);
+    }
+    generator = audio_codec_generator(audioCodec);
+    if (!generator)
+    {
+        ERROR("Format of %s is not supported!\n", audioFileName.c_str());
+        audioCodec = AUDIO_CODEC_UNKNOWN;
+        generator = &noAudioGenerator;
+    }
+    audio_gen = generator;
+}
+
+/*
+ * Start generator on audio source, cost of codec is measured.
+ */
+static bool audio_begin()
+{
+    uint32_t freeHeap = ESP.getFreeHeap();
+    uint32_t start_us = micros();
+    bool ok;
+
+    ok = audio_gen->begin(&audioSource, out);
+    if (ok)
+    {
+        audio_codec_stats_start(audioCodec, micros() - start_us, freeHeap);
+    }
+
+    return ok;
+}
+
+/*
+ * Send samples to output.
+ */
+static void audio_loop()
+{
+    uint32_t start_us = micros();
+
+    audio_gen->loop();
+    audioLoopTimestamp_us = micros();
+    audioLoopActive = true;
+    audio_codec_stats_loop(audioLoopTimestamp_us - start_us);
 }
 
 bool doorbell_is_playing()
@@ -103,7 +310,7 @@ bool doorbell_is_playing()
     {
         is_playing = true;
     }
-    else if (replay_timestamp_ms)
+    else if (replay_pending)
     {
         is_playing = true;
     }
@@ -126,6 +333,12 @@ bool doorbell_mqtt_init()
     lineCnt = readStringsFromFile(DOORBELL_MQTT_FOLLOW_TOPIC_FILENAME, 0,
                                   lines, DOORBELL_MAX_MQTT_FOLLOW_TOPICS);
     TRACE("Number of lines in file: %i\n", lineCnt);
+    mqtt_topic_trie_init(&followedMqttTopicTrie);
+    for (int i = 0; i < DOORBELL_MAX_MQTT_FOLLOW_TOPICS; i++)
+    {
+        followedMqttTopics[i].topic.clear();
+        followedMqttTopics[i].value.clear();
+    }
     for (int i = 0; i < lineCnt && i < DOORBELL_MAX_MQTT_FOLLOW_TOPICS; i++)
     {
         /* Two line formats accepted: with comma or without comma */
@@ -150,6 +363,11 @@ bool doorbell_mqtt_init()
         mqttTopic = followedMqttTopics[i].topic;
         if (mqttTopic.length())
         {
+            if (!mqtt_topic_trie_add(&followedMqttTopicTrie, followedMqttTopics[i].topic.c_str(), i))
+            {
+                ret = false;
+                continue;
+            }
             TRACE("Following topic '%s'... ", mqttTopic.c_str());
             if (mqttClient.subscribe(mqttTopic.c_str()))
             {
@@ -171,83 +389,182 @@ bool doorbell_mqtt_init()
     return ret;
 }
 
-#if DOORBELL_HISTORY_LENGTH > 0
-static String doorbell_get_timestamp()
+void doorbell_update_history(uint8_t eventType)
 {
-    String timestamp;
-    char buffer[32];
-    time_t rawtime;
-    struct tm *timeinfo;
+    const char *eventName = (eventType == EVENT_COURTYARD_LAMP) ? "longPress" : "ring";
+
+#if DOORBELL_HISTORY_LENGTH > 0
+    doorbell_history_add(eventType);
+    http_events_send(eventName, doorbell_history_record_to_str(*doorbell_history_get(0)));
+#else
+    http_events_send(eventName, String(eventType));
+#endif
+}
 
-    time(&rawtime);
-    timeinfo = localtime(&rawtime);
+/*
+ * Play audio and store the event.
+ *
+ * @param[in] eventType     EVENT_DOORBELL...
+ * @param[in] delay_us      Audio starts after this time, 0: immediately.
+ */
+static void doorbell_ring(uint8_t eventType, uint32_t delay_us=0)
+{
+    profile_begin(PROFILE_RING);
+    doorbell_play(delay_us);
+    doorbell_update_history(eventType);
+    profile_end(PROFILE_RING);
+}
 
-    strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", timeinfo);
-    timestamp = buffer;
+#if ENABLE_MQTT_CLIENT || ENABLE_RING_MULTICAST
+/*
+ * Ring for an event of another doorbell. The same event can arrive by
+ * multicast and by MQTT, the later one is dropped.
+ *
+ * @param[in] eventType     EVENT_DOORBELL_MQTT or EVENT_DOORBELL_LAN.
+ * @param[in] delay_us      Audio starts after this time, 0: immediately.
+ */
+static void doorbell_remote_ring(uint8_t eventType, uint32_t delay_us=0)
+{
+    uint32_t now = millis();
 
-    return timestamp;
+    if (remoteRingCntr && now - remoteRingTimestamp_ms < DOORBELL_REMOTE_RING_HOLDOFF_MS)
+    {
+        TRACE("Remote ring dropped, event %i\n", eventType);
+        remoteRingDupCntr++;
+        return;
+    }
+    remoteRingCntr++;
+    remoteRingTimestamp_ms = now;
+    doorbell_ring(eventType, delay_us);
 }
 #endif
 
+#if DOORBELL_SWITCH_PIN != -1
+/*
+ * Interrupt handler of doorbell switch. It stores time stamp and level of
+ * every edge, they are processed by doorbell_switch_task().
+ */
+static void IRAM_ATTR doorbell_switch_isr()
+{
+    uint8_t head = switchEdgeHead;
+    uint8_t next = (head + 1u) & (DOORBELL_SWITCH_EDGE_BUF_SIZE - 1u);
 
-void doorbell_update_history(uint8_t eventType)
+    if (next != switchEdgeTail)
+    {
+        switchEdges[head].timestamp_us = micros();
+        switchEdges[head].level = digitalRead(DOORBELL_SWITCH_PIN);
+        switchEdgeHead = next;
+    }
+    else
+    {
+        /* Buffer is full, edge is lost */
+        switchEdgeDropCntr++;
+    }
+}
+
+/*
+ * Someone pressed the button, ring the bell!
+ */
+static void doorbell_switch_pressed()
 {
-#if DOORBELL_HISTORY_LENGTH > 0
-    uint16_t lineNum = 0;
-    size_t writtenBytes = 0;
+    uint32_t delay_us = 0;
+
+#if ENABLE_RING_MULTICAST
+    /* Followers get the deadline, all doorbells of the group start together */
+    if (ring_multicast_send(EVENT_DOORBELL, playAtDelay_ms))
+    {
+        delay_us = playAtDelay_ms * 1000u;
+    }
+#endif
+    if (!doorbell_is_playing())
+    {
+        doorbell_ring(EVENT_DOORBELL, delay_us);
+    }
+#if ENABLE_MQTT_CLIENT
+    /* After the first samples, publish or queue does not delay the ring */
+    mqtt_queue_publish(mqttTopicPressId, mqttMsg);
+#endif
+}
+
+/*
+ * The button was pressed for long time
+ */
+static void doorbell_switch_long_pressed()
+{
+#if ENABLE_MQTT_CLIENT
+    mqtt_queue_publish(mqttTopicLongPressId, mqttMsg);
+#endif
+    doorbell_update_history(EVENT_COURTYARD_LAMP);
+}
 
-    lineNum = readStringsFromFile(DOORBELL_HISTORY_FILENAME, 0, doorbell_history, DOORBELL_HISTORY_LENGTH, false);
+/*
+ * Process edges captured by doorbell_switch_isr(). Debouncing and long press
+ * detection use the time stamps of the interrupt, so they do not depend on
+ * how often this function is called.
+ */
+static void doorbell_switch_task()
+{
+    static int switchStatus = HIGH; /* GPIO pin is pulled high, inverted logic! */
+    static uint32_t dropCntr = 0;
+    uint8_t tail = switchEdgeTail;
+    uint32_t timestamp_us;
+    int level;
 
-    File file = LittleFS.open(DOORBELL_HISTORY_FILENAME, "w");
-    if (file)
+    while (tail != switchEdgeHead)
     {
-        writtenBytes = file.print(doorbell_get_timestamp().c_str());
-        if (eventType == EVENT_COURTYARD_LAMP)
-        {
-            writtenBytes += file.print(" courtyard lamp");
-        }
-        else if (eventType == EVENT_DOORBELL)
-        {
-            writtenBytes += file.print(" doorbell switch");
-        }
-        else if (eventType == EVENT_DOORBELL_WEB)
+        timestamp_us = switchEdges[tail].timestamp_us;
+        level = switchEdges[tail].level;
+        tail = (tail + 1u) & (DOORBELL_SWITCH_EDGE_BUF_SIZE - 1u);
+        switchEdgeTail = tail;
+        switchEdgeCntr++;
+
+        if (level == switchStatus)
         {
-            writtenBytes += file.print(" doorbell through web");
+            /* Bouncing, level has changed back before it was read */
+            continue;
         }
-        else if (eventType == EVENT_DOORBELL_MQTT)
+        switchStatus = level;
+        if (switchStatus == LOW) /* inverted logic */
         {
-            writtenBytes += file.print(" doorbell through MQTT");
+            /* The switch has just pressed */
+            if (!switch_pressed)
+            {
+                switch_pressed = true;
+                switch_press_timestamp_us = timestamp_us;
+            }
         }
         else
         {
-            writtenBytes += file.print(" unknown event!");
-        }
-        file.print("\n");
-
-        if (writtenBytes < 28)
-        {
-            ERROR("Cannot write data to %s!\n", DOORBELL_HISTORY_FILENAME);
-        }
-
-        for (uint16_t idx = 0; idx < lineNum; idx++)
-        {
-            writtenBytes = file.print(doorbell_history[idx]);
-            writtenBytes += file.print("\n");
-            if (writtenBytes < doorbell_history[idx].length() + 1)
+            /* The switch has just released */
+            if (switch_pressed
+                && timestamp_us - switch_press_timestamp_us > DOORBELL_SOFTWARE_DEBOUNCE_TIME_MS * 1000u)
             {
-                ERROR("Cannot write data to %s!\n", DOORBELL_HISTORY_FILENAME);
-                break;
+                doorbell_switch_pressed();
             }
+            switch_pressed = false;
         }
+    }
 
-        file.close();
+    if (dropCntr != switchEdgeDropCntr)
+    {
+        /* Some edges were lost, continue with current level of switch */
+        ERROR("%i switch edges lost!\n", switchEdgeDropCntr - dropCntr);
+        dropCntr = switchEdgeDropCntr;
+        switchStatus = digitalRead(DOORBELL_SWITCH_PIN);
+        if (switchStatus == HIGH)
+        {
+            switch_pressed = false;
+        }
     }
-    else
+
+    if (switch_pressed
+        && micros() - switch_press_timestamp_us > DOORBELL_LONG_PRESS_TIME_MS * 1000u)
     {
-        ERROR("Cannot create %s!\n", DOORBELL_HISTORY_FILENAME);
+        switch_pressed = false;
+        doorbell_switch_long_pressed();
     }
-#endif
 }
+#endif
 
 /*
  * It should be called in the loop function.
@@ -264,97 +581,73 @@ void doorbell_task(uint8_t mqtt_flags)
         subscribedToMqttTopics = false;
     }
 #endif
-#if DOORBELL_SWITCH_PIN != -1
-    static int prevSwitchStatus = HIGH; /* GPIO pin is pulled high, inverted logic! */
-    int switchStatus = digitalRead(DOORBELL_SWITCH_PIN);
-    //setLed(switchStatus == LOW); /* inverted logic */
-    int risingEdge = (prevSwitchStatus ^ switchStatus) & switchStatus;
-    int fallingEdge = (prevSwitchStatus ^ switchStatus) & prevSwitchStatus;
-    if (fallingEdge) /* inverted logic */
-    {
-        /* The switch has just pressed */
-        if (!switch_press_timestamp_ms)
-        {
-            switch_press_timestamp_ms = millis();
-        }
-    }
-    if (risingEdge) /* inverted logic */
+}
+
+/*
+ * Timed task of doorbell_play(): deadline has come, first samples are sent.
+ */
+static void doorbell_play_at_task()
+{
+    if (!playAtPending)
     {
-        /* The switch has just released */
-        if (switch_press_timestamp_ms
-            && switch_press_timestamp_ms + DOORBELL_SOFTWARE_DEBOUNCE_TIME_MS < millis())
-        {
-            /* Someone pressed the button, ring the bell! */
-#if ENABLE_MQTT_CLIENT
-            boolean ok;
+        return;
+    }
+    playAtPending = false;
+    playAtLastSkew_us = static_cast<int32_t>(micros() - playAt_us);
+    playAtMaxSkew_us = MAX(playAtMaxSkew_us, playAtLastSkew_us);
+    audio_loop();
+}
 
-            if (mqttClient.connected())
-            {
-                ok = mqttClient.publish(mqttTopicPress.c_str(), mqttMsg);
-                if (ok)
-                {
-                    TRACE("Publish %s, %s\n", mqttTopicPress.c_str(), mqttMsg);
-                }
-                else
-                {
-                    ERROR("Cannot publish %s, %s\n", mqttTopicPress.c_str(), mqttMsg);
-                }
-            }
+/*
+ * Handle switch and send audio samples. It is a high priority task, it runs
+ * between every other task.
+ */
+void doorbell_audio_task()
+{
+    static bool wasPlaying = false;
+    uint32_t now_us;
+    bool playing;
+
+#if DOORBELL_SWITCH_PIN != -1
+    doorbell_switch_task();
 #endif
-            if (!doorbell_is_playing())
-            {
-                doorbell_play();
-                doorbell_update_history(EVENT_DOORBELL);
-            }
-        }
-        switch_press_timestamp_ms = 0;
+
+    if (playAtPending)
+    {
+        /* Decoder is ready, doorbell_play_at_task() starts it */
     }
-    if (switch_press_timestamp_ms && switch_press_timestamp_ms + DOORBELL_LONG_PRESS_TIME_MS < millis())
+    else if (audio_gen->isRunning())
     {
-        /* The button was pressed for long time */
-#if ENABLE_MQTT_CLIENT
-        boolean ok;
-
-        if (mqttClient.connected())
+        now_us = micros();
+        if (audioLoopActive)
         {
-            ok = mqttClient.publish(mqttTopicLongPress.c_str(), mqttMsg);
-            if (ok)
-            {
-                TRACE("Publish %s, %s\n", mqttTopicLongPress.c_str(), mqttMsg);
-            }
-            else
-            {
-                ERROR("Cannot publish %s, %s\n", mqttTopicLongPress.c_str(), mqttMsg);
-            }
+            maxAudioLoopGap_us = MAX(maxAudioLoopGap_us, now_us - audioLoopTimestamp_us);
         }
-#endif
-        switch_press_timestamp_ms = 0;
-        doorbell_update_history(EVENT_COURTYARD_LAMP);
-    }
-    prevSwitchStatus = switchStatus;
-#endif
-
-    if (audio_gen->isRunning())
-    {
-        audio_gen->loop();
+        audio_loop();
     }
     else
     {
-        if (replay_timestamp_ms)
+        if (audioLoopActive)
+        {
+            /* Generator has just finished */
+            audio_codec_stats_stop();
+        }
+        audioLoopActive = false;
+        if (replay_pending)
         {
-            if (replay_timestamp_ms < millis())
+            if (static_cast<int32_t>(micros() - replay_timestamp_us) >= 0)
             {
-                TRACE("Re-playing audio... ");
-                prepare_audio();
-                if (audio_gen->begin(in, out))
+                /* Audio file is still open, start again from the beginning */
+                audioSource.rewind();
+                if (audio_begin())
                 {
-                    TRACE("Done.\n");
+                    TRACE("Re-playing audio\n");
                 }
                 else
                 {
                     ERROR("Cannot replay audio!\n");
                 }
-                replay_timestamp_ms = 0;
+                replay_pending = false;
             }
         }
         else if (replay_cntr)
@@ -373,44 +666,45 @@ void doorbell_task(uint8_t mqtt_flags)
             if (replay_cntr)
             {
                 TRACE("Re-playing audio in %i ms...\n", audioPlayDelay_ms);
-                replay_timestamp_ms = millis() + audioPlayDelay_ms;
+                replay_timestamp_us = micros() + audioPlayDelay_ms * 1000u;
+                replay_pending = true;
             }
             else
             {
                 TRACE("No more audio playing...\n");
-                replay_timestamp_ms = 0;
+                replay_pending = false;
+                audioSource.release();
             }
         }
     }
+
+    playing = doorbell_is_playing();
+    if (playing != wasPlaying)
+    {
+        wasPlaying = playing;
+        http_events_send("playing", playing ? "1" : "0");
+    }
 }
 
 void doorbell_init()
 {
 #if DOORBELL_SWITCH_PIN != -1
     pinMode(DOORBELL_SWITCH_PIN, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(DOORBELL_SWITCH_PIN), doorbell_switch_isr, CHANGE);
 #endif
     audioLogger = &Serial;
-    audioFileName = readStringFromFile(DOORBELL_CONFIG_FILENAME, 0);
-    String str = readStringFromFile(DOORBELL_CONFIG_FILENAME, 1);
-    if (str.isEmpty())
-    {
-        audioFileName = DOORBELL_AUDIO_FILE_NAME;
-    }
-    else
-    {
-        audioPlayCount = str.toInt();
-    }
-    str = readStringFromFile(DOORBELL_CONFIG_FILENAME, 2);
-    if (!str.isEmpty())
-    {
-        audioPlayDelay_ms = str.toInt();
-    }
-    str = readStringFromFile(DOORBELL_CONFIG_FILENAME, 3);
-    if (!str.isEmpty())
-    {
-        audioGain = str.toFloat();
-    }
-    prepare_audio();
+    audioFileName = config_get_str(CONFIG_DOORBELL_AUDIO_FILE_NAME);
+    audioPlayCount = config_get_int(CONFIG_DOORBELL_AUDIO_PLAY_COUNT);
+    audioPlayDelay_ms = config_get_int(CONFIG_DOORBELL_AUDIO_PLAY_DELAY);
+    audioGain = config_get_float(CONFIG_DOORBELL_AUDIO_GAIN);
+    playAtDelay_ms = config_get_int(CONFIG_DOORBELL_PLAY_AT_DELAY);
+#if DOORBELL_AUDIO_CACHE_MAX_SIZE > 0
+    audio_cache_load();
+#endif
+    audio_codec_select();
+#if DOORBELL_HISTORY_LENGTH > 0
+    doorbell_history_init();
+#endif
 #if ENABLE_DOORBELL_I2S_DAC
     out = new AudioOutputI2S();
 #else
@@ -421,24 +715,83 @@ void doorbell_init()
     mqttTopicPlayAudio = mqttSwitchesTopicPrefix + "playAudio";
     mqttTopicPress = mqttSwitchesTopicPrefix + "press";
     mqttTopicLongPress = mqttSwitchesTopicPrefix + "longPress";
+    mqttTopicPressId = mqtt_queue_add_topic(&mqttTopicPress);
+    mqttTopicLongPressId = mqtt_queue_add_topic(&mqttTopicLongPress);
+    mqttTopicPlayAudioId = mqtt_queue_add_topic(&mqttTopicPlayAudio);
 #endif
 }
 
-void doorbell_play()
+/*
+ * A file was uploaded or deleted. If it is the audio file, playing is
+ * stopped, the file is cached and its format is detected again.
+ *
+ * @param[in] fileName  Example: "/doorbell.wav"
+ */
+void doorbell_audio_file_changed(const String &fileName)
 {
-#if ENABLE_MQTT_CLIENT
-    boolean ok;
+    const char *changedName = fileName.c_str();
+    const char *audioName = audioFileName.c_str();
+
+    /* Audio file name may be configured without leading '/' */
+    changedName += (*changedName == '/');
+    audioName += (*audioName == '/');
+    if (strcmp(changedName, audioName))
+    {
+        return;
+    }
 
+    TRACE("Audio file %s changed\n", fileName.c_str());
+    if (audio_gen->isRunning())
+    {
+        audio_gen->stop();
+        audio_codec_stats_stop();
+    }
+    audioLoopActive = false;
+    playAtPending = false;
+    scheduler_cancel_timed(doorbell_play_at_task);
+    replay_pending = false;
+    replay_cntr = 0;
+    audioSource.release();
+    if (audioFileSource.isOpen())
+    {
+        audioFileSource.close();
+    }
+#if DOORBELL_AUDIO_CACHE_MAX_SIZE > 0
+    audio_cache_load();
 #endif
+    audio_codec_select();
+}
 
+/*
+ * Start playing audio file.
+ *
+ * @param[in] delay_us  0: first samples are sent immediately. Otherwise
+ *                      the file is opened and decoder is started now, the
+ *                      first samples are sent after delay_us.
+ */
+void doorbell_play(uint32_t delay_us)
+{
     if (!doorbell_is_playing())
     {
         TRACE("Start playing audio... ");
-        prepare_audio();
-        if (audio_gen->begin(in, out))
+        audioPlayCntr++;
+        minMaxFreeBlockSize = MIN(minMaxFreeBlockSize, ESP.getMaxFreeBlockSize());
+        if (prepare_audio() && audio_begin())
         {
-            TRACE("done.\n");
             replay_cntr = audioPlayCount;
+            playAt_us = micros() + delay_us;
+            if (delay_us && scheduler_add_timed(doorbell_play_at_task, playAt_us))
+            {
+                playAtPending = true;
+                playAtCntr++;
+                TRACE("armed, start in %u us.\n", static_cast<unsigned int>(delay_us));
+            }
+            else
+            {
+                /* Send the first samples right now, do not wait for next loop */
+                audio_loop();
+                TRACE("done.\n");
+            }
         }
         else
         {
@@ -451,18 +804,7 @@ void doorbell_play()
     }
 
 #if ENABLE_MQTT_CLIENT
-    if (mqttClient.connected())
-    {
-        ok = mqttClient.publish(mqttTopicPlayAudio.c_str(), mqttMsg);
-        if (ok)
-        {
-            TRACE("Publish %s, %s\n", mqttTopicPlayAudio.c_str(), mqttMsg);
-        }
-        else
-        {
-            ERROR("Cannot publish %s, %s\n", mqttTopicPlayAudio.c_str(), mqttMsg);
-        }
-    }
+    mqtt_queue_publish(mqttTopicPlayAudioId, mqttMsg);
 #endif
 }
 
@@ -470,88 +812,176 @@ void doorbell_play()
 /*
  * It handles functions of doorbell
  */
-void doorbell_handle_doorbell_htm(ESP8266WebServer &httpServer, String requestUri)
+void doorbell_handle_doorbell_htm()
 {
-    String buf;
     String bell;
 
-#if ENABLE_HTTP_AUTH
-    if (!http_is_authenticated(DOORBELL_HTM))
-    {
-        request_http_auth();
-        return;
-    }
-#endif
-
     if (httpServer.hasArg("bell"))
     {
         bell = httpServer.arg("bell");
     }
 
-    buf += html_begin(false, homepageTitleStr, "Ringing the bell", 1, INDEX_HTM);
     if (bell == "RING")
     {
-        doorbell_play();
-        doorbell_update_history(EVENT_DOORBELL_WEB);
+        doorbell_ring(EVENT_DOORBELL_WEB);
     }
-    buf += "<p>" + html_link_to_index() + "</p>";
-    buf += html_footer();
-    buf += html_end();
 
+    HttpResponseStream out(httpServer);
     httpServer.sendHeader("Cache-Control", "no-cache");
-    httpServer.send(200, "text/html; charset=utf-8", buf);
+    out.begin(200, "text/html; charset=utf-8");
+    html_begin(out, false, homepageTitleStr, "Ringing the bell", 1, INDEX_HTM);
+    out.print("<p>");
+    out.print(html_link_to_index());
+    out.print("</p>");
+    html_footer(out);
+    html_end(out);
 }
 
-String doorbell_generate_index_htm()
-{
-    String buf;
-    String disabledStr;
+/* Slots of doorbellIndexTemplate */
+#define DOORBELL_INDEX_SLOT_DISABLED    0
+#define DOORBELL_INDEX_SLOT_HISTORY     1
+
+static const char doorbellIndexTemplate[] PROGMEM =
+    "<form action=\"" DOORBELL_HTM "\">Doorbell: "
+    "<input type=\"submit\" id=\"ring\" name=\"bell\" value=\"RING\""
+    HTML_SLOT(DOORBELL_INDEX_SLOT_DISABLED) "></form>"
+#if DOORBELL_HISTORY_LENGTH > 0
+    "<p>Last " TOSTR(DOORBELL_HISTORY_DISPLAY_LENGTH) " events:<br><span id=\"history\">"
+    HTML_SLOT(DOORBELL_INDEX_SLOT_HISTORY)
+    "</span></p>"
+#endif
+    ;
 
-    buf += "<form action=\"" DOORBELL_HTM "\">Doorbell: ";
-    if (doorbell_is_playing())
+static void doorbell_index_slot(Print &out, uint8_t slot, const void UNUSED *ctx)
+{
+    if (slot == DOORBELL_INDEX_SLOT_DISABLED)
     {
-        disabledStr = " disabled=\"true\"";
+        if (doorbell_is_playing())
+        {
+            out.print(F(" disabled=\"true\""));
+        }
     }
-    buf += "<input type=\"submit\" name=\"bell\" value=\"RING\"" + disabledStr + ">";
-    buf += "</form>";
-
 #if DOORBELL_HISTORY_LENGTH > 0
-    uint16_t lines = 0;
+    else if (slot == DOORBELL_INDEX_SLOT_HISTORY)
+    {
+        const doorbellHistoryRecord_t *record;
+
+        for (uint16_t idx = 0; (record = doorbell_history_get(idx)) != NULL; idx++)
+        {
+            doorbell_history_print_record(out, *record);
+            out.print(F("<br>"));
+        }
+    }
+#endif
+}
 
-    buf += "<p>Last " TOSTR(DOORBELL_HISTORY_LENGTH) " events:<br>";
+void doorbell_generate_index_htm(Print &out)
+{
+    html_render(out, doorbellIndexTemplate, doorbell_index_slot);
+}
 
-    lines = readStringsFromFile(DOORBELL_HISTORY_FILENAME, 0, doorbell_history, DOORBELL_HISTORY_LENGTH, false);
+/*
+ * Longest time between two audio_gen->loop() calls while playing.
+ */
+uint32_t doorbell_max_audio_loop_gap_us()
+{
+    return maxAudioLoopGap_us;
+}
 
-    for (uint16_t idx = 0; idx < lines; idx++)
+/*
+ * It generates the doorbell part of /sysinfo.json
+ */
+void doorbell_generate_sysinfo_json(Print &out)
+{
+    out.print("  , \"doorbellAudioPlayCntr\": " + String(audioPlayCntr) + "\n");
+    if (audioPlayCntr)
     {
-        buf += doorbell_history[idx] + "<br>";
+        out.print("  , \"doorbellMinMaxFreeBlockSize\": " + String(minMaxFreeBlockSize) + "\n");
     }
-
-    buf += "</p>";
+    out.print("  , \"doorbellAudioFileOpenCntr\": " + String(audioFileOpenCntr) + "\n");
+    out.print("  , \"doorbellAudioCodec\": \"" + String(audio_codec_name(audioCodec)) + "\"\n");
+    audio_codec_generate_sysinfo_json(out);
+    out.print("  , \"doorbellMaxAudioLoopGap_us\": " + String(maxAudioLoopGap_us) + "\n");
+    out.print("  , \"doorbellPlayAtCntr\": " + String(playAtCntr) + "\n");
+    if (playAtCntr)
+    {
+        out.print("  , \"doorbellPlayAtLastSkew_us\": " + String(playAtLastSkew_us) + "\n");
+        out.print("  , \"doorbellPlayAtMaxSkew_us\": " + String(playAtMaxSkew_us) + "\n");
+    }
+#if ENABLE_MQTT_CLIENT
+    out.print("  , \"doorbellMqttMessageCntr\": " + String(mqttMessageCntr) + "\n");
+    out.print("  , \"doorbellMqttFollowMatchCntr\": " + String(mqttFollowMatchCntr) + "\n");
+    out.print("  , \"doorbellMqttFollowTrieNodeCnt\": " + String(followedMqttTopicTrie.nodeCnt) + "\n");
+#endif
+#if ENABLE_MQTT_CLIENT || ENABLE_RING_MULTICAST
+    out.print("  , \"doorbellRemoteRingCntr\": " + String(remoteRingCntr) + "\n");
+    out.print("  , \"doorbellRemoteRingDupCntr\": " + String(remoteRingDupCntr) + "\n");
+#endif
+#if DOORBELL_SWITCH_PIN != -1
+    out.print("  , \"doorbellSwitchEdgeCntr\": " + String(switchEdgeCntr) + "\n");
+    out.print("  , \"doorbellSwitchEdgeDropCntr\": " + String(switchEdgeDropCntr) + "\n");
+#endif
+#if DOORBELL_AUDIO_CACHE_MAX_SIZE > 0
+    out.print("  , \"doorbellAudioCacheMaxSize\": " TOSTR(DOORBELL_AUDIO_CACHE_MAX_SIZE) "\n");
+    out.print("  , \"doorbellAudioCacheHeapMargin\": " TOSTR(DOORBELL_AUDIO_CACHE_HEAP_MARGIN) "\n");
+    out.print("  , \"doorbellAudioCacheSize\": " + String(audioCacheSize) + "\n");
+    out.print("  , \"doorbellAudioCacheHit\": " + String(audioCacheHitCntr) + "\n");
+    out.print("  , \"doorbellAudioCacheMiss\": " + String(audioCacheMissCntr) + "\n");
+    out.print("  , \"doorbellAudioCacheLoadTime_ms\": " + String(audioCacheLoadTime_ms) + "\n");
 #endif
-
-    return buf;
 }
 #endif
 
 #if ENABLE_MQTT_CLIENT
-void doorbell_mqtt_callback(String& topicStr, String& payloadStr, unsigned int length)
+/*
+ * It handles a received MQTT message. Topic and payload are used in place,
+ * in the buffer of MQTT client.
+ *
+ * @param[in] topic     Topic of message.
+ * @param[in] topicLen  Length of topic.
+ * @param[in] payload   Payload, it is not zero terminated.
+ * @param[in] length    Length of payload.
+ */
+void doorbell_mqtt_callback(const char *topic, uint16_t topicLen, const uint8_t *payload, unsigned int length)
 {
+    mqttTopicMask_t mask;
     uint16_t i;
 
-    for (i = 0; i < DOORBELL_MAX_MQTT_FOLLOW_TOPICS; i++)
+    mqttMessageCntr++;
+    mask = mqtt_topic_trie_match(&followedMqttTopicTrie, topic, topicLen);
+    for (i = 0; mask && i < DOORBELL_MAX_MQTT_FOLLOW_TOPICS; i++, mask >>= 1)
     {
-        if (topicStr == followedMqttTopics[i].topic
-            && (followedMqttTopics[i].value.isEmpty()
-              || (payloadStr == followedMqttTopics[i].value)))
+        const String &value = followedMqttTopics[i].value;
+
+        if ((mask & 1u)
+            && (value.isEmpty()
+              || (value.length() == length && !memcmp(payload, value.c_str(), length))))
         {
-            TRACE("Followed topic '%s' match, payload: '%s'\n", topicStr.c_str(), payloadStr.c_str());
-            doorbell_play();
-            doorbell_update_history(EVENT_DOORBELL_MQTT);
+            TRACE("Followed topic '%s' match\n", followedMqttTopics[i].topic.c_str());
+            mqttFollowMatchCntr++;
+            doorbell_remote_ring(EVENT_DOORBELL_MQTT);
+            /* One ring per message even if more filters match */
+            break;
         }
     }
 }
 #endif /* MQTT_CLIENT */
 
+#if ENABLE_RING_MULTICAST
+/*
+ * It handles an event received by multicast from a doorbell of the group.
+ *
+ * @param[in] eventType     EVENT_DOORBELL... of the sender.
+ * @param[in] delay_us      Time until deadline of sender, 0: play immediately.
+ */
+void doorbell_multicast_callback(uint8_t eventType, uint32_t delay_us)
+{
+    if (eventType == EVENT_DOORBELL)
+    {
+        doorbell_remote_ring(EVENT_DOORBELL_LAN, delay_us);
+    }
+}
+#endif
+
 
 #endif
@@ -20,14 +20,22 @@
 
 #if ENABLE_DOORBELL
 extern void doorbell_task(uint8_t mqtt_flags);
+extern void doorbell_audio_task();
 extern void doorbell_init();
-extern void doorbell_play();
+extern void doorbell_play(uint32_t delay_us=0);
+extern bool doorbell_is_playing();
+extern void doorbell_audio_file_changed(const String &fileName);
 #if ENABLE_HTTP_SERVER
-extern void doorbell_handle_doorbell_htm(ESP8266WebServer &httpServer, String requestUri);
-extern String doorbell_generate_index_htm();
+extern void doorbell_handle_doorbell_htm();
+extern void doorbell_generate_index_htm(Print &out);
+extern void doorbell_generate_sysinfo_json(Print &out);
+extern uint32_t doorbell_max_audio_loop_gap_us();
 #endif
 #if ENABLE_MQTT_CLIENT
-extern void doorbell_mqtt_callback(String& topicStr, String& payloadStr, unsigned int length);
+extern void doorbell_mqtt_callback(const char *topic, uint16_t topicLen, const uint8_t *payload, unsigned int length);
+#endif
+#if ENABLE_RING_MULTICAST
+extern void doorbell_multicast_callback(uint8_t eventType, uint32_t delay_us);
 #endif
 #endif
 
@@ -0,0 +1,359 @@
+/**
+ * @file        doorbell_history.cpp
+ * @brief       Event log of doorbell
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 11:02:17
+ * Last modify: 2026-10-16 11:02:17 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * Events are stored as fixed size binary records in two segment files.
+ * New records are appended to the active segment. Before its last record
+ * is appended, the other segment is truncated, it becomes the active one
+ * after that append. So writing an event costs one small append regardless
+ * of the history length. Two full segments are never on the file system: the
+ * head is the segment which is not full, or the one with more records if
+ * none is full. The clock is not needed to find it (time stamps are near
+ * zero before NTP synchronization).
+ * Records are converted to text only when they are displayed.
+ *
+ * The newest DOORBELL_HISTORY_DISPLAY_LENGTH records are kept in RAM as well,
+ * so displaying them does not read the file system.
+ */
+
+#include <Arduino.h>
+
+#include "common.h"
+#include "config.h"
+#include "trace.h"
+#include "fileutils.h"
+#include "doorbell_history.h"
+#include "profile.h"
+
+#include <FS.h>       // File System for Web Server Files
+#include <LittleFS.h> // This file system is used.
+
+#define DOORBELL_HISTORY_SEGMENT_COUNT  2
+
+#if ENABLE_DOORBELL && DOORBELL_HISTORY_LENGTH > 0
+static const char *historySegmentFileNames[DOORBELL_HISTORY_SEGMENT_COUNT] =
+{
+    "doorbell_history0.bin",
+    "doorbell_history1.bin"
+};
+static uint8_t activeSegment = 0;       /* Segment where new records are appended */
+static uint16_t activeRecordCnt = 0;    /* Head: number of records in active segment */
+static uint16_t prevRecordCnt = 0;      /* Number of records in the other segment */
+static doorbellHistoryRecord_t historyCache[DOORBELL_HISTORY_DISPLAY_LENGTH];
+static uint16_t historyCacheHead = 0;   /* Index of newest record in historyCache */
+static uint16_t historyCacheCnt = 0;
+static uint32_t historyVersion = 0;     /* Incremented on every change */
+
+static void doorbell_history_cache_add(const doorbellHistoryRecord_t &record)
+{
+    historyCacheHead = (historyCacheHead + 1u) % DOORBELL_HISTORY_DISPLAY_LENGTH;
+    historyCache[historyCacheHead] = record;
+    if (historyCacheCnt < DOORBELL_HISTORY_DISPLAY_LENGTH)
+    {
+        historyCacheCnt++;
+    }
+    historyVersion++;
+}
+
+static uint16_t doorbell_history_segment_record_cnt(uint8_t segment)
+{
+    uint32_t cnt = fileSize(historySegmentFileNames[segment]) / sizeof(doorbellHistoryRecord_t);
+
+    return MIN(cnt, static_cast<uint32_t>(DOORBELL_HISTORY_LENGTH));
+}
+
+static uint32_t doorbell_history_last_timestamp(uint8_t segment, uint16_t recordCnt)
+{
+    doorbellHistoryRecord_t record = { 0, 0 };
+
+    File file = LittleFS.open(historySegmentFileNames[segment], "r");
+    if (file)
+    {
+        if (recordCnt && file.seek((recordCnt - 1) * sizeof(record), SeekSet))
+        {
+            file.read(reinterpret_cast<uint8_t *>(&record), sizeof(record));
+        }
+        file.close();
+    }
+
+    return record.timestamp;
+}
+
+/*
+ * The other segment becomes the active one, its records are dropped.
+ */
+static void doorbell_history_switch_segment()
+{
+    activeSegment ^= 1;
+    prevRecordCnt = activeRecordCnt;
+    activeRecordCnt = 0;
+}
+
+/*
+ * Find the active segment (head of log) using the size of segment files and
+ * load the newest records into RAM.
+ */
+void doorbell_history_init()
+{
+    uint16_t cnt[DOORBELL_HISTORY_SEGMENT_COUNT];
+    doorbellHistoryRecord_t records[DOORBELL_HISTORY_DISPLAY_LENGTH];
+    uint16_t idx;
+
+    cnt[0] = doorbell_history_segment_record_cnt(0);
+    cnt[1] = doorbell_history_segment_record_cnt(1);
+
+    if (cnt[0] == DOORBELL_HISTORY_LENGTH && cnt[1] == DOORBELL_HISTORY_LENGTH)
+    {
+        /* Both segments are full, only older firmware left them so. The
+         * newest record has the later time stamp. */
+        activeSegment = doorbell_history_last_timestamp(1, cnt[1]) > doorbell_history_last_timestamp(0, cnt[0]);
+    }
+    else if (cnt[0] == DOORBELL_HISTORY_LENGTH || cnt[1] == DOORBELL_HISTORY_LENGTH)
+    {
+        activeSegment = cnt[0] == DOORBELL_HISTORY_LENGTH;
+    }
+    else
+    {
+        /* The other one was truncated, it is empty */
+        activeSegment = cnt[1] > cnt[0];
+    }
+    activeRecordCnt = cnt[activeSegment];
+    prevRecordCnt = cnt[activeSegment ^ 1];
+    TRACE("Doorbell history: %i + %i events\n", activeRecordCnt, prevRecordCnt);
+
+    historyCacheCnt = 0;
+    idx = doorbell_history_read(records, DOORBELL_HISTORY_DISPLAY_LENGTH);
+    /* Oldest first */
+    while (idx > 0)
+    {
+        doorbell_history_cache_add(records[--idx]);
+    }
+}
+
+/*
+ * Append an event to the log.
+ *
+ * @param[in] eventType     EVENT_...
+ *
+ * @return true if event was stored.
+ */
+bool doorbell_history_add(uint8_t eventType)
+{
+    bool ok = false;
+    doorbellHistoryRecord_t record;
+    const char *mode = "a";
+    time_t rawtime;
+
+    time(&rawtime);
+    record.timestamp = rawtime;
+    record.eventType = eventType;
+
+    if (activeRecordCnt >= DOORBELL_HISTORY_LENGTH)
+    {
+        /* Both segments were full, overwrite the older one */
+        doorbell_history_switch_segment();
+        mode = "w";
+    }
+    if (activeRecordCnt + 1u >= DOORBELL_HISTORY_LENGTH && prevRecordCnt)
+    {
+        /* Last record of active segment: the other one is truncated first,
+         * so two full segments are not left even if power is lost */
+        File prevFile = LittleFS.open(historySegmentFileNames[activeSegment ^ 1], "w");
+        if (prevFile)
+        {
+            prevFile.close();
+            prevRecordCnt = 0;
+            fs_changed();
+        }
+        else
+        {
+            ERROR("Cannot truncate %s!\n", historySegmentFileNames[activeSegment ^ 1]);
+        }
+    }
+
+    File file = LittleFS.open(historySegmentFileNames[activeSegment], mode);
+    if (file)
+    {
+        if (file.write(reinterpret_cast<uint8_t *>(&record), sizeof(record)) == sizeof(record))
+        {
+            activeRecordCnt++;
+            profile_fs_write(sizeof(record));
+            fs_changed();
+            ok = true;
+        }
+        else
+        {
+            ERROR("Cannot write data to %s!\n", historySegmentFileNames[activeSegment]);
+        }
+        file.close();
+    }
+    else
+    {
+        ERROR("Cannot open %s!\n", historySegmentFileNames[activeSegment]);
+    }
+    if (activeRecordCnt >= DOORBELL_HISTORY_LENGTH && !prevRecordCnt)
+    {
+        /* Next record goes to the truncated segment */
+        doorbell_history_switch_segment();
+    }
+    /* Event is displayed even if it could not be stored */
+    doorbell_history_cache_add(record);
+
+    return ok;
+}
+
+/*
+ * Read the last records of a segment in reverse order.
+ */
+static uint16_t doorbell_history_read_segment(uint8_t segment, uint16_t recordCnt,
+                                              doorbellHistoryRecord_t *records, uint16_t maxRecords)
+{
+    uint16_t cnt = MIN(recordCnt, maxRecords);
+    uint16_t idx;
+    doorbellHistoryRecord_t record;
+
+    if (!cnt)
+    {
+        return 0;
+    }
+
+    File file = LittleFS.open(historySegmentFileNames[segment], "r");
+    if (file)
+    {
+        if (file.seek((recordCnt - cnt) * sizeof(record), SeekSet))
+        {
+            cnt = file.read(reinterpret_cast<uint8_t *>(records), cnt * sizeof(record)) / sizeof(record);
+        }
+        else
+        {
+            cnt = 0;
+        }
+        file.close();
+        /* Newest first */
+        for (idx = 0; idx < cnt / 2; idx++)
+        {
+            record = records[idx];
+            records[idx] = records[cnt - 1 - idx];
+            records[cnt - 1 - idx] = record;
+        }
+    }
+    else
+    {
+        ERROR("Cannot open %s!\n", historySegmentFileNames[segment]);
+        cnt = 0;
+    }
+
+    return cnt;
+}
+
+/*
+ * Read the newest events from the log.
+ *
+ * @param[out] records      Events, newest first.
+ * @param[in] maxRecords    Maximum number of events to read.
+ *
+ * @return Number of events read.
+ */
+uint16_t doorbell_history_read(doorbellHistoryRecord_t *records, uint16_t maxRecords)
+{
+    uint16_t cnt;
+
+    cnt = doorbell_history_read_segment(activeSegment, activeRecordCnt, records, maxRecords);
+    cnt += doorbell_history_read_segment(activeSegment ^ 1, prevRecordCnt, records + cnt, maxRecords - cnt);
+
+    return cnt;
+}
+
+/*
+ * Get an event from RAM.
+ *
+ * @param[in] idx   0: newest event, 1: previous event, etc.
+ *
+ * @return Event or NULL if idx is out of range.
+ */
+const doorbellHistoryRecord_t *doorbell_history_get(uint16_t idx)
+{
+    if (idx >= historyCacheCnt)
+    {
+        return NULL;
+    }
+
+    return &historyCache[(historyCacheHead + DOORBELL_HISTORY_DISPLAY_LENGTH - idx) % DOORBELL_HISTORY_DISPLAY_LENGTH];
+}
+
+/*
+ * Version of history, it changes when an event is added.
+ */
+uint32_t doorbell_history_version()
+{
+    return historyVersion;
+}
+
+static const __FlashStringHelper *doorbell_history_event_name(uint8_t eventType)
+{
+    if (eventType == EVENT_COURTYARD_LAMP)
+    {
+        return F(" courtyard lamp");
+    }
+    else if (eventType == EVENT_DOORBELL)
+    {
+        return F(" doorbell switch");
+    }
+    else if (eventType == EVENT_DOORBELL_WEB)
+    {
+        return F(" doorbell through web");
+    }
+    else if (eventType == EVENT_DOORBELL_MQTT)
+    {
+        return F(" doorbell through MQTT");
+    }
+    else if (eventType == EVENT_DOORBELL_LAN)
+    {
+        return F(" doorbell through LAN");
+    }
+
+    return F(" unknown event!");
+}
+
+static void doorbell_history_format_time(const doorbellHistoryRecord_t &record, char *buffer, size_t size)
+{
+    time_t rawtime = record.timestamp;
+    struct tm *timeinfo;
+
+    timeinfo = localtime(&rawtime);
+    strftime(buffer, size, "%Y-%m-%d %H:%M:%S", timeinfo);
+}
+
+/*
+ * Convert event to text, example: "2024-11-23 12:49:15 doorbell switch"
+ */
+String doorbell_history_record_to_str(const doorbellHistoryRecord_t &record)
+{
+    String str;
+    char buffer[32];
+
+    doorbell_history_format_time(record, buffer, sizeof(buffer));
+    str = buffer;
+    str += doorbell_history_event_name(record.eventType);
+
+    return str;
+}
+
+/*
+ * Same as doorbell_history_record_to_str(), but it is written to out
+ * without allocating a String.
+ */
+void doorbell_history_print_record(Print &out, const doorbellHistoryRecord_t &record)
+{
+    char buffer[32];
+
+    doorbell_history_format_time(record, buffer, sizeof(buffer));
+    out.print(buffer);
+    out.print(doorbell_history_event_name(record.eventType));
+}
+#endif /* ENABLE_DOORBELL && DOORBELL_HISTORY_LENGTH > 0 */
@@ -0,0 +1,47 @@
+/**
+ * @file        doorbell_history.h
+ * @brief       Definitions of doorbell_history.cpp
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 11:02:17
+ * Last modify: 2026-10-16 11:02:17 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#ifndef INCLUDE_DOORBELL_HISTORY_H
+#define INCLUDE_DOORBELL_HISTORY_H
+
+#include <stdint.h>
+
+#include <Arduino.h>
+
+#include "common.h"
+#include "config.h"
+
+#define EVENT_DOORBELL                  0
+#define EVENT_COURTYARD_LAMP            1
+#define EVENT_DOORBELL_WEB              2
+#define EVENT_DOORBELL_MQTT             3
+#define EVENT_DOORBELL_LAN              4
+
+#ifndef DOORBELL_HISTORY_DISPLAY_LENGTH
+#define DOORBELL_HISTORY_DISPLAY_LENGTH 32
+#endif
+
+typedef struct __attribute__((packed))
+{
+    uint32_t timestamp;     /* Epoch time of event */
+    uint8_t eventType;      /* EVENT_... */
+} doorbellHistoryRecord_t;
+
+#if ENABLE_DOORBELL && DOORBELL_HISTORY_LENGTH > 0
+extern void doorbell_history_init();
+extern bool doorbell_history_add(uint8_t eventType);
+extern uint16_t doorbell_history_read(doorbellHistoryRecord_t *records, uint16_t maxRecords);
+extern const doorbellHistoryRecord_t *doorbell_history_get(uint16_t idx);
+extern uint32_t doorbell_history_version();
+extern String doorbell_history_record_to_str(const doorbellHistoryRecord_t &record);
+extern void doorbell_history_print_record(Print &out, const doorbellHistoryRecord_t &record);
+#endif
+
+#endif /* INCLUDE_DOORBELL_HISTORY_H */
@@ -17,6 +17,42 @@
 #include <FS.h>       // File System for Web Server Files
 #include <LittleFS.h> // This file system is used.
 
+static uint32_t fsGeneration = 0;   /* Incremented when a file is written or removed */
+
+/*
+ * Remove comment and trailing spaces of a line read from a file.
+ *
+ * @param[in,out] line              Line to modify.
+ * @param[in] commentChar           Ignore this character and all data after this character
+ * @param[in] removeTrailingSpace   true: Remove all trailing space characters
+ */
+void trimLine(String &line, uint8_t commentChar, bool removeTrailingSpaces)
+{
+    int idx;
+
+    if (commentChar != 0)
+    {
+        idx = line.indexOf(commentChar);
+        /* Check if comment character is in the string */
+        if (idx != -1)
+        {
+            /* Remove comment character and evrything after that*/
+            line.remove(idx);
+        }
+    }
+
+    if (removeTrailingSpaces)
+    {
+        idx = line.length() - 1;
+        /* Remove trailing spaces */
+        while (idx >= 0 && (line[idx] == ' ' || line[idx] == '\t' || line[idx] == '\r'))
+        {
+            line.remove(idx);
+            idx--;
+        }
+    }
+}
+
 /*
  * Read given line of a file and return.
  *
@@ -32,7 +68,6 @@ String readStringFromFile(const String &filename, uint16_t lineIdx, bool error,
 {
     String content;
     uint16_t idx;
-    int commentCharIdx;
 
     File file = LittleFS.open(filename, "r");
     if (file)
@@ -46,27 +81,7 @@ String readStringFromFile(const String &filename, uint16_t lineIdx, bool error,
         if (file.available())
         {
             content = file.readStringUntil('\n');
-            if (commentChar != 0)
-            {
-                commentCharIdx = content.indexOf(commentChar);
-                /* Check if comment character is in the string */
-                if (commentCharIdx != -1)
-                {
-                    /* Remove comment character and evrything after that*/
-                    content.remove(commentCharIdx);
-                }
-            }
-
-            if (removeTrailingSpaces)
-            {
-                idx = content.length() - 1;
-                /* Remove trailing spaces */
-                while (content[idx] == ' ' || content[idx] == '\t')
-                {
-                    content.remove(idx);
-                    idx--;
-                }
-            }
+            trimLine(content, commentChar, removeTrailingSpaces);
         }
         TRACE("Line #%i from file '%s': '%s'\n", lineIdx, filename.c_str(), content.c_str());
     }
@@ -145,7 +160,6 @@ uint16_t readStringsFromFile(const String &filename, uint16_t startLineIdx,
 {
     String content;
     uint16_t idx;
-    int commentCharIdx;
     uint16_t lineCntr = 0;
 
     File file = LittleFS.open(filename, "r");
@@ -160,27 +174,7 @@ uint16_t readStringsFromFile(const String &filename, uint16_t startLineIdx,
         while (file.available() && lineCntr < a_max_lines)
         {
             content = file.readStringUntil('\n');
-            if (commentChar != 0)
-            {
-                commentCharIdx = content.indexOf(commentChar);
-                /* Check if comment character is in the string */
-                if (commentCharIdx != -1)
-                {
-                    /* Remove comment character and evrything after that*/
-                    content.remove(commentCharIdx);
-                }
-            }
-
-            if (removeTrailingSpaces)
-            {
-                idx = content.length() - 1;
-                /* Remove trailing spaces */
-                while (content[idx] == ' ' || content[idx] == '\t')
-                {
-                    content.remove(idx);
-                    idx--;
-                }
-            }
+            trimLine(content, commentChar, removeTrailingSpaces);
             a_lines[lineCntr] = content;
             TRACE("Line #%i from file '%s': '%s'\n", lineCntr + startLineIdx, filename.c_str(), content.c_str());
             lineCntr++;
@@ -215,3 +209,20 @@ uint32_t fileSize(const String &filename)
 
     return size;
 }
+
+/*
+ * It shall be called after a file was written, created or removed.
+ */
+void fs_changed()
+{
+    fsGeneration++;
+}
+
+/*
+ * Generation of file system: it changes when a file is written, created or
+ * removed. It can be used to detect changes without reading the directory.
+ */
+uint32_t fs_generation()
+{
+    return fsGeneration;
+}
@@ -15,6 +15,7 @@
 #include "common.h"
 #include "config.h"
 
+extern void trimLine(String &line, uint8_t commentChar = COMMENT_CHAR, bool removeTrailingSpaces = true);
 extern String readStringFromFile(const String &filename, uint16_t lineIdx = 0, bool error=false,
                                  uint8_t commentChar = COMMENT_CHAR, bool removeTrailingSpaces = true);
 extern int32_t getLineCountOfFile(const String& filename, bool error=true);
@@ -22,5 +23,7 @@ extern uint16_t readStringsFromFile(const String &filename, uint16_t startLineId
                                     String *a_lines, uint32_t a_max_lines, bool error=false,
                                     uint8_t commentChar = COMMENT_CHAR, bool removeTrailingSpaces = true);
 extern uint32_t fileSize(const String &filename);
+extern void fs_changed();
+extern uint32_t fs_generation();
 #endif /* INCLUDE_FILEUTILS_H */
 
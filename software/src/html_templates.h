@@ -0,0 +1,101 @@
+/**
+ * @file        html_templates.h
+ * @brief       Constant parts of generated pages
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 17:31:08
+ * Last modify: 2026-10-16 17:31:08 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * Templates are stored in flash and written by html_render(). Dynamic parts
+ * are marked by HTML_SLOT() and written by the slot writer of the page.
+ */
+
+#ifndef INCLUDE_HTML_TEMPLATES_H
+#define INCLUDE_HTML_TEMPLATES_H
+
+#include "http_server.h"
+
+/* Slots of htmlBeginTemplate */
+#define HTML_BEGIN_SLOT_REFRESH         0
+#define HTML_BEGIN_SLOT_VIEWPORT        1
+#define HTML_BEGIN_SLOT_TITLE           2
+#define HTML_BEGIN_SLOT_STYLE           3
+#define HTML_BEGIN_SLOT_HEADING         4
+#define HTML_BEGIN_SLOT_REDIRECT        5
+
+static const char htmlBeginTemplate[] PROGMEM =
+    "<!DOCTYPE html PUBLIC \"-//W3C//DTD XHTML 1.0 Strict//EN\""
+    "\"http://www.w3.org/TR/xhtml1/DTD/xhtml1-strict.dtd\">"
+    "<html xmlns=\"http://www.w3.org/1999/xhtml\" lang=\"en\" xml:lang=\"en\">"
+    "<head><meta http-equiv=\"content-type\" content=\"text/html; charset=utf-8\"/>"
+    HTML_SLOT(HTML_BEGIN_SLOT_REFRESH)
+    "<meta name=\"mobile-web-app-capable\" content=\"yes\">"
+    HTML_SLOT(HTML_BEGIN_SLOT_VIEWPORT)
+    "<title>" HTML_SLOT(HTML_BEGIN_SLOT_TITLE) "</title>"
+    "<link Content-Type=\"text/css\" href=\"" HTML_SLOT(HTML_BEGIN_SLOT_STYLE) "\" rel=\"stylesheet\" />"
+    "</head><body>"
+    HTML_SLOT(HTML_BEGIN_SLOT_HEADING)
+    HTML_SLOT(HTML_BEGIN_SLOT_REDIRECT);
+
+static const char htmlViewport[] PROGMEM =
+    "<meta name=\"viewport\" content=\"user-scalable=no, width=device-width, initial-scale=1.2, maximum-scale=1.2\"/>";
+
+/* Slots of htmlFooterTemplate */
+#define HTML_FOOTER_SLOT_TRACE_INFO     0
+#define HTML_FOOTER_SLOT_UPTIME         1
+#define HTML_FOOTER_SLOT_HOSTNAME       2
+
+static const char htmlFooterTemplate[] PROGMEM =
+    "<hr><p><small>"
+    HTML_SLOT(HTML_FOOTER_SLOT_TRACE_INFO)
+    "<a href=\"" ADMIN_HTM "\">Admin</a> | Uptime: " HTML_SLOT(HTML_FOOTER_SLOT_UPTIME)
+    " | Hostname: <a href=\"http://" HTML_SLOT(HTML_FOOTER_SLOT_HOSTNAME) "\">"
+    HTML_SLOT(HTML_FOOTER_SLOT_HOSTNAME) "</a><br><br>"
+    "Copyright (C) Peter Ivanov &lt;<a href=\"mailto:ivanovp@gmail.com\">ivanovp@gmail.com</a>&gt;, 2023, 2024.<br>"
+    "</small></p>";
+
+static const char htmlEnd[] PROGMEM = "</body></html>";
+
+static const char htmlLinkToIndex[] PROGMEM = "<a href=\"" INDEX_HTM "\">Index</a>";
+
+#if ENABLE_FILE_TRACE
+static const char htmlLinkToTraceLog[] PROGMEM =
+    "Trace log: <a href=\"" TRACE_FILE_NAME "\">" TRACE_FILE_NAME "</a>";
+#endif
+
+static const char adminContent[] PROGMEM = R"==(
+<p>The following pages are available:</p>
+<ul>
+  <li><a href="/index.htm">/index.htm</a> - Index page</li>
+  <li><a href="/admin.htm">/admin.htm</a> - This page</li>
+  <li><a href="/files.htm">/files.htm</a> - Manage files on the server</li>
+  <li><a href="/upload.htm">/upload.htm</a> - Built-in upload utility</a></li>)=="
+#if ENABLE_FIRMWARE_UPDATE
+    "<li><a href=\"/update.htm\">/update.htm</a> - Firmware update</li>"
+#endif
+#if ENABLE_RESET
+    "<li><a href=\"/reset.htm\">/reset.htm</a> - Board reset</li>"
+#endif
+#if ENABLE_FILE_TRACE
+    "<li><a href=\"/file_trace.htm\">/file_trace.htm</a> - Enable/disable file trace</li>"
+#endif
+#if ENABLE_BINARY_TRACE
+    "<li><a href=\"/trace_bin.txt\">/trace_bin.txt</a> - Binary trace as text</li>"
+    "<li><a href=\"/trace_bin.bin\">/trace_bin.bin</a> - Binary trace for tools/trace_decode.py</li>"
+#endif
+    R"==(
+</ul>
+
+<p>The following REST services are available:</p>
+<ul>
+  <li><a href="/sysinfo.json">/sysinfo.json</a> - Some system level information</a></li>
+  <li><a href="/file_list.json">/file_list.json</a> - Array of all files</a></li>
+  <li><a href="/config.json">/config.json</a> - Effective configuration</a></li>
+  <li><a href="/tasks.json">/tasks.json</a> - Runtime of tasks</a></li>)=="
+#if ENABLE_PROFILE
+    "<li><a href=\"/profile.json\">/profile.json</a> - Cost of ring, page load, MQTT message and upload</li>"
+#endif
+    "</ul>";
+
+#endif /* INCLUDE_HTML_TEMPLATES_H */
@@ -0,0 +1,231 @@
+/**
+ * @file        http_events.cpp
+ * @brief       Server-Sent Events
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 16:48:12
+ * Last modify: 2026-10-16 16:48:12 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * Browsers subscribe to /events and keep the connection open. Events (ring,
+ * long press, playing state) are queued by http_events_send() and written
+ * to the subscribers by http_events_task(), so the index page is updated
+ * in place without reloading it periodically.
+ */
+
+#include <Arduino.h>
+#include <ESP8266WebServer.h>
+
+#include "main.h"
+#include "common.h"
+#include "config.h"
+#include "trace.h"
+#include "http_server.h"
+#include "http_events.h"
+#include "doorbell_history.h"
+
+#if ENABLE_HTTP_SERVER && ENABLE_HTTP_EVENTS
+typedef struct
+{
+    WiFiClient client;
+    bool active;                /* true: client was connected */
+    uint32_t lastSend_ms;
+} httpEventsSubscriber_t;
+
+static httpEventsSubscriber_t subscribers[HTTP_EVENTS_MAX_SUBSCRIBERS];
+static String pendingEvents;            /* Formatted events waiting to be sent */
+static uint32_t eventSentCntr = 0;
+static uint32_t eventDropCntr = 0;      /* Events which did not fit into queue */
+static uint32_t subscriberRejectCntr = 0;
+static uint32_t subscriberStallCntr = 0; /* Subscribers dropped, they did not read */
+
+static uint8_t http_events_subscriber_cnt()
+{
+    uint8_t cnt = 0;
+    uint8_t i;
+
+    for (i = 0; i < HTTP_EVENTS_MAX_SUBSCRIBERS; i++)
+    {
+        if (subscribers[i].client.connected())
+        {
+            cnt++;
+        }
+    }
+
+    return cnt;
+}
+
+/*
+ * It handles /events: the connection is kept open and events are sent
+ * through it. Number of subscribers is limited to protect the heap.
+ */
+void http_events_handle_subscribe()
+{
+    uint8_t i;
+
+    for (i = 0; i < HTTP_EVENTS_MAX_SUBSCRIBERS; i++)
+    {
+        if (!subscribers[i].client.connected())
+        {
+            break;
+        }
+    }
+    if (i == HTTP_EVENTS_MAX_SUBSCRIBERS)
+    {
+        subscriberRejectCntr++;
+        httpServer.send(503, "text/plain", "Too many subscribers");
+        return;
+    }
+
+    subscribers[i].client = httpServer.client();
+    subscribers[i].client.setNoDelay(true);
+    subscribers[i].client.print("HTTP/1.1 200 OK\r\n"
+                                "Content-Type: text/event-stream\r\n"
+                                "Cache-Control: no-cache\r\n"
+                                "Connection: keep-alive\r\n"
+                                "\r\n"
+                                "retry: 5000\n\n");
+    subscribers[i].active = true;
+    subscribers[i].lastSend_ms = millis();
+    TRACE("Events subscriber #%i connected\n", i);
+}
+
+/*
+ * Queue an event for all subscribers.
+ *
+ * @param[in] event     Event name, example: "ring".
+ * @param[in] data      Content of event, it shall be one line.
+ */
+void http_events_send(const char *event, const String &data)
+{
+    uint32_t len;
+
+    if (!http_events_subscriber_cnt())
+    {
+        return;
+    }
+    len = 7 + strlen(event) + 7 + data.length() + 2;    /* "event: " ... "\ndata: " ... "\n\n" */
+    if (pendingEvents.length() + len > HTTP_EVENTS_QUEUE_SIZE)
+    {
+        eventDropCntr++;
+        return;
+    }
+    pendingEvents += "event: ";
+    pendingEvents += event;
+    pendingEvents += "\ndata: ";
+    pendingEvents += data;
+    pendingEvents += "\n\n";
+}
+
+/*
+ * Write to subscriber without waiting. A subscriber which does not read
+ * fills the send buffer, it is dropped and the browser reconnects.
+ *
+ * @return true if everything was written.
+ */
+static bool http_events_write(uint8_t idx, const char *data, uint32_t len)
+{
+    WiFiClient &client = subscribers[idx].client;
+
+    if (static_cast<uint32_t>(MAX(client.availableForWrite(), 0)) < len)
+    {
+        ERROR("Events subscriber #%i does not read, dropped!\n", idx);
+        subscriberStallCntr++;
+        client.stop();
+        return false;
+    }
+    if (client.write(reinterpret_cast<const uint8_t *>(data), len) != len)
+    {
+        ERROR("Cannot send events to subscriber #%i!\n", idx);
+        client.stop();
+        return false;
+    }
+
+    return true;
+}
+
+/*
+ * Send queued events and keep-alive comments. Subscribers which cannot
+ * receive are dropped.
+ */
+void http_events_task()
+{
+    uint8_t i;
+    uint32_t now = millis();
+    uint32_t len = pendingEvents.length();
+    httpEventsSubscriber_t *subscriber;
+
+    for (i = 0; i < HTTP_EVENTS_MAX_SUBSCRIBERS; i++)
+    {
+        subscriber = &subscribers[i];
+        if (!subscriber->client.connected())
+        {
+            if (subscriber->active)
+            {
+                TRACE("Events subscriber #%i disconnected\n", i);
+                subscriber->client.stop();
+                subscriber->client = WiFiClient();
+                subscriber->active = false;
+            }
+            continue;
+        }
+        if (len)
+        {
+            if (http_events_write(i, pendingEvents.c_str(), len))
+            {
+                subscriber->lastSend_ms = now;
+            }
+        }
+        else if (now - subscriber->lastSend_ms >= HTTP_EVENTS_KEEPALIVE_MS)
+        {
+            if (http_events_write(i, ":\n\n", 3))
+            {
+                subscriber->lastSend_ms = now;
+            }
+        }
+    }
+    if (len)
+    {
+        eventSentCntr++;
+        pendingEvents.clear();
+    }
+}
+
+/*
+ * Script of index page: update history and ring button from events. If
+ * events are not available, the page is reloaded periodically.
+ */
+void http_events_generate_script(Print &out)
+{
+    out.print("<script>\n"
+              "var es = new EventSource(\"" EVENTS_URI "\");\n"
+              "function addEvent(e) {\n"
+              "  var h = document.getElementById(\"history\");\n"
+              "  if (!h) return;\n"
+              "  var l = h.innerHTML.split(\"<br>\").filter(function(s) { return s.length; });\n"
+              "  l.unshift(e.data);\n"
+              "  h.innerHTML = l.slice(0, " TOSTR(DOORBELL_HISTORY_DISPLAY_LENGTH) ").join(\"<br>\") + \"<br>\";\n"
+              "}\n"
+              "es.addEventListener(\"ring\", addEvent);\n"
+              "es.addEventListener(\"longPress\", addEvent);\n"
+              "es.addEventListener(\"playing\", function(e) {\n"
+              "  var b = document.getElementById(\"ring\");\n"
+              "  if (b) b.disabled = (e.data == \"1\");\n"
+              "});\n"
+              "es.onerror = function() {\n"
+              "  if (es.readyState == EventSource.CLOSED) setTimeout(function() { location.reload(); }, ");
+    out.print(String(MAX(homepageRefreshInterval_sec, 1u) * 1000u));
+    out.print(");\n"
+              "};\n"
+              "</script>\n");
+}
+
+void http_events_generate_sysinfo_json(Print &out)
+{
+    out.print("  , \"httpEventsSubscribers\": " + String(http_events_subscriber_cnt()) + "\n");
+    out.print("  , \"httpEventsSubscriberRejectCntr\": " + String(subscriberRejectCntr) + "\n");
+    out.print("  , \"httpEventsSubscriberStallCntr\": " + String(subscriberStallCntr) + "\n");
+    out.print("  , \"httpEventsSentCntr\": " + String(eventSentCntr) + "\n");
+    out.print("  , \"httpEventsDropCntr\": " + String(eventDropCntr) + "\n");
+}
+#endif /* ENABLE_HTTP_SERVER && ENABLE_HTTP_EVENTS */
@@ -0,0 +1,49 @@
+/**
+ * @file        http_events.h
+ * @brief       Definitions of http_events.cpp
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 16:48:12
+ * Last modify: 2026-10-16 16:48:12 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#ifndef INCLUDE_HTTP_EVENTS_H
+#define INCLUDE_HTTP_EVENTS_H
+
+#include <stdint.h>
+
+#include <Arduino.h>
+
+#include "common.h"
+#include "config.h"
+
+#ifndef ENABLE_HTTP_EVENTS
+#define ENABLE_HTTP_EVENTS              0
+#endif
+
+#ifndef HTTP_EVENTS_MAX_SUBSCRIBERS
+#define HTTP_EVENTS_MAX_SUBSCRIBERS     2       /* Every subscriber keeps a TCP connection open */
+#endif
+
+#ifndef HTTP_EVENTS_QUEUE_SIZE
+#define HTTP_EVENTS_QUEUE_SIZE          512     /* Bytes of events waiting to be sent */
+#endif
+
+#ifndef HTTP_EVENTS_KEEPALIVE_MS
+#define HTTP_EVENTS_KEEPALIVE_MS        15000   /* Comment is sent to idle subscribers to detect lost connections */
+#endif
+
+#define EVENTS_URI      "/events"
+
+#if ENABLE_HTTP_SERVER && ENABLE_HTTP_EVENTS
+extern void http_events_handle_subscribe();
+extern void http_events_send(const char *event, const String &data);
+extern void http_events_task();
+extern void http_events_generate_script(Print &out);
+extern void http_events_generate_sysinfo_json(Print &out);
+#else
+static inline void http_events_send(const char UNUSED *event, const String UNUSED &data) {}
+#endif
+
+#endif /* INCLUDE_HTTP_EVENTS_H */
@@ -0,0 +1,180 @@
+/**
+ * @file        http_routes.cpp
+ * @brief       Route table of generated pages
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 17:58:40
+ * Last modify: 2026-10-16 17:58:40 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * Generated pages are listed in a constant table with the hash of their URI,
+ * allowed methods, authentication policy and handler. One request handler
+ * serves all of them: the URI is hashed once, the route is found in an open
+ * addressing index built at start-up and only that route's URI is compared.
+ * Authentication policy of routes is resolved once, so a request needs only
+ * the session cookie to be checked.
+ */
+
+#include <Arduino.h>
+#include <ESP8266WebServer.h>
+
+#include "common.h"
+#include "config.h"
+#include "trace.h"
+#include "http_server.h"
+#include "http_routes.h"
+
+#if ENABLE_HTTP_SERVER
+#define HTTP_ROUTE_EMPTY_BUCKET         0xFF
+
+static_assert(http_route_hash("a") == 0xe40c292cu, "URI hash shall be FNV-1a");
+
+static const httpRoute_t *routeTable = NULL;
+static uint8_t routeTableCnt = 0;
+static uint8_t routeBuckets[HTTP_ROUTE_BUCKET_CNT];     /* Index of route, HTTP_ROUTE_EMPTY_BUCKET: empty */
+#if ENABLE_HTTP_AUTH
+static uint32_t routeAuthRequired = 0;                  /* Bit n: route n needs session cookie */
+#endif
+static uint8_t routeMaxProbes = 0;      /* Longest probe sequence of buckets */
+static uint32_t routeLookupCntr = 0;
+static uint32_t routeLookupCycles = 0;  /* Sum of CPU cycles of lookups */
+static uint32_t routeLookupMaxCycles = 0;
+
+/*
+ * Find route of URI.
+ *
+ * @return Route or NULL if URI is not in table.
+ */
+const httpRoute_t *http_routes_find(const String &uri)
+{
+    uint32_t startCycle = ESP.getCycleCount();
+    uint32_t hash = http_route_hash(uri.c_str());
+    uint32_t bucket = hash & (HTTP_ROUTE_BUCKET_CNT - 1);
+    const httpRoute_t *route = NULL;
+    uint8_t idx;
+    uint8_t i;
+
+    for (i = 0; i < routeMaxProbes; i++)
+    {
+        idx = routeBuckets[(bucket + i) & (HTTP_ROUTE_BUCKET_CNT - 1)];
+        if (idx == HTTP_ROUTE_EMPTY_BUCKET)
+        {
+            break;
+        }
+        if (routeTable[idx].hash == hash && !strcmp(routeTable[idx].uri, uri.c_str()))
+        {
+            route = &routeTable[idx];
+            break;
+        }
+    }
+
+    startCycle = ESP.getCycleCount() - startCycle;
+    routeLookupCntr++;
+    routeLookupCycles += startCycle;
+    routeLookupMaxCycles = MAX(routeLookupMaxCycles, startCycle);
+
+    return route;
+}
+
+class RouteTableHandler : public RequestHandler
+{
+public:
+    RouteTableHandler()
+    {
+        m_route = NULL;
+    }
+
+    bool canHandle(HTTPMethod requestMethod, const String &requestUri) override
+    {
+        m_route = http_routes_find(requestUri);
+        if (m_route && !(m_route->methods & HTTP_ROUTE_METHOD(requestMethod)))
+        {
+            m_route = NULL;
+        }
+
+        return m_route != NULL;
+    }
+
+    bool handle(ESP8266WebServer UNUSED &server, HTTPMethod UNUSED requestMethod, const String UNUSED &requestUri) override
+    {
+        if (!m_route)
+        {
+            return false;
+        }
+#if ENABLE_HTTP_AUTH
+        if ((routeAuthRequired & (1u << (m_route - routeTable))) && !http_has_session())
+        {
+            request_http_auth();
+            return true;
+        }
+#endif
+        m_route->handler();
+
+        return true;
+    }
+
+protected:
+    const httpRoute_t *m_route;     /* Route found by canHandle() */
+};
+
+/*
+ * Build index of route table and register its request handler. It shall
+ * be called after authentication settings were read and before other
+ * handlers are registered.
+ *
+ * @param[in] routes    Route table, it shall be kept in memory.
+ * @param[in] routeCnt  Number of routes.
+ */
+void http_routes_init(const httpRoute_t *routes, uint8_t routeCnt)
+{
+    uint32_t bucket;
+    uint8_t probes;
+    uint8_t i;
+
+    if (routeCnt > HTTP_ROUTE_BUCKET_CNT / 2 || routeCnt > 32)
+    {
+        ERROR("Too many routes: %i!\n", routeCnt);
+        routeCnt = MIN(HTTP_ROUTE_BUCKET_CNT / 2, 32);
+    }
+    routeTable = routes;
+    routeTableCnt = routeCnt;
+    memset(routeBuckets, HTTP_ROUTE_EMPTY_BUCKET, sizeof(routeBuckets));
+    routeMaxProbes = 0;
+#if ENABLE_HTTP_AUTH
+    routeAuthRequired = 0;
+#endif
+
+    for (i = 0; i < routeCnt; i++)
+    {
+        bucket = routes[i].hash;
+        for (probes = 1; routeBuckets[bucket & (HTTP_ROUTE_BUCKET_CNT - 1)] != HTTP_ROUTE_EMPTY_BUCKET; probes++)
+        {
+            bucket++;
+        }
+        routeBuckets[bucket & (HTTP_ROUTE_BUCKET_CNT - 1)] = i;
+        routeMaxProbes = MAX(routeMaxProbes, probes);
+#if ENABLE_HTTP_AUTH
+        if (routes[i].auth == HTTP_AUTH_CONFIG
+            && !http_page_is_public(routes[i].authPage ? routes[i].authPage : routes[i].uri))
+        {
+            routeAuthRequired |= 1u << i;
+        }
+#endif
+    }
+    TRACE("%i routes, max probes: %i\n", routeCnt, routeMaxProbes);
+
+    httpServer.addHandler(new RouteTableHandler());
+}
+
+void http_routes_generate_sysinfo_json(Print &out)
+{
+    out.print("  , \"routeCnt\": " + String(routeTableCnt) + "\n");
+    out.print("  , \"routeMaxProbes\": " + String(routeMaxProbes) + "\n");
+    out.print("  , \"routeLookupCntr\": " + String(routeLookupCntr) + "\n");
+    if (routeLookupCntr)
+    {
+        out.print("  , \"routeLookupAvgCycles\": " + String(routeLookupCycles / routeLookupCntr) + "\n");
+    }
+    out.print("  , \"routeLookupMaxCycles\": " + String(routeLookupMaxCycles) + "\n");
+}
+#endif /* ENABLE_HTTP_SERVER */
@@ -0,0 +1,71 @@
+/**
+ * @file        http_routes.h
+ * @brief       Definitions of http_routes.cpp
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 17:58:40
+ * Last modify: 2026-10-16 17:58:40 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#ifndef INCLUDE_HTTP_ROUTES_H
+#define INCLUDE_HTTP_ROUTES_H
+
+#include <stdint.h>
+
+#include <Arduino.h>
+#include <ESP8266WebServer.h>
+
+#include "common.h"
+#include "config.h"
+
+#ifndef HTTP_ROUTE_BUCKET_CNT
+#define HTTP_ROUTE_BUCKET_CNT           32      /* Power of 2, at least twice the number of routes */
+#endif
+
+/* Method mask of routes */
+#define HTTP_ROUTE_METHOD(method)       (1u << (method))
+#define HTTP_ROUTE_GET                  HTTP_ROUTE_METHOD(HTTP_GET)
+#define HTTP_ROUTE_ANY                  0xFFu
+
+/* URI with its hash for route table */
+#define HTTP_ROUTE(uri)                 http_route_hash(uri), uri
+
+typedef enum
+{
+    HTTP_AUTH_PUBLIC,   /* Page is always available, like login page */
+    HTTP_AUTH_CONFIG    /* Decided by include/exclude_http_auth_pages.txt */
+} httpAuthPolicy_t;
+
+typedef struct
+{
+    uint32_t hash;              /* http_route_hash(uri) */
+    const char *uri;
+    uint8_t methods;            /* HTTP_ROUTE_... */
+    httpAuthPolicy_t auth;
+    const char *authPage;       /* Name in include/exclude_http_auth_pages.txt, NULL: uri */
+    void (*handler)();
+} httpRoute_t;
+
+/*
+ * FNV-1a hash of URI. It is evaluated by the compiler for route tables.
+ */
+constexpr uint32_t http_route_hash(const char *uri)
+{
+    uint32_t hash = 2166136261u;
+
+    while (*uri)
+    {
+        hash = (hash ^ static_cast<uint8_t>(*uri++)) * 16777619u;
+    }
+
+    return hash;
+}
+
+#if ENABLE_HTTP_SERVER
+extern void http_routes_init(const httpRoute_t *routes, uint8_t routeCnt);
+extern const httpRoute_t *http_routes_find(const String &uri);
+extern void http_routes_generate_sysinfo_json(Print &out);
+#endif
+
+#endif /* INCLUDE_HTTP_ROUTES_H */
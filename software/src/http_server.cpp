@@ -25,6 +25,16 @@
 #include "fileutils.h"
 #include "trace.h"
 #include "doorbell.h"
+#include "profile.h"
+#include "config_store.h"
+#include "scheduler.h"
+#include "http_events.h"
+#include "http_static.h"
+#include "doorbell_history.h"
+#include "http_routes.h"
+#include "mqtt_queue.h"
+#include "ring_multicast.h"
+#include "audio_transcode.h"
 
 #if ENABLE_HTTP_SERVER
 // need a WebServer for http access on port 80.
@@ -34,6 +44,7 @@ ESP8266HTTPUpdateServer httpUpdater;
 #endif
 uint32_t homepageRefreshInterval_sec = DEFAULT_HOMEPAGE_REFRESH_INTERVAL_SEC; /* First line of homepage_refresh_interval.txt */
 String homepageTitleStr = TITLE_STR;   /* First line of homepage_texts.txt */
+httpStreamStats_t httpStreamStats;
 #if ENABLE_HTTP_AUTH
 /* true: include HTTP pages of httpPages for authentication */
 /* false: exclude HTTP pages of httpPages for authentication */
@@ -47,120 +58,311 @@ uint32_t httpAuthPageNumber = 0;
 #if ENABLE_HTTP_SERVER
 // The text of builtin files are in this header file
 #include "builtinfiles.h"
+#include "html_templates.h"
 
-const String& html_link_to_index()
+const __FlashStringHelper *html_link_to_index()
 {
-    static const String str = String("<a href=\"" INDEX_HTM "\">Index</a>");
-    return str;
+    return FPSTR(htmlLinkToIndex);
 }
 
 #if ENABLE_FILE_TRACE
-const String& html_link_to_trace_log()
+const __FlashStringHelper *html_link_to_trace_log()
 {
-    static const String str = String("Trace log: <a href=\"" TRACE_FILE_NAME "\">" TRACE_FILE_NAME "</a>");
-    return str;
+    return FPSTR(htmlLinkToTraceLog);
 }
 #endif
 
-String& html_begin(bool a_scalable, String a_title, String a_heading,
-    int a_homepage_refresh_interval_sec , String a_homepage_redirect)
+HttpResponseStream::HttpResponseStream(ESP8266WebServer &server) : m_server(server)
 {
-    static String buf;
-    int refresh_sec = 0;
-    String redirectMsg = "";
+    m_len = 0;
+    m_started = false;
+    m_firstByteSent = false;
+    m_startTime_us = micros();
+    m_startFreeHeap = ESP.getFreeHeap();
+    m_minFreeHeap = m_startFreeHeap;
+    profile_begin(PROFILE_PAGE_LOAD);
+}
 
-    buf = "<!DOCTYPE html PUBLIC \"-//W3C//DTD XHTML 1.0 Strict//EN\"";
-    buf += "\"http://www.w3.org/TR/xhtml1/DTD/xhtml1-strict.dtd\">";
-    buf += "<html xmlns=\"http://www.w3.org/1999/xhtml\" lang=\"en\" xml:lang=\"en\">";
-    buf += "<head><meta http-equiv=\"content-type\" content=\"text/html; charset=utf-8\"/>";
-    if (a_homepage_refresh_interval_sec < 0 && homepageRefreshInterval_sec > 0)
-    {
-        refresh_sec = homepageRefreshInterval_sec;
-    }
-    else if (a_homepage_refresh_interval_sec > 0)
+HttpResponseStream::~HttpResponseStream()
+{
+    end();
+}
+
+/*
+ * Send status line and headers. Content is sent with chunked transfer
+ * encoding as the length is not known in advance.
+ */
+void HttpResponseStream::begin(int code, const char *contentType)
+{
+    m_server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    m_server.send(code, contentType, "");
+    m_started = true;
+    m_len = 0;
+}
+
+/*
+ * Send buffered content and terminate the response.
+ */
+void HttpResponseStream::end()
+{
+    uint32_t heapUsage;
+
+    if (m_started)
     {
-        refresh_sec = a_homepage_refresh_interval_sec;
+        sendBuffer();
+        /* Empty chunk marks end of content */
+        m_server.sendContent("");
+        m_started = false;
+
+        heapUsage = m_startFreeHeap - m_minFreeHeap;
+        httpStreamStats.requestCntr++;
+        httpStreamStats.lastPeakHeapUsage = heapUsage;
+        httpStreamStats.maxPeakHeapUsage = MAX(httpStreamStats.maxPeakHeapUsage, heapUsage);
+        httpStreamStats.lastResponseTime_us = micros() - m_startTime_us;
+        profile_end(PROFILE_PAGE_LOAD);
     }
-    if (refresh_sec > 0 || a_homepage_redirect.length())
+}
+
+void HttpResponseStream::sendBuffer()
+{
+    uint32_t freeHeap;
+
+    if (m_len)
     {
-        if (!a_homepage_redirect.length())
-        {
-            buf += "<meta http-equiv=\"refresh\" content=\"" + String(refresh_sec) + "\"/>"; // automatically reload in 60 seconds
-        }
-        else
+        m_server.sendContent(m_buf, m_len);
+        m_len = 0;
+        freeHeap = ESP.getFreeHeap();
+        m_minFreeHeap = MIN(m_minFreeHeap, freeHeap);
+        if (!m_firstByteSent)
         {
-            buf += "<meta http-equiv=\"refresh\" content=\"" + String(refresh_sec) + "; URL=" + a_homepage_redirect + "\" />";
-            redirectMsg = "You will be redirected to <a href=\"" + a_homepage_redirect + "\">";
-            redirectMsg += a_homepage_redirect + "</a> in " + sec2str(refresh_sec) + ".";
+            m_firstByteSent = true;
+            httpStreamStats.lastTimeToFirstByte_us = micros() - m_startTime_us;
+            httpStreamStats.maxTimeToFirstByte_us = MAX(httpStreamStats.maxTimeToFirstByte_us,
+                                                        httpStreamStats.lastTimeToFirstByte_us);
         }
     }
-    buf += "<meta name=\"mobile-web-app-capable\" content=\"yes\">";
-    if (!a_scalable)
-    {
-        buf += "<meta name=\"viewport\" content=\"user-scalable=no, width=device-width, initial-scale=1.2, maximum-scale=1.2\"/>";
-    }
-    buf += "<title>" + homepageTitleStr + "</title>";
-    buf += "<link Content-Type=\"text/css\" href=\"/style.css\" rel=\"stylesheet\" />";
-    buf += "</head><body>";
-    if (a_heading.length())
-    {
-        buf += "<h1>" + a_heading + "</h1>";
-    }
-    if (redirectMsg.length())
+}
+
+size_t HttpResponseStream::write(uint8_t c)
+{
+    return write(&c, 1);
+}
+
+size_t HttpResponseStream::write(const uint8_t *buffer, size_t size)
+{
+    size_t written = 0;
+    size_t len;
+
+    while (written < size)
     {
-        buf += "<p>" + redirectMsg + "</p>";
+        if (m_len == sizeof(m_buf))
+        {
+            sendBuffer();
+        }
+        len = MIN(size - written, sizeof(m_buf) - m_len);
+        memcpy(m_buf + m_len, buffer + written, len);
+        m_len += len;
+        written += len;
     }
 
-    return buf;
+    return written;
 }
 
-String& html_footer(bool enableTraceInfo)
+/*
+ * Write a template stored in flash. Constant parts are copied to out through
+ * a small stack buffer, slots are written by writer.
+ *
+ * @param[out] out      Output, typically HttpResponseStream.
+ * @param[in] tmpl      Template in PROGMEM, slots are marked by HTML_SLOT().
+ * @param[in] writer    Writer of slots, NULL: slots are left empty.
+ * @param[in] ctx       Passed to writer.
+ */
+void html_render(Print &out, PGM_P tmpl, htmlSlotWriter_t writer, const void *ctx)
 {
-    static String buf;
-    uint32_t uptime_sec = millis() / 1000;
+    uint8_t buf[64];
+    size_t len = 0;
+    uint8_t c;
 
-    buf = "<hr><p><small>";
-#if ENABLE_FILE_TRACE
-    if (enableTraceInfo)
+    while ((c = pgm_read_byte(tmpl++)) != 0)
     {
-        if (trace_file_enable_exists())
+        if (c == HTML_SLOT_MARKER)
         {
-            buf += "<b>Trace enabled";
-            if (trace_to_file_is_working())
+            if (len)
             {
-                buf += " and trace to file is working.";
+                out.write(buf, len);
+                len = 0;
             }
-            else
+            c = pgm_read_byte(tmpl++);
+            if (!c)
             {
-                buf += ", but trace to file is not working currently!";
+                break;
+            }
+            if (writer)
+            {
+                writer(out, c - '0', ctx);
             }
-            buf += "</b><br>";
-            buf += html_link_to_trace_log() + "<br>";
         }
         else
         {
-            if (trace_to_file_is_working())
+            buf[len++] = c;
+            if (len == sizeof(buf))
             {
-                buf += "<b>Trace disabled, but trace to file is still working!</b><br>";
-                buf += html_link_to_trace_log() + "<br>";
+                out.write(buf, len);
+                len = 0;
             }
         }
     }
+    if (len)
+    {
+        out.write(buf, len);
+    }
+}
+
+typedef struct
+{
+    bool scalable;
+    const String &title;
+    const String &heading;
+    int refresh_sec;
+    const String &redirect;
+} htmlBeginCtx_t;
+
+static void html_begin_slot(Print &out, uint8_t slot, const void *ctx)
+{
+    const htmlBeginCtx_t *page = static_cast<const htmlBeginCtx_t *>(ctx);
+
+    switch (slot)
+    {
+        case HTML_BEGIN_SLOT_REFRESH:
+            if (page->refresh_sec > 0 || page->redirect.length())
+            {
+                out.print(F("<meta http-equiv=\"refresh\" content=\""));
+                out.print(page->refresh_sec);
+                if (!page->redirect.length())
+                {
+                    out.print(F("\"/>")); // automatically reload in 60 seconds
+                }
+                else
+                {
+                    out.print(F("; URL="));
+                    out.print(page->redirect);
+                    out.print(F("\" />"));
+                }
+            }
+            break;
+        case HTML_BEGIN_SLOT_VIEWPORT:
+            if (!page->scalable)
+            {
+                out.print(FPSTR(htmlViewport));
+            }
+            break;
+        case HTML_BEGIN_SLOT_TITLE:
+            out.print(page->title);
+            break;
+        case HTML_BEGIN_SLOT_STYLE:
+            out.print(http_static_versioned_uri("/style.css"));
+            break;
+        case HTML_BEGIN_SLOT_HEADING:
+            if (page->heading.length())
+            {
+                out.print(F("<h1>"));
+                out.print(page->heading);
+                out.print(F("</h1>"));
+            }
+            break;
+        case HTML_BEGIN_SLOT_REDIRECT:
+            if (page->redirect.length())
+            {
+                out.print(F("<p>You will be redirected to <a href=\""));
+                out.print(page->redirect);
+                out.print(F("\">"));
+                out.print(page->redirect);
+                out.print(F("</a> in "));
+                out.print(sec2str(page->refresh_sec));
+                out.print(F(".</p>"));
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void html_begin(Print &out, bool a_scalable, const String &a_title, const String &a_heading,
+    int a_homepage_refresh_interval_sec, const String &a_homepage_redirect)
+{
+    int refresh_sec = 0;
+
+    if (a_homepage_refresh_interval_sec < 0 && homepageRefreshInterval_sec > 0)
+    {
+        refresh_sec = homepageRefreshInterval_sec;
+    }
+    else if (a_homepage_refresh_interval_sec > 0)
+    {
+        refresh_sec = a_homepage_refresh_interval_sec;
+    }
+
+    const htmlBeginCtx_t page = { a_scalable, a_title, a_heading, refresh_sec, a_homepage_redirect };
+    html_render(out, htmlBeginTemplate, html_begin_slot, &page);
+}
+
+static void html_footer_slot(Print &out, uint8_t slot, const void *ctx)
+{
+#if ENABLE_FILE_TRACE
+    bool enableTraceInfo = *static_cast<const bool *>(ctx);
+#endif
+
+    switch (slot)
+    {
+#if ENABLE_FILE_TRACE
+        case HTML_FOOTER_SLOT_TRACE_INFO:
+            if (enableTraceInfo)
+            {
+                if (trace_file_enable_exists())
+                {
+                    out.print(F("<b>Trace enabled"));
+                    if (trace_to_file_is_working())
+                    {
+                        out.print(F(" and trace to file is working."));
+                    }
+                    else
+                    {
+                        out.print(F(", but trace to file is not working currently!"));
+                    }
+                    out.print(F("</b><br>"));
+                    out.print(html_link_to_trace_log());
+                    out.print(F("<br>"));
+                }
+                else
+                {
+                    if (trace_to_file_is_working())
+                    {
+                        out.print(F("<b>Trace disabled, but trace to file is still working!</b><br>"));
+                        out.print(html_link_to_trace_log());
+                        out.print(F("<br>"));
+                    }
+                }
+            }
+            break;
 #endif
-    buf += "<a href=\"" ADMIN_HTM "\">Admin</a> | ";
-    buf += "Uptime: " + sec2str_short(uptime_sec) + " | ";
-    buf += "Hostname: <a href=\"http://" + hostname + "\">" + hostname + "</a><br>";
-    buf += "<br>";
-    buf += "Copyright (C) Peter Ivanov &lt;<a href=\"mailto:ivanovp@gmail.com\">ivanovp@gmail.com</a>&gt;, 2023, 2024.<br>";
-    buf += "</small></p>";
+        case HTML_FOOTER_SLOT_UPTIME:
+            out.print(sec2str_short(millis() / 1000));
+            break;
+        case HTML_FOOTER_SLOT_HOSTNAME:
+            out.print(hostname);
+            break;
+        default:
+            break;
+    }
+}
 
-    return buf;
+void html_footer(Print &out, bool enableTraceInfo)
+{
+    html_render(out, htmlFooterTemplate, html_footer_slot, &enableTraceInfo);
 }
 
-const String& html_end()
+void html_end(Print &out)
 {
-    static const String str = String("</body></html>");
-    return str;
+    out.print(FPSTR(htmlEnd));
 }
 
 void http_redirect_to_index()
@@ -170,14 +372,73 @@ void http_redirect_to_index()
     httpServer.send(301);
 }
 
+/* Pages which answer If-None-Match */
+typedef enum
+{
+    HTTP_ETAG_INDEX,
+    HTTP_ETAG_SYSINFO,
+    HTTP_ETAG_FILE_LIST,
+    HTTP_ETAG_PAGE_COUNT
+} httpEtagPage_t;
+
+static const char *httpEtagPageNames[HTTP_ETAG_PAGE_COUNT] = { "index", "sysinfo", "fileList" };
+static uint32_t etagBootId = 0;     /* ETags of previous run are not valid */
+static uint32_t etagCheckCntr[HTTP_ETAG_PAGE_COUNT];
+static uint32_t notModifiedCntr[HTTP_ETAG_PAGE_COUNT];
+
+/*
+ * Add a value to version of a page (FNV-1a).
+ */
+static uint32_t http_etag_mix(uint32_t version, uint32_t value)
+{
+    uint8_t i;
+
+    for (i = 0; i < 4; i++)
+    {
+        version ^= value & 0xFF;
+        version *= 16777619u;
+        value >>= 8;
+    }
+
+    return version;
+}
+
+/*
+ * Send ETag of a generated page and answer 304 if the client has the same
+ * version. It shall be called before any rendering work. ETags are weak:
+ * the page may differ in details, like uptime, which are not part of version.
+ *
+ * @param[in] page      Page to count.
+ * @param[in] version   Version of page content.
+ *
+ * @return true if 304 was sent, page shall not be generated.
+ */
+static bool http_send_etag(httpEtagPage_t page, uint32_t version)
+{
+    char etag[24];
+
+    snprintf(etag, sizeof(etag), "W/\"%08x%08x\"", static_cast<unsigned int>(etagBootId),
+             static_cast<unsigned int>(version));
+    etagCheckCntr[page]++;
+    httpServer.sendHeader("ETag", etag);
+    httpServer.sendHeader("Cache-Control", "no-cache");
+    if (httpServer.header("If-None-Match") == etag)
+    {
+        notModifiedCntr[page]++;
+        httpServer.send(304);
+        return true;
+    }
+
+    return false;
+}
+
 #if ENABLE_HTTP_AUTH
-// Check if header is present and correct
-bool http_is_authenticated(String htmPage)
+// Check if page is available without authentication according to httpAuthPages
+bool http_page_is_public(const String &htmPage)
 {
     bool ok = false;
     uint8_t i;
 
-    // TRACE("is_authenticated %s\n", htmPage.c_str());
     if (htmPage.length())
     {
         // TRACE("Auth page number: %i\n", httpAuthPageNumber);
@@ -193,7 +454,16 @@ bool http_is_authenticated(String htmPage)
             }
         }
     }
-    if (!ok && httpServer.hasHeader("Cookie"))
+
+    return ok;
+}
+
+// Check if session cookie is present and correct
+bool http_has_session()
+{
+    bool ok = false;
+
+    if (httpServer.hasHeader("Cookie"))
     {
         String cookie = httpServer.header("Cookie");
         // TRACE("Found cookie: %s\n", cookie.c_str());
@@ -212,11 +482,17 @@ bool http_is_authenticated(String htmPage)
     return ok;
 }
 
+// Check if page is available without authentication or session cookie is present
+bool http_is_authenticated(String htmPage)
+{
+    // TRACE("is_authenticated %s\n", htmPage.c_str());
+    return http_page_is_public(htmPage) || http_has_session();
+}
+
 // login page, also called for disconnect
 void http_server_handle_login_htm()
 {
     bool loginFailed = false;
-    static String buf;
     if (httpServer.hasArg("DISCONNECT"))
     {
         TRACE("Disconnection\n");
@@ -240,19 +516,19 @@ void http_server_handle_login_htm()
         loginFailed = true;
         ERROR("Log in failed!\n");
     }
-    buf = html_begin(false, homepageTitleStr, "Login");
+    HttpResponseStream out(httpServer);
+    out.begin(200, "text/html");
+    html_begin(out, false, homepageTitleStr, "Login");
     if (loginFailed)
     {
-        buf += "<p>Log in failed! Wrong username or password.</p>";
+        out.print("<p>Log in failed! Wrong username or password.</p>");
     }
-    buf += "<form action='" + String(LOGIN_HTM) + "' method='POST'>";
-    buf += "Username: <input type='text' name='USERNAME' placeholder='user name'><br>";
-    buf += "Password: <input type='password' name='PASSWORD' placeholder='password'><br>";
-    buf += "<input type='submit' name='SUBMIT' value='Submit'></form>";
-    buf += html_footer();
-    buf += html_end();
-
-    httpServer.send(200, "text/html", buf);
+    out.print("<form action='" LOGIN_HTM "' method='POST'>"
+              "Username: <input type='text' name='USERNAME' placeholder='user name'><br>"
+              "Password: <input type='password' name='PASSWORD' placeholder='password'><br>"
+              "<input type='submit' name='SUBMIT' value='Submit'></form>");
+    html_footer(out);
+    html_end(out);
 }
 
 void request_http_auth()
@@ -268,23 +544,39 @@ void request_http_auth()
  */
 void http_server_handle_index_htm()
 {
-    static String buf;
-
-#if ENABLE_HTTP_AUTH
-    if (!http_is_authenticated(INDEX_HTM))
+    /* Uptime in footer is refreshed once per minute. Page does not depend
+     * on files, so writes of the file system (history, trace) do not
+     * change its version. */
+    uint32_t version = http_etag_mix(2166136261u, millis() / 60000u);
+#if ENABLE_DOORBELL
+    version = http_etag_mix(version, doorbell_is_playing());
+#if DOORBELL_HISTORY_LENGTH > 0
+    version = http_etag_mix(version, doorbell_history_version());
+#endif
+#endif
+#if ENABLE_FILE_TRACE
+    version = http_etag_mix(version, trace_file_enable_exists());
+    version = http_etag_mix(version, trace_to_file_is_working());
+#endif
+    if (http_send_etag(HTTP_ETAG_INDEX, version))
     {
-        request_http_auth();
         return;
     }
-#endif
-
-    buf = html_begin();
-    buf += doorbell_generate_index_htm();
-    buf += html_footer();
-    buf += html_end();
 
-    httpServer.sendHeader("Cache-Control", "no-cache");
-    httpServer.send(200, "text/html; charset=utf-8", buf);
+    HttpResponseStream out(httpServer);
+    out.begin(200, "text/html; charset=utf-8");
+#if ENABLE_HTTP_EVENTS
+    /* Page is updated by events, it is not reloaded */
+    html_begin(out, false, homepageTitleStr, homepageTitleStr, 0);
+#else
+    html_begin(out);
+#endif
+    doorbell_generate_index_htm(out);
+#if ENABLE_HTTP_EVENTS
+    http_events_generate_script(out);
+#endif
+    html_footer(out);
+    html_end(out);
 }
 
 /*
@@ -292,58 +584,17 @@ void http_server_handle_index_htm()
  */
 void http_server_handle_admin_htm()
 {
-    static String buf;
-
-#if ENABLE_HTTP_AUTH
-    if (!http_is_authenticated(ADMIN_HTM))
-    {
-        request_http_auth();
-        return;
-    }
-#endif
-
-    buf = html_begin(false, "Admin", "Admin", 0);
-    buf += R"==(
-<p>The following pages are available:</p>
-<ul>
-  <li><a href="/index.htm">/index.htm</a> - Index page</li>
-  <li><a href="/admin.htm">/admin.htm</a> - This page</li>
-  <li><a href="/files.htm">/files.htm</a> - Manage files on the server</li>
-  <li><a href="/upload.htm">/upload.htm</a> - Built-in upload utility</a></li>)==";
-#if ENABLE_FIRMWARE_UPDATE
-    buf += "<li><a href=\"/update.htm\">/update.htm</a> - Firmware update</li>";
-#endif
-#if ENABLE_RESET
-    buf += "<li><a href=\"/reset.htm\">/reset.htm</a> - Board reset</li>";
-#endif
-#if ENABLE_FILE_TRACE
-    buf += "<li><a href=\"/file_trace.htm\">/file_trace.htm</a> - Enable/disable file trace</li>";
-#endif
-    buf += R"==(
-</ul>
-
-<p>The following REST services are available:</p>
-<ul>
-  <li><a href="/sysinfo.json">/sysinfo.json</a> - Some system level information</a></li>
-  <li><a href="/file_list.json">/file_list.json</a> - Array of all files</a></li>
-</ul>)==";
-    buf += html_footer();
-    buf += html_end();
-
+    HttpResponseStream out(httpServer);
     httpServer.sendHeader("Cache-Control", "no-cache");
-    httpServer.send(200, "text/html; charset=utf-8", buf);
+    out.begin(200, "text/html; charset=utf-8");
+    html_begin(out, false, "Admin", "Admin", 0);
+    out.print(FPSTR(adminContent));
+    html_footer(out);
+    html_end(out);
 }
 
 void http_server_handle_upload_htm()
 {
-#if ENABLE_HTTP_AUTH
-    if (!http_is_authenticated(UPLOAD_HTM))
-    {
-        request_http_auth();
-        return;
-    }
-#endif
-
     httpServer.sendHeader("Cache-Control", "no-cache");
     httpServer.send(200, "text/html", FPSTR(uploadContent));
 }
@@ -354,55 +605,43 @@ void http_server_handle_upload_htm()
  */
 void http_server_handle_reset_htm()
 {
-    String buf;
     String reset_confirmed;
-    String yes = "Yes, reset the board!";
+    const char *yes = "Yes, reset the board!";
     int refresh_sec = BOARD_RESET_TIME_MS / 1000 + 5;
 
-#if ENABLE_HTTP_AUTH
-    if (!http_is_authenticated(RESET_HTM))
+    if (httpServer.hasArg("reset_confirmed"))
     {
-        request_http_auth();
-        return;
+        reset_confirmed = httpServer.arg("reset_confirmed");
     }
-#endif
 
-    if (httpServer.hasArg("reset_confirmed"))
+    if (reset_confirmed.length() && reset_confirmed != yes)
     {
-        reset_confirmed = httpServer.arg("reset_confirmed");
+        http_redirect_to_index();
+        return;
     }
 
+    HttpResponseStream out(httpServer);
+    httpServer.sendHeader("Cache-Control", "no-cache");
+    out.begin(200, "text/html; charset=utf-8");
     if (reset_confirmed.length())
     {
-        if (reset_confirmed == yes)
-        {
-            buf = html_begin(false, homepageTitleStr, "Board reset", refresh_sec, INDEX_HTM);
-            buf += "<p>Board will be resetted in " + String(BOARD_RESET_TIME_MS) + " milliseconds...</p>";
-            buf += html_footer();
-            buf += html_end();
-
-            httpServer.sendHeader("Cache-Control", "no-cache");
-            httpServer.send(200, "text/html; charset=utf-8", buf);
+        html_begin(out, false, homepageTitleStr, "Board reset", refresh_sec, INDEX_HTM);
+        out.print("<p>Board will be resetted in " TOSTR(BOARD_RESET_TIME_MS) " milliseconds...</p>");
+        html_footer(out);
+        html_end(out);
 
-            board_reset = true;
-            board_reset_timestamp_ms = millis();
-        }
-        else
-        {
-            http_redirect_to_index();
-        }
+        board_reset = true;
+        board_reset_timestamp_ms = millis();
     }
     else
     {
-        buf = html_begin(false, homepageTitleStr, "Board reset");
-        buf += "<p>Are you sure you want to reset the board?</p>";
-        buf += "<form><input type=\"submit\" name=\"reset_confirmed\" value=\"" + yes + "\">&nbsp;";
-        buf += "<input type=\"submit\" name=\"reset_confirmed\" value=\"No\"></form>";
-        buf += html_footer();
-        buf += html_end();
-
-        httpServer.sendHeader("Cache-Control", "no-cache");
-        httpServer.send(200, "text/html; charset=utf-8", buf);
+        html_begin(out, false, homepageTitleStr, "Board reset");
+        out.print("<p>Are you sure you want to reset the board?</p>");
+        out.print("<form><input type=\"submit\" name=\"reset_confirmed\" value=\"");
+        out.print(yes);
+        out.print("\">&nbsp;<input type=\"submit\" name=\"reset_confirmed\" value=\"No\"></form>");
+        html_footer(out);
+        html_end(out);
     }
 }
 #endif
@@ -411,101 +650,96 @@ void http_server_handle_reset_htm()
 /*
  * It handles file trace enable/disable
  */
-void http_server_handle_file_trace_htm(ESP8266WebServer &httpServer, String requestUri)
+void http_server_handle_file_trace_htm()
 {
-    String buf;
     String enableFileTrace;
 
-#if ENABLE_HTTP_AUTH
-    if (!http_is_authenticated(FILE_TRACE_HTM))
-    {
-        request_http_auth();
-        return;
-    }
-#endif
     if (httpServer.hasArg("filetrace"))
     {
         enableFileTrace = httpServer.arg("filetrace");
     }
 
+    HttpResponseStream out(httpServer);
+    httpServer.sendHeader("Cache-Control", "no-cache");
+    out.begin(200, "text/html; charset=utf-8");
     if (enableFileTrace.length())
     {
-        buf = html_begin(false, homepageTitleStr, "Enabling/disabling file trace", 5, FILE_TRACE_HTM);
+        html_begin(out, false, homepageTitleStr, "Enabling/disabling file trace", 5, FILE_TRACE_HTM);
     }
     else
     {
-        buf = html_begin(false, homepageTitleStr, "Enabling/disabling file trace");
+        html_begin(out, false, homepageTitleStr, "Enabling/disabling file trace");
     }
-    buf += "<p>";
+    out.print("<p>");
     if (enableFileTrace.length())
     {
-        buf += "<large><b>";
+        out.print("<large><b>");
         if (enableFileTrace == "DISABLE")
         {
             if (trace_disable())
             {
-                buf += "File trace has been disabled.";
+                out.print("File trace has been disabled.");
             }
             else
             {
-                buf += "ERROR: cannot disable file trace!";
+                out.print("ERROR: cannot disable file trace!");
             }
         }
         else
         {
             if (trace_enable())
             {
-                buf += "File trace has been enabled.";
+                out.print("File trace has been enabled.");
             }
             else
             {
-                buf += "ERROR: cannot enable file trace!";
+                out.print("ERROR: cannot enable file trace!");
             }
         }
-        buf += "</b></large>";
+        out.print("</b></large>");
     }
     else
     {
         if (trace_file_enable_exists())
         {
-            // buf += "<p>" ENABLE_TRACE_FILE_NAME " file exists in the file system, ";
-            // buf += "trace to file is ENABLED.</p>";
-            buf += "Trace enabled";
+            // out.print("<p>" ENABLE_TRACE_FILE_NAME " file exists in the file system, ");
+            // out.print("trace to file is ENABLED.</p>");
+            out.print("Trace enabled");
             if (trace_to_file_is_working())
             {
-                buf += " and trace to file is working.";
+                out.print(" and trace to file is working.");
             }
             else
             {
-                buf += ", but trace to file is not working currently!";
+                out.print(", but trace to file is not working currently!");
             }
-            buf += "<br>";
-            buf += html_link_to_trace_log() + "<br>";
-            buf += "<form action=\"" FILE_TRACE_HTM "\">File trace: ";
-            buf += "<input type=\"submit\" name=\"filetrace\" value=\"DISABLE\"></form>";
+            out.print("<br>");
+            out.print(html_link_to_trace_log());
+            out.print("<br>");
+            out.print("<form action=\"" FILE_TRACE_HTM "\">File trace: ");
+            out.print("<input type=\"submit\" name=\"filetrace\" value=\"DISABLE\"></form>");
         }
         else
         {
-            // buf += "<p>" ENABLE_TRACE_FILE_NAME " file does not exist in the file system, ";
-            // buf += "trace to file is DISABLED.</p>";
-            buf += "Trace disabled";
+            // out.print("<p>" ENABLE_TRACE_FILE_NAME " file does not exist in the file system, ");
+            // out.print("trace to file is DISABLED.</p>");
+            out.print("Trace disabled");
             if (trace_to_file_is_working())
             {
-                buf += ", <b>but trace to file is still working!</b>";
+                out.print(", <b>but trace to file is still working!</b>");
             }
-            buf += "<br>";
-            buf += html_link_to_trace_log() + "<br>";
-            buf += "<form action=\"" FILE_TRACE_HTM "\">File trace: ";
-            buf += "<input type=\"submit\" name=\"filetrace\" value=\"ENABLE\"></form>";
+            out.print("<br>");
+            out.print(html_link_to_trace_log());
+            out.print("<br>");
+            out.print("<form action=\"" FILE_TRACE_HTM "\">File trace: ");
+            out.print("<input type=\"submit\" name=\"filetrace\" value=\"ENABLE\"></form>");
         }
     }
-    buf += "</p>";
-    buf += "<p>" + html_link_to_index() + "</p>";
-    buf += html_footer(false);
-    buf += html_end();
-
-    httpServer.sendHeader("Cache-Control", "no-cache");
-    httpServer.send(200, "text/html; charset=utf-8", buf);
+    out.print("</p><p>");
+    out.print(html_link_to_index());
+    out.print("</p>");
+    html_footer(out, false);
+    html_end(out);
 }
 #endif
 
@@ -513,84 +747,107 @@ void http_server_handle_file_trace_htm(ESP8266WebServer &httpServer, String requ
 // a JSON array with file information is returned.
 void http_server_handle_file_list_json()
 {
-    Dir dir = LittleFS.openDir("/");
-    static String result;
+    bool first = true;
 
-#if ENABLE_HTTP_AUTH
-    if (!http_is_authenticated(FILE_LIST_JSON))
+    if (http_send_etag(HTTP_ETAG_FILE_LIST, fs_generation()))
     {
-        request_http_auth();
         return;
     }
-#endif
 
-    result = "[\n";
+    Dir dir = LittleFS.openDir("/");
+    HttpResponseStream out(httpServer);
+    out.begin(200, "text/javascript; charset=utf-8");
+    out.print("[\n");
     while (dir.next())
     {
-        if (result.length() > 4)
+        if (!first)
         {
-            result += ",";
+            out.print(",");
         }
-        result += "  {";
-        result += " \"name\": \"" + dir.fileName() + "\", ";
-        result += " \"size\": " + String(dir.fileSize()) + ", ";
-        result += " \"time\": " + String(dir.fileTime());
-        result += " }\n";
+        first = false;
+        out.print("  { \"name\": \"");
+        out.print(dir.fileName());
+        out.print("\",  \"size\": ");
+        out.print(dir.fileSize());
+        out.print(",  \"time\": ");
+        out.print(dir.fileTime());
+        out.print(" }\n");
         // jc.addProperty("size", dir.fileSize());
     } // while
-    result += "]";
-    httpServer.sendHeader("Cache-Control", "no-cache");
-    httpServer.send(200, "text/javascript; charset=utf-8", result);
+    out.print("]");
 }
 
 // This function is called when the sysInfo service was requested.
 void http_server_handle_sysinfo_json()
 {
-    String result;
-
-#if ENABLE_HTTP_AUTH
-    if (!http_is_authenticated(SYSINFO_JSON))
+    /* Counters change continuously, a snapshot is valid for one second */
+    if (http_send_etag(HTTP_ETAG_SYSINFO, millis() / 1000u))
     {
-        request_http_auth();
         return;
     }
-#endif
 
     FSInfo fs_info;
     LittleFS.info(fs_info);
 
-    result = "{\n"
-             "  \"firmwareVersionMajor\": " TOSTR(VERSION_MAJOR) "\n"
-             "  , \"firmwareVersionMinor\": " TOSTR(VERSION_MINOR) "\n"
-             "  , \"firmwareVersionRevision\": " TOSTR(VERSION_REVISION) "\n"
-             "  , \"compileDate\": \"" __DATE__ "\"\n"
-             "  , \"compileTime\": \"" __TIME__ "\"\n";
+    HttpResponseStream out(httpServer);
+    out.begin(200, "text/javascript; charset=utf-8");
+
+    out.print("{\n"
+              "  \"firmwareVersionMajor\": " TOSTR(VERSION_MAJOR) "\n"
+              "  , \"firmwareVersionMinor\": " TOSTR(VERSION_MINOR) "\n"
+              "  , \"firmwareVersionRevision\": " TOSTR(VERSION_REVISION) "\n"
+              "  , \"compileDate\": \"" __DATE__ "\"\n"
+              "  , \"compileTime\": \"" __TIME__ "\"\n");
 #if HW_TYPE == HW_TYPE_ESP01
-    result += "  , \"hwType\": \"ESP01\"\n";
+    out.print("  , \"hwType\": \"ESP01\"\n");
 #elif HW_TYPE == HW_TYPE_ESP201
-    result += "  , \"hwType\": \"ESP201\"\n";
+    out.print("  , \"hwType\": \"ESP201\"\n");
 #elif HW_TYPE == HW_TYPE_WEMOS_D1_MINI
-    result += "  , \"hwType\": \"WEMOS_D1_MINI\"\n";
+    out.print("  , \"hwType\": \"WEMOS_D1_MINI\"\n");
 #elif HW_TYPE == HW_TYPE_ESP12F
-    result += "  , \"hwType\": \"ESP12F\"\n";
+    out.print("  , \"hwType\": \"ESP12F\"\n");
 #else
-    result += "  , \"hwType\": \"unknown\"\n";
-#endif
-    result += "  , \"hostName\": \"" + String(WiFi.getHostname()) + "\"\n";
-    result += "  , \"macAddress\": \"" + WiFi.macAddress() + "\"\n";
-    result += "  , \"ipAddress\": \"" + WiFi.localIP().toString() + "\"\n";
-    result += "  , \"ipMask\": \"" + WiFi.subnetMask().toString() + "\"\n";
-    result += "  , \"dnsIp\": \"" + WiFi.dnsIP().toString() + "\"\n";
-    result += "  , \"flashSize\": " + String(ESP.getFlashChipSize()) + "\n";
-    result += "  , \"freeHeap\": " + String(ESP.getFreeHeap()) + "\n";
-    result += "  , \"fsTotalBytes\": " + String(fs_info.totalBytes) + "\n";
-    result += "  , \"fsUsedBytes\": " + String(fs_info.usedBytes) + "\n";
-    result += "  , \"uptime_ms\": " + String(millis()) + "\n";
-    result += "  , \"doorbell\": 1\n"
+    out.print("  , \"hwType\": \"unknown\"\n");
+#endif
+    out.print("  , \"hostName\": \"" + String(WiFi.getHostname()) + "\"\n");
+    out.print("  , \"macAddress\": \"" + WiFi.macAddress() + "\"\n");
+    out.print("  , \"ipAddress\": \"" + WiFi.localIP().toString() + "\"\n");
+    out.print("  , \"ipMask\": \"" + WiFi.subnetMask().toString() + "\"\n");
+    out.print("  , \"dnsIp\": \"" + WiFi.dnsIP().toString() + "\"\n");
+    out.print("  , \"flashSize\": " + String(ESP.getFlashChipSize()) + "\n");
+    out.print("  , \"freeHeap\": " + String(ESP.getFreeHeap()) + "\n");
+    out.print("  , \"maxFreeBlockSize\": " + String(ESP.getMaxFreeBlockSize()) + "\n");
+    out.print("  , \"heapFragmentation\": " + String(ESP.getHeapFragmentation()) + "\n");
+    out.print("  , \"fsTotalBytes\": " + String(fs_info.totalBytes) + "\n");
+    out.print("  , \"fsUsedBytes\": " + String(fs_info.usedBytes) + "\n");
+    out.print("  , \"uptime_ms\": " + String(millis()) + "\n");
+    out.print("  , \"loopMaxTime_us\": " + String(loopMaxTime_us) + "\n");
+    out.print("  , \"configFileOpenCntr\": " + String(config_store_file_open_cntr()) + "\n");
+#if ENABLE_MQTT_CLIENT
+    out.print("  , \"mqttConnected\": " + String(mqttClient.connected()) + "\n");
+    out.print("  , \"mqttConnectRetry_ms\": " + String(mqtt_connect_retry_ms) + "\n");
+    out.print("  , \"mqttTaskMaxTime_us\": " + String(mqttTaskMaxTime_us) + "\n");
+    mqtt_queue_generate_sysinfo_json(out);
+#endif
+#if ENABLE_RING_MULTICAST
+    ring_multicast_generate_sysinfo_json(out);
+#endif
+#if ENABLE_AUDIO_TRANSCODE
+    audio_transcode_generate_sysinfo_json(out);
+#endif
+    out.print("  , \"httpRequestCntr\": " + String(httpStreamStats.requestCntr) + "\n");
+    out.print("  , \"httpLastPeakHeapUsage\": " + String(httpStreamStats.lastPeakHeapUsage) + "\n");
+    out.print("  , \"httpMaxPeakHeapUsage\": " + String(httpStreamStats.maxPeakHeapUsage) + "\n");
+    out.print("  , \"httpLastTimeToFirstByte_us\": " + String(httpStreamStats.lastTimeToFirstByte_us) + "\n");
+    out.print("  , \"httpMaxTimeToFirstByte_us\": " + String(httpStreamStats.maxTimeToFirstByte_us) + "\n");
+    out.print("  , \"httpLastResponseTime_us\": " + String(httpStreamStats.lastResponseTime_us) + "\n");
+    out.print("  , \"doorbell\": 1\n"
               "  , \"doorbellAudioFileName\": \"" DOORBELL_AUDIO_FILE_NAME "\"\n"
               "  , \"doorbellAudioPlayCount\": " TOSTR(DOORBELL_AUDIO_PLAY_COUNT) "\n"
               "  , \"doorbellAudioPlayDelay_ms\": " TOSTR(DOORBELL_AUDIO_PLAY_DELAY_MS) "\n"
-              "  , \"doorbellSwitchPin\": " TOSTR(DOORBELL_SWITCH_PIN) "\n"
+              "  , \"doorbellSwitchPin\": " TOSTR(DOORBELL_SWITCH_PIN) "\n");
+    doorbell_generate_sysinfo_json(out);
+    out.print(""
 #if ENABLE_MQTT_CLIENT
               "  , \"mqttClient\": 1\n"
 #endif
@@ -618,14 +875,83 @@ void http_server_handle_sysinfo_json()
 #ifdef ENABLE_TRACE_MS_TIMESAMP
               "  , \"enableTraceMsTimestamp\": " TOSTR(ENABLE_TRACE_MS_TIMESAMP) "\n"
 #endif
-              ;
-    result += "  , \"traceToFileIsWorking\": " + String(trace_to_file_is_working()) + "\n";
+              );
+    out.print("  , \"traceToFileIsWorking\": " + String(trace_to_file_is_working()) + "\n");
 #endif /* ENABLE_FILE_TRACE*/
-    result += "}";
-    httpServer.sendHeader("Cache-Control", "no-cache");
-    httpServer.send(200, "text/javascript; charset=utf-8", result);
+    trace_generate_sysinfo_json(out);
+#if ENABLE_HTTP_EVENTS
+    http_events_generate_sysinfo_json(out);
+#endif
+#if ENABLE_HTTP_STATIC_GZIP
+    http_static_generate_sysinfo_json(out);
+#endif
+    http_routes_generate_sysinfo_json(out);
+    for (uint8_t page = 0; page < HTTP_ETAG_PAGE_COUNT; page++)
+    {
+        out.print(String("  , \"") + httpEtagPageNames[page] + "EtagCheckCntr\": " + String(etagCheckCntr[page]) + "\n");
+        out.print(String("  , \"") + httpEtagPageNames[page] + "NotModifiedCntr\": " + String(notModifiedCntr[page]) + "\n");
+    }
+#if ENABLE_BINARY_TRACE
+    trace_bin_generate_sysinfo_json(out);
+#endif
+    out.print("}");
 } // http_server_handle_sysinfo_json()
 
+// This function is called when the tasks service was requested.
+void http_server_handle_tasks_json()
+{
+    HttpResponseStream out(httpServer);
+    httpServer.sendHeader("Cache-Control", "no-cache");
+    out.begin(200, "application/json");
+    out.print("{\n  \"tasks\": ");
+    scheduler_generate_json(out);
+    out.print("\n  , \"loopMaxTime_us\": " + String(loopMaxTime_us) + "\n");
+#if ENABLE_DOORBELL
+    out.print("  , \"maxAudioLoopGap_us\": " + String(doorbell_max_audio_loop_gap_us()) + "\n");
+#endif
+    out.print("}");
+} // http_server_handle_tasks_json()
+
+// This function is called when the config service was requested.
+void http_server_handle_config_json()
+{
+    HttpResponseStream out(httpServer);
+    httpServer.sendHeader("Cache-Control", "no-cache");
+    out.begin(200, "application/json");
+    config_generate_json(out);
+} // http_server_handle_config_json()
+
+#if ENABLE_BINARY_TRACE
+// Binary trace records formatted as text.
+void http_server_handle_trace_bin_txt()
+{
+    HttpResponseStream out(httpServer);
+    httpServer.sendHeader("Cache-Control", "no-cache");
+    out.begin(200, "text/plain; charset=utf-8");
+    trace_bin_generate_text(out);
+}
+
+// Raw binary trace records.
+void http_server_handle_trace_bin_bin()
+{
+    HttpResponseStream out(httpServer);
+    httpServer.sendHeader("Cache-Control", "no-cache");
+    out.begin(200, "application/octet-stream");
+    trace_bin_dump(out);
+}
+#endif
+
+#if ENABLE_PROFILE
+// This function is called when the profile service was requested.
+void http_server_handle_profile_json()
+{
+    HttpResponseStream out(httpServer);
+    httpServer.sendHeader("Cache-Control", "no-cache");
+    out.begin(200, "application/json");
+    profile_generate_json(out);
+} // http_server_handle_profile_json()
+#endif
+
 
 // ===== Request Handler class used to answer more complex requests =====
 
@@ -643,33 +969,13 @@ public:
     }
 
     // @brief check incoming request. Can handle POST for uploads and DELETE.
+    // Generated pages are handled by the route table.
     // @param requestMethod method of the http request line.
     // @param requestUri request ressource from the http request line.
     // @return true when method can be handled.
-    bool canHandle(HTTPMethod requestMethod, const String &requestUri) override
+    bool canHandle(HTTPMethod requestMethod, const String UNUSED &requestUri) override
     {
-        bool can = false;
-
-        if (requestMethod == HTTP_POST)
-        {
-            can = true;
-        }
-        else if (requestMethod == HTTP_DELETE)
-        {
-            can = true;
-        }
-        else if ((requestMethod == HTTP_GET) && (requestUri == DOORBELL_HTM))
-        {
-            can = true;
-        }
-#if ENABLE_FILE_TRACE
-        else if ((requestMethod == HTTP_GET) && (requestUri == FILE_TRACE_HTM))
-        {
-            can = true;
-        }
-#endif
-
-        return can;
+        return (requestMethod == HTTP_POST) || (requestMethod == HTTP_DELETE);
     } // canHandle()
 
     bool canUpload(const String &uri) override
@@ -692,39 +998,19 @@ public:
         {
             // all done in upload. no other forms.
         }
-        else if (requestMethod == HTTP_GET)
-        {
-            if (requestUri == DOORBELL_HTM)
-            {
-                doorbell_handle_doorbell_htm(httpServer, requestUri);
-            }
-            else
-#if ENABLE_FILE_TRACE
-            if (requestUri == FILE_TRACE_HTM)
-            {
-                http_server_handle_file_trace_htm(httpServer, requestUri);
-            }
-            else
-#endif
-            {
-#if ENABLE_HTTP_AUTH
-                if (!http_is_authenticated(requestUri))
-                {
-                    request_http_auth();
-                    return true;
-                }
-#endif
-                return RequestHandler::handle(httpServer, requestMethod, requestUri);
-            }
-        }
         else if (requestMethod == HTTP_DELETE)
         {
             TRACE("Deleting %s... ", fileName.c_str());
+            http_static_invalidate(fileName);
+            fs_changed();
             if (LittleFS.exists(fileName))
             {
                 if (LittleFS.remove(fileName))
                 {
                     TRACE("Done.\n");
+#if ENABLE_DOORBELL
+                    doorbell_audio_file_changed(fileName);
+#endif
                 }
                 else
                 {
@@ -754,33 +1040,68 @@ public:
 
         if (upload.status == UPLOAD_FILE_START)
         {
+            profile_begin(PROFILE_UPLOAD);
+            http_static_invalidate(fileName);
             // Open the file
             if (LittleFS.exists(fileName))
             {
                 LittleFS.remove(fileName);
             }
             m_fsUploadFile = LittleFS.open(fileName, "w");
+            fs_changed();
+#if ENABLE_DOORBELL
+            // Audio file shall not be open while it is written
+            doorbell_audio_file_changed(fileName);
+#endif
+#if ENABLE_AUDIO_TRANSCODE
+            // WAV files are converted to playback format while they are written
+            m_transcode = audio_transcode_begin(fileName);
+#endif
         }
         else if (upload.status == UPLOAD_FILE_WRITE)
         {
             // Write received bytes
             if (m_fsUploadFile)
             {
-                m_fsUploadFile.write(upload.buf, upload.currentSize);
+#if ENABLE_AUDIO_TRANSCODE
+                if (m_transcode)
+                {
+                    profile_fs_write(audio_transcode_write(m_fsUploadFile, upload.buf, upload.currentSize));
+                }
+                else
+#endif
+                {
+                    profile_fs_write(m_fsUploadFile.write(upload.buf, upload.currentSize));
+                }
             }
         }
-        else if (upload.status == UPLOAD_FILE_END)
+        else if (upload.status == UPLOAD_FILE_END || upload.status == UPLOAD_FILE_ABORTED)
         {
             // Close the file
             if (m_fsUploadFile)
             {
+#if ENABLE_AUDIO_TRANSCODE
+                if (m_transcode)
+                {
+                    profile_fs_write(audio_transcode_end(m_fsUploadFile));
+                    m_transcode = false;
+                }
+#endif
                 m_fsUploadFile.close();
+                fs_changed();
+#if ENABLE_DOORBELL
+                doorbell_audio_file_changed(fileName);
+#endif
             }
+            profile_end(PROFILE_UPLOAD);
         }
     } // upload()
 
 protected:
     File m_fsUploadFile;
+#if ENABLE_AUDIO_TRANSCODE
+    bool m_transcode = false;
+#endif
 };
 
 #if ENABLE_HTTP_AUTH
@@ -794,7 +1115,7 @@ static void http_auth_init()
     else if (LittleFS.exists("/exclude_http_auth_pages.txt"))
     {
         includeHttpAuthPages = false;
-        httpAuthPageNumber = readStringsFromFile("/include_http_auth_pages.txt", 0, httpAuthPages, MAX_AUTH_PAGES);
+        httpAuthPageNumber = readStringsFromFile("/exclude_http_auth_pages.txt", 0, httpAuthPages, MAX_AUTH_PAGES);
     }
     else
     {
@@ -807,10 +1128,56 @@ static void http_auth_init()
 }
 #endif
 
-void http_server_init(void)
+// Request headers used by handlers, other headers are dropped by the server
+static const char *collectedHeaders[] =
+{
+    "Accept-Encoding",
+    "If-None-Match",
+#if ENABLE_HTTP_AUTH
+    "User-Agent",
+    "Cookie",
+#endif
+};
+
+// Generated pages and REST services
+static const httpRoute_t httpRoutes[] =
 {
-    String str;
+    { HTTP_ROUTE("/"),              HTTP_ROUTE_GET, HTTP_AUTH_CONFIG, INDEX_HTM, http_server_handle_index_htm },
+    { HTTP_ROUTE(INDEX_HTM),        HTTP_ROUTE_GET, HTTP_AUTH_CONFIG, NULL,      http_server_handle_index_htm },
+    { HTTP_ROUTE(ADMIN_HTM),        HTTP_ROUTE_GET, HTTP_AUTH_CONFIG, NULL,      http_server_handle_admin_htm },
+    // serve a built-in htm page
+    { HTTP_ROUTE(UPLOAD_HTM),       HTTP_ROUTE_ANY, HTTP_AUTH_CONFIG, NULL,      http_server_handle_upload_htm },
+#if ENABLE_RESET
+    { HTTP_ROUTE(RESET_HTM),        HTTP_ROUTE_GET, HTTP_AUTH_CONFIG, NULL,      http_server_handle_reset_htm },
+#endif
+#if ENABLE_HTTP_AUTH
+    { HTTP_ROUTE(LOGIN_HTM),        HTTP_ROUTE_ANY, HTTP_AUTH_PUBLIC, NULL,      http_server_handle_login_htm },
+#endif
+#if ENABLE_DOORBELL
+    { HTTP_ROUTE(DOORBELL_HTM),     HTTP_ROUTE_GET, HTTP_AUTH_CONFIG, NULL,      doorbell_handle_doorbell_htm },
+#endif
+#if ENABLE_FILE_TRACE
+    { HTTP_ROUTE(FILE_TRACE_HTM),   HTTP_ROUTE_GET, HTTP_AUTH_CONFIG, NULL,      http_server_handle_file_trace_htm },
+#endif
+    { HTTP_ROUTE(FILE_LIST_JSON),   HTTP_ROUTE_GET, HTTP_AUTH_CONFIG, NULL,      http_server_handle_file_list_json },
+    { HTTP_ROUTE(SYSINFO_JSON),     HTTP_ROUTE_GET, HTTP_AUTH_CONFIG, NULL,      http_server_handle_sysinfo_json },
+    { HTTP_ROUTE(CONFIG_JSON),      HTTP_ROUTE_GET, HTTP_AUTH_CONFIG, NULL,      http_server_handle_config_json },
+    { HTTP_ROUTE(TASKS_JSON),       HTTP_ROUTE_GET, HTTP_AUTH_CONFIG, NULL,      http_server_handle_tasks_json },
+#if ENABLE_HTTP_EVENTS
+    { HTTP_ROUTE(EVENTS_URI),       HTTP_ROUTE_GET, HTTP_AUTH_CONFIG, NULL,      http_events_handle_subscribe },
+#endif
+#if ENABLE_BINARY_TRACE
+    { HTTP_ROUTE(TRACE_BIN_TXT),    HTTP_ROUTE_GET, HTTP_AUTH_CONFIG, NULL,      http_server_handle_trace_bin_txt },
+    { HTTP_ROUTE(TRACE_BIN_BIN),    HTTP_ROUTE_GET, HTTP_AUTH_CONFIG, NULL,      http_server_handle_trace_bin_bin },
+#endif
+#if ENABLE_PROFILE
+    { HTTP_ROUTE(PROFILE_JSON),     HTTP_ROUTE_GET, HTTP_AUTH_CONFIG, NULL,      http_server_handle_profile_json },
+#endif
+};
 
+void http_server_init(void)
+{
+    etagBootId = ESP.random();
 #if ENABLE_FIRMWARE_UPDATE
     MDNS.begin(hostname);
     httpUpdater.setup(&httpServer, UPDATE_HTM
@@ -820,36 +1187,14 @@ void http_server_init(void)
     );
 #endif
 
-    str = readStringFromFile("/homepage_refresh_interval.txt");
-    if (!str.isEmpty())
-    {
-        homepageRefreshInterval_sec = str.toInt();
-        TRACE("Setting homepage refresh interval to %i seconds...\n", homepageRefreshInterval_sec);
-    }
-
-    str = readStringFromFile("/homepage_texts.txt");
-    if (!str.isEmpty())
-    {
-        homepageTitleStr = str;
-        TRACE("Setting homepage title to '%s'...\n", homepageTitleStr.c_str());
-    }
+    homepageRefreshInterval_sec = config_get_int(CONFIG_HOMEPAGE_REFRESH_INTERVAL);
+    homepageTitleStr = config_get_str(CONFIG_HOMEPAGE_TITLE);
 
-    // serve a built-in htm page
-    httpServer.on(UPLOAD_HTM, http_server_handle_upload_htm);
-
-    httpServer.on("/", HTTP_GET, http_server_handle_index_htm);
-    httpServer.on(INDEX_HTM, HTTP_GET, http_server_handle_index_htm);
-    httpServer.on(ADMIN_HTM, HTTP_GET, http_server_handle_admin_htm);
-#if ENABLE_RESET
-    httpServer.on(RESET_HTM, HTTP_GET, http_server_handle_reset_htm);
-#endif
 #if ENABLE_HTTP_AUTH
-    httpServer.on(LOGIN_HTM, http_server_handle_login_htm);
+    http_auth_init();
 #endif
-
-    // register some REST services
-    httpServer.on(FILE_LIST_JSON, HTTP_GET, http_server_handle_file_list_json);
-    httpServer.on(SYSINFO_JSON, HTTP_GET, http_server_handle_sysinfo_json);
+    // generated pages and REST services
+    http_routes_init(httpRoutes, sizeof(httpRoutes) / sizeof(httpRoutes[0]));
 
     // UPLOAD and DELETE of files in the file system using a request handler.
     httpServer.addHandler(new FileServerHandler());
@@ -860,10 +1205,11 @@ void http_server_init(void)
     // enable ETAG header in webserver results from serveStatic handler
     httpServer.enableETag(true);
 
-#if ENABLE_HTTP_AUTH
     // ask server to track these headers
-    httpServer.collectHeaders("User-Agent", "Cookie");
-    http_auth_init();
+    httpServer.collectHeaders(collectedHeaders, sizeof(collectedHeaders) / sizeof(collectedHeaders[0]));
+#if ENABLE_HTTP_STATIC_GZIP
+    // serve compressed assets of gz_manifest.txt
+    http_static_init();
 #endif
     // serve all static files
     httpServer.serveStatic("/", LittleFS, "/");
@@ -29,6 +29,12 @@
 #define UPLOAD_HTM      "/upload.htm"
 #define FILE_LIST_JSON  "/file_list.json"
 #define SYSINFO_JSON    "/sysinfo.json"
+#define CONFIG_JSON     "/config.json"
+#define TASKS_JSON      "/tasks.json"
+
+#if ENABLE_PROFILE
+#define PROFILE_JSON    "/profile.json"
+#endif
 
 #if ENABLE_DOORBELL
 #define DOORBELL_HTM "/doorbell.htm"
@@ -36,6 +42,10 @@
 #if ENABLE_FILE_TRACE
 #define FILE_TRACE_HTM "/file_trace.htm"
 #endif
+#if ENABLE_BINARY_TRACE
+#define TRACE_BIN_TXT   "/trace_bin.txt"
+#define TRACE_BIN_BIN   "/trace_bin.bin"
+#endif
 #if ENABLE_HTTP_AUTH
 #define LOGIN_HTM   "/login.htm"
 #endif
@@ -46,22 +56,84 @@
 #define RESET_HTM   "/reset.htm"
 #endif
 
-#define TITLE_STR "Doorbell"
+/* Generated pages are sent in chunks of this size */
+#define HTTP_STREAM_BUF_SIZE    512
+
+/* Dynamic part of a template, n: 0..9. See html_render(). */
+#define HTML_SLOT_MARKER        '\x1b'
+#define HTML_SLOT(n)            "\x1b" TOSTR(n)
 
 #if ENABLE_HTTP_SERVER
 extern ESP8266WebServer httpServer;
 extern String homepageTitleStr;   /* First line of homepage_texts.txt */
+extern uint32_t homepageRefreshInterval_sec;
+
+
+typedef struct
+{
+    uint32_t requestCntr;               /* Number of generated responses */
+    uint32_t lastPeakHeapUsage;         /* Heap used while last response was generated */
+    uint32_t maxPeakHeapUsage;
+    uint32_t lastTimeToFirstByte_us;    /* Time until first chunk of content was sent */
+    uint32_t maxTimeToFirstByte_us;
+    uint32_t lastResponseTime_us;       /* Time to generate and send last response */
+} httpStreamStats_t;
+extern httpStreamStats_t httpStreamStats;
+
+/*
+ * Response writer for generated pages. Content is collected in a small buffer
+ * and sent with chunked transfer encoding when the buffer is full, so the
+ * whole page is never held in the heap.
+ */
+class HttpResponseStream : public Print
+{
+public:
+    HttpResponseStream(ESP8266WebServer &server);
+    ~HttpResponseStream();
+
+    void begin(int code, const char *contentType);
+    void end();
+
+    virtual size_t write(uint8_t c) override;
+    virtual size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+
+protected:
+    void sendBuffer();
+
+    ESP8266WebServer &m_server;
+    char m_buf[HTTP_STREAM_BUF_SIZE];
+    size_t m_len;
+    bool m_started;
+    bool m_firstByteSent;
+    uint32_t m_startTime_us;
+    uint32_t m_startFreeHeap;
+    uint32_t m_minFreeHeap;
+};
+
+/*
+ * Write dynamic part of a template.
+ *
+ * @param[out] out  Output.
+ * @param[in] slot  Number of slot given to HTML_SLOT().
+ * @param[in] ctx   Context given to html_render().
+ */
+typedef void (*htmlSlotWriter_t)(Print &out, uint8_t slot, const void *ctx);
 
-extern const String& html_link_to_index();
+extern void html_render(Print &out, PGM_P tmpl, htmlSlotWriter_t writer = NULL, const void *ctx = NULL);
+extern const __FlashStringHelper *html_link_to_index();
 #if ENABLE_FILE_TRACE
-extern const String& html_link_to_trace_log();
+extern const __FlashStringHelper *html_link_to_trace_log();
 #endif
-extern String& html_begin(bool a_scalable=false, String a_title=homepageTitleStr, String a_heading=homepageTitleStr,
-    int a_homepage_refresh_interval_sec = -1, String a_homepage_redirect="");
-extern String& html_footer(bool enableTraceInfo=true);
-extern const String& html_end();
+extern void html_begin(Print &out, bool a_scalable=false, const String &a_title=homepageTitleStr,
+    const String &a_heading=homepageTitleStr, int a_homepage_refresh_interval_sec = -1,
+    const String &a_homepage_redirect="");
+extern void html_footer(Print &out, bool enableTraceInfo=true);
+extern void html_end(Print &out);
 extern void http_redirect_to_index();
 #if ENABLE_HTTP_AUTH
+extern bool http_page_is_public(const String &htmPage);
+extern bool http_has_session();
 extern bool http_is_authenticated(String htmPage="");
 extern void http_server_handle_login_htm();
 extern void request_http_auth();
@@ -0,0 +1,247 @@
+/**
+ * @file        http_static.cpp
+ * @brief       Pre-gzipped static assets
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 17:05:12
+ * Last modify: 2026-10-16 17:05:12 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * tools/gzip_data.py compresses the web assets of data/ before the file
+ * system image is made and lists them with their content hash in
+ * gz_manifest.txt. Assets of the manifest are served by this handler:
+ * the .gz sibling is sent when the client accepts gzip, the content hash is
+ * used as ETag and requests with matching "?v=<hash>" can be cached forever.
+ * Other files are served by serveStatic() as before.
+ */
+
+#include <Arduino.h>
+#include <ESP8266WebServer.h>
+#include <detail/mimetable.h>
+
+#include "common.h"
+#include "config.h"
+#include "trace.h"
+#include "fileutils.h"
+#include "http_server.h"
+#include "http_static.h"
+
+#include <FS.h>       // File System for Web Server Files
+#include <LittleFS.h> // This file system is used.
+
+#if ENABLE_HTTP_SERVER && ENABLE_HTTP_STATIC_GZIP
+typedef struct
+{
+    String uri;                                 /* Example: "/style.css" */
+    char hash[HTTP_STATIC_HASH_LENGTH + 1];     /* Empty: file was changed, it is not served from here */
+    bool gzipped;                               /* true: uri + ".gz" exists */
+    uint32_t savedBytes;                        /* Size of original - size of .gz */
+} httpStaticAsset_t;
+
+static httpStaticAsset_t assets[HTTP_STATIC_MAX_FILES];
+static uint8_t assetCnt = 0;
+static uint32_t gzipCntr = 0;           /* Responses with compressed content */
+static uint32_t plainCntr = 0;          /* Responses to clients without gzip support */
+static uint32_t notModifiedCntr = 0;    /* 304 responses */
+static uint32_t savedBytes = 0;         /* Bytes not sent due to compression */
+
+static int8_t http_static_find(const String &uri)
+{
+    uint8_t i;
+
+    for (i = 0; i < assetCnt; i++)
+    {
+        if (assets[i].hash[0] && assets[i].uri == uri)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/*
+ * Read gz_manifest.txt. Format of lines: "<uri> <hash>".
+ */
+static void http_static_load_manifest()
+{
+    String line;
+    int idx;
+
+    assetCnt = 0;
+    File file = LittleFS.open(HTTP_STATIC_MANIFEST, "r");
+    if (!file)
+    {
+        TRACE("No %s, assets are served uncompressed\n", HTTP_STATIC_MANIFEST);
+        return;
+    }
+
+    while (file.available() && assetCnt < HTTP_STATIC_MAX_FILES)
+    {
+        line = file.readStringUntil('\n');
+        trimLine(line);
+        idx = line.indexOf(' ');
+        if (idx <= 0 || line.length() - idx - 1 != HTTP_STATIC_HASH_LENGTH)
+        {
+            continue;
+        }
+        httpStaticAsset_t &asset = assets[assetCnt];
+        asset.uri = line.substring(0, idx);
+        strncpy(asset.hash, line.c_str() + idx + 1, sizeof(asset.hash));
+        asset.gzipped = LittleFS.exists(asset.uri + ".gz");
+        asset.savedBytes = 0;
+        if (asset.gzipped)
+        {
+            asset.savedBytes = fileSize(asset.uri) - MIN(fileSize(asset.uri), fileSize(asset.uri + ".gz"));
+        }
+        TRACE("Asset %s hash: %s gzip: %i\n", asset.uri.c_str(), asset.hash, asset.gzipped);
+        assetCnt++;
+    }
+    file.close();
+}
+
+class StaticAssetHandler : public RequestHandler
+{
+public:
+    bool canHandle(HTTPMethod requestMethod, const String &requestUri) override
+    {
+        return (requestMethod == HTTP_GET) && (http_static_find(requestUri) >= 0);
+    }
+
+    bool handle(ESP8266WebServer &server, HTTPMethod requestMethod, const String &requestUri) override
+    {
+        int8_t idx = http_static_find(requestUri);
+        String etag;
+        String path;
+        bool acceptGzip;
+
+        if (requestMethod != HTTP_GET || idx < 0)
+        {
+            return false;
+        }
+        httpStaticAsset_t &asset = assets[idx];
+
+        etag = "\"";
+        etag += asset.hash;
+        etag += "\"";
+        server.sendHeader("ETag", etag);
+        server.sendHeader("Vary", "Accept-Encoding");
+        if (server.hasArg("v") && server.arg("v") == asset.hash)
+        {
+            server.sendHeader("Cache-Control", HTTP_STATIC_CACHE_IMMUTABLE);
+        }
+        else
+        {
+            // Unversioned URI: browser has to revalidate, but 304 is cheap
+            server.sendHeader("Cache-Control", "no-cache");
+        }
+        if (server.header("If-None-Match") == etag)
+        {
+            notModifiedCntr++;
+            server.send(304);
+            return true;
+        }
+
+        acceptGzip = server.header("Accept-Encoding").indexOf("gzip") >= 0;
+        path = asset.uri;
+        if (asset.gzipped && acceptGzip)
+        {
+            path += ".gz";
+        }
+        File file = LittleFS.open(path, "r");
+        if (!file)
+        {
+            ERROR("Cannot open %s!\n", path.c_str());
+            return false;
+        }
+        // Content-Encoding is added by streamFile() for .gz files
+        server.streamFile(file, mime::getContentType(asset.uri));
+        file.close();
+        if (asset.gzipped && acceptGzip)
+        {
+            gzipCntr++;
+            savedBytes += asset.savedBytes;
+        }
+        else
+        {
+            plainCntr++;
+        }
+
+        return true;
+    }
+};
+
+/*
+ * Load manifest and register handler. It shall be called before serveStatic().
+ */
+void http_static_init()
+{
+    http_static_load_manifest();
+    httpServer.addHandler(new StaticAssetHandler());
+}
+
+/*
+ * Append content hash to URI of an asset, so it can be cached forever.
+ *
+ * @param[in] uri   Example: "/style.css"
+ *
+ * @return Example: "/style.css?v=4abd67cd", uri if it is not in manifest.
+ */
+String http_static_versioned_uri(const char *uri)
+{
+    String versionedUri = uri;
+    int8_t idx = http_static_find(versionedUri);
+
+    if (idx >= 0)
+    {
+        versionedUri += "?v=";
+        versionedUri += assets[idx].hash;
+    }
+
+    return versionedUri;
+}
+
+/*
+ * File is uploaded or deleted: hash and .gz sibling are not valid anymore.
+ * The file is served by serveStatic() afterwards.
+ *
+ * @param[in] fileName  Example: "/style.css" or "/style.css.gz"
+ */
+void http_static_invalidate(const String &fileName)
+{
+    String uri = fileName;
+    int8_t idx;
+
+    if (fileName == HTTP_STATIC_MANIFEST)
+    {
+        // New manifest is loaded at next start
+        assetCnt = 0;
+        return;
+    }
+    if (uri.endsWith(".gz"))
+    {
+        uri.remove(uri.length() - 3);
+    }
+    idx = http_static_find(uri);
+    if (idx < 0)
+    {
+        return;
+    }
+    TRACE("Asset %s changed\n", uri.c_str());
+    assets[idx].hash[0] = 0;
+    if (assets[idx].gzipped && uri == fileName)
+    {
+        // Stale compressed copy would waste flash
+        LittleFS.remove(uri + ".gz");
+    }
+}
+
+void http_static_generate_sysinfo_json(Print &out)
+{
+    out.print("  , \"staticAssetCnt\": " + String(assetCnt) + "\n");
+    out.print("  , \"staticGzipCntr\": " + String(gzipCntr) + "\n");
+    out.print("  , \"staticPlainCntr\": " + String(plainCntr) + "\n");
+    out.print("  , \"staticNotModifiedCntr\": " + String(notModifiedCntr) + "\n");
+    out.print("  , \"staticGzipSavedBytes\": " + String(savedBytes) + "\n");
+}
+#endif /* ENABLE_HTTP_SERVER && ENABLE_HTTP_STATIC_GZIP */
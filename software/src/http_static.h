@@ -0,0 +1,43 @@
+/**
+ * @file        http_static.h
+ * @brief       Definitions of http_static.cpp
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 17:05:12
+ * Last modify: 2026-10-16 17:05:12 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#ifndef INCLUDE_HTTP_STATIC_H
+#define INCLUDE_HTTP_STATIC_H
+
+#include <stdint.h>
+
+#include <Arduino.h>
+
+#include "common.h"
+#include "config.h"
+
+#ifndef ENABLE_HTTP_STATIC_GZIP
+#define ENABLE_HTTP_STATIC_GZIP         0
+#endif
+
+#ifndef HTTP_STATIC_MAX_FILES
+#define HTTP_STATIC_MAX_FILES           8       /* Maximum number of assets in manifest */
+#endif
+
+#define HTTP_STATIC_HASH_LENGTH         8       /* Hex digits of content hash, see tools/gzip_data.py */
+#define HTTP_STATIC_MANIFEST            "/gz_manifest.txt"
+#define HTTP_STATIC_CACHE_IMMUTABLE     "public, max-age=31536000, immutable"
+
+#if ENABLE_HTTP_SERVER && ENABLE_HTTP_STATIC_GZIP
+extern void http_static_init();
+extern String http_static_versioned_uri(const char *uri);
+extern void http_static_invalidate(const String &fileName);
+extern void http_static_generate_sysinfo_json(Print &out);
+#else
+static inline String http_static_versioned_uri(const char *uri) { return String(uri); }
+static inline void http_static_invalidate(const String UNUSED &fileName) {}
+#endif
+
+#endif /* INCLUDE_HTTP_STATIC_H */
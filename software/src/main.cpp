@@ -26,6 +26,12 @@
 #include "fileutils.h"
 #include "trace.h"
 #include "doorbell.h"
+#include "profile.h"
+#include "config_store.h"
+#include "scheduler.h"
+#include "http_events.h"
+#include "mqtt_queue.h"
+#include "ring_multicast.h"
 
 const char *ssid = STASSID;
 const char *passPhrase = STAPSK;
@@ -33,10 +39,26 @@ const char *passPhrase = STAPSK;
 String hostname;
 WiFiClient wifiClient;
 
+uint32_t loopMaxTime_us = 0;
+
 #if ENABLE_MQTT_CLIENT
+typedef enum
+{
+    MQTT_STATE_DISCONNECTED = 0,    /* Waiting for next connection attempt */
+    MQTT_STATE_RESOLVE,             /* Resolving address of broker */
+    MQTT_STATE_TCP_CONNECT,         /* Opening TCP connection */
+    MQTT_STATE_MQTT_CONNECT,        /* Sending MQTT CONNECT and waiting for CONNACK */
+    MQTT_STATE_CONNECTED
+} mqttState_t;
+
 PubSubClient mqttClient(wifiClient);
 
 uint32_t mqtt_connect_start_time = 0;
+uint32_t mqtt_connect_retry_ms = MQTT_CONNECT_RETRY_MIN_MS;
+uint32_t mqttTaskMaxTime_us = 0;
+static mqttState_t mqttState = MQTT_STATE_DISCONNECTED;
+static IPAddress mqttServerIp;
+static bool mqttServerIpValid = false;
 String mqttTopic;
 
 String mqttSwitchesTopicPrefix;
@@ -187,17 +209,41 @@ String sec2str_short(uint32_t a_seconds)
 #if ENABLE_MQTT_CLIENT
 void mqtt_callback(char *topic, byte *payload, unsigned int length)
 {
-    String topicStr = topic;
-    String payloadStr;
-    uint16_t i;
+    profile_begin(PROFILE_MQTT_MESSAGE);
+    /* Topic is zero terminated in the buffer of MQTT client, payload is not */
+    TRACE("MQTT callback, topic: '%s', payload length: %u\n", topic, length);
+
+    doorbell_mqtt_callback(topic, strlen(topic), payload, length);
+    profile_end(PROFILE_MQTT_MESSAGE);
+}
+#endif
+
+#if ENABLE_MQTT_CLIENT
+static uint8_t mqttFlags = 0;   /* Set by mqtt task, processed by doorbell task */
+
+static void mqtt_scheduler_task()
+{
+    mqttFlags |= mqtt_task();
+}
+
+static void doorbell_scheduler_task()
+{
+    doorbell_task(mqttFlags);
+    mqttFlags = 0;
+}
+#endif
+
+#if ENABLE_RESET
+static void reset_task()
+{
+    uint32_t now = millis();
 
-    for (i = 0; i < length; i++)
+    if (board_reset && now >= BOARD_RESET_TIME_MS && now - BOARD_RESET_TIME_MS >= board_reset_timestamp_ms)
     {
-        payloadStr += static_cast<char>(payload[i]);
+        TRACE("Restarting...\n");
+        trace_flush();
+        ESP.restart();
     }
-    TRACE("MQTT callback, topic: '%s', payload: '%s'\n", topic, payloadStr.c_str());
-
-    doorbell_mqtt_callback(topicStr, payloadStr, length);
 }
 #endif
 
@@ -241,6 +287,7 @@ void setup(void)
     else
     {
         ERROR("Could not mount the filesystem!\n");
+        trace_flush();
         delay(2000);
         ESP.restart();
     }
@@ -258,7 +305,9 @@ void setup(void)
         WiFi.begin(ssid, passPhrase);
     }
 
-    hostname = readStringFromFile("/hostname.txt");
+    config_store_init();
+
+    hostname = config_get_str(CONFIG_HOSTNAME);
     if (hostname.isEmpty())
     {
         // allow to address the device by the given name e.g. http://doorbell<MAC>
@@ -271,18 +320,21 @@ void setup(void)
         hostname += mac[13];
         hostname += mac[15];
         hostname += mac[16];
+        config_set_str(CONFIG_HOSTNAME, hostname);
     }
 #if ENABLE_MQTT_CLIENT
-    mqttTopic = readStringFromFile("/mqtt_topic.txt");
+    mqttTopic = config_get_str(CONFIG_MQTT_TOPIC);
     if (mqttTopic.isEmpty())
     {
         mqttTopic = hostname;
         TRACE("Using hostname '%s' as MQTT topic\n", hostname.c_str());
+        config_set_str(CONFIG_MQTT_TOPIC, mqttTopic);
     }
-    mqttSwitchesTopicPrefix = readStringFromFile("/mqtt_topic.txt", 2);
+    mqttSwitchesTopicPrefix = config_get_str(CONFIG_MQTT_SWITCHES_TOPIC_PREFIX);
     if (mqttSwitchesTopicPrefix.isEmpty())
     {
         mqttSwitchesTopicPrefix = MQTT_SWITCHES_TOPIC_PREFIX + mqttTopic + "/";
+        config_set_str(CONFIG_MQTT_SWITCHES_TOPIC_PREFIX, mqttSwitchesTopicPrefix);
     }
 #endif
 
@@ -293,6 +345,12 @@ void setup(void)
     String str;
 
     doorbell_init();
+#if ENABLE_MQTT_CLIENT
+    mqtt_queue_init();
+#endif
+#if ENABLE_RING_MULTICAST
+    ring_multicast_init();
+#endif
 
     TRACE("Connecting to WiFi...\n");
     while (WiFi.status() != WL_CONNECTED)
@@ -318,54 +376,150 @@ void setup(void)
 
 #if ENABLE_MQTT_CLIENT
     mqttClient.setKeepAlive(15);        /* default is 15 seconds */
-    mqttClient.setSocketTimeout(15);    /* default is 15 seconds */
+    mqttClient.setSocketTimeout(MQTT_SOCKET_TIMEOUT_SEC);    /* default is 15 seconds */
     mqttClient.setServer(MQTT_SERVER, MQTT_SERVERPORT);
     mqttClient.setCallback(mqtt_callback);
 #endif /* ENABLE_MQTT_CLIENT */
+
+    /* Audio is served between every other task */
+    scheduler_add("audio", doorbell_audio_task, 0, TASK_AUDIO_BUDGET_US, SCHEDULER_PRIO_HIGH);
+#if ENABLE_RING_MULTICAST
+    /* Received rings are played immediately */
+    scheduler_add("ringmc", ring_multicast_task, 0, TASK_RING_MULTICAST_BUDGET_US, SCHEDULER_PRIO_HIGH);
+#endif
+#if ENABLE_HTTP_SERVER
+    scheduler_add("http", http_server_task, 0, TASK_HTTP_BUDGET_US, SCHEDULER_PRIO_NORMAL);
+#if ENABLE_HTTP_EVENTS
+    scheduler_add("events", http_events_task, 0, TASK_HTTP_EVENTS_BUDGET_US, SCHEDULER_PRIO_NORMAL);
+#endif
+#endif
+#if ENABLE_MQTT_CLIENT
+    scheduler_add("mqtt", mqtt_scheduler_task, 0, TASK_MQTT_BUDGET_US, SCHEDULER_PRIO_NORMAL);
+    scheduler_add("doorbell", doorbell_scheduler_task, TASK_DOORBELL_PERIOD_MS, TASK_DOORBELL_BUDGET_US, SCHEDULER_PRIO_NORMAL);
+    scheduler_add("mqttq", mqtt_queue_task, TASK_MQTT_QUEUE_PERIOD_MS, TASK_MQTT_QUEUE_BUDGET_US, SCHEDULER_PRIO_NORMAL);
+#endif
+#if ENABLE_RESET
+    scheduler_add("reset", reset_task, TASK_RESET_PERIOD_MS, TASK_RESET_BUDGET_US, SCHEDULER_PRIO_NORMAL);
+#endif
+    scheduler_add("trace", trace_task, 0, TASK_TRACE_BUDGET_US, SCHEDULER_PRIO_NORMAL);
 } // setup
 
 #if ENABLE_MQTT_CLIENT
+/*
+ * It is called when connection to MQTT broker failed or lost. Next attempt
+ * is delayed exponentially.
+ */
+static uint8_t mqtt_connect_failed()
+{
+    uint32_t delay_ms = mqtt_connect_retry_ms + random(mqtt_connect_retry_ms / 4 + 1);
+
+    mqttClient.disconnect();
+    wifiClient.stop();
+    TRACE("Retrying MQTT connection in %i ms...\n", delay_ms);
+    mqtt_connect_start_time = millis() + delay_ms;
+    mqtt_connect_retry_ms = MIN(mqtt_connect_retry_ms * 2, static_cast<uint32_t>(MQTT_CONNECT_RETRY_MAX_MS));
+    mqttState = MQTT_STATE_DISCONNECTED;
+
+    return MQTT_FLAG_DISCONNECTED;
+}
+
 // Function to connect and reconnect as necessary to the MQTT server.
 // Should be called in the loop function and it will take care of connecting.
+// Connecting is split into steps, one step is done per call and every step
+// has a short time limit, so an unreachable broker does not stall the loop.
 uint8_t mqtt_task()
 {
     uint8_t mqtt_flags = 0;
+    uint32_t start_us = micros();
+    uint32_t elapsed_us;
+    unsigned long timeout_ms;
+    bool ok;
 
     if (WiFi.status() == WL_CONNECTED)
     {
-        if (!mqttClient.connected())
+        switch (mqttState)
         {
-            if ((mqtt_connect_start_time == 0) || (millis() >= mqtt_connect_start_time))
-            {
-                TRACE("Connecting to MQTT... ");
-
+            case MQTT_STATE_DISCONNECTED:
+                /* Do not disturb playing audio with connection attempts */
+                if (static_cast<int32_t>(millis() - mqtt_connect_start_time) >= 0
+                    && !doorbell_is_playing())
+                {
+                    TRACE("Connecting to MQTT...\n");
+                    mqttState = mqttServerIpValid ? MQTT_STATE_TCP_CONNECT : MQTT_STATE_RESOLVE;
+                }
+                break;
+            case MQTT_STATE_RESOLVE:
+                if (mqttServerIp.fromString(MQTT_SERVER)
+                    || WiFi.hostByName(MQTT_SERVER, mqttServerIp, MQTT_DNS_TIMEOUT_MS) == 1)
+                {
+                    mqttServerIpValid = true;
+                    mqttState = MQTT_STATE_TCP_CONNECT;
+                }
+                else
+                {
+                    ERROR("Cannot resolve MQTT broker %s!\n", MQTT_SERVER);
+                    mqtt_flags |= mqtt_connect_failed();
+                }
+                break;
+            case MQTT_STATE_TCP_CONNECT:
+                /* Short time limit is only for connecting, writes of the
+                 * open connection keep the default timeout of the client */
+                timeout_ms = wifiClient.getTimeout();
+                wifiClient.setTimeout(MQTT_TCP_CONNECT_TIMEOUT_MS);
+                ok = wifiClient.connect(mqttServerIp, MQTT_SERVERPORT);
+                wifiClient.setTimeout(timeout_ms);
+                if (ok)
+                {
+                    mqttState = MQTT_STATE_MQTT_CONNECT;
+                }
+                else
+                {
+                    ERROR("Cannot connect to MQTT broker %s:%i!\n", MQTT_SERVER, MQTT_SERVERPORT);
+                    /* Address might have changed */
+                    mqttServerIpValid = false;
+                    mqtt_flags |= mqtt_connect_failed();
+                }
+                break;
+            case MQTT_STATE_MQTT_CONNECT:
+                /* TCP connection is already open, only MQTT CONNECT is sent */
                 if (mqttClient.connect(hostname.c_str()))
                 {
                     TRACE("Connected to MQTT broker\n");
+                    mqtt_connect_retry_ms = MQTT_CONNECT_RETRY_MIN_MS;
+                    mqttState = MQTT_STATE_CONNECTED;
                     mqtt_flags |= MQTT_FLAG_CONNECTED;
                 }
                 else
                 {
                     ERROR("Cannot connect to MQTT broker! Error: %i\n", mqttClient.state());
-                    TRACE("Retrying MQTT connection in %i seconds...", MQTT_CONNECT_RETRY_SEC);
-                    mqttClient.disconnect();
-                    mqtt_connect_start_time = millis() + SEC_TO_MS(MQTT_CONNECT_RETRY_SEC);
-                    mqtt_flags |= MQTT_FLAG_DISCONNECTED;
+                    mqtt_flags |= mqtt_connect_failed();
                 }
-            }
+                break;
+            case MQTT_STATE_CONNECTED:
+                if (!mqttClient.connected())
+                {
+                    ERROR("Disconnected from MQTT broker! Error: %i\n", mqttClient.state());
+                    mqtt_flags |= mqtt_connect_failed();
+                }
+                break;
         }
     }
     else
     {
-        if (mqttClient.connected())
+        if (mqttState != MQTT_STATE_DISCONNECTED)
         {
-            TRACE("WiFi disconnected, disconnecting from MQTT broker... ");
+            TRACE("WiFi disconnected, disconnecting from MQTT broker...\n");
             mqttClient.disconnect();
+            wifiClient.stop();
+            mqttState = MQTT_STATE_DISCONNECTED;
             mqtt_flags |= MQTT_FLAG_DISCONNECTED;
         }
     }
     mqttClient.loop();
 
+    elapsed_us = micros() - start_us;
+    mqttTaskMaxTime_us = MAX(mqttTaskMaxTime_us, elapsed_us);
+
     return mqtt_flags;
 }
 #endif /* ENABLE_MQTT_CLIENT */
@@ -373,27 +527,10 @@ uint8_t mqtt_task()
 // run the server...
 void loop(void)
 {
-    uint8_t mqtt_flags = 0;
-#if ENABLE_RESET
-    uint32_t now;
-#endif
+    uint32_t loopStart_us = micros();
+    uint32_t loopTime_us;
 
-#if ENABLE_HTTP_SERVER
-    http_server_task();
-#endif
-#if ENABLE_MQTT_CLIENT
-    mqtt_flags = mqtt_task();
-#endif
-    doorbell_task(mqtt_flags);
-#if ENABLE_RESET
-    now = millis();
-    if (board_reset && now >= BOARD_RESET_TIME_MS && now - BOARD_RESET_TIME_MS >= board_reset_timestamp_ms)
-    {
-        TRACE("Restarting...");
-        ESP.restart();
-    }
-#endif
-#if ENABLE_FILE_TRACE
-    trace_task();
-#endif
+    scheduler_run();
+    loopTime_us = micros() - loopStart_us;
+    loopMaxTime_us = MAX(loopMaxTime_us, loopTime_us);
 }
@@ -30,6 +30,7 @@
 
 extern String hostname;
 extern WiFiClient wifiClient;
+extern uint32_t loopMaxTime_us;     /* Longest loop() iteration since boot */
 
 #if ENABLE_RESET
 extern bool board_reset;
@@ -40,9 +41,13 @@ extern uint32_t board_reset_timestamp_ms;
 extern PubSubClient mqttClient;
 
 extern uint32_t mqtt_connect_start_time;
+extern uint32_t mqtt_connect_retry_ms;
+extern uint32_t mqttTaskMaxTime_us; /* Longest mqtt_task() call since boot */
 extern uint32_t mqtt_publish_start_time;
 extern uint32_t mqtt_publish_interval_sec;
 extern String mqttSwitchesTopicPrefix;
+
+extern uint8_t mqtt_task();
 #endif
 
 extern void setLed(bool on=true);
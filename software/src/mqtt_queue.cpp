@@ -0,0 +1,379 @@
+/**
+ * @file        mqtt_queue.cpp
+ * @brief       Store-and-forward queue of MQTT publishes
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 18:52:17
+ * Last modify: 2026-10-16 18:52:17 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * Events are published immediately when the broker is connected, even if
+ * older events are still waiting: a live event shall ring the followers
+ * now. Otherwise they are queued in RAM with the time of the event, so a
+ * ring never waits for the file system. A repeated event of a topic within
+ * MQTT_QUEUE_COALESCE_S after the first one of its newest record in RAM is
+ * coalesced: only the counter is incremented. Later events start a new
+ * record, so the original event times are kept. When more
+ * than MQTT_QUEUE_SPILL_THRESHOLD records are in RAM, mqtt_queue_task()
+ * moves the oldest ones to MQTT_QUEUE_SPILL_FILE, which survives a reset as
+ * well. Records of the file are older than the ones in RAM.
+ *
+ * After reconnection mqtt_queue_task() publishes the backlog in small
+ * batches to "<topic>/offline" with payload "<epoch of first event>,<count>",
+ * so followers of "<topic>" do not ring for an old event. Only events which
+ * could not be published at their time get there. Nothing is sent
+ * while audio is playing and one call stops after MQTT_QUEUE_FLUSH_BUDGET_US.
+ */
+
+#include <Arduino.h>
+#include "PubSubClient.h"       /* MQTT */
+
+#include "common.h"
+#include "config.h"
+#include "trace.h"
+#include "main.h"
+#include "doorbell.h"
+#include "fileutils.h"
+#include "mqtt_queue.h"
+
+#include <FS.h>       // File System for Web Server Files
+#include <LittleFS.h> // This file system is used.
+
+#if ENABLE_MQTT_CLIENT
+typedef struct __attribute__((packed))
+{
+    uint32_t timestamp;     /* Epoch time of first event [s] */
+    uint16_t count;         /* Number of coalesced events */
+    uint8_t topicId;        /* Returned by mqtt_queue_add_topic() */
+    uint8_t reserved;
+} mqttQueueRecord_t;
+
+static const String *queueTopics[MQTT_QUEUE_MAX_TOPICS];
+static uint8_t queueTopicCnt = 0;
+static mqttQueueRecord_t queue[MQTT_QUEUE_SIZE];
+static uint8_t queueHead = 0;           /* Index of oldest record */
+static uint8_t queueCnt = 0;
+#if MQTT_QUEUE_SPILL_MAX_RECORDS
+static uint16_t spillCnt = 0;           /* Records in spill file */
+static uint16_t spillReadCnt = 0;       /* Records of spill file already published */
+static uint32_t spillWriteCntr = 0;
+#endif
+static uint32_t directCntr = 0;         /* Events published immediately */
+static uint32_t queuedCntr = 0;         /* Events stored in queue */
+static uint32_t coalescedCntr = 0;      /* Events merged into a record of the same topic */
+static uint32_t flushCntr = 0;          /* Records published from queue */
+static uint32_t flushFailCntr = 0;
+static uint32_t dropCntr = 0;           /* Events lost, queue was full */
+static uint16_t maxBacklog = 0;
+static uint32_t flushMaxTime_us = 0;    /* Longest mqtt_queue_task() call which published */
+
+/*
+ * Register a topic which can be queued.
+ *
+ * @param[in] topic     It is not copied, it shall remain valid.
+ *
+ * @return Topic ID for mqtt_queue_publish(), MQTT_QUEUE_TOPIC_NONE if there
+ *         are too many topics.
+ */
+uint8_t mqtt_queue_add_topic(const String *topic)
+{
+    if (queueTopicCnt >= MQTT_QUEUE_MAX_TOPICS)
+    {
+        ERROR("Too many queued topics, %s is not added!\n", topic->c_str());
+        return MQTT_QUEUE_TOPIC_NONE;
+    }
+    queueTopics[queueTopicCnt] = topic;
+
+    return queueTopicCnt++;
+}
+
+/*
+ * Events left in spill file before reset are published after reconnection.
+ * Topic IDs shall be registered in the same order at every start.
+ */
+void mqtt_queue_init()
+{
+#if MQTT_QUEUE_SPILL_MAX_RECORDS
+    File file = LittleFS.open(MQTT_QUEUE_SPILL_FILE, "r");
+
+    spillCnt = 0;
+    spillReadCnt = 0;
+    if (!file)
+    {
+        return;
+    }
+    spillCnt = MIN(file.size() / sizeof(mqttQueueRecord_t), MQTT_QUEUE_SPILL_MAX_RECORDS);
+    file.close();
+    TRACE("%i queued MQTT events in %s\n", spillCnt, MQTT_QUEUE_SPILL_FILE);
+#endif
+}
+
+uint16_t mqtt_queue_backlog()
+{
+#if MQTT_QUEUE_SPILL_MAX_RECORDS
+    return queueCnt + spillCnt - spillReadCnt;
+#else
+    return queueCnt;
+#endif
+}
+
+/*
+ * Store event in RAM queue. It is called on the path of a ring, so the file
+ * system is not used.
+ */
+static void mqtt_queue_store(uint8_t topicId)
+{
+    mqttQueueRecord_t record;
+    mqttQueueRecord_t *newest = NULL;
+    time_t rawtime;
+    uint8_t i;
+
+    time(&rawtime);
+    for (i = queueCnt; i > 0 && !newest; i--)
+    {
+        if (queue[(queueHead + i - 1) % MQTT_QUEUE_SIZE].topicId == topicId)
+        {
+            newest = &queue[(queueHead + i - 1) % MQTT_QUEUE_SIZE];
+        }
+    }
+
+    /* Clock stepped back: difference overflows, new record is started */
+    if (newest && static_cast<uint32_t>(rawtime) - newest->timestamp < MQTT_QUEUE_COALESCE_S
+        && newest->count < UINT16_MAX)
+    {
+        newest->count++;
+        coalescedCntr++;
+        return;
+    }
+
+    record.timestamp = rawtime;
+    record.count = 1;
+    record.topicId = topicId;
+    record.reserved = 0;
+
+    if (queueCnt >= MQTT_QUEUE_SIZE)
+    {
+        ERROR("MQTT queue is full, %s is lost!\n", queueTopics[topicId]->c_str());
+        dropCntr++;
+        return;
+    }
+    queue[(queueHead + queueCnt) % MQTT_QUEUE_SIZE] = record;
+    queueCnt++;
+    queuedCntr++;
+    maxBacklog = MAX(maxBacklog, mqtt_queue_backlog());
+}
+
+/*
+ * Publish event or queue it if broker is not available. Backlog does not
+ * delay a live event, it is published to "<topic>/offline" later.
+ *
+ * @param[in] topicId   Returned by mqtt_queue_add_topic().
+ * @param[in] payload   Payload of immediate publish. Queued events are
+ *                      published with time stamp and count.
+ *
+ * @return true if event was published or queued.
+ */
+bool mqtt_queue_publish(uint8_t topicId, const char *payload)
+{
+    if (topicId >= queueTopicCnt)
+    {
+        return false;
+    }
+    if (mqttClient.connected())
+    {
+        if (mqttClient.publish(queueTopics[topicId]->c_str(), payload))
+        {
+            TRACE("Publish %s, %s\n", queueTopics[topicId]->c_str(), payload);
+            directCntr++;
+            return true;
+        }
+        ERROR("Cannot publish %s, %s\n", queueTopics[topicId]->c_str(), payload);
+    }
+    mqtt_queue_store(topicId);
+
+    return true;
+}
+
+/*
+ * Publish a queued record to "<topic>/offline".
+ *
+ * @return false if publish failed, record shall be kept.
+ */
+static bool mqtt_queue_publish_record(const mqttQueueRecord_t &record)
+{
+    String topic;
+    char payload[24];
+
+    if (record.topicId >= queueTopicCnt)
+    {
+        dropCntr += record.count;
+        return true;
+    }
+    topic = *queueTopics[record.topicId];
+    topic += MQTT_QUEUE_OFFLINE_SUFFIX;
+    snprintf(payload, sizeof(payload), "%u,%u",
+             static_cast<unsigned int>(record.timestamp), static_cast<unsigned int>(record.count));
+    if (!mqttClient.publish(topic.c_str(), payload))
+    {
+        ERROR("Cannot publish %s, %s\n", topic.c_str(), payload);
+        flushFailCntr++;
+        return false;
+    }
+    TRACE("Publish %s, %s\n", topic.c_str(), payload);
+    flushCntr++;
+
+    return true;
+}
+
+#if MQTT_QUEUE_SPILL_MAX_RECORDS
+/*
+ * Move oldest records of RAM queue to the end of spill file, so RAM has room
+ * for new events.
+ */
+static void mqtt_queue_spill_save()
+{
+    uint16_t cnt;
+    File file;
+
+    if (queueCnt <= MQTT_QUEUE_SPILL_THRESHOLD || spillCnt >= MQTT_QUEUE_SPILL_MAX_RECORDS)
+    {
+        return;
+    }
+    cnt = MIN(queueCnt - MQTT_QUEUE_SPILL_THRESHOLD, MQTT_QUEUE_SPILL_MAX_RECORDS - spillCnt);
+    file = LittleFS.open(MQTT_QUEUE_SPILL_FILE, spillCnt ? "a" : "w");
+    if (!file)
+    {
+        ERROR("Cannot write %s!\n", MQTT_QUEUE_SPILL_FILE);
+        return;
+    }
+    while (cnt--)
+    {
+        if (file.write(reinterpret_cast<const uint8_t *>(&queue[queueHead]), sizeof(mqttQueueRecord_t))
+            != sizeof(mqttQueueRecord_t))
+        {
+            ERROR("Cannot write %s!\n", MQTT_QUEUE_SPILL_FILE);
+            break;
+        }
+        queueHead = (queueHead + 1) % MQTT_QUEUE_SIZE;
+        queueCnt--;
+        spillCnt++;
+    }
+    file.close();
+    fs_changed();
+    spillWriteCntr++;
+}
+
+/*
+ * Publish next records of spill file. File is removed when all of its
+ * records were published.
+ *
+ * @return Number of published records.
+ */
+static uint8_t mqtt_queue_spill_flush(uint32_t start_us)
+{
+    mqttQueueRecord_t records[MQTT_QUEUE_FLUSH_BATCH];
+    uint8_t cnt = MIN(spillCnt - spillReadCnt, MQTT_QUEUE_FLUSH_BATCH);
+    uint8_t i;
+    File file = LittleFS.open(MQTT_QUEUE_SPILL_FILE, "r");
+
+    if (!file || !file.seek(spillReadCnt * sizeof(mqttQueueRecord_t))
+        || file.read(reinterpret_cast<uint8_t *>(records), cnt * sizeof(mqttQueueRecord_t)) != cnt * sizeof(mqttQueueRecord_t))
+    {
+        ERROR("Cannot read %s, %i events are lost!\n", MQTT_QUEUE_SPILL_FILE, spillCnt - spillReadCnt);
+        dropCntr += spillCnt - spillReadCnt;
+        spillReadCnt = spillCnt;
+        cnt = 0;
+    }
+    if (file)
+    {
+        file.close();
+    }
+    for (i = 0; i < cnt && micros() - start_us < MQTT_QUEUE_FLUSH_BUDGET_US; i++)
+    {
+        if (!mqtt_queue_publish_record(records[i]))
+        {
+            // Kept in file, next call retries
+            break;
+        }
+        spillReadCnt++;
+    }
+    if (spillReadCnt >= spillCnt)
+    {
+        LittleFS.remove(MQTT_QUEUE_SPILL_FILE);
+        fs_changed();
+        spillCnt = 0;
+        spillReadCnt = 0;
+    }
+
+    return i;
+}
+#endif
+
+/*
+ * Publish queued events while connected, move them to spill file while
+ * not. It shall be called periodically.
+ */
+void mqtt_queue_task()
+{
+    uint32_t start_us;
+    uint8_t publishCnt = 0;
+
+    if (doorbell_is_playing())
+    {
+        return;
+    }
+    if (!mqttClient.connected())
+    {
+#if MQTT_QUEUE_SPILL_MAX_RECORDS
+        mqtt_queue_spill_save();
+#endif
+        return;
+    }
+    if (!mqtt_queue_backlog())
+    {
+        return;
+    }
+
+    start_us = micros();
+#if MQTT_QUEUE_SPILL_MAX_RECORDS
+    if (spillCnt > spillReadCnt)
+    {
+        publishCnt = mqtt_queue_spill_flush(start_us);
+    }
+    else
+#endif
+    {
+        while (queueCnt && publishCnt < MQTT_QUEUE_FLUSH_BATCH && micros() - start_us < MQTT_QUEUE_FLUSH_BUDGET_US)
+        {
+            if (!mqtt_queue_publish_record(queue[queueHead]))
+            {
+                // Kept in queue, next call retries
+                break;
+            }
+            queueHead = (queueHead + 1) % MQTT_QUEUE_SIZE;
+            queueCnt--;
+            publishCnt++;
+        }
+    }
+    if (publishCnt)
+    {
+        flushMaxTime_us = MAX(flushMaxTime_us, micros() - start_us);
+    }
+}
+
+void mqtt_queue_generate_sysinfo_json(Print &out)
+{
+    out.print("  , \"mqttQueueBacklog\": " + String(mqtt_queue_backlog()) + "\n");
+    out.print("  , \"mqttQueueMaxBacklog\": " + String(maxBacklog) + "\n");
+    out.print("  , \"mqttQueueDirectCntr\": " + String(directCntr) + "\n");
+    out.print("  , \"mqttQueueQueuedCntr\": " + String(queuedCntr) + "\n");
+    out.print("  , \"mqttQueueCoalescedCntr\": " + String(coalescedCntr) + "\n");
+    out.print("  , \"mqttQueueFlushCntr\": " + String(flushCntr) + "\n");
+    out.print("  , \"mqttQueueFlushFailCntr\": " + String(flushFailCntr) + "\n");
+    out.print("  , \"mqttQueueFlushMaxTime_us\": " + String(flushMaxTime_us) + "\n");
+    out.print("  , \"mqttQueueDropCntr\": " + String(dropCntr) + "\n");
+#if MQTT_QUEUE_SPILL_MAX_RECORDS
+    out.print("  , \"mqttQueueSpillWriteCntr\": " + String(spillWriteCntr) + "\n");
+#endif
+}
+#endif /* ENABLE_MQTT_CLIENT */
@@ -0,0 +1,58 @@
+/**
+ * @file        mqtt_queue.h
+ * @brief       Store-and-forward queue of MQTT publishes
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 18:52:17
+ * Last modify: 2026-10-16 18:52:17 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#ifndef INCLUDE_MQTT_QUEUE_H
+#define INCLUDE_MQTT_QUEUE_H
+
+#include <stdint.h>
+
+#include <Arduino.h>
+
+#include "common.h"
+#include "config.h"
+
+#ifndef MQTT_QUEUE_SIZE
+#define MQTT_QUEUE_SIZE                 16      /* Events kept in RAM */
+#endif
+#ifndef MQTT_QUEUE_SPILL_MAX_RECORDS
+#define MQTT_QUEUE_SPILL_MAX_RECORDS    64      /* Events kept in MQTT_QUEUE_SPILL_FILE, 0: no spill */
+#endif
+#ifndef MQTT_QUEUE_SPILL_THRESHOLD
+#define MQTT_QUEUE_SPILL_THRESHOLD      (MQTT_QUEUE_SIZE / 2)   /* Records kept in RAM while disconnected, older ones go to file */
+#endif
+#ifndef MQTT_QUEUE_SPILL_FILE
+#define MQTT_QUEUE_SPILL_FILE           "/mqtt_queue.bin"
+#endif
+#ifndef MQTT_QUEUE_FLUSH_BATCH
+#define MQTT_QUEUE_FLUSH_BATCH          4       /* Max. publishes per mqtt_queue_task() call */
+#endif
+#ifndef MQTT_QUEUE_FLUSH_BUDGET_US
+#define MQTT_QUEUE_FLUSH_BUDGET_US      5000    /* No more publishes after this time in one call */
+#endif
+#ifndef MQTT_QUEUE_COALESCE_S
+#define MQTT_QUEUE_COALESCE_S           60      /* Events of a topic within this time are counted in one record */
+#endif
+#ifndef MQTT_QUEUE_MAX_TOPICS
+#define MQTT_QUEUE_MAX_TOPICS           8
+#endif
+#define MQTT_QUEUE_OFFLINE_SUFFIX       "/offline"
+
+#define MQTT_QUEUE_TOPIC_NONE           0xFF
+
+#if ENABLE_MQTT_CLIENT
+extern uint8_t mqtt_queue_add_topic(const String *topic);
+extern void mqtt_queue_init();
+extern bool mqtt_queue_publish(uint8_t topicId, const char *payload);
+extern void mqtt_queue_task();
+extern uint16_t mqtt_queue_backlog();
+extern void mqtt_queue_generate_sysinfo_json(Print &out);
+#endif
+
+#endif /* INCLUDE_MQTT_QUEUE_H */
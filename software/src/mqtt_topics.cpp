@@ -0,0 +1,232 @@
+/**
+ * @file        mqtt_topics.cpp
+ * @brief       Matching MQTT topics against topic filters
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 18:24:51
+ * Last modify: 2026-10-16 18:24:51 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * Filters may contain MQTT wildcards: '+' matches exactly one level, '#'
+ * (last level only) matches any number of levels including zero, so
+ * "switches/#" matches "switches" as well. Wildcards at the first level do
+ * not match topics starting with '$'.
+ *
+ * Topics are matched in place (pointer and length), level names of filters
+ * are hashed when the filter is added.
+ */
+
+#include <Arduino.h>
+
+#include "common.h"
+#include "config.h"
+#include "trace.h"
+#include "mqtt_topics.h"
+
+static uint32_t mqtt_topic_level_hash(const char *level, uint16_t len)
+{
+    uint32_t hash = 2166136261u;
+
+    while (len--)
+    {
+        hash = (hash ^ static_cast<uint8_t>(*level++)) * 16777619u;
+    }
+
+    return hash;
+}
+
+static uint8_t mqtt_topic_trie_new_node(mqttTopicTrie_t *trie, const char *level, uint8_t levelLen)
+{
+    mqttTopicNode_t *node;
+
+    if (trie->nodeCnt >= MQTT_TOPIC_TRIE_MAX_NODES)
+    {
+        return MQTT_TOPIC_NODE_NONE;
+    }
+    node = &trie->nodes[trie->nodeCnt];
+    node->level = level;
+    node->levelLen = levelLen;
+    node->hash = mqtt_topic_level_hash(level, levelLen);
+    node->firstChild = MQTT_TOPIC_NODE_NONE;
+    node->nextSibling = MQTT_TOPIC_NODE_NONE;
+    node->plusChild = MQTT_TOPIC_NODE_NONE;
+    node->endMask = 0;
+    node->hashMask = 0;
+
+    return trie->nodeCnt++;
+}
+
+/*
+ * Find child with given level name.
+ */
+static uint8_t mqtt_topic_trie_find_child(const mqttTopicTrie_t *trie, uint8_t parent,
+                                          const char *level, uint16_t levelLen, uint32_t hash)
+{
+    uint8_t idx;
+    const mqttTopicNode_t *node;
+
+    for (idx = trie->nodes[parent].firstChild; idx != MQTT_TOPIC_NODE_NONE; idx = node->nextSibling)
+    {
+        node = &trie->nodes[idx];
+        if (node->hash == hash && node->levelLen == levelLen && !memcmp(node->level, level, levelLen))
+        {
+            break;
+        }
+    }
+
+    return idx;
+}
+
+void mqtt_topic_trie_init(mqttTopicTrie_t *trie)
+{
+    trie->nodeCnt = 0;
+    mqtt_topic_trie_new_node(trie, "", 0);
+}
+
+/*
+ * Add a topic filter.
+ *
+ * @param[in] trie      Trie to modify.
+ * @param[in] filter    Topic filter, example: "switches/+/press". It is not
+ *                      copied, it shall remain valid while the trie is used.
+ * @param[in] filterId  0..MQTT_TOPIC_TRIE_MAX_FILTERS-1, reported by mqtt_topic_trie_match().
+ *
+ * @return true if filter was added, false if it is invalid or trie is full.
+ */
+bool mqtt_topic_trie_add(mqttTopicTrie_t *trie, const char *filter, uint8_t filterId)
+{
+    uint8_t nodeIdx = 0;
+    uint8_t childIdx;
+    const char *level = filter;
+    const char *end;
+    uint16_t levelLen;
+    uint32_t hash;
+
+    if (filterId >= MQTT_TOPIC_TRIE_MAX_FILTERS || !*filter)
+    {
+        return false;
+    }
+
+    while (true)
+    {
+        end = strchr(level, '/');
+        levelLen = end ? end - level : strlen(level);
+        if (levelLen == 1 && *level == '#')
+        {
+            if (end)
+            {
+                ERROR("'#' shall be the last level of '%s'!\n", filter);
+                return false;
+            }
+            trie->nodes[nodeIdx].hashMask |= 1u << filterId;
+            return true;
+        }
+        if (levelLen == 1 && *level == '+')
+        {
+            childIdx = trie->nodes[nodeIdx].plusChild;
+            if (childIdx == MQTT_TOPIC_NODE_NONE)
+            {
+                childIdx = mqtt_topic_trie_new_node(trie, level, levelLen);
+                trie->nodes[nodeIdx].plusChild = childIdx;
+            }
+        }
+        else
+        {
+            if (memchr(level, '+', levelLen) || memchr(level, '#', levelLen) || levelLen > UINT8_MAX)
+            {
+                ERROR("Invalid level in '%s'!\n", filter);
+                return false;
+            }
+            hash = mqtt_topic_level_hash(level, levelLen);
+            childIdx = mqtt_topic_trie_find_child(trie, nodeIdx, level, levelLen, hash);
+            if (childIdx == MQTT_TOPIC_NODE_NONE)
+            {
+                childIdx = mqtt_topic_trie_new_node(trie, level, levelLen);
+                if (childIdx != MQTT_TOPIC_NODE_NONE)
+                {
+                    trie->nodes[childIdx].nextSibling = trie->nodes[nodeIdx].firstChild;
+                    trie->nodes[nodeIdx].firstChild = childIdx;
+                }
+            }
+        }
+        if (childIdx == MQTT_TOPIC_NODE_NONE)
+        {
+            ERROR("Too many topic levels, '%s' is not added!\n", filter);
+            return false;
+        }
+        nodeIdx = childIdx;
+        if (!end)
+        {
+            trie->nodes[nodeIdx].endMask |= 1u << filterId;
+            return true;
+        }
+        level = end + 1;
+    }
+}
+
+static mqttTopicMask_t mqtt_topic_trie_match_node(const mqttTopicTrie_t *trie, uint8_t nodeIdx,
+                                                  const char *level, const char *topicEnd)
+{
+    const mqttTopicNode_t *node = &trie->nodes[nodeIdx];
+    mqttTopicMask_t mask = node->hashMask;
+    const char *end;
+    uint16_t levelLen;
+    uint8_t childIdx;
+
+    if (!level)
+    {
+        /* All levels of topic are consumed */
+        return mask | node->endMask;
+    }
+
+    end = static_cast<const char *>(memchr(level, '/', topicEnd - level));
+    levelLen = (end ? end : topicEnd) - level;
+    childIdx = mqtt_topic_trie_find_child(trie, nodeIdx, level, levelLen,
+                                          mqtt_topic_level_hash(level, levelLen));
+    if (childIdx != MQTT_TOPIC_NODE_NONE)
+    {
+        mask |= mqtt_topic_trie_match_node(trie, childIdx, end ? end + 1 : NULL, topicEnd);
+    }
+    if (node->plusChild != MQTT_TOPIC_NODE_NONE)
+    {
+        mask |= mqtt_topic_trie_match_node(trie, node->plusChild, end ? end + 1 : NULL, topicEnd);
+    }
+
+    return mask;
+}
+
+/*
+ * Match a topic against all filters.
+ *
+ * @param[in] trie      Filters.
+ * @param[in] topic     Topic of received message, it is not modified.
+ * @param[in] topicLen  Length of topic.
+ *
+ * @return Bit n is set if filter n matches.
+ */
+mqttTopicMask_t mqtt_topic_trie_match(const mqttTopicTrie_t *trie, const char *topic, uint16_t topicLen)
+{
+    uint8_t childIdx;
+    const char *end;
+    uint16_t levelLen;
+
+    if (!trie->nodeCnt || !topicLen)
+    {
+        return 0;
+    }
+    if (topic[0] != '$')
+    {
+        return mqtt_topic_trie_match_node(trie, 0, topic, topic + topicLen);
+    }
+
+    /* System topics: no wildcard at first level */
+    end = static_cast<const char *>(memchr(topic, '/', topicLen));
+    levelLen = end ? end - topic : topicLen;
+    childIdx = mqtt_topic_trie_find_child(trie, 0, topic, levelLen, mqtt_topic_level_hash(topic, levelLen));
+    if (childIdx == MQTT_TOPIC_NODE_NONE)
+    {
+        return 0;
+    }
+
+    return mqtt_topic_trie_match_node(trie, childIdx, end ? end + 1 : NULL, topic + topicLen);
+}
@@ -0,0 +1,57 @@
+/**
+ * @file        mqtt_topics.h
+ * @brief       Definitions of mqtt_topics.cpp
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 18:24:51
+ * Last modify: 2026-10-16 18:24:51 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#ifndef INCLUDE_MQTT_TOPICS_H
+#define INCLUDE_MQTT_TOPICS_H
+
+#include <stdint.h>
+
+#include <Arduino.h>
+
+#include "common.h"
+#include "config.h"
+
+#ifndef MQTT_TOPIC_TRIE_MAX_NODES
+#define MQTT_TOPIC_TRIE_MAX_NODES       32      /* One node per distinct topic level */
+#endif
+
+#define MQTT_TOPIC_TRIE_MAX_FILTERS     32      /* Bits of mqttTopicMask_t */
+#define MQTT_TOPIC_NODE_NONE            0xFF
+
+/* Bit n: topic filter n matches */
+typedef uint32_t mqttTopicMask_t;
+
+typedef struct
+{
+    const char *level;          /* Name of level, points into the filter */
+    uint8_t levelLen;
+    uint32_t hash;              /* FNV-1a of level name */
+    uint8_t firstChild;         /* Children with name, MQTT_TOPIC_NODE_NONE: none */
+    uint8_t nextSibling;
+    uint8_t plusChild;          /* Child for '+' level */
+    mqttTopicMask_t endMask;    /* Filters which end at this level */
+    mqttTopicMask_t hashMask;   /* Filters which continue with '#' */
+} mqttTopicNode_t;
+
+/*
+ * Topic filters are stored as a trie of levels, so matching a topic costs
+ * one hash per level regardless of the number of filters.
+ */
+typedef struct
+{
+    mqttTopicNode_t nodes[MQTT_TOPIC_TRIE_MAX_NODES];  /* nodes[0] is the root */
+    uint8_t nodeCnt;
+} mqttTopicTrie_t;
+
+extern void mqtt_topic_trie_init(mqttTopicTrie_t *trie);
+extern bool mqtt_topic_trie_add(mqttTopicTrie_t *trie, const char *filter, uint8_t filterId);
+extern mqttTopicMask_t mqtt_topic_trie_match(const mqttTopicTrie_t *trie, const char *topic, uint16_t topicLen);
+
+#endif /* INCLUDE_MQTT_TOPICS_H */
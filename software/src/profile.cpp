@@ -0,0 +1,121 @@
+/**
+ * @file        profile.cpp
+ * @brief       Cost of typical scenarios measured on target
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 13:20:05
+ * Last modify: 2026-10-16 13:20:05 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * Every scenario is surrounded by profile_begin() and profile_end(). Elapsed
+ * time, change of free heap and bytes written to the file system are
+ * collected. Scenarios can be nested, for example ringing through MQTT is
+ * counted as MQTT message and ring too.
+ */
+
+#include <Arduino.h>
+
+#include "common.h"
+#include "config.h"
+#include "profile.h"
+
+#if ENABLE_PROFILE
+typedef struct
+{
+    uint32_t cntr;              /* Number of finished runs */
+    uint32_t startTime_us;
+    uint32_t startFreeHeap;
+    uint32_t fsBytes;           /* File system bytes written during current run */
+    uint32_t lastTime_us;
+    uint32_t maxTime_us;
+    uint64_t totalTime_us;
+    int32_t lastHeapDelta;      /* Positive: heap remained allocated */
+    int32_t maxHeapDelta;
+    uint32_t lastFsBytes;
+    uint32_t totalFsBytes;
+} profileStats_t;
+
+static const char *profileScenarioNames[PROFILE_SCENARIO_COUNT] =
+{
+    "ring",
+    "pageLoad",
+    "mqttMessage",
+    "upload"
+};
+static profileStats_t profileStats[PROFILE_SCENARIO_COUNT];
+static uint8_t activeScenarios = 0;     /* Bit mask of running scenarios */
+
+void profile_begin(profileScenario_t scenario)
+{
+    profileStats_t *stats = &profileStats[scenario];
+
+    activeScenarios |= 1u << scenario;
+    stats->fsBytes = 0;
+    stats->startFreeHeap = ESP.getFreeHeap();
+    stats->startTime_us = micros();
+}
+
+void profile_end(profileScenario_t scenario)
+{
+    profileStats_t *stats = &profileStats[scenario];
+    uint32_t elapsed_us = micros() - stats->startTime_us;
+
+    if (!(activeScenarios & (1u << scenario)))
+    {
+        return;
+    }
+    activeScenarios &= ~(1u << scenario);
+
+    stats->cntr++;
+    stats->lastTime_us = elapsed_us;
+    stats->maxTime_us = MAX(stats->maxTime_us, elapsed_us);
+    stats->totalTime_us += elapsed_us;
+    stats->lastHeapDelta = static_cast<int32_t>(stats->startFreeHeap - ESP.getFreeHeap());
+    stats->maxHeapDelta = MAX(stats->maxHeapDelta, stats->lastHeapDelta);
+    stats->lastFsBytes = stats->fsBytes;
+    stats->totalFsBytes += stats->fsBytes;
+}
+
+/*
+ * Account bytes written to the file system to the running scenarios.
+ */
+void profile_fs_write(uint32_t bytes)
+{
+    uint8_t scenario;
+
+    for (scenario = 0; scenario < PROFILE_SCENARIO_COUNT; scenario++)
+    {
+        if (activeScenarios & (1u << scenario))
+        {
+            profileStats[scenario].fsBytes += bytes;
+        }
+    }
+}
+
+/*
+ * It generates /profile.json
+ */
+void profile_generate_json(Print &out)
+{
+    uint8_t scenario;
+    const profileStats_t *stats;
+
+    out.print("{\n");
+    for (scenario = 0; scenario < PROFILE_SCENARIO_COUNT; scenario++)
+    {
+        stats = &profileStats[scenario];
+        out.print(scenario ? "  , \"" : "    \"");
+        out.print(profileScenarioNames[scenario]);
+        out.print("\": { \"cntr\": " + String(stats->cntr));
+        out.print(", \"lastTime_us\": " + String(stats->lastTime_us));
+        out.print(", \"maxTime_us\": " + String(stats->maxTime_us));
+        out.print(", \"avgTime_us\": " + String(stats->cntr ? static_cast<uint32_t>(stats->totalTime_us / stats->cntr) : 0));
+        out.print(", \"lastHeapDelta\": " + String(stats->lastHeapDelta));
+        out.print(", \"maxHeapDelta\": " + String(stats->maxHeapDelta));
+        out.print(", \"lastFsBytes\": " + String(stats->lastFsBytes));
+        out.print(", \"totalFsBytes\": " + String(stats->totalFsBytes));
+        out.print(" }\n");
+    }
+    out.print("}");
+}
+#endif /* ENABLE_PROFILE */
@@ -0,0 +1,45 @@
+/**
+ * @file        profile.h
+ * @brief       Definitions of profile.cpp
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 13:20:05
+ * Last modify: 2026-10-16 13:20:05 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#ifndef INCLUDE_PROFILE_H
+#define INCLUDE_PROFILE_H
+
+#include <stdint.h>
+
+#include <Arduino.h>
+
+#include "common.h"
+#include "config.h"
+
+#ifndef ENABLE_PROFILE
+#define ENABLE_PROFILE          0
+#endif
+
+typedef enum
+{
+    PROFILE_RING = 0,           /* Start of audio and storing the event */
+    PROFILE_PAGE_LOAD,          /* Generating a page */
+    PROFILE_MQTT_MESSAGE,       /* Processing a received MQTT message */
+    PROFILE_UPLOAD,             /* Receiving a file */
+    PROFILE_SCENARIO_COUNT
+} profileScenario_t;
+
+#if ENABLE_PROFILE
+extern void profile_begin(profileScenario_t scenario);
+extern void profile_end(profileScenario_t scenario);
+extern void profile_fs_write(uint32_t bytes);
+extern void profile_generate_json(Print &out);
+#else
+static inline void profile_begin(profileScenario_t UNUSED scenario) {}
+static inline void profile_end(profileScenario_t UNUSED scenario) {}
+static inline void profile_fs_write(uint32_t UNUSED bytes) {}
+#endif
+
+#endif /* INCLUDE_PROFILE_H */
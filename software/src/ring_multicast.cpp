@@ -0,0 +1,379 @@
+/**
+ * @file        ring_multicast.cpp
+ * @brief       Ring events on LAN by UDP multicast
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 19:21:44
+ * Last modify: 2026-10-16 19:21:44 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * Doorbells of the same group (/ring_multicast.txt) send a datagram to the
+ * multicast group when their switch is pressed and ring when they receive
+ * one, without the round trip through the MQTT broker. Every event is sent
+ * RING_MULTICAST_REPEAT more times against packet loss; receivers drop
+ * copies by origin and sequence number. The sequence number starts at a
+ * random value, so a restarted peer is not taken for a duplicate. When the
+ * peer table is full, the peer heard from least recently is replaced, so
+ * copies of a new peer are still dropped.
+ *
+ * The datagram carries the NTP time of the event, receivers keep one-way
+ * latency statistics per peer. The accuracy is limited by the NTP
+ * synchronization of the two devices.
+ *
+ * If the sender sets play delay, every doorbell starts the audio at the
+ * same NTP time (time of event + delay) instead of at reception, so the
+ * network jitter is not heard. Late datagrams are played immediately.
+ */
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <WiFiUdp.h>
+#include <sys/time.h>
+
+#include "common.h"
+#include "config.h"
+#include "trace.h"
+#include "config_store.h"
+#include "doorbell.h"
+#include "ring_multicast.h"
+
+#if ENABLE_RING_MULTICAST
+#define RING_MULTICAST_VALID_EPOCH      1600000000u     /* Earlier time: clock is not set by NTP */
+
+static_assert(sizeof(ringMulticastPacket_t) == 24, "Datagram layout is shared with tools/ring_multicast.py");
+
+typedef struct
+{
+    uint32_t origin;            /* Chip ID, 0: unused entry */
+    uint32_t lastSeq;
+    uint32_t lastRx_ms;         /* millis() of last datagram */
+    uint32_t rxCntr;            /* Events */
+    uint32_t dupCntr;           /* Copies and duplicates */
+    uint32_t latencyCntr;       /* Events with valid time stamp */
+    int32_t lastLatency_us;
+    int32_t minLatency_us;
+    int32_t maxLatency_us;
+    int64_t sumLatency_us;
+} ringMulticastPeer_t;
+
+static WiFiUDP ringUdp;
+static bool ringUdpStarted = false;
+static uint16_t ringGroup = 0;          /* 0: disabled */
+static bool ringFollow = false;         /* true: ring on events of group */
+static uint32_t ringOrigin = 0;
+static uint32_t ringSeq = 0;
+static ringMulticastPacket_t ringLastPacket;
+static uint8_t ringRepeatCnt = 0;       /* Copies of ringLastPacket still to be sent */
+static uint32_t ringRepeatTimestamp_ms = 0;
+static ringMulticastPeer_t ringPeers[RING_MULTICAST_MAX_PEERS];
+static uint32_t ringTxCntr = 0;
+static uint32_t ringTxErrorCntr = 0;
+static uint32_t ringRxCntr = 0;         /* All datagrams */
+static uint32_t ringRxInvalidCntr = 0;  /* Wrong magic, version or size */
+static uint32_t ringRxOtherGroupCntr = 0;
+static uint32_t ringPeerEvictCntr = 0;  /* Peers replaced, table was full */
+static uint32_t ringPlayAtCntr = 0;         /* Events played at deadline */
+static uint32_t ringPlayAtLateCntr = 0;     /* Deadline passed or clocks are not synchronized */
+static uint32_t ringPlayAtNoClockCntr = 0;  /* Deadline ignored, clock is not set */
+
+void ring_multicast_init()
+{
+    ringGroup = config_get_int(CONFIG_RING_MULTICAST_GROUP);
+    ringFollow = config_get_int(CONFIG_RING_MULTICAST_FOLLOW) != 0;
+    ringOrigin = ESP.getChipId();
+    ringSeq = ESP.random();
+    TRACE("Ring multicast group: %i, follow: %i\n", ringGroup, ringFollow);
+}
+
+static bool ring_multicast_write(const ringMulticastPacket_t &packet)
+{
+    if (!ringUdp.beginPacketMulticast(IPAddress(RING_MULTICAST_ADDRESS), RING_MULTICAST_PORT, WiFi.localIP())
+        || ringUdp.write(reinterpret_cast<const uint8_t *>(&packet), sizeof(packet)) != sizeof(packet)
+        || !ringUdp.endPacket())
+    {
+        ringTxErrorCntr++;
+        return false;
+    }
+    ringTxCntr++;
+
+    return true;
+}
+
+/*
+ * Send event to the group. Copies are sent by ring_multicast_task().
+ *
+ * @param[in] eventType     EVENT_DOORBELL...
+ * @param[in] playDelay_ms  Group plays audio this time after the event,
+ *                          0: immediately. It is not sent if the clock is
+ *                          not set.
+ *
+ * @return true if event was sent with playDelay_ms, so sender shall also
+ *         delay its audio.
+ */
+bool ring_multicast_send(uint8_t eventType, uint16_t playDelay_ms)
+{
+    struct timeval tv;
+    bool ok;
+
+    if (!ringGroup || !ringUdpStarted)
+    {
+        return false;
+    }
+    gettimeofday(&tv, NULL);
+    ringLastPacket.magic = RING_MULTICAST_MAGIC;
+    ringLastPacket.version = RING_MULTICAST_VERSION;
+    ringLastPacket.eventType = eventType;
+    ringLastPacket.group = ringGroup;
+    ringLastPacket.playDelay_ms = playDelay_ms;
+    ringLastPacket.seq = ++ringSeq;
+    ringLastPacket.origin = ringOrigin;
+    ringLastPacket.originTime_s = static_cast<uint32_t>(tv.tv_sec) >= RING_MULTICAST_VALID_EPOCH ? tv.tv_sec : 0;
+    ringLastPacket.originTime_us = tv.tv_usec;
+    if (!ringLastPacket.originTime_s)
+    {
+        ringLastPacket.playDelay_ms = 0;
+    }
+    ok = ring_multicast_write(ringLastPacket);
+    if (ok)
+    {
+        TRACE("Ring multicast sent, seq: %u\n", static_cast<unsigned int>(ringLastPacket.seq));
+    }
+    else
+    {
+        ERROR("Cannot send ring multicast!\n");
+    }
+    ringRepeatCnt = RING_MULTICAST_REPEAT;
+    ringRepeatTimestamp_ms = millis();
+
+    return ok && ringLastPacket.playDelay_ms;
+}
+
+/*
+ * Time until the deadline of event.
+ *
+ * @return Delay, 0: no deadline or it has passed.
+ */
+static uint32_t ring_multicast_play_delay_us(const ringMulticastPacket_t &packet)
+{
+    struct timeval tv;
+    int64_t delay_us;
+
+    if (!packet.playDelay_ms || !packet.originTime_s)
+    {
+        return 0;
+    }
+    gettimeofday(&tv, NULL);
+    if (static_cast<uint32_t>(tv.tv_sec) < RING_MULTICAST_VALID_EPOCH)
+    {
+        ringPlayAtNoClockCntr++;
+        return 0;
+    }
+    delay_us = (static_cast<int64_t>(packet.originTime_s) - tv.tv_sec) * 1000000
+               + static_cast<int64_t>(packet.originTime_us) - tv.tv_usec
+               + packet.playDelay_ms * 1000;
+    if (delay_us <= 0 || delay_us > RING_MULTICAST_MAX_PLAY_DELAY_MS * 1000)
+    {
+        ringPlayAtLateCntr++;
+        return 0;
+    }
+    ringPlayAtCntr++;
+
+    return delay_us;
+}
+
+/*
+ * Find peer of origin or add it. If table is full, the peer heard from
+ * least recently is replaced.
+ */
+static ringMulticastPeer_t *ring_multicast_find_peer(uint32_t origin)
+{
+    ringMulticastPeer_t *peer = NULL;
+    uint32_t now = millis();
+    uint8_t oldest = 0;
+    uint8_t i;
+
+    for (i = 0; i < RING_MULTICAST_MAX_PEERS && ringPeers[i].origin; i++)
+    {
+        if (ringPeers[i].origin == origin)
+        {
+            ringPeers[i].lastRx_ms = now;
+            return &ringPeers[i];
+        }
+        if (now - ringPeers[i].lastRx_ms > now - ringPeers[oldest].lastRx_ms)
+        {
+            oldest = i;
+        }
+    }
+    if (i < RING_MULTICAST_MAX_PEERS)
+    {
+        peer = &ringPeers[i];
+    }
+    else
+    {
+        peer = &ringPeers[oldest];
+        TRACE("Ring multicast peer %08x is replaced\n", static_cast<unsigned int>(peer->origin));
+        ringPeerEvictCntr++;
+    }
+    memset(peer, 0, sizeof(*peer));
+    peer->origin = origin;
+    peer->lastRx_ms = now;
+
+    return peer;
+}
+
+/*
+ * @return true if event is new, false if it is a copy or duplicate.
+ */
+static bool ring_multicast_is_new(ringMulticastPeer_t *peer, uint32_t seq)
+{
+    int32_t diff = static_cast<int32_t>(seq - peer->lastSeq);
+
+    if (peer->rxCntr && diff <= 0 && diff > -RING_MULTICAST_SEQ_WINDOW)
+    {
+        peer->dupCntr++;
+        return false;
+    }
+    peer->lastSeq = seq;
+    peer->rxCntr++;
+
+    return true;
+}
+
+static void ring_multicast_update_latency(ringMulticastPeer_t *peer, const ringMulticastPacket_t &packet)
+{
+    struct timeval tv;
+    int32_t latency_us;
+
+    gettimeofday(&tv, NULL);
+    if (!packet.originTime_s || static_cast<uint32_t>(tv.tv_sec) < RING_MULTICAST_VALID_EPOCH)
+    {
+        return;
+    }
+    /* Can be negative if clocks differ more than the latency */
+    latency_us = (static_cast<int32_t>(tv.tv_sec - packet.originTime_s)) * 1000000
+                 + static_cast<int32_t>(tv.tv_usec) - static_cast<int32_t>(packet.originTime_us);
+    if (!peer->latencyCntr)
+    {
+        peer->minLatency_us = latency_us;
+        peer->maxLatency_us = latency_us;
+    }
+    peer->lastLatency_us = latency_us;
+    peer->minLatency_us = MIN(peer->minLatency_us, latency_us);
+    peer->maxLatency_us = MAX(peer->maxLatency_us, latency_us);
+    peer->sumLatency_us += latency_us;
+    peer->latencyCntr++;
+}
+
+static void ring_multicast_receive()
+{
+    ringMulticastPacket_t packet;
+    ringMulticastPeer_t *peer;
+    int size;
+
+    while ((size = ringUdp.parsePacket()) > 0)
+    {
+        ringRxCntr++;
+        if (size != sizeof(packet)
+            || ringUdp.read(reinterpret_cast<uint8_t *>(&packet), sizeof(packet)) != sizeof(packet)
+            || packet.magic != RING_MULTICAST_MAGIC || packet.version != RING_MULTICAST_VERSION)
+        {
+            ringRxInvalidCntr++;
+            continue;
+        }
+        if (packet.origin == ringOrigin)
+        {
+            /* Own datagram looped back */
+            continue;
+        }
+        if (packet.group != ringGroup)
+        {
+            ringRxOtherGroupCntr++;
+            continue;
+        }
+        peer = ring_multicast_find_peer(packet.origin);
+        if (!ring_multicast_is_new(peer, packet.seq))
+        {
+            continue;
+        }
+        ring_multicast_update_latency(peer, packet);
+        TRACE("Ring multicast from %08x, seq: %u\n", static_cast<unsigned int>(packet.origin),
+              static_cast<unsigned int>(packet.seq));
+        if (ringFollow)
+        {
+            doorbell_multicast_callback(packet.eventType, ring_multicast_play_delay_us(packet));
+        }
+    }
+}
+
+/*
+ * Receive events and send copies. It is a high priority task, received
+ * events are played immediately.
+ */
+void ring_multicast_task()
+{
+    if (!ringGroup)
+    {
+        return;
+    }
+    if (!ringUdpStarted)
+    {
+        if (WiFi.status() != WL_CONNECTED)
+        {
+            return;
+        }
+        ringUdpStarted = ringUdp.beginMulticast(WiFi.localIP(), IPAddress(RING_MULTICAST_ADDRESS),
+                                                RING_MULTICAST_PORT);
+        if (!ringUdpStarted)
+        {
+            ERROR("Cannot join ring multicast group!\n");
+            return;
+        }
+    }
+
+    ring_multicast_receive();
+
+    if (ringRepeatCnt && millis() - ringRepeatTimestamp_ms >= RING_MULTICAST_REPEAT_INTERVAL_MS)
+    {
+        ring_multicast_write(ringLastPacket);
+        ringRepeatCnt--;
+        ringRepeatTimestamp_ms = millis();
+    }
+}
+
+void ring_multicast_generate_sysinfo_json(Print &out)
+{
+    uint8_t i;
+    char buf[32];
+
+    out.print("  , \"ringMulticastGroup\": " + String(ringGroup) + "\n");
+    out.print("  , \"ringMulticastTxCntr\": " + String(ringTxCntr) + "\n");
+    out.print("  , \"ringMulticastTxErrorCntr\": " + String(ringTxErrorCntr) + "\n");
+    out.print("  , \"ringMulticastRxCntr\": " + String(ringRxCntr) + "\n");
+    out.print("  , \"ringMulticastRxInvalidCntr\": " + String(ringRxInvalidCntr) + "\n");
+    out.print("  , \"ringMulticastRxOtherGroupCntr\": " + String(ringRxOtherGroupCntr) + "\n");
+    out.print("  , \"ringMulticastPeerEvictCntr\": " + String(ringPeerEvictCntr) + "\n");
+    out.print("  , \"ringMulticastPlayAtCntr\": " + String(ringPlayAtCntr) + "\n");
+    out.print("  , \"ringMulticastPlayAtLateCntr\": " + String(ringPlayAtLateCntr) + "\n");
+    out.print("  , \"ringMulticastPlayAtNoClockCntr\": " + String(ringPlayAtNoClockCntr) + "\n");
+    out.print("  , \"ringMulticastPeers\": [");
+    for (i = 0; i < RING_MULTICAST_MAX_PEERS && ringPeers[i].origin; i++)
+    {
+        const ringMulticastPeer_t &peer = ringPeers[i];
+
+        snprintf(buf, sizeof(buf), "%s{\"origin\": \"%08x\"", i ? ", " : "", static_cast<unsigned int>(peer.origin));
+        out.print(buf);
+        out.print(", \"rxCntr\": " + String(peer.rxCntr));
+        out.print(", \"dupCntr\": " + String(peer.dupCntr));
+        out.print(", \"latencyCntr\": " + String(peer.latencyCntr));
+        if (peer.latencyCntr)
+        {
+            out.print(", \"lastLatency_us\": " + String(peer.lastLatency_us));
+            out.print(", \"minLatency_us\": " + String(peer.minLatency_us));
+            out.print(", \"maxLatency_us\": " + String(peer.maxLatency_us));
+            out.print(", \"avgLatency_us\": " + String(static_cast<int32_t>(peer.sumLatency_us / peer.latencyCntr)));
+        }
+        out.print("}");
+    }
+    out.print("]\n");
+}
+#endif /* ENABLE_RING_MULTICAST */
@@ -0,0 +1,70 @@
+/**
+ * @file        ring_multicast.h
+ * @brief       Ring events on LAN by UDP multicast
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 19:21:44
+ * Last modify: 2026-10-16 19:21:44 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#ifndef INCLUDE_RING_MULTICAST_H
+#define INCLUDE_RING_MULTICAST_H
+
+#include <stdint.h>
+
+#include <Arduino.h>
+
+#include "common.h"
+#include "config.h"
+
+#ifndef ENABLE_RING_MULTICAST
+#define ENABLE_RING_MULTICAST           0
+#endif
+#ifndef RING_MULTICAST_ADDRESS
+#define RING_MULTICAST_ADDRESS          239, 255, 68, 66    /* Arguments of IPAddress() */
+#endif
+#ifndef RING_MULTICAST_PORT
+#define RING_MULTICAST_PORT             4366
+#endif
+#ifndef RING_MULTICAST_REPEAT
+#define RING_MULTICAST_REPEAT           2       /* Copies sent after the first datagram */
+#endif
+#ifndef RING_MULTICAST_REPEAT_INTERVAL_MS
+#define RING_MULTICAST_REPEAT_INTERVAL_MS 20
+#endif
+#ifndef RING_MULTICAST_MAX_PEERS
+#define RING_MULTICAST_MAX_PEERS        8
+#endif
+#ifndef RING_MULTICAST_MAX_PLAY_DELAY_MS
+#define RING_MULTICAST_MAX_PLAY_DELAY_MS 5000   /* Longer wait means clocks are not synchronized */
+#endif
+#ifndef RING_MULTICAST_SEQ_WINDOW
+#define RING_MULTICAST_SEQ_WINDOW       64      /* Older sequence numbers mean restart of peer */
+#endif
+
+#define RING_MULTICAST_MAGIC            0x4244  /* "DB" */
+#define RING_MULTICAST_VERSION          1
+
+/* Datagram, little endian. Layout is used by tools/ring_multicast.py too. */
+typedef struct __attribute__((packed))
+{
+    uint16_t magic;             /* RING_MULTICAST_MAGIC */
+    uint8_t version;            /* RING_MULTICAST_VERSION */
+    uint8_t eventType;          /* EVENT_DOORBELL... */
+    uint16_t group;             /* Only members of the same group ring */
+    uint16_t playDelay_ms;      /* Audio starts at time of event + playDelay_ms, 0: immediately */
+    uint32_t seq;               /* Sequence number of event, copies have the same */
+    uint32_t origin;            /* Chip ID of sender */
+    uint32_t originTime_s;      /* Epoch time of event, 0: clock is not set */
+    uint32_t originTime_us;
+} ringMulticastPacket_t;
+
+#if ENABLE_RING_MULTICAST
+extern void ring_multicast_init();
+extern bool ring_multicast_send(uint8_t eventType, uint16_t playDelay_ms=0);
+extern void ring_multicast_task();
+extern void ring_multicast_generate_sysinfo_json(Print &out);
+#endif
+
+#endif /* INCLUDE_RING_MULTICAST_H */
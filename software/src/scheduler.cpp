@@ -0,0 +1,267 @@
+/**
+ * @file        scheduler.cpp
+ * @brief       Cooperative task scheduler
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 16:02:48
+ * Last modify: 2026-10-16 16:02:48 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * Every call of scheduler_run() runs all high priority tasks (audio,
+ * switch), then one due normal priority task in round robin order, then the
+ * high priority tasks again. So the gap between two runs of a high priority
+ * task is limited by the runtime of one normal task, not by the sum of them.
+ * Runtime of tasks is measured and compared to their budget.
+ *
+ * Timed tasks run once at a given micros() value, at the same points as the
+ * high priority tasks. A normal task is held back while its budget would
+ * reach past the deadline of a timed task, so the deadline is missed at
+ * most by the runtime of the high priority tasks.
+ */
+
+#include <Arduino.h>
+
+#include "common.h"
+#include "config.h"
+#include "trace.h"
+#include "scheduler.h"
+
+typedef struct
+{
+    const char *name;
+    schedulerTaskFunc_t func;
+    uint32_t period_ms;         /* 0: run as often as possible */
+    uint32_t budget_us;         /* Expected maximum runtime */
+    uint8_t priority;           /* SCHEDULER_PRIO_... */
+    uint32_t lastRun_ms;
+    uint32_t runCntr;
+    uint32_t lastTime_us;
+    uint32_t maxTime_us;
+    uint64_t totalTime_us;
+    uint32_t overrunCntr;       /* Number of runs longer than budget */
+    uint32_t heldCntr;          /* Number of runs delayed by a timed task */
+} schedulerTask_t;
+
+typedef struct
+{
+    schedulerTaskFunc_t func;   /* NULL: unused entry */
+    uint32_t at_us;             /* Deadline, micros() */
+} schedulerTimedTask_t;
+
+static schedulerTask_t schedulerTasks[SCHEDULER_MAX_TASKS];
+static uint8_t schedulerTaskCnt = 0;
+static uint8_t schedulerNextTaskIdx = 0;    /* Round robin position of normal tasks */
+static schedulerTimedTask_t schedulerTimedTasks[SCHEDULER_MAX_TIMED_TASKS];
+
+/*
+ * Register a task.
+ *
+ * @param[in] name          Name in /tasks.json.
+ * @param[in] func          Task function, it shall return quickly.
+ * @param[in] period_ms     Minimum time between two runs, 0: every time.
+ * @param[in] budget_us     Expected maximum runtime, longer runs are counted.
+ * @param[in] priority      SCHEDULER_PRIO_...
+ *
+ * @return true if task was registered.
+ */
+bool scheduler_add(const char *name, schedulerTaskFunc_t func, uint32_t period_ms,
+                   uint32_t budget_us, uint8_t priority)
+{
+    schedulerTask_t *task;
+
+    if (schedulerTaskCnt >= SCHEDULER_MAX_TASKS)
+    {
+        ERROR("Cannot add task %s!\n", name);
+        return false;
+    }
+    task = &schedulerTasks[schedulerTaskCnt++];
+    memset(task, 0, sizeof(*task));
+    task->name = name;
+    task->func = func;
+    task->period_ms = period_ms;
+    task->budget_us = budget_us;
+    task->priority = priority;
+
+    return true;
+}
+
+/*
+ * Run a function once at the given time. If it is already waiting, only its
+ * deadline is changed.
+ *
+ * @param[in] func          Task function, it shall return quickly.
+ * @param[in] at_us         Deadline, value of micros().
+ *
+ * @return true if task was registered.
+ */
+bool scheduler_add_timed(schedulerTaskFunc_t func, uint32_t at_us)
+{
+    schedulerTimedTask_t *free = NULL;
+    uint8_t idx;
+
+    for (idx = 0; idx < SCHEDULER_MAX_TIMED_TASKS; idx++)
+    {
+        if (schedulerTimedTasks[idx].func == func)
+        {
+            schedulerTimedTasks[idx].at_us = at_us;
+            return true;
+        }
+        if (!free && !schedulerTimedTasks[idx].func)
+        {
+            free = &schedulerTimedTasks[idx];
+        }
+    }
+    if (!free)
+    {
+        ERROR("Cannot add timed task!\n");
+        return false;
+    }
+    free->func = func;
+    free->at_us = at_us;
+
+    return true;
+}
+
+void scheduler_cancel_timed(schedulerTaskFunc_t func)
+{
+    uint8_t idx;
+
+    for (idx = 0; idx < SCHEDULER_MAX_TIMED_TASKS; idx++)
+    {
+        if (schedulerTimedTasks[idx].func == func)
+        {
+            schedulerTimedTasks[idx].func = NULL;
+        }
+    }
+}
+
+/*
+ * @return true if a timed task is due within time_us.
+ */
+static bool scheduler_timed_due_within(uint32_t time_us)
+{
+    uint32_t now_us = micros();
+    uint8_t idx;
+
+    for (idx = 0; idx < SCHEDULER_MAX_TIMED_TASKS; idx++)
+    {
+        if (schedulerTimedTasks[idx].func
+            && static_cast<int32_t>(schedulerTimedTasks[idx].at_us - now_us) <= static_cast<int32_t>(time_us))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void scheduler_run_timed()
+{
+    schedulerTaskFunc_t func;
+    uint8_t idx;
+
+    for (idx = 0; idx < SCHEDULER_MAX_TIMED_TASKS; idx++)
+    {
+        func = schedulerTimedTasks[idx].func;
+        if (func && static_cast<int32_t>(micros() - schedulerTimedTasks[idx].at_us) >= 0)
+        {
+            /* Entry is freed first, function can add itself again */
+            schedulerTimedTasks[idx].func = NULL;
+            func();
+        }
+    }
+}
+
+static void scheduler_run_task(schedulerTask_t *task)
+{
+    uint32_t start_us = micros();
+    uint32_t elapsed_us;
+
+    task->lastRun_ms = millis();
+    task->func();
+    elapsed_us = micros() - start_us;
+
+    task->runCntr++;
+    task->lastTime_us = elapsed_us;
+    task->maxTime_us = MAX(task->maxTime_us, elapsed_us);
+    task->totalTime_us += elapsed_us;
+    if (elapsed_us > task->budget_us)
+    {
+        task->overrunCntr++;
+    }
+}
+
+static void scheduler_run_high_prio()
+{
+    uint8_t idx;
+
+    scheduler_run_timed();
+    for (idx = 0; idx < schedulerTaskCnt; idx++)
+    {
+        if (schedulerTasks[idx].priority == SCHEDULER_PRIO_HIGH)
+        {
+            scheduler_run_task(&schedulerTasks[idx]);
+        }
+    }
+}
+
+/*
+ * It shall be called from loop().
+ */
+void scheduler_run()
+{
+    uint8_t i;
+    uint8_t idx;
+    schedulerTask_t *task;
+
+    scheduler_run_high_prio();
+
+    for (i = 0; i < schedulerTaskCnt; i++)
+    {
+        idx = (schedulerNextTaskIdx + i) % schedulerTaskCnt;
+        task = &schedulerTasks[idx];
+        if (task->priority == SCHEDULER_PRIO_HIGH
+            || (task->period_ms && millis() - task->lastRun_ms < task->period_ms))
+        {
+            continue;
+        }
+        if (scheduler_timed_due_within(task->budget_us))
+        {
+            /* Next loop() comes back quickly to the deadline */
+            task->heldCntr++;
+            break;
+        }
+        scheduler_run_task(task);
+        schedulerNextTaskIdx = idx + 1u;
+        scheduler_run_high_prio();
+        break;
+    }
+}
+
+/*
+ * It generates the array of tasks for /tasks.json
+ */
+void scheduler_generate_json(Print &out)
+{
+    uint8_t idx;
+    const schedulerTask_t *task;
+
+    out.print("[\n");
+    for (idx = 0; idx < schedulerTaskCnt; idx++)
+    {
+        task = &schedulerTasks[idx];
+        out.print(idx ? "  , { \"name\": \"" : "    { \"name\": \"");
+        out.print(task->name);
+        out.print("\", \"priority\": " + String(task->priority));
+        out.print(", \"period_ms\": " + String(task->period_ms));
+        out.print(", \"budget_us\": " + String(task->budget_us));
+        out.print(", \"runCntr\": " + String(task->runCntr));
+        out.print(", \"lastTime_us\": " + String(task->lastTime_us));
+        out.print(", \"maxTime_us\": " + String(task->maxTime_us));
+        out.print(", \"avgTime_us\": " + String(task->runCntr ? static_cast<uint32_t>(task->totalTime_us / task->runCntr) : 0));
+        out.print(", \"overrunCntr\": " + String(task->overrunCntr));
+        out.print(", \"heldCntr\": " + String(task->heldCntr));
+        out.print(" }\n");
+    }
+    out.print("  ]");
+}
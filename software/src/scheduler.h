@@ -0,0 +1,41 @@
+/**
+ * @file        scheduler.h
+ * @brief       Definitions of scheduler.cpp
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 16:02:48
+ * Last modify: 2026-10-16 16:02:48 ivanovp {Time-stamp}
+ * Licence:     GPL
+ */
+
+#ifndef INCLUDE_SCHEDULER_H
+#define INCLUDE_SCHEDULER_H
+
+#include <stdint.h>
+
+#include <Arduino.h>
+
+#include "common.h"
+#include "config.h"
+
+#ifndef SCHEDULER_MAX_TASKS
+#define SCHEDULER_MAX_TASKS         12
+#endif
+
+#ifndef SCHEDULER_MAX_TIMED_TASKS
+#define SCHEDULER_MAX_TIMED_TASKS   2
+#endif
+
+#define SCHEDULER_PRIO_NORMAL       0   /* One normal task runs per loop() */
+#define SCHEDULER_PRIO_HIGH         1   /* Runs before and after every normal task */
+
+typedef void (*schedulerTaskFunc_t)(void);
+
+extern bool scheduler_add(const char *name, schedulerTaskFunc_t func, uint32_t period_ms,
+                          uint32_t budget_us, uint8_t priority);
+extern bool scheduler_add_timed(schedulerTaskFunc_t func, uint32_t at_us);
+extern void scheduler_cancel_timed(schedulerTaskFunc_t func);
+extern void scheduler_run();
+extern void scheduler_generate_json(Print &out);
+
+#endif /* INCLUDE_SCHEDULER_H */
@@ -14,6 +14,7 @@
 #include "common.h"
 #include "config.h"
 #include "fileutils.h"
+#include "profile.h"
 
 #include <FS.h>       // File System for Web Server Files
 #include <LittleFS.h> // This file system is used.
@@ -38,6 +39,22 @@
 #define TRACE_ELAPSED_TIME_TO_FLUSH_MS  5000                /* flush file after 5 seconds */
 #endif
 
+#ifndef TRACE_SERIAL_BUF_SIZE
+#define TRACE_SERIAL_BUF_SIZE           1024                /* Output waiting for serial port */
+#endif
+
+#ifndef TRACE_FILE_BUF_SIZE
+#define TRACE_FILE_BUF_SIZE             1024                /* Output waiting for trace file */
+#endif
+
+#ifndef TRACE_ERROR_BUF_SIZE
+#define TRACE_ERROR_BUF_SIZE            512                 /* Output waiting for error file */
+#endif
+
+#ifndef TRACE_DRAIN_BUDGET_BYTES
+#define TRACE_DRAIN_BUDGET_BYTES        256                 /* Bytes written to a file by one trace_task() call */
+#endif
+
 #ifndef ENABLE_TRACE_MS_TIMESAMP
 #define ENABLE_TRACE_MS_TIMESAMP        1
 #endif
@@ -48,14 +65,181 @@ File traceFile;
 #if TRACE_LINE_COUNT_TO_FLUSH
 static uint16_t traceFileLineCntr = 0;
 #endif
-#if TRACE_ELAPSED_TIME_TO_FLUSH_MS
 bool traceFileFlushPending = false;
 uint32_t traceFileLastFlushTimesamp_ms = 0;
 #endif
-#endif
 bool errorFileIsOpened = false;
 File errorFile;
 
+/*
+ * Trace output is staged in RAM and written to serial port and files by
+ * trace_task(), so TRACE() does not wait for the UART or the file system.
+ */
+typedef struct
+{
+    char *buf;
+    uint16_t size;
+    uint32_t head;              /* Write position, counted from start-up */
+    uint32_t tail;              /* Read position, counted from start-up */
+    uint32_t maxBacklog;        /* Maximum number of bytes waiting */
+    uint32_t drainedBytes;
+    uint32_t droppedBytes;      /* Bytes of messages which did not fit */
+} traceRing_t;
+
+#if !DISABLE_SERIAL_TRACE
+static char traceSerialBuf[TRACE_SERIAL_BUF_SIZE];
+static traceRing_t traceSerialRing = { traceSerialBuf, TRACE_SERIAL_BUF_SIZE, 0, 0, 0, 0, 0 };
+#endif
+#if ENABLE_FILE_TRACE
+static char traceFileBuf[TRACE_FILE_BUF_SIZE];
+static traceRing_t traceFileRing = { traceFileBuf, TRACE_FILE_BUF_SIZE, 0, 0, 0, 0, 0 };
+#endif
+static char traceErrorBuf[TRACE_ERROR_BUF_SIZE];
+static traceRing_t traceErrorRing = { traceErrorBuf, TRACE_ERROR_BUF_SIZE, 0, 0, 0, 0, 0 };
+static bool traceDrainInLoop = false;       /* true: trace_task() drains output */
+static uint32_t traceDrainWindowStart_ms = 0;
+static uint32_t traceDrainWindowStartBytes = 0;
+static uint32_t traceDrainRate = 0;         /* Bytes drained in last second */
+
+/*
+ * Stage a message. If it does not fit, it is dropped and counted.
+ */
+static void trace_ring_put(traceRing_t *ring, const char *data, uint32_t len)
+{
+    uint32_t backlog = ring->head - ring->tail;
+    uint32_t idx;
+
+    if (backlog + len > ring->size)
+    {
+        ring->droppedBytes += len;
+        return;
+    }
+    while (len--)
+    {
+        idx = ring->head % ring->size;
+        ring->buf[idx] = *data++;
+        ring->head++;
+    }
+    backlog = ring->head - ring->tail;
+    ring->maxBacklog = MAX(ring->maxBacklog, backlog);
+}
+
+/*
+ * Write staged bytes to output.
+ *
+ * @param[in] ring      Staged output.
+ * @param[in] out       Serial port or file.
+ * @param[in] maxLen    Maximum number of bytes to write.
+ *
+ * @return Number of bytes written.
+ */
+static uint32_t trace_ring_drain(traceRing_t *ring, Print &out, uint32_t maxLen)
+{
+    uint32_t len;
+    uint32_t idx;
+    uint32_t written;
+    uint32_t total = 0;
+
+    while (ring->head != ring->tail && total < maxLen)
+    {
+        /* Contiguous part of buffer */
+        idx = ring->tail % ring->size;
+        len = MIN(ring->head - ring->tail, ring->size - idx);
+        len = MIN(len, maxLen - total);
+        written = out.write(reinterpret_cast<const uint8_t *>(&ring->buf[idx]), len);
+        ring->tail += written;
+        total += written;
+        if (written < len)
+        {
+            break;
+        }
+    }
+    ring->drainedBytes += total;
+
+    return total;
+}
+
+/*
+ * Write staged output to serial port and files.
+ *
+ * @param[in] blocking  true: write everything, false: write only as much as
+ *                      serial port accepts without waiting and at most
+ *                      TRACE_DRAIN_BUDGET_BYTES to each file.
+ */
+static void trace_drain(bool blocking)
+{
+    uint32_t len;
+
+#if !DISABLE_SERIAL_TRACE
+    len = blocking ? UINT32_MAX : static_cast<uint32_t>(MAX(Serial.availableForWrite(), 0));
+    trace_ring_drain(&traceSerialRing, Serial, len);
+#endif
+    len = blocking ? UINT32_MAX : TRACE_DRAIN_BUDGET_BYTES;
+#if ENABLE_FILE_TRACE
+    if (traceToFileIsWorking)
+    {
+        len = trace_ring_drain(&traceFileRing, traceFile, len);
+        profile_fs_write(len);
+        if (len)
+        {
+            /* There was some data to be printed */
+            traceFileFlushPending = true;
+            fs_changed();
+        }
+        if (traceFileFlushPending && traceFileRing.head == traceFileRing.tail
+            && (blocking
+#if TRACE_LINE_COUNT_TO_FLUSH
+                || traceFileLineCntr >= TRACE_LINE_COUNT_TO_FLUSH
+#endif
+#if TRACE_ELAPSED_TIME_TO_FLUSH_MS
+                || traceFileLastFlushTimesamp_ms + TRACE_ELAPSED_TIME_TO_FLUSH_MS <= millis()
+#endif
+                ))
+        {
+            traceFile.flush();
+#if TRACE_LINE_COUNT_TO_FLUSH
+            traceFileLineCntr = 0;
+#endif
+            traceFileFlushPending = false;
+            traceFileLastFlushTimesamp_ms = millis();
+        }
+        len = blocking ? UINT32_MAX : TRACE_DRAIN_BUDGET_BYTES;
+    }
+#endif
+    if (errorFileIsOpened && traceErrorRing.head != traceErrorRing.tail)
+    {
+        profile_fs_write(trace_ring_drain(&traceErrorRing, errorFile, len));
+        fs_changed();
+        if (traceErrorRing.head == traceErrorRing.tail)
+        {
+            errorFile.flush();
+        }
+    }
+}
+
+static void trace_ring_generate_sysinfo_json(Print &out, const char *name, const traceRing_t &ring)
+{
+    out.print(String("  , \"") + name + "Backlog\": " + String(ring.head - ring.tail) + "\n");
+    out.print(String("  , \"") + name + "MaxBacklog\": " + String(ring.maxBacklog) + "\n");
+    out.print(String("  , \"") + name + "Drained\": " + String(ring.drainedBytes) + "\n");
+    out.print(String("  , \"") + name + "Dropped\": " + String(ring.droppedBytes) + "\n");
+}
+
+/*
+ * It generates the trace output part of /sysinfo.json
+ */
+void trace_generate_sysinfo_json(Print &out)
+{
+    out.print("  , \"traceDrainRate_Bps\": " + String(traceDrainRate) + "\n");
+#if !DISABLE_SERIAL_TRACE
+    trace_ring_generate_sysinfo_json(out, "traceSerial", traceSerialRing);
+#endif
+#if ENABLE_FILE_TRACE
+    trace_ring_generate_sysinfo_json(out, "traceFile", traceFileRing);
+#endif
+    trace_ring_generate_sysinfo_json(out, "traceError", traceErrorRing);
+}
+
 #if ENABLE_FILE_TRACE
 static bool trace_file_start()
 {
@@ -75,6 +259,7 @@ static bool trace_file_start()
         }
     }
     traceFile = LittleFS.open(TRACE_FILE_NAME, "w");
+    fs_changed();
     if (traceFile)
     {
         traceFileOk = true;
@@ -94,6 +279,8 @@ static bool trace_file_stop()
 
     if (traceFile)
     {
+        /* Write staged output before closing */
+        trace_drain(true);
         traceFile.close();
         TRACE("Trace file %s closed.\n", TRACE_FILE_NAME);
         ok = true;
@@ -156,6 +343,267 @@ void trace_init()
     }
 }
 
+#if ENABLE_BINARY_TRACE
+#define TRACE_BIN_DUMP_MAGIC            0x31425254u         /* "TRB1" */
+#define TRACE_BIN_POS_TO_IDX(pos)       ((pos) & (TRACE_BIN_BUF_SIZE - 1u))
+
+typedef struct __attribute__((packed))
+{
+    uint16_t size;          /* Size of record including header */
+    uint8_t flags;          /* TRACE_FLAG_... */
+    uint8_t argCnt;         /* Number of argument types after header */
+    uint32_t timestamp_ms;
+    uint32_t fmt;           /* Address of format string */
+} traceBinHeader_t;
+
+static uint8_t traceBinBuf[TRACE_BIN_BUF_SIZE];
+/* Positions are counted from start-up, they are converted to index of traceBinBuf */
+static uint32_t traceBinWritePos = 0;
+static uint32_t traceBinOldestPos = 0;  /* Position of oldest record */
+static uint32_t traceBinRecordCntr = 0;
+static uint32_t traceBinDropCntr = 0;   /* Records overwritten by newer ones */
+
+static void trace_bin_write(uint32_t pos, const void *data, uint32_t len)
+{
+    const uint8_t *src = reinterpret_cast<const uint8_t *>(data);
+
+    while (len--)
+    {
+        traceBinBuf[TRACE_BIN_POS_TO_IDX(pos)] = *src++;
+        pos++;
+    }
+}
+
+static void trace_bin_read(uint32_t pos, void *data, uint32_t len)
+{
+    uint8_t *dst = reinterpret_cast<uint8_t *>(data);
+
+    while (len--)
+    {
+        *dst++ = traceBinBuf[TRACE_BIN_POS_TO_IDX(pos)];
+        pos++;
+    }
+}
+
+/*
+ * Store a trace record: format string address, time stamp and arguments.
+ * String arguments are copied as they might not exist when the record
+ * is formatted. Oldest records are overwritten if the buffer is full.
+ */
+void trace_bin_record(uint8_t trace_flags, const char *fmt, const traceBinArg_t *args, uint8_t argCnt)
+{
+    traceBinHeader_t header;
+    uint8_t strLen[TRACE_BIN_MAX_ARGS];
+    uint32_t pos;
+    uint16_t oldestSize;
+    uint8_t i;
+
+    header.size = sizeof(header) + argCnt;
+    for (i = 0; i < argCnt; i++)
+    {
+        if (args[i].type == TRACE_BIN_ARG_STR)
+        {
+            strLen[i] = args[i].s ? strnlen(args[i].s, TRACE_BIN_MAX_STR_LEN) : 0;
+            header.size += 1 + strLen[i];
+        }
+        else if (args[i].type == TRACE_BIN_ARG_DOUBLE)
+        {
+            header.size += sizeof(double);
+        }
+        else
+        {
+            header.size += sizeof(uint32_t);
+        }
+    }
+    header.flags = trace_flags;
+    header.argCnt = argCnt;
+    header.timestamp_ms = millis();
+    header.fmt = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(fmt));
+
+    /* Make room */
+    while (traceBinWritePos + header.size - traceBinOldestPos > TRACE_BIN_BUF_SIZE)
+    {
+        trace_bin_read(traceBinOldestPos, &oldestSize, sizeof(oldestSize));
+        traceBinOldestPos += oldestSize;
+        traceBinDropCntr++;
+    }
+
+    pos = traceBinWritePos;
+    trace_bin_write(pos, &header, sizeof(header));
+    pos += sizeof(header);
+    for (i = 0; i < argCnt; i++)
+    {
+        trace_bin_write(pos++, &args[i].type, 1);
+    }
+    for (i = 0; i < argCnt; i++)
+    {
+        if (args[i].type == TRACE_BIN_ARG_STR)
+        {
+            trace_bin_write(pos++, &strLen[i], 1);
+            trace_bin_write(pos, args[i].s, strLen[i]);
+            pos += strLen[i];
+        }
+        else if (args[i].type == TRACE_BIN_ARG_DOUBLE)
+        {
+            trace_bin_write(pos, &args[i].d, sizeof(double));
+            pos += sizeof(double);
+        }
+        else
+        {
+            trace_bin_write(pos, &args[i].u, sizeof(uint32_t));
+            pos += sizeof(uint32_t);
+        }
+    }
+    traceBinWritePos = pos;
+    traceBinRecordCntr++;
+}
+
+/*
+ * Format a stored record like printf() would do. Every conversion is
+ * printed separately with its own argument.
+ */
+static void trace_bin_format(Print &out, const traceBinHeader_t &header, uint32_t pos)
+{
+    const char *fmt = reinterpret_cast<const char *>(static_cast<uintptr_t>(header.fmt));
+    char spec[16];
+    char buf[64];
+    char str[TRACE_BIN_MAX_STR_LEN + 1];
+    uint32_t argPos = pos + header.argCnt;
+    uint8_t argIdx = 0;
+    uint8_t specLen;
+    uint8_t type;
+    uint8_t len;
+    uint32_t u;
+    double d;
+
+    while (*fmt)
+    {
+        if (*fmt != '%')
+        {
+            out.print(*fmt++);
+            continue;
+        }
+        /* Collect conversion specification, example: %-08lu */
+        specLen = 0;
+        do
+        {
+            spec[specLen++] = *fmt++;
+        } while (*fmt && specLen < sizeof(spec) - 1 && !strchr("diouxXcsfFeEgGp%", *fmt));
+        if (!*fmt)
+        {
+            break;
+        }
+        spec[specLen++] = *fmt++;
+        spec[specLen] = CHR_EOS;
+        if (spec[specLen - 1] == '%')
+        {
+            out.print('%');
+            continue;
+        }
+        if (argIdx >= header.argCnt)
+        {
+            out.print("<?>");
+            continue;
+        }
+        trace_bin_read(pos + argIdx, &type, 1);
+        argIdx++;
+        if (type == TRACE_BIN_ARG_STR)
+        {
+            trace_bin_read(argPos++, &len, 1);
+            trace_bin_read(argPos, str, len);
+            str[len] = CHR_EOS;
+            argPos += len;
+            snprintf(buf, sizeof(buf), spec, str);
+        }
+        else if (type == TRACE_BIN_ARG_DOUBLE)
+        {
+            trace_bin_read(argPos, &d, sizeof(d));
+            argPos += sizeof(d);
+            snprintf(buf, sizeof(buf), spec, d);
+        }
+        else
+        {
+            trace_bin_read(argPos, &u, sizeof(u));
+            argPos += sizeof(u);
+            snprintf(buf, sizeof(buf), spec, u);
+        }
+        out.print(buf);
+    }
+}
+
+/*
+ * Format all stored records, it is used by /trace_bin.txt
+ */
+void trace_bin_generate_text(Print &out)
+{
+    traceBinHeader_t header;
+    uint32_t pos = traceBinOldestPos;
+    uint32_t endPos = traceBinWritePos;
+    bool printTimeStamp = true;
+    char buf[16];
+    const char *fmt;
+
+    while (static_cast<int32_t>(endPos - pos) > 0)
+    {
+        if (static_cast<int32_t>(traceBinOldestPos - pos) > 0)
+        {
+            /* Record was overwritten while previous ones were sent */
+            pos = traceBinOldestPos;
+            continue;
+        }
+        trace_bin_read(pos, &header, sizeof(header));
+        if (printTimeStamp)
+        {
+            snprintf(buf, sizeof(buf), "%lu.%03lu ",
+                     static_cast<unsigned long>(header.timestamp_ms / 1000u),
+                     static_cast<unsigned long>(header.timestamp_ms % 1000u));
+            out.print(buf);
+        }
+        trace_bin_format(out, header, pos + sizeof(header));
+        fmt = reinterpret_cast<const char *>(static_cast<uintptr_t>(header.fmt));
+        printTimeStamp = fmt[0] && fmt[strlen(fmt) - 1] == CHR_LF;
+        pos += header.size;
+    }
+}
+
+/*
+ * Send raw content of buffer for tools/trace_decode.py, it is used by
+ * /trace_bin.bin. Dump header: magic, uptime [ms], epoch time [s], number
+ * of dropped records. Records follow from oldest to newest.
+ */
+void trace_bin_dump(Print &out)
+{
+    uint32_t header[4];
+    uint32_t pos = traceBinOldestPos;
+    uint32_t endPos = traceBinWritePos;
+    uint32_t len;
+    time_t rawtime;
+
+    time(&rawtime);
+    header[0] = TRACE_BIN_DUMP_MAGIC;
+    header[1] = millis();
+    header[2] = rawtime;
+    header[3] = traceBinDropCntr;
+    out.write(reinterpret_cast<const uint8_t *>(header), sizeof(header));
+
+    while (pos != endPos)
+    {
+        /* Send contiguous part of the buffer */
+        len = MIN(endPos - pos, TRACE_BIN_BUF_SIZE - TRACE_BIN_POS_TO_IDX(pos));
+        out.write(&traceBinBuf[TRACE_BIN_POS_TO_IDX(pos)], len);
+        pos += len;
+    }
+}
+
+void trace_bin_generate_sysinfo_json(Print &out)
+{
+    out.print("  , \"traceBinBufSize\": " TOSTR(TRACE_BIN_BUF_SIZE) "\n");
+    out.print("  , \"traceBinUsed\": " + String(traceBinWritePos - traceBinOldestPos) + "\n");
+    out.print("  , \"traceBinRecordCntr\": " + String(traceBinRecordCntr) + "\n");
+    out.print("  , \"traceBinDropCntr\": " + String(traceBinDropCntr) + "\n");
+}
+#endif /* ENABLE_BINARY_TRACE */
+
 static String trace_get_timestamp()
 {
     String timestamp;
@@ -191,10 +639,12 @@ void trace_printf(uint8_t trace_flags, const char *fmt, ...)
     static bool printTimeStamp = true;
     static char buf[TRACE_PRINTF_BUF_SIZE];
     static String timeStampStr;
+    size_t len;
 
     va_start (valist, fmt);
-    vsnprintf (buf, sizeof (buf), fmt, valist);
+    len = vsnprintf (buf, sizeof (buf), fmt, valist);
     va_end (valist);
+    len = MIN(len, sizeof(buf) - 1);
 
     if (printTimeStamp)
     {
@@ -204,15 +654,15 @@ void trace_printf(uint8_t trace_flags, const char *fmt, ...)
 #if ENABLE_TIMESTAMP_ON_SERIAL_TRACE
     if (printTimeStamp)
     {
-        Serial.print(timeStampStr);
-        Serial.print(' ');
+        trace_ring_put(&traceSerialRing, timeStampStr.c_str(), timeStampStr.length());
+        trace_ring_put(&traceSerialRing, " ", 1);
     }
 #endif
     if (trace_flags & TRACE_FLAG_ERROR)
     {
-        Serial.print("ERROR: ");
+        trace_ring_put(&traceSerialRing, "ERROR: ", 7);
     }
-    Serial.print(buf);
+    trace_ring_put(&traceSerialRing, buf, len);
 #endif
 
 #if ENABLE_FILE_TRACE
@@ -220,14 +670,9 @@ void trace_printf(uint8_t trace_flags, const char *fmt, ...)
     {
         if (printTimeStamp)
         {
-            traceFile.print(timeStampStr);
-        }
-        traceFile.print(buf);
-        if (buf[0])
-        {
-            /* There was some data to be printed */
-            traceFileFlushPending = true;
+            trace_ring_put(&traceFileRing, timeStampStr.c_str(), timeStampStr.length());
         }
+        trace_ring_put(&traceFileRing, buf, len);
     }
 #endif
 
@@ -235,57 +680,32 @@ void trace_printf(uint8_t trace_flags, const char *fmt, ...)
     {
         // if (printTimeStamp)
         // always print timestamp for errors!
-        errorFile.print(timeStampStr);
-        errorFile.print(buf);
+        trace_ring_put(&traceErrorRing, timeStampStr.c_str(), timeStampStr.length());
+        trace_ring_put(&traceErrorRing, buf, len);
     }
 
-    size_t len = strnlen(buf, sizeof(buf));
     if (len > 0 && (buf[len - 1] == CHR_CR || buf[len - 1] == CHR_LF))
     {
         /* If end of printed string is new line character, put timestamp */
         /* at the beginning of line next time! */
         printTimeStamp = true;
-#if ENABLE_FILE_TRACE
+#if ENABLE_FILE_TRACE && TRACE_LINE_COUNT_TO_FLUSH
         if (traceToFileIsWorking)
         {
-#if TRACE_LINE_COUNT_TO_FLUSH
             traceFileLineCntr++;
-            if (traceFileFlushPending
-                && traceFileLineCntr >= TRACE_LINE_COUNT_TO_FLUSH)
-            {
-                // Serial.print("#\n");
-                traceFile.flush();
-                traceFileLineCntr = 0;
-                traceFileFlushPending = false;
-                traceFileLastFlushTimesamp_ms = millis();
-            }
-#endif
-#if TRACE_LINE_COUNT_TO_FLUSH && TRACE_ELAPSED_TIME_TO_FLUSH_MS
-            else
-#endif
-#if TRACE_ELAPSED_TIME_TO_FLUSH_MS
-            if (traceFileFlushPending
-                && traceFileLastFlushTimesamp_ms + TRACE_ELAPSED_TIME_TO_FLUSH_MS <= millis())
-            {
-                // Serial.print("^\n");
-                traceFile.flush();
-                traceFileLineCntr = 0;
-                traceFileFlushPending = false;
-                traceFileLastFlushTimesamp_ms = millis();
-            }
-#endif
-
         }
 #endif
-        if (errorFileIsOpened && (trace_flags & TRACE_FLAG_ERROR))
-        {
-            errorFile.flush();
-        }
     }
     else
     {
         printTimeStamp = false;
     }
+
+    if (!traceDrainInLoop)
+    {
+        /* trace_task() is not called yet, output is written immediately */
+        trace_drain(true);
+    }
 }
 
 bool trace_enable()
@@ -297,6 +717,7 @@ bool trace_enable()
 
     TRACE("Enabling file trace... ");
     file = LittleFS.open(ENABLE_TRACE_FILE_NAME, "w");
+    fs_changed();
     if (file)
     {
         file.close();
@@ -326,6 +747,7 @@ bool trace_disable()
         traceToFileIsWorking = false;
     }
     TRACE("Disabling file trace... ");
+    fs_changed();
     if (LittleFS.remove(ENABLE_TRACE_FILE_NAME))
     {
         TRACE("Done.\n");
@@ -368,18 +790,34 @@ bool trace_to_file_is_working()
     return enabled;
 }
 
+/*
+ * Write all staged output. Call it before restart, otherwise the output
+ * still in RAM is lost.
+ */
+void trace_flush()
+{
+    trace_drain(true);
+}
+
 void trace_task()
 {
-#if ENABLE_FILE_TRACE && TRACE_ELAPSED_TIME_TO_FLUSH_MS
-    if (traceToFileIsWorking
-        && traceFileFlushPending
-        && traceFileLastFlushTimesamp_ms + TRACE_ELAPSED_TIME_TO_FLUSH_MS <= millis())
+    uint32_t now = millis();
+    uint32_t drainedBytes;
+
+    traceDrainInLoop = true;
+    trace_drain(false);
+
+    if (now - traceDrainWindowStart_ms >= 1000u)
     {
-        // Serial.print("&\n");
-        traceFile.flush();
-        traceFileLineCntr = 0;
-        traceFileLastFlushTimesamp_ms = millis();
-        traceFileFlushPending = false;
-    }
+        drainedBytes = traceErrorRing.drainedBytes;
+#if !DISABLE_SERIAL_TRACE
+        drainedBytes += traceSerialRing.drainedBytes;
 #endif
+#if ENABLE_FILE_TRACE
+        drainedBytes += traceFileRing.drainedBytes;
+#endif
+        traceDrainRate = (drainedBytes - traceDrainWindowStartBytes) * 1000u / (now - traceDrainWindowStart_ms);
+        traceDrainWindowStartBytes = drainedBytes;
+        traceDrainWindowStart_ms = now;
+    }
 }
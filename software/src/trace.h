@@ -22,7 +22,96 @@
 #define TRACE_FLAG_ERROR    0x01u
 #define TRACE_FLAG_FILE     0x02u
 
+#ifndef ENABLE_BINARY_TRACE
+#define ENABLE_BINARY_TRACE 0
+#endif
+
+#if ENABLE_BINARY_TRACE
+#ifndef TRACE_BIN_BUF_SIZE
+#define TRACE_BIN_BUF_SIZE  4096    /* Size of binary trace buffer, power of 2 */
+#endif
+#define TRACE_BIN_MAX_STR_LEN   32  /* Longer string arguments are truncated */
+#define TRACE_BIN_MAX_ARGS      16
+
+#define TRACE_BIN_ARG_INT       0
+#define TRACE_BIN_ARG_DOUBLE    1
+#define TRACE_BIN_ARG_STR       2
+
+/* Argument of TRACE(), type is determined at compile time */
+typedef struct
+{
+    uint8_t type;   /* TRACE_BIN_ARG_... */
+    union
+    {
+        uint32_t u;
+        double d;
+        const char *s;
+    };
+} traceBinArg_t;
+
+static inline traceBinArg_t trace_bin_arg(const char *s)
+{
+    traceBinArg_t arg;
+    arg.type = TRACE_BIN_ARG_STR;
+    arg.s = s;
+    return arg;
+}
+
+/* Otherwise char * would be taken by trace_bin_arg(T *p) and stored as address */
+static inline traceBinArg_t trace_bin_arg(char *s)
+{
+    return trace_bin_arg(static_cast<const char *>(s));
+}
+
+static inline traceBinArg_t trace_bin_arg(double d)
+{
+    traceBinArg_t arg;
+    arg.type = TRACE_BIN_ARG_DOUBLE;
+    arg.d = d;
+    return arg;
+}
+
+static inline traceBinArg_t trace_bin_arg(float f)
+{
+    return trace_bin_arg(static_cast<double>(f));
+}
+
+template <typename T>
+static inline traceBinArg_t trace_bin_arg(T *p)
+{
+    traceBinArg_t arg;
+    arg.type = TRACE_BIN_ARG_INT;
+    arg.u = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(p));
+    return arg;
+}
+
+template <typename T>
+static inline traceBinArg_t trace_bin_arg(T v)
+{
+    traceBinArg_t arg;
+    arg.type = TRACE_BIN_ARG_INT;
+    arg.u = static_cast<uint32_t>(v);
+    return arg;
+}
+
+extern void trace_bin_record(uint8_t trace_flags, const char *fmt, const traceBinArg_t *args, uint8_t argCnt);
+
+/*
+ * Store format string's address and arguments, they are formatted later.
+ */
+template <typename... Args>
+static inline void trace_bin(uint8_t trace_flags, const char *fmt, Args... args)
+{
+    static_assert(sizeof...(args) <= TRACE_BIN_MAX_ARGS, "Too many trace arguments");
+    const traceBinArg_t argArray[] = { trace_bin_arg(args)..., traceBinArg_t() };
+
+    trace_bin_record(trace_flags, fmt, argArray, sizeof...(args));
+}
+
+#define TRACE(...)          trace_bin(TRACE_FLAG_NORMAL, __VA_ARGS__)
+#else
 #define TRACE(...)          trace_printf(TRACE_FLAG_NORMAL, __VA_ARGS__)
+#endif
 #define ERROR(...)          trace_printf(TRACE_FLAG_ERROR, __VA_ARGS__)
 #define FILE_TRACE(...)     trace_printf(TRACE_FLAG_FILE, __VA_ARGS__)
 
@@ -33,6 +122,13 @@ extern bool trace_disable();
 extern bool trace_file_enable_exists();
 extern bool trace_to_file_is_working();
 extern void trace_task();
+extern void trace_flush();
+extern void trace_generate_sysinfo_json(Print &out);
+#if ENABLE_BINARY_TRACE
+extern void trace_bin_generate_text(Print &out);
+extern void trace_bin_dump(Print &out);
+extern void trace_bin_generate_sysinfo_json(Print &out);
+#endif
 
 #endif /* INCLUDE_TRACE_H */
 
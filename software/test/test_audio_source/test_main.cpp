@@ -0,0 +1,169 @@
+/**
+ * @file        test_main.cpp
+ * @brief       File access of the rewindable audio source
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:41:18
+ * Last modify: 2026-10-16 22:41:18 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * A ring opens the audio file once, replays of the same ring only seek.
+ * Header is read ahead only for WAV files.
+ *
+ * pio test -e native -f test_audio_source
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+
+#include "native.h"
+#include "native_audio.h"
+#include "AudioFileSourcePROGMEM.h"
+
+#include "config.h"
+#include "audio_source.h"
+#include "doorbell.h"
+
+#define TEST_LOOP_STEP_US       1000
+#define TEST_MAX_LOOPS          100000
+#define TEST_PLAY_COUNT         3
+
+/* Audio source which counts reads of the wrapped source */
+class CountingSource : public AudioFileSourcePROGMEM
+{
+public:
+    CountingSource(const void *data, uint32_t len) : AudioFileSourcePROGMEM(data, len) {}
+    virtual uint32_t read(void *data, uint32_t len) override
+    {
+        readCntr++;
+        readBytes += len;
+        return AudioFileSourcePROGMEM::read(data, len);
+    }
+
+    uint32_t readCntr = 0;
+    uint32_t readBytes = 0;
+};
+
+/* PCM WAV, 8 kHz, 16 bit mono, 4 samples */
+static const uint8_t wavFile[] =
+{
+    'R', 'I', 'F', 'F', 44, 0, 0, 0, 'W', 'A', 'V', 'E',
+    'f', 'm', 't', ' ', 16, 0, 0, 0, 1, 0, 1, 0, 0x40, 0x1F, 0, 0, 0x80, 0x3E, 0, 0, 2, 0, 16, 0,
+    'd', 'a', 't', 'a', 8, 0, 0, 0, 1, 0, 2, 0, 3, 0, 4, 0
+};
+
+/* MPEG audio frame header and some data */
+static const uint8_t mp3File[] = { 0xFF, 0xFB, 0x90, 0x64, 1, 2, 3, 4, 5, 6, 7, 8 };
+
+extern void setup(void);
+extern void loop(void);
+
+static bool ring()
+{
+    uint32_t beginCntr = native_i2s_stats().beginCntr;
+    uint32_t i;
+
+    native_gpio_input(DOORBELL_SWITCH_PIN, LOW);
+    native_clock_advance(200000);
+    loop();
+    native_gpio_input(DOORBELL_SWITCH_PIN, HIGH);
+    for (i = 0; i < TEST_MAX_LOOPS; i++)
+    {
+        if (native_i2s_stats().beginCntr != beginCntr && !doorbell_is_playing())
+        {
+            return true;
+        }
+        loop();
+        native_clock_advance(TEST_LOOP_STEP_US);
+    }
+
+    return false;
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+static void test_ring_opens_audio_file_once(void)
+{
+    uint32_t openCntr = native_fs_open_cntr("doorbell.wav");
+    uint32_t beginCntr = native_i2s_stats().beginCntr;
+
+    TEST_ASSERT_TRUE(ring());
+    TEST_ASSERT_EQUAL_UINT32(TEST_PLAY_COUNT, native_i2s_stats().beginCntr - beginCntr);
+    TEST_ASSERT_EQUAL_UINT32(openCntr + 1, native_fs_open_cntr("doorbell.wav"));
+
+    TEST_ASSERT_TRUE(ring());
+    TEST_ASSERT_EQUAL_UINT32(openCntr + 2, native_fs_open_cntr("doorbell.wav"));
+}
+
+static void test_wav_header_is_cached(void)
+{
+    CountingSource file(wavFile, sizeof(wavFile));
+    AudioFileSourceRewind source;
+    uint8_t buf[sizeof(wavFile)];
+    uint32_t readCntr;
+
+    TEST_ASSERT_TRUE(source.attach(&file, true));
+    TEST_ASSERT_EQUAL_UINT32(1, file.readCntr);
+    TEST_ASSERT_EQUAL_UINT32(44, source.getDataOffset());
+    TEST_ASSERT_EQUAL_UINT32(sizeof(wavFile), source.read(buf, sizeof(buf)));
+    TEST_ASSERT_TRUE(!memcmp(buf, wavFile, sizeof(wavFile)));
+
+    /* Replay reads only audio data from the file */
+    source.rewind();
+    readCntr = file.readCntr;
+    file.readBytes = 0;
+    TEST_ASSERT_EQUAL_UINT32(sizeof(wavFile), source.read(buf, sizeof(buf)));
+    TEST_ASSERT_TRUE(!memcmp(buf, wavFile, sizeof(wavFile)));
+    TEST_ASSERT_EQUAL_UINT32(readCntr + 1, file.readCntr);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(wavFile) - 44, file.readBytes);
+}
+
+static void test_header_of_other_codecs_is_not_read(void)
+{
+    CountingSource file(mp3File, sizeof(mp3File));
+    AudioFileSourceRewind source;
+    uint8_t buf[sizeof(mp3File)];
+
+    TEST_ASSERT_TRUE(source.attach(&file, false));
+    TEST_ASSERT_EQUAL_UINT32(0, file.readCntr);
+    TEST_ASSERT_EQUAL_UINT32(0, source.getDataOffset());
+    TEST_ASSERT_EQUAL_UINT32(4, source.read(buf, 4));
+    TEST_ASSERT_EQUAL_UINT32(1, file.readCntr);
+    TEST_ASSERT_EQUAL_UINT32(4, file.readBytes);
+
+    source.rewind();
+    TEST_ASSERT_EQUAL_UINT32(sizeof(mp3File), source.read(buf, sizeof(buf)));
+    TEST_ASSERT_TRUE(!memcmp(buf, mp3File, sizeof(mp3File)));
+}
+
+int main(int argc, char **argv)
+{
+    File config;
+
+    (void)argc;
+    (void)argv;
+
+    native_serial_echo(false);
+    if (!native_fs_mount_copy(NATIVE_DATA_DIR))
+    {
+        return 1;
+    }
+    /* Audio is replayed, replays shall not open the file again */
+    config = LittleFS.open("/doorbell.txt", "w");
+    config.printf("doorbell.wav\n%i\n100\n0.5\n0\n", TEST_PLAY_COUNT);
+    config.close();
+    setup();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_ring_opens_audio_file_once);
+    RUN_TEST(test_wav_header_is_cached);
+    RUN_TEST(test_header_of_other_codecs_is_not_read);
+
+    return UNITY_END();
+}
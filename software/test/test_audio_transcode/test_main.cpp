@@ -0,0 +1,386 @@
+/**
+ * @file        test_main.cpp
+ * @brief       Conversion of uploaded WAV files
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-17 12:20:14
+ * Last modify: 2026-10-17 12:20:14 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * Files are uploaded like from the browser and the stored file is read
+ * back: patched header, number of samples, trimmed silence, anti-aliasing
+ * filter. Files which are not PCM WAV are stored byte by byte.
+ * audio_transcode.txt of data/ converts to 22050 Hz and drops leading
+ * samples below 256.
+ *
+ * pio test -e native -f test_audio_transcode
+ */
+
+#include <math.h>
+
+#include <string>
+#include <vector>
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <unity.h>
+
+#include "native.h"
+
+#include "config.h"
+#include "http_server.h"
+#include "audio_transcode.h"
+
+#define TEST_LOOP_STEP_US       1000
+#define TEST_MAX_LOOPS          1000
+#define TEST_SESSION_COOKIE     "ESPSESSIONID=1"
+#define TEST_OUT_SAMPLE_RATE    22050
+#define TEST_SILENCE_THRESHOLD  256
+#define TEST_WAV_HEADER_SIZE    44
+#define TEST_FORMAT_PCM         0x0001
+#define TEST_FORMAT_MULAW       0x0007
+#define TEST_FORMAT_EXTENSIBLE  0xFFFE
+#define TEST_AMPLITUDE          16000
+
+extern void setup(void);
+extern void loop(void);
+
+typedef struct
+{
+    uint16_t format;
+    uint16_t channels;
+    uint32_t sampleRate;
+    uint16_t bitsPerSample;
+    std::string chunksBefore;       /* Between "WAVE" and fmt chunk */
+    std::string chunksAfter;        /* After data chunk */
+} testWavFormat_t;
+
+static void put_le16(std::string &s, uint16_t value)
+{
+    s += static_cast<char>(value);
+    s += static_cast<char>(value >> 8);
+}
+
+static void put_le32(std::string &s, uint32_t value)
+{
+    put_le16(s, value);
+    put_le16(s, value >> 16);
+}
+
+static uint32_t get_le32(const std::string &s, size_t pos)
+{
+    return static_cast<uint8_t>(s[pos]) | (static_cast<uint8_t>(s[pos + 1]) << 8)
+           | (static_cast<uint8_t>(s[pos + 2]) << 16) | (static_cast<uint32_t>(static_cast<uint8_t>(s[pos + 3])) << 24);
+}
+
+static std::string chunk(const char *id, const std::string &content)
+{
+    std::string s = id;
+
+    put_le32(s, content.size());
+    s += content;
+    if (content.size() & 1)
+    {
+        /* Chunks are word aligned */
+        s += '\0';
+    }
+
+    return s;
+}
+
+/*
+ * RIFF WAVE file of samples, every channel gets the same sample.
+ * WAVE_FORMAT_EXTENSIBLE has the format as sub format.
+ */
+static std::string make_wav(const testWavFormat_t &fmt, const std::vector<int32_t> &samples)
+{
+    uint16_t bytesPerSample = (fmt.bitsPerSample + 7) / 8;
+    std::string fmtChunk;
+    std::string data;
+    std::string wav;
+    uint16_t ch;
+    uint8_t i;
+
+    put_le16(fmtChunk, fmt.format);
+    put_le16(fmtChunk, fmt.channels);
+    put_le32(fmtChunk, fmt.sampleRate);
+    put_le32(fmtChunk, fmt.sampleRate * fmt.channels * bytesPerSample);
+    put_le16(fmtChunk, fmt.channels * bytesPerSample);
+    put_le16(fmtChunk, fmt.bitsPerSample);
+    if (fmt.format == TEST_FORMAT_EXTENSIBLE)
+    {
+        put_le16(fmtChunk, 22);
+        put_le16(fmtChunk, fmt.bitsPerSample);
+        put_le32(fmtChunk, (1u << fmt.channels) - 1);
+        /* KSDATAFORMAT_SUBTYPE_PCM */
+        fmtChunk += std::string("\x01\x00\x00\x00\x00\x00\x10\x00\x80\x00\x00\xAA\x00\x38\x9B\x71", 16);
+    }
+    for (int32_t sample : samples)
+    {
+        for (ch = 0; ch < fmt.channels; ch++)
+        {
+            if (bytesPerSample == 1)
+            {
+                data += static_cast<char>((sample >> 8) + 128);
+                continue;
+            }
+            /* Sample is the upper 16 bits, lower bits are noise */
+            for (i = 2; i < bytesPerSample; i++)
+            {
+                data += static_cast<char>(0x5A + i);
+            }
+            put_le16(data, sample);
+        }
+    }
+
+    wav = "WAVE" + fmt.chunksBefore + chunk("fmt ", fmtChunk) + chunk("data", data) + fmt.chunksAfter;
+
+    return chunk("RIFF", wav);
+}
+
+static std::vector<int32_t> sine(uint32_t freq, uint32_t sampleRate, uint32_t cnt, uint32_t silentCnt)
+{
+    std::vector<int32_t> samples(silentCnt, 0);
+    uint32_t i;
+
+    for (i = 0; i < cnt; i++)
+    {
+        samples.push_back(lround(TEST_AMPLITUDE * sin(2 * M_PI * freq * i / sampleRate)));
+    }
+
+    return samples;
+}
+
+static void upload(const char *fileName, const std::string &content)
+{
+    uint32_t i;
+
+    httpServer.nativeBeginRequest(HTTP_POST, "/");
+    httpServer.nativeAddHeader("Cookie", TEST_SESSION_COOKIE);
+    httpServer.nativeSetUpload("file", fileName, reinterpret_cast<const uint8_t *>(content.data()), content.size());
+    for (i = 0; i < TEST_MAX_LOOPS && httpServer.nativeRequestPending(); i++)
+    {
+        loop();
+        native_clock_advance(TEST_LOOP_STEP_US);
+    }
+}
+
+static std::string read_file(const char *fileName)
+{
+    std::string content;
+    uint8_t buf[512];
+    size_t len;
+
+    File file = LittleFS.open(fileName, "r");
+    if (file)
+    {
+        while ((len = file.read(buf, sizeof(buf))) > 0)
+        {
+            content.append(reinterpret_cast<const char *>(buf), len);
+        }
+        file.close();
+    }
+
+    return content;
+}
+
+/*
+ * Check header of converted file.
+ *
+ * @param[out] samples  Samples of file.
+ */
+static void read_converted(const char *fileName, std::vector<int16_t> &samples)
+{
+    std::string wav = read_file(fileName);
+    size_t pos;
+
+    samples.clear();
+    TEST_ASSERT_TRUE(wav.size() >= TEST_WAV_HEADER_SIZE);
+    TEST_ASSERT_EQUAL_INT(0, wav.compare(0, 4, "RIFF"));
+    TEST_ASSERT_EQUAL_UINT32(wav.size() - 8, get_le32(wav, 4));
+    TEST_ASSERT_EQUAL_INT(0, wav.compare(8, 8, "WAVEfmt "));
+    TEST_ASSERT_EQUAL_UINT32(16, get_le32(wav, 16));
+    /* PCM, mono */
+    TEST_ASSERT_EQUAL_UINT32(TEST_FORMAT_PCM | (1u << 16), get_le32(wav, 20));
+    TEST_ASSERT_EQUAL_UINT32(TEST_OUT_SAMPLE_RATE, get_le32(wav, 24));
+    TEST_ASSERT_EQUAL_UINT32(TEST_OUT_SAMPLE_RATE * 2, get_le32(wav, 28));
+    /* Block align 2, 16 bit */
+    TEST_ASSERT_EQUAL_UINT32(2 | (16u << 16), get_le32(wav, 32));
+    TEST_ASSERT_EQUAL_INT(0, wav.compare(36, 4, "data"));
+    TEST_ASSERT_EQUAL_UINT32(wav.size() - TEST_WAV_HEADER_SIZE, get_le32(wav, 40));
+    for (pos = TEST_WAV_HEADER_SIZE; pos + 1 < wav.size(); pos += 2)
+    {
+        samples.push_back(static_cast<int16_t>(static_cast<uint8_t>(wav[pos]) | (static_cast<uint8_t>(wav[pos + 1]) << 8)));
+    }
+}
+
+/*
+ * Amplitude of sine wave from RMS of the second half of samples, the
+ * filter has settled by then.
+ */
+static double amplitude(const std::vector<int16_t> &samples)
+{
+    double sum = 0;
+    size_t i;
+
+    for (i = samples.size() / 2; i < samples.size(); i++)
+    {
+        sum += static_cast<double>(samples[i]) * samples[i];
+    }
+
+    return sqrt(2 * sum / (samples.size() - samples.size() / 2));
+}
+
+static void check_sample_cnt(uint32_t inCnt, uint32_t inSampleRate, size_t outCnt)
+{
+    uint32_t expected = static_cast<uint64_t>(inCnt) * TEST_OUT_SAMPLE_RATE / inSampleRate;
+
+    TEST_ASSERT_TRUE(outCnt + 2 >= expected && outCnt <= expected + 2);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/*
+ * Stereo 44.1 kHz 24 bit with leading silence: mono 22050 Hz, silence is
+ * dropped, 1 kHz passes.
+ */
+static void test_stereo_24bit(void)
+{
+    const testWavFormat_t fmt = { TEST_FORMAT_PCM, 2, 44100, 24, "", "" };
+    std::vector<int16_t> out;
+
+    upload("/t_stereo24.wav", make_wav(fmt, sine(1000, 44100, 44100, 4410)));
+    read_converted("/t_stereo24.wav", out);
+    check_sample_cnt(44100, 44100, out.size());
+    TEST_ASSERT_TRUE(!out.empty() && abs(out[0]) >= TEST_SILENCE_THRESHOLD);
+    TEST_ASSERT_TRUE(fabs(amplitude(out) - TEST_AMPLITUDE) < TEST_AMPLITUDE * 0.05);
+}
+
+/*
+ * Pass band is flat up to near the cut-off, the stop band above the output
+ * Nyquist frequency is attenuated instead of being aliased.
+ */
+static void test_anti_aliasing(void)
+{
+    const testWavFormat_t fmt = { TEST_FORMAT_PCM, 1, 44100, 16, "", "" };
+    std::vector<int16_t> out;
+    char msg[80];
+    double passBand;
+    double stopBand;
+
+    upload("/t_pass.wav", make_wav(fmt, sine(8000, 44100, 22050, 0)));
+    read_converted("/t_pass.wav", out);
+    passBand = amplitude(out) / TEST_AMPLITUDE;
+    upload("/t_stop.wav", make_wav(fmt, sine(18000, 44100, 22050, 0)));
+    read_converted("/t_stop.wav", out);
+    stopBand = amplitude(out) / TEST_AMPLITUDE;
+    snprintf(msg, sizeof(msg), "Gain at 8 kHz: %.2f, at 18 kHz: %.3f", passBand, stopBand);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE(passBand > 0.75);
+    TEST_ASSERT_TRUE(stopBand < 0.15);
+}
+
+/*
+ * 8 bit samples are unsigned, upsampled 11025 -> 22050 Hz.
+ */
+static void test_8bit(void)
+{
+    const testWavFormat_t fmt = { TEST_FORMAT_PCM, 1, 11025, 8, "", "" };
+    std::vector<int32_t> samples(1000, 72 << 8);
+    std::vector<int16_t> out;
+
+    upload("/t_8bit.wav", make_wav(fmt, samples));
+    read_converted("/t_8bit.wav", out);
+    check_sample_cnt(samples.size(), 11025, out.size());
+    for (int16_t sample : out)
+    {
+        TEST_ASSERT_EQUAL_INT(72 << 8, sample);
+    }
+}
+
+/*
+ * WAVE_FORMAT_EXTENSIBLE with PCM sub format, channels are averaged.
+ */
+static void test_extensible(void)
+{
+    testWavFormat_t fmt = { TEST_FORMAT_EXTENSIBLE, 2, 22050, 16, "", "" };
+    std::vector<int32_t> samples(500, 3000);
+    std::vector<int16_t> out;
+
+    upload("/t_ext.wav", make_wav(fmt, samples));
+    read_converted("/t_ext.wav", out);
+    TEST_ASSERT_EQUAL_UINT32(samples.size(), out.size());
+    for (int16_t sample : out)
+    {
+        TEST_ASSERT_EQUAL_INT(3000, sample);
+    }
+}
+
+/*
+ * LIST chunk of odd size before fmt and after data. Output rate is the
+ * same: samples after the silence are kept exactly.
+ */
+static void test_list_before_fmt(void)
+{
+    testWavFormat_t fmt = { TEST_FORMAT_PCM, 1, 22050, 16, chunk("LIST", "INFOx"), chunk("LIST", "INFOtrailer") };
+    std::vector<int32_t> samples = sine(440, 22050, 2000, 100);
+    std::vector<int16_t> out;
+    size_t first = 0;
+    size_t i;
+
+    upload("/t_list.wav", make_wav(fmt, samples));
+    read_converted("/t_list.wav", out);
+    while (first < samples.size() && abs(samples[first]) < TEST_SILENCE_THRESHOLD)
+    {
+        first++;
+    }
+    TEST_ASSERT_EQUAL_UINT32(samples.size() - first, out.size());
+    for (i = 0; i < out.size(); i++)
+    {
+        TEST_ASSERT_EQUAL_INT(samples[first + i], out[i]);
+    }
+}
+
+/*
+ * u-law WAV and a file which is not WAV at all are stored as they are.
+ */
+static void test_passthrough(void)
+{
+    const testWavFormat_t fmt = { TEST_FORMAT_MULAW, 1, 8000, 8, "", "" };
+    std::string ulaw = make_wav(fmt, sine(440, 8000, 3000, 0));
+    std::string notWav = "ID3\x03" + std::string(3000, '\x55');
+
+    upload("/t_ulaw.wav", ulaw);
+    TEST_ASSERT_TRUE(ulaw == read_file("/t_ulaw.wav"));
+    upload("/t_id3.wav", notWav);
+    TEST_ASSERT_TRUE(notWav == read_file("/t_id3.wav"));
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    native_serial_echo(false);
+    if (!native_fs_mount_copy(NATIVE_DATA_DIR))
+    {
+        return 1;
+    }
+    setup();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_stereo_24bit);
+    RUN_TEST(test_anti_aliasing);
+    RUN_TEST(test_8bit);
+    RUN_TEST(test_extensible);
+    RUN_TEST(test_list_before_fmt);
+    RUN_TEST(test_passthrough);
+
+    return UNITY_END();
+}
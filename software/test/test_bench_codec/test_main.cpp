@@ -0,0 +1,454 @@
+/**
+ * @file        test_main.cpp
+ * @brief       Decoding cost of the audio codecs on the host
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-17 01:41:09
+ * Last modify: 2026-10-17 01:41:09 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * doorbell.wav of data/ is encoded to u-law and IMA ADPCM by the test, then
+ * every format is decoded by the generator of audio_codec_generator() into
+ * memory. CPU time per sample is reported, compared to PCM WAV, with the
+ * size of the file. Decoded audio is compared to the original.
+ *
+ * MP3 and MOD have no decoder in the native environment, they are skipped;
+ * on the target the codec statistics of /sysinfo.json give their cost.
+ *
+ * pio test -e native -f test_bench_codec -v
+ */
+
+#include <math.h>
+#include <time.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <unity.h>
+#include "AudioFileSourcePROGMEM.h"
+#include "AudioOutput.h"
+
+#include "native.h"
+
+#include "config.h"
+#include "audio_codec.h"
+#include "audio_wav_compressed.h"
+
+#define BENCH_RUN_CNT               5       /* Fastest run is reported */
+#define BENCH_ADPCM_BLOCK_SIZE      256     /* Block of mono IMA ADPCM */
+#define BENCH_ADPCM_BLOCK_SAMPLES   ((BENCH_ADPCM_BLOCK_SIZE - 4) * 2 + 1)
+#define BENCH_ULAW_MIN_SNR_DB       30.0
+#define BENCH_ADPCM_MIN_SNR_DB      20.0
+
+/* Samples are stored, it never refuses them */
+class BenchOutput : public AudioOutput
+{
+public:
+    virtual bool begin() override { samples.clear(); return true; }
+    virtual bool ConsumeSample(int16_t sample[2]) override
+    {
+        int16_t ms[2] = { sample[LEFTCHANNEL], sample[RIGHTCHANNEL] };
+
+        MakeSampleStereo16(ms);
+        samples.push_back(ms[LEFTCHANNEL]);
+        return true;
+    }
+    virtual bool stop() override { return true; }
+
+    std::vector<int16_t> samples;
+};
+
+static const int16_t adpcmStepTable[89] =
+{
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+    253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+    1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+    3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442,
+    11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794,
+    32767
+};
+
+static const int8_t adpcmIndexTable[8] = { -1, -1, -1, -1, 2, 4, 6, 8 };
+
+static std::string benchPcmWav;     /* doorbell.wav */
+static std::vector<int16_t> benchPcm;
+static uint32_t benchSampleRate;
+static double benchWavNsPerSample;
+
+static uint64_t bench_cpu_ns()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000u + ts.tv_nsec;
+}
+
+static void put_le16(std::string &s, uint16_t v)
+{
+    s += static_cast<char>(v & 0xFF);
+    s += static_cast<char>(v >> 8);
+}
+
+static void put_le32(std::string &s, uint32_t v)
+{
+    put_le16(s, v & 0xFFFF);
+    put_le16(s, v >> 16);
+}
+
+static uint32_t get_le32(const std::string &s, size_t pos)
+{
+    return static_cast<uint8_t>(s[pos]) | (static_cast<uint8_t>(s[pos + 1]) << 8)
+           | (static_cast<uint8_t>(s[pos + 2]) << 16) | (static_cast<uint32_t>(static_cast<uint8_t>(s[pos + 3])) << 24);
+}
+
+/*
+ * Mono WAV file: fmt chunk of formatTag, then data.
+ */
+static std::string make_wav(uint16_t formatTag, uint32_t byteRate, uint16_t blockAlign, uint16_t bitsPerSample,
+                            const std::string &extra, const std::string &data)
+{
+    std::string fmt;
+    std::string wav("RIFF");
+
+    put_le16(fmt, formatTag);
+    put_le16(fmt, 1);
+    put_le32(fmt, benchSampleRate);
+    put_le32(fmt, byteRate);
+    put_le16(fmt, blockAlign);
+    put_le16(fmt, bitsPerSample);
+    if (!extra.empty())
+    {
+        put_le16(fmt, extra.size());
+        fmt += extra;
+    }
+    put_le32(wav, 4 + 8 + fmt.size() + 8 + data.size());
+    wav += "WAVEfmt ";
+    put_le32(wav, fmt.size());
+    wav += fmt;
+    wav += "data";
+    put_le32(wav, data.size());
+
+    return wav + data;
+}
+
+/*
+ * G.711 u-law encoder.
+ */
+static uint8_t ulaw_encode(int16_t sample)
+{
+    int32_t s = sample;
+    uint8_t sign = 0;
+    uint8_t exponent = 7;
+    uint16_t mask;
+
+    if (s < 0)
+    {
+        sign = 0x80;
+        s = -s;
+    }
+    s = MIN(s, 32635) + 0x84;
+    for (mask = 0x4000; !(s & mask) && exponent; mask >>= 1)
+    {
+        exponent--;
+    }
+
+    return ~(sign | (exponent << 4) | ((s >> (exponent + 3)) & 0x0F));
+}
+
+static std::string make_ulaw_wav()
+{
+    std::string data;
+
+    for (int16_t sample : benchPcm)
+    {
+        data += static_cast<char>(ulaw_encode(sample));
+    }
+
+    return make_wav(WAV_FORMAT_MULAW, benchSampleRate, 1, 8, std::string(), data);
+}
+
+/*
+ * IMA ADPCM encoder, returns the nibble and updates the state like the
+ * decoder does.
+ */
+static uint8_t adpcm_encode(int16_t sample, int32_t &predictor, int8_t &stepIndex)
+{
+    int32_t diff = sample - predictor;
+    int32_t step = adpcmStepTable[stepIndex];
+    int32_t delta = step >> 3;
+    uint8_t nibble = 0;
+
+    if (diff < 0)
+    {
+        nibble = 8;
+        diff = -diff;
+    }
+    if (diff >= step)
+    {
+        nibble |= 4;
+        diff -= step;
+        delta += step;
+    }
+    step >>= 1;
+    if (diff >= step)
+    {
+        nibble |= 2;
+        diff -= step;
+        delta += step;
+    }
+    step >>= 1;
+    if (diff >= step)
+    {
+        nibble |= 1;
+        delta += step;
+    }
+    predictor += (nibble & 8) ? -delta : delta;
+    predictor = MAX(-32768, MIN(32767, predictor));
+    stepIndex = MAX(0, MIN(88, stepIndex + adpcmIndexTable[nibble & 7]));
+
+    return nibble;
+}
+
+static std::string make_adpcm_wav()
+{
+    std::string data;
+    std::string extra;
+    int32_t predictor;
+    int8_t stepIndex = 0;
+    size_t pos;
+    size_t i;
+    uint8_t nibbles[8];
+    uint8_t j;
+
+    for (pos = 0; pos < benchPcm.size(); pos += BENCH_ADPCM_BLOCK_SAMPLES)
+    {
+        /* Header has the first sample, last block is padded with silence */
+        predictor = benchPcm[pos];
+        put_le16(data, static_cast<uint16_t>(predictor));
+        data += static_cast<char>(stepIndex);
+        data += '\0';
+        for (i = pos + 1; i < pos + BENCH_ADPCM_BLOCK_SAMPLES; i += 8)
+        {
+            for (j = 0; j < 8; j++)
+            {
+                nibbles[j] = adpcm_encode(i + j < benchPcm.size() ? benchPcm[i + j] : 0, predictor, stepIndex);
+            }
+            for (j = 0; j < 8; j += 2)
+            {
+                data += static_cast<char>(nibbles[j] | (nibbles[j + 1] << 4));
+            }
+        }
+    }
+    put_le16(extra, BENCH_ADPCM_BLOCK_SAMPLES);
+
+    return make_wav(WAV_FORMAT_IMA_ADPCM, benchSampleRate * BENCH_ADPCM_BLOCK_SIZE / BENCH_ADPCM_BLOCK_SAMPLES,
+                    BENCH_ADPCM_BLOCK_SIZE, 4, extra, data);
+}
+
+/*
+ * Decode file BENCH_RUN_CNT times with the generator of codec.
+ *
+ * @return Fastest run in ns per sample, 0: file is not detected as codec or
+ *         generator did not start.
+ */
+static double bench_decode(audioCodec_t codec, const std::string &file, BenchOutput &out)
+{
+    AudioGenerator *gen = audio_codec_generator(codec);
+    AudioFileSourcePROGMEM source;
+    uint64_t start_ns;
+    uint64_t best_ns = UINT64_MAX;
+    uint8_t run;
+
+    if (!gen || audio_codec_sniff_buffer(reinterpret_cast<const uint8_t *>(file.data()), file.size()) != codec)
+    {
+        return 0;
+    }
+    for (run = 0; run < BENCH_RUN_CNT; run++)
+    {
+        source.open(file.data(), file.size());
+        out.begin();
+        out.samples.reserve(benchPcm.size() + BENCH_ADPCM_BLOCK_SAMPLES);
+        start_ns = bench_cpu_ns();
+        if (!gen->begin(&source, &out))
+        {
+            source.close();
+            return 0;
+        }
+        while (gen->isRunning() && gen->loop())
+        {
+        }
+        gen->stop();
+        best_ns = MIN(best_ns, bench_cpu_ns() - start_ns);
+    }
+
+    return out.samples.empty() ? 0 : static_cast<double>(best_ns) / out.samples.size();
+}
+
+/*
+ * Signal to noise ratio of decoded samples against the original.
+ */
+static double bench_snr_db(const std::vector<int16_t> &decoded)
+{
+    double signal = 0;
+    double noise = 0;
+    size_t i;
+
+    for (i = 0; i < benchPcm.size(); i++)
+    {
+        signal += static_cast<double>(benchPcm[i]) * benchPcm[i];
+        noise += static_cast<double>(decoded[i] - benchPcm[i]) * (decoded[i] - benchPcm[i]);
+    }
+
+    return noise ? 10.0 * log10(signal / noise) : INFINITY;
+}
+
+static void bench_report(audioCodec_t codec, size_t fileSize, double nsPerSample, double snr_db)
+{
+    char buf[160];
+
+    snprintf(buf, sizeof(buf), "%-10s file: %7u bytes (%5.1f %%), decode: %6.1f ns/sample (%5.2f x WAV), SNR: %5.1f dB",
+             audio_codec_name(codec), static_cast<unsigned int>(fileSize), 100.0 * fileSize / benchPcmWav.size(),
+             nsPerSample, benchWavNsPerSample ? nsPerSample / benchWavNsPerSample : 1.0, snr_db);
+    TEST_MESSAGE(buf);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+static void test_wav(void)
+{
+    BenchOutput out;
+
+    benchWavNsPerSample = bench_decode(AUDIO_CODEC_WAV, benchPcmWav, out);
+    TEST_ASSERT_TRUE(benchWavNsPerSample > 0);
+    /* Like ESP8266Audio, the generator sends its previous sample first */
+    TEST_ASSERT_EQUAL_UINT32(benchPcm.size() + 1u, out.samples.size());
+    TEST_ASSERT_TRUE(std::equal(benchPcm.begin(), benchPcm.end(), out.samples.begin() + 1));
+    bench_report(AUDIO_CODEC_WAV, benchPcmWav.size(), benchWavNsPerSample, INFINITY);
+}
+
+static void test_ulaw(void)
+{
+    std::string file = make_ulaw_wav();
+    BenchOutput out;
+    double nsPerSample = bench_decode(AUDIO_CODEC_ULAW, file, out);
+    double snr_db;
+
+    TEST_ASSERT_TRUE(nsPerSample > 0);
+    TEST_ASSERT_EQUAL_UINT32(benchPcm.size(), out.samples.size());
+    snr_db = bench_snr_db(out.samples);
+    bench_report(AUDIO_CODEC_ULAW, file.size(), nsPerSample, snr_db);
+    TEST_ASSERT_TRUE(snr_db > BENCH_ULAW_MIN_SNR_DB);
+}
+
+static void test_adpcm(void)
+{
+    std::string file = make_adpcm_wav();
+    BenchOutput out;
+    double nsPerSample = bench_decode(AUDIO_CODEC_ADPCM, file, out);
+    double snr_db;
+
+    TEST_ASSERT_TRUE(nsPerSample > 0);
+    /* Last block is padded */
+    TEST_ASSERT_TRUE(out.samples.size() >= benchPcm.size()
+                     && out.samples.size() < benchPcm.size() + BENCH_ADPCM_BLOCK_SAMPLES);
+    snr_db = bench_snr_db(out.samples);
+    bench_report(AUDIO_CODEC_ADPCM, file.size(), nsPerSample, snr_db);
+    TEST_ASSERT_TRUE(snr_db > BENCH_ADPCM_MIN_SNR_DB);
+}
+
+static void test_mp3(void)
+{
+    TEST_IGNORE_MESSAGE("No MP3 decoder in native environment");
+}
+
+static void test_mod(void)
+{
+    File file = LittleFS.open("/pinkpanther.mod", "r");
+    std::string data;
+    BenchOutput out;
+    double nsPerSample;
+
+    TEST_ASSERT_TRUE(file);
+    data.resize(file.size());
+    file.read(reinterpret_cast<uint8_t *>(&data[0]), data.size());
+    file.close();
+    TEST_ASSERT_EQUAL_INT(AUDIO_CODEC_MOD, audio_codec_sniff_buffer(reinterpret_cast<const uint8_t *>(data.data()), data.size()));
+    nsPerSample = bench_decode(AUDIO_CODEC_MOD, data, out);
+    if (!nsPerSample)
+    {
+        TEST_IGNORE_MESSAGE("No MOD decoder in native environment");
+    }
+    bench_report(AUDIO_CODEC_MOD, data.size(), nsPerSample, NAN);
+}
+
+/*
+ * 16 bit mono PCM of doorbell.wav.
+ */
+static bool load_pcm()
+{
+    File file = LittleFS.open("/doorbell.wav", "r");
+    size_t pos = 12;
+    uint32_t len;
+
+    if (!file)
+    {
+        return false;
+    }
+    benchPcmWav.resize(file.size());
+    file.read(reinterpret_cast<uint8_t *>(&benchPcmWav[0]), benchPcmWav.size());
+    file.close();
+    while (pos + 8 <= benchPcmWav.size())
+    {
+        len = get_le32(benchPcmWav, pos + 4);
+        if (!benchPcmWav.compare(pos, 4, "fmt "))
+        {
+            benchSampleRate = get_le32(benchPcmWav, pos + 12);
+            if (benchPcmWav[pos + 10] != 1 || benchPcmWav[pos + 22] != 16)
+            {
+                /* Not mono or not 16 bit */
+                return false;
+            }
+        }
+        if (!benchPcmWav.compare(pos, 4, "data"))
+        {
+            benchPcm.resize(MIN(len, benchPcmWav.size() - pos - 8) / 2);
+            memcpy(benchPcm.data(), &benchPcmWav[pos + 8], benchPcm.size() * 2);
+            return benchSampleRate && !benchPcm.empty();
+        }
+        pos += 8 + len + (len & 1);
+    }
+
+    return false;
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    native_serial_echo(false);
+    if (!native_fs_mount_copy(NATIVE_DATA_DIR) || !load_pcm())
+    {
+        return 1;
+    }
+
+    UNITY_BEGIN();
+    RUN_TEST(test_wav);
+    RUN_TEST(test_ulaw);
+    RUN_TEST(test_adpcm);
+    RUN_TEST(test_mp3);
+    RUN_TEST(test_mod);
+
+    return UNITY_END();
+}
@@ -0,0 +1,250 @@
+/**
+ * @file        test_main.cpp
+ * @brief       Cost of ring, page load, MQTT message and upload on the host
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:10:04
+ * Last modify: 2026-10-16 22:10:04 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * The unchanged firmware runs on the native stand-ins: setup() once, then
+ * loop() like on the target. Every scenario reports CPU time of the
+ * firmware, heap allocations and file system traffic, so a change can be
+ * compared before and after without flashing a device.
+ *
+ * pio test -e native -f test_bench_firmware -v
+ */
+
+#include <time.h>
+
+#include <Arduino.h>
+#include <unity.h>
+
+#include "native.h"
+#include "native_audio.h"
+#include "native_mqtt_broker.h"
+
+#include "config.h"
+#include "secrets.h"
+#include "doorbell.h"
+#include "http_server.h"
+
+#define BENCH_LOOP_STEP_US      1000        /* Clock advance between loop() calls */
+#define BENCH_MAX_LOOPS         100000      /* Limit of a scenario */
+#define BENCH_SESSION_COOKIE    "ESPSESSIONID=1"
+#define BENCH_FOLLOWED_TOPIC    "/switches/doorbell-test2/press"
+#define BENCH_UPLOAD_FILE_NAME  "bench_upload.wav"
+
+typedef struct
+{
+    uint64_t cpu_us;            /* CPU time of the firmware thread */
+    uint32_t loopCntr;          /* loop() calls */
+    uint32_t allocCntr;
+    uint64_t allocBytes;
+    int64_t peakUsedBytes;      /* Peak of heap use above start of scenario */
+    uint32_t fsOpenCntr;
+    uint64_t fsReadBytes;
+    uint64_t fsWriteBytes;
+} benchResult_t;
+
+extern void setup(void);
+extern void loop(void);
+
+static uint64_t benchStartCpu_us;
+static nativeHeapStats_t benchStartHeap;
+static nativeFsStats_t benchStartFs;
+static benchResult_t benchResult;
+
+static uint64_t bench_cpu_us()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000u + ts.tv_nsec / 1000u;
+}
+
+static void bench_begin()
+{
+    memset(&benchResult, 0, sizeof(benchResult));
+    native_heap_reset_peak();
+    benchStartHeap = native_heap_stats();
+    benchStartFs = native_fs_stats();
+    benchStartCpu_us = bench_cpu_us();
+}
+
+static void bench_end(const char *scenario)
+{
+    nativeHeapStats_t heap;
+    nativeFsStats_t fs;
+    char buf[256];
+
+    benchResult.cpu_us = bench_cpu_us() - benchStartCpu_us;
+    heap = native_heap_stats();
+    fs = native_fs_stats();
+    benchResult.allocCntr = heap.allocCntr - benchStartHeap.allocCntr;
+    benchResult.allocBytes = heap.allocBytes - benchStartHeap.allocBytes;
+    benchResult.peakUsedBytes = heap.peakUsedBytes - benchStartHeap.usedBytes;
+    benchResult.fsOpenCntr = fs.openCntr - benchStartFs.openCntr;
+    benchResult.fsReadBytes = fs.readBytes - benchStartFs.readBytes;
+    benchResult.fsWriteBytes = fs.writeBytes - benchStartFs.writeBytes;
+    snprintf(buf, sizeof(buf),
+             "%-12s time: %7llu us, loops: %5u, alloc: %5u / %8llu bytes, peak heap: +%6lli bytes, "
+             "FS open: %3u, read: %7llu bytes, write: %7llu bytes",
+             scenario, (unsigned long long)benchResult.cpu_us, benchResult.loopCntr,
+             benchResult.allocCntr, (unsigned long long)benchResult.allocBytes,
+             (long long)benchResult.peakUsedBytes, benchResult.fsOpenCntr,
+             (unsigned long long)benchResult.fsReadBytes, (unsigned long long)benchResult.fsWriteBytes);
+    TEST_MESSAGE(buf);
+}
+
+/*
+ * One iteration of the main loop on the target.
+ */
+static void bench_loop()
+{
+    loop();
+    native_clock_advance(BENCH_LOOP_STEP_US);
+    benchResult.loopCntr++;
+}
+
+/*
+ * Loop until audio started by the scenario has been played.
+ */
+static bool bench_loop_until_played(uint32_t beginCntr)
+{
+    uint32_t i;
+
+    for (i = 0; i < BENCH_MAX_LOOPS; i++)
+    {
+        if (native_i2s_stats().beginCntr != beginCntr && !doorbell_is_playing())
+        {
+            return true;
+        }
+        bench_loop();
+    }
+
+    return false;
+}
+
+static void bench_loop_until_response()
+{
+    uint32_t i;
+
+    for (i = 0; i < BENCH_MAX_LOOPS && httpServer.nativeRequestPending(); i++)
+    {
+        bench_loop();
+    }
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/*
+ * Switch is pressed and released, the whole audio file is played.
+ */
+static void test_ring(void)
+{
+    uint32_t beginCntr = native_i2s_stats().beginCntr;
+    uint32_t sampleCntr;
+
+    bench_begin();
+    native_gpio_input(DOORBELL_SWITCH_PIN, LOW);
+    native_clock_advance(200000);
+    bench_loop();
+    native_gpio_input(DOORBELL_SWITCH_PIN, HIGH);
+    TEST_ASSERT_TRUE(bench_loop_until_played(beginCntr));
+    sampleCntr = native_i2s_stats().sampleCntr;
+    bench_end("ring");
+
+    TEST_ASSERT_GREATER_THAN_UINT32(0, sampleCntr);
+}
+
+static void test_page_load(void)
+{
+    /* Request is taken by the next loop() */
+    httpServer.nativeBeginRequest(HTTP_GET, "/index.htm");
+    httpServer.nativeAddHeader("Cookie", BENCH_SESSION_COOKIE);
+    httpServer.nativeAddHeader("Accept-Encoding", "gzip");
+    bench_begin();
+    bench_loop_until_response();
+    bench_end("page load");
+
+    TEST_ASSERT_EQUAL_INT(200, httpServer.nativeResponse().code);
+    TEST_ASSERT_GREATER_THAN(0, httpServer.nativeResponse().body.size());
+}
+
+/*
+ * Message of the followed topic rings the doorbell.
+ */
+static void test_mqtt_message(void)
+{
+    uint16_t port = native_broker_start();
+    uint32_t beginCntr;
+    uint32_t i;
+    bool published = false;
+
+    TEST_ASSERT_GREATER_THAN(0, port);
+    native_net_redirect(IPAddress(192, 168, 5, 4), MQTT_SERVERPORT, port);
+    /* Connecting and subscribing is not part of the scenario */
+    for (i = 0; i < BENCH_MAX_LOOPS && !published; i++)
+    {
+        bench_loop();
+        published = native_broker_publish(BENCH_FOLLOWED_TOPIC, "1");
+    }
+    TEST_ASSERT_TRUE(published);
+    beginCntr = native_i2s_stats().beginCntr;
+    bench_begin();
+    TEST_ASSERT_TRUE(bench_loop_until_played(beginCntr));
+    bench_end("MQTT message");
+    native_broker_stop();
+}
+
+static void test_upload(void)
+{
+    File wav = LittleFS.open("/doorbell.wav", "r");
+    std::string data;
+
+    TEST_ASSERT_TRUE(wav);
+    data.resize(wav.size());
+    wav.read(reinterpret_cast<uint8_t *>(&data[0]), data.size());
+    wav.close();
+
+    httpServer.nativeBeginRequest(HTTP_POST, "/");
+    httpServer.nativeAddHeader("Cookie", BENCH_SESSION_COOKIE);
+    httpServer.nativeSetUpload("file", BENCH_UPLOAD_FILE_NAME, reinterpret_cast<const uint8_t *>(data.data()),
+                               data.size());
+    bench_begin();
+    bench_loop_until_response();
+    bench_end("upload");
+
+    TEST_ASSERT_EQUAL_INT(200, httpServer.nativeResponse().code);
+    TEST_ASSERT_TRUE(LittleFS.exists("/" BENCH_UPLOAD_FILE_NAME));
+    TEST_ASSERT_GREATER_THAN(0, benchResult.fsWriteBytes);
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    native_serial_echo(false);
+    if (!native_fs_mount_copy(NATIVE_DATA_DIR))
+    {
+        return 1;
+    }
+    setup();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_ring);
+    RUN_TEST(test_page_load);
+    RUN_TEST(test_mqtt_message);
+    RUN_TEST(test_upload);
+
+    return UNITY_END();
+}
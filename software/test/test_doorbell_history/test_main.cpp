@@ -0,0 +1,114 @@
+/**
+ * @file        test_main.cpp
+ * @brief       Head of the segmented event log after restart
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-17 11:05:48
+ * Last modify: 2026-10-17 11:05:48 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * Events are added within the same second, like before NTP
+ * synchronization, and the log is loaded again around every rollover of
+ * the segments. The newest events are found without the time stamps.
+ *
+ * pio test -e native -f test_doorbell_history
+ */
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <unity.h>
+
+#include "native.h"
+
+#include "config.h"
+#include "fileutils.h"
+#include "doorbell_history.h"
+
+#define TEST_SEGMENT0           "doorbell_history0.bin"
+#define TEST_SEGMENT1           "doorbell_history1.bin"
+#define TEST_SEGMENT_SIZE       (DOORBELL_HISTORY_LENGTH * sizeof(doorbellHistoryRecord_t))
+#define TEST_EVENT_TYPE_CNT     5
+
+static doorbellHistoryRecord_t records[DOORBELL_HISTORY_LENGTH];
+
+/*
+ * Event type of n-th added event, so the order can be checked.
+ */
+static uint8_t test_event_type(uint32_t n)
+{
+    return (n / 3 + n) % TEST_EVENT_TYPE_CNT;
+}
+
+/*
+ * Load log like after restart and check the newest events.
+ *
+ * @param[in] addedCnt  Number of events added since the log was empty.
+ */
+static void check_after_restart(uint32_t addedCnt)
+{
+    uint16_t cnt;
+    uint16_t i;
+    char msg[64];
+
+    snprintf(msg, sizeof(msg), "after %u events", addedCnt);
+    TEST_ASSERT_FALSE_MESSAGE(fileSize(TEST_SEGMENT0) == TEST_SEGMENT_SIZE && fileSize(TEST_SEGMENT1) == TEST_SEGMENT_SIZE,
+                              msg);
+    doorbell_history_init();
+    cnt = doorbell_history_read(records, DOORBELL_HISTORY_LENGTH);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(MIN(addedCnt, static_cast<uint32_t>(DOORBELL_HISTORY_LENGTH)), cnt, msg);
+    for (i = 0; i < cnt; i++)
+    {
+        TEST_ASSERT_EQUAL_INT_MESSAGE(test_event_type(addedCnt - 1 - i), records[i].eventType, msg);
+    }
+    TEST_ASSERT_NOT_NULL(doorbell_history_get(0));
+    TEST_ASSERT_EQUAL_INT_MESSAGE(test_event_type(addedCnt - 1), doorbell_history_get(0)->eventType, msg);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+static void test_head_is_found_at_rollover(void)
+{
+    const uint32_t checkpoints[] =
+    {
+        1, DOORBELL_HISTORY_LENGTH - 1, DOORBELL_HISTORY_LENGTH, DOORBELL_HISTORY_LENGTH + 1,
+        2 * DOORBELL_HISTORY_LENGTH - 1, 2 * DOORBELL_HISTORY_LENGTH, 2 * DOORBELL_HISTORY_LENGTH + 1,
+        3 * DOORBELL_HISTORY_LENGTH, 3 * DOORBELL_HISTORY_LENGTH + DOORBELL_HISTORY_LENGTH / 2
+    };
+    uint32_t n = 0;
+    uint8_t i;
+
+    LittleFS.remove(TEST_SEGMENT0);
+    LittleFS.remove(TEST_SEGMENT1);
+    doorbell_history_init();
+    for (i = 0; i < sizeof(checkpoints) / sizeof(checkpoints[0]); i++)
+    {
+        for (; n < checkpoints[i]; n++)
+        {
+            TEST_ASSERT_TRUE(doorbell_history_add(test_event_type(n)));
+        }
+        check_after_restart(n);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    native_serial_echo(false);
+    if (!native_fs_mount_copy(NATIVE_DATA_DIR))
+    {
+        return 1;
+    }
+
+    UNITY_BEGIN();
+    RUN_TEST(test_head_is_found_at_rollover);
+
+    return UNITY_END();
+}
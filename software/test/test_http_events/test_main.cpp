@@ -0,0 +1,185 @@
+/**
+ * @file        test_main.cpp
+ * @brief       Subscribers of Server-Sent Events which do not read
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-17 10:12:36
+ * Last modify: 2026-10-17 10:12:36 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * One subscriber reads the events, the other one never does. When its send
+ * buffer is full it is dropped without waiting, the other subscriber gets
+ * every event.
+ *
+ * pio test -e native -f test_http_events
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <Arduino.h>
+#include <unity.h>
+
+#include "native.h"
+
+#include "config.h"
+#include "http_server.h"
+#include "http_events.h"
+
+#define TEST_LOOP_STEP_US       1000
+#define TEST_MAX_LOOPS          1000
+#define TEST_MAX_EVENTS         100000
+#define TEST_MAX_TASK_TIME_US   50000   /* Write with timeout took 1 s */
+#define TEST_SESSION_COOKIE     "ESPSESSIONID=1"
+
+extern void setup(void);
+extern void loop(void);
+
+static uint64_t test_time_us()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000u + ts.tv_nsec / 1000u;
+}
+
+/*
+ * @return Test end of the connection, -1 on error.
+ */
+static int subscribe()
+{
+    uint32_t i;
+    int fd;
+
+    httpServer.nativeBeginRequest(HTTP_GET, EVENTS_URI);
+    httpServer.nativeAddHeader("Cookie", TEST_SESSION_COOKIE);
+    for (i = 0; i < TEST_MAX_LOOPS && httpServer.nativeRequestPending(); i++)
+    {
+        loop();
+        native_clock_advance(TEST_LOOP_STEP_US);
+    }
+    fd = httpServer.nativeResponse().clientFd;
+    /* Connection is taken, next request does not close it */
+    httpServer.nativeResponse().clientFd = -1;
+    if (fd >= 0)
+    {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    }
+
+    return fd;
+}
+
+/*
+ * Read everything which arrived.
+ *
+ * @return Number of events read, -1 if connection was closed.
+ */
+static int read_events(int fd, std::string &buf)
+{
+    char data[1024];
+    ssize_t len;
+    size_t pos;
+    int cnt = 0;
+
+    while ((len = read(fd, data, sizeof(data))) > 0)
+    {
+        buf.append(data, len);
+    }
+    if (!len)
+    {
+        return -1;
+    }
+    while ((pos = buf.find("\n\n")) != std::string::npos)
+    {
+        cnt += buf.compare(0, 11, "event: ring") == 0;
+        buf.erase(0, pos + 2);
+    }
+
+    return cnt;
+}
+
+/*
+ * @return true if the firmware closed its end, nothing is read.
+ */
+static bool is_closed(int fd)
+{
+    struct pollfd pfd = { fd, POLLRDHUP, 0 };
+
+    return poll(&pfd, 1, 0) > 0 && (pfd.revents & (POLLRDHUP | POLLHUP));
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+static void test_stalled_subscriber_is_dropped(void)
+{
+    String data = "Ring at 2026-10-17 10:12:36 ";
+    std::string readerBuf;
+    uint64_t start_us;
+    uint64_t maxTaskTime_us = 0;
+    uint32_t sent;
+    uint32_t received = 0;
+    int reader;
+    int stalled;
+    int cnt;
+
+    reader = subscribe();
+    stalled = subscribe();
+    while (data.length() < 128)
+    {
+        data += '.';
+    }
+    TEST_ASSERT_TRUE(reader >= 0);
+    TEST_ASSERT_TRUE(stalled >= 0);
+    read_events(reader, readerBuf);
+
+    /* Stalled subscriber is closed by the firmware when it is dropped */
+    for (sent = 0; sent < TEST_MAX_EVENTS; sent++)
+    {
+        if (is_closed(stalled))
+        {
+            break;
+        }
+        http_events_send("ring", data);
+        start_us = test_time_us();
+        http_events_task();
+        maxTaskTime_us = MAX(maxTaskTime_us, test_time_us() - start_us);
+        cnt = read_events(reader, readerBuf);
+        TEST_ASSERT_TRUE(cnt >= 0);
+        received += cnt;
+    }
+    TEST_ASSERT_TRUE(sent < TEST_MAX_EVENTS);
+    TEST_ASSERT_TRUE(sent > 1);
+    TEST_ASSERT_EQUAL_UINT32(sent, received);
+    TEST_ASSERT_TRUE(maxTaskTime_us < TEST_MAX_TASK_TIME_US);
+
+    close(reader);
+    close(stalled);
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    native_serial_echo(false);
+    if (!native_fs_mount_copy(NATIVE_DATA_DIR))
+    {
+        return 1;
+    }
+    setup();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_stalled_subscriber_is_dropped);
+
+    return UNITY_END();
+}
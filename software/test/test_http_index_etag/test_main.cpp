@@ -0,0 +1,132 @@
+/**
+ * @file        test_main.cpp
+ * @brief       Version of the generated index page
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 23:12:40
+ * Last modify: 2026-10-16 23:12:40 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * Writing an unrelated file keeps the ETag of the index page, a ring
+ * changes it.
+ *
+ * pio test -e native -f test_http_index_etag
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+
+#include "native.h"
+
+#include "config.h"
+#include "doorbell.h"
+#include "http_server.h"
+
+#define TEST_LOOP_STEP_US       1000
+#define TEST_MAX_LOOPS          100000
+#define TEST_SESSION_COOKIE     "ESPSESSIONID=1"
+
+extern void setup(void);
+extern void loop(void);
+
+static void loop_until_response()
+{
+    uint32_t i;
+
+    for (i = 0; i < TEST_MAX_LOOPS && httpServer.nativeRequestPending(); i++)
+    {
+        loop();
+        native_clock_advance(TEST_LOOP_STEP_US);
+    }
+}
+
+/*
+ * @return Response code of GET /index.htm.
+ */
+static int get_index(const String &etag)
+{
+    httpServer.nativeBeginRequest(HTTP_GET, "/index.htm");
+    httpServer.nativeAddHeader("Cookie", TEST_SESSION_COOKIE);
+    if (etag.length())
+    {
+        httpServer.nativeAddHeader("If-None-Match", etag);
+    }
+    loop_until_response();
+
+    return httpServer.nativeResponse().code;
+}
+
+static void upload(const char *fileName, const char *content)
+{
+    httpServer.nativeBeginRequest(HTTP_POST, "/");
+    httpServer.nativeAddHeader("Cookie", TEST_SESSION_COOKIE);
+    httpServer.nativeSetUpload("file", fileName, reinterpret_cast<const uint8_t *>(content), strlen(content));
+    loop_until_response();
+}
+
+static void ring()
+{
+    uint32_t i;
+
+    native_gpio_input(DOORBELL_SWITCH_PIN, LOW);
+    native_clock_advance(200000);
+    loop();
+    native_gpio_input(DOORBELL_SWITCH_PIN, HIGH);
+    loop();
+    for (i = 0; i < TEST_MAX_LOOPS && doorbell_is_playing(); i++)
+    {
+        loop();
+        native_clock_advance(TEST_LOOP_STEP_US);
+    }
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+static void test_file_write_keeps_etag(void)
+{
+    String etag;
+
+    TEST_ASSERT_EQUAL_INT(200, get_index(""));
+    etag = httpServer.nativeResponse().header("ETag");
+    TEST_ASSERT_TRUE(etag.length() > 0);
+
+    upload("notes.txt", "unrelated file\n");
+    TEST_ASSERT_EQUAL_INT(200, httpServer.nativeResponse().code);
+    TEST_ASSERT_EQUAL_INT(304, get_index(etag));
+}
+
+static void test_ring_changes_etag(void)
+{
+    String etag;
+
+    TEST_ASSERT_EQUAL_INT(200, get_index(""));
+    etag = httpServer.nativeResponse().header("ETag");
+    ring();
+    TEST_ASSERT_EQUAL_INT(200, get_index(etag));
+    TEST_ASSERT_TRUE(etag != httpServer.nativeResponse().header("ETag"));
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    native_serial_echo(false);
+    if (!native_fs_mount_copy(NATIVE_DATA_DIR))
+    {
+        return 1;
+    }
+    setup();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_file_write_keeps_etag);
+    RUN_TEST(test_ring_changes_etag);
+
+    return UNITY_END();
+}
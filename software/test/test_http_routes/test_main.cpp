@@ -0,0 +1,186 @@
+/**
+ * @file        test_main.cpp
+ * @brief       Route table of generated pages
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 23:30:52
+ * Last modify: 2026-10-16 23:30:52 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * Authentication of routes follows the auth page of the route, and the
+ * cost of finding a route is measured as the table grows, compared with
+ * the linear search of handlers registered by ESP8266WebServer::on().
+ *
+ * pio test -e native -f test_http_routes -v
+ */
+
+#include <time.h>
+
+#include <Arduino.h>
+#include <unity.h>
+
+#include "native.h"
+
+#include "config.h"
+#include "http_server.h"
+#include "http_routes.h"
+
+#define TEST_LOOP_STEP_US       1000
+#define TEST_MAX_LOOPS          1000
+#define TEST_MAX_ROUTES         (HTTP_ROUTE_BUCKET_CNT / 2)
+#define TEST_LOOKUP_CNT         200000
+#define TEST_URI_SIZE           24
+
+extern void setup(void);
+extern void loop(void);
+
+static char routeUris[TEST_MAX_ROUTES][TEST_URI_SIZE];
+static httpRoute_t routes[TEST_MAX_ROUTES];
+static volatile uint32_t sink;
+
+static uint64_t test_time_ns()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000u + ts.tv_nsec;
+}
+
+static void test_handler()
+{
+}
+
+static int get(const char *uri)
+{
+    uint32_t i;
+
+    httpServer.nativeBeginRequest(HTTP_GET, uri);
+    for (i = 0; i < TEST_MAX_LOOPS && httpServer.nativeRequestPending(); i++)
+    {
+        loop();
+        native_clock_advance(TEST_LOOP_STEP_US);
+    }
+
+    return httpServer.nativeResponse().code;
+}
+
+/*
+ * Search of handler chain of ESP8266WebServer: URI of every handler is
+ * compared until one matches.
+ */
+static const httpRoute_t *linear_find(const String &uri, uint8_t routeCnt)
+{
+    uint8_t i;
+
+    for (i = 0; i < routeCnt; i++)
+    {
+        if (uri == routes[i].uri)
+        {
+            return &routes[i];
+        }
+    }
+
+    return NULL;
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/*
+ * By default only index.htm is public, "/" serves the same page.
+ */
+static void test_root_follows_index_auth(void)
+{
+    TEST_ASSERT_EQUAL_INT(200, get(INDEX_HTM));
+    TEST_ASSERT_EQUAL_INT(200, get("/"));
+    TEST_ASSERT_EQUAL_INT(301, get(ADMIN_HTM));
+    TEST_ASSERT_EQUAL_STRING(LOGIN_HTM, httpServer.nativeResponse().header("Location").c_str());
+}
+
+/*
+ * Time of http_routes_find() includes its own statistics (two
+ * ESP.getCycleCount() calls), like on the target.
+ */
+static void test_dispatch_cost(void)
+{
+    const String missUri = "/missing.htm";
+    String hitUri;
+    uint64_t start_ns;
+    uint32_t tableHit_ns;
+    uint32_t tableMiss_ns;
+    uint32_t linearHit_ns;
+    uint32_t linearMiss_ns;
+    uint32_t i;
+    uint8_t routeCnt;
+    char buf[160];
+
+    for (i = 0; i < TEST_MAX_ROUTES; i++)
+    {
+        snprintf(routeUris[i], sizeof(routeUris[i]), "/generated_page_%02u.htm", i);
+        routes[i] = { http_route_hash(routeUris[i]), routeUris[i], HTTP_ROUTE_GET, HTTP_AUTH_PUBLIC, NULL, test_handler };
+    }
+
+    for (routeCnt = 1; routeCnt <= TEST_MAX_ROUTES; routeCnt *= 2)
+    {
+        http_routes_init(routes, routeCnt);
+        /* Last route is the worst case of linear search */
+        hitUri = routes[routeCnt - 1].uri;
+        TEST_ASSERT_TRUE(http_routes_find(hitUri) == &routes[routeCnt - 1]);
+        TEST_ASSERT_NULL(http_routes_find(missUri));
+
+        start_ns = test_time_ns();
+        for (i = 0; i < TEST_LOOKUP_CNT; i++)
+        {
+            sink += http_routes_find(hitUri) != NULL;
+        }
+        tableHit_ns = (test_time_ns() - start_ns) / TEST_LOOKUP_CNT;
+        start_ns = test_time_ns();
+        for (i = 0; i < TEST_LOOKUP_CNT; i++)
+        {
+            sink += http_routes_find(missUri) != NULL;
+        }
+        tableMiss_ns = (test_time_ns() - start_ns) / TEST_LOOKUP_CNT;
+        start_ns = test_time_ns();
+        for (i = 0; i < TEST_LOOKUP_CNT; i++)
+        {
+            sink += linear_find(hitUri, routeCnt) != NULL;
+        }
+        linearHit_ns = (test_time_ns() - start_ns) / TEST_LOOKUP_CNT;
+        start_ns = test_time_ns();
+        for (i = 0; i < TEST_LOOKUP_CNT; i++)
+        {
+            sink += linear_find(missUri, routeCnt) != NULL;
+        }
+        linearMiss_ns = (test_time_ns() - start_ns) / TEST_LOOKUP_CNT;
+
+        snprintf(buf, sizeof(buf), "%2u routes: table hit %4u ns, miss %4u ns; linear hit %4u ns, miss %4u ns",
+                 routeCnt, tableHit_ns, tableMiss_ns, linearHit_ns, linearMiss_ns);
+        TEST_MESSAGE(buf);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    native_serial_echo(false);
+    if (!native_fs_mount_copy(NATIVE_DATA_DIR))
+    {
+        return 1;
+    }
+    setup();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_root_follows_index_auth);
+    /* It replaces route table of the firmware */
+    RUN_TEST(test_dispatch_cost);
+
+    return UNITY_END();
+}
@@ -0,0 +1,152 @@
+/**
+ * @file        test_main.cpp
+ * @brief       Connecting to the MQTT broker step by step
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 22:58:07
+ * Last modify: 2026-10-16 22:58:07 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * The firmware connects to a local fake broker. The short TCP connect
+ * timeout shall not remain on the connection, and the time a loop() can
+ * take while waiting for CONNACK is measured.
+ *
+ * pio test -e native -f test_mqtt_connect
+ */
+
+#include <Arduino.h>
+#include <unity.h>
+
+#include "native.h"
+#include "native_mqtt_broker.h"
+
+#include "config.h"
+#include "secrets.h"
+#include "main.h"
+
+#define TEST_LOOP_STEP_US       10000
+#define TEST_MAX_LOOPS          20000
+
+extern void setup(void);
+extern void loop(void);
+
+static unsigned long defaultTimeout_ms;
+static uint32_t maxLoopTime_us;
+
+/*
+ * Loop until the firmware has made a new MQTT connection attempt and it
+ * is finished.
+ *
+ * @return true if client is connected.
+ */
+static bool loop_until_connect_attempt()
+{
+    uint32_t connectCntr = native_broker_connect_cntr();
+    uint64_t start_us;
+    uint32_t i;
+
+    maxLoopTime_us = 0;
+    for (i = 0; i < TEST_MAX_LOOPS; i++)
+    {
+        start_us = native_clock_us();
+        loop();
+        maxLoopTime_us = MAX(maxLoopTime_us, static_cast<uint32_t>(native_clock_us() - start_us));
+        if (native_broker_connect_cntr() != connectCntr && (mqttClient.connected() || mqttClient.state() != MQTT_CONNECTED))
+        {
+            return mqttClient.connected();
+        }
+        native_clock_advance(TEST_LOOP_STEP_US);
+    }
+
+    return false;
+}
+
+/*
+ * Broker closes the connection, loop until the firmware has noticed it.
+ */
+static void drop_connection()
+{
+    uint32_t i;
+
+    native_broker_drop_client();
+    for (i = 0; i < TEST_MAX_LOOPS && mqttClient.connected(); i++)
+    {
+        loop();
+        native_clock_advance(TEST_LOOP_STEP_US);
+    }
+}
+
+void setUp(void)
+{
+    native_broker_set_connack(true, 0);
+}
+
+void tearDown(void)
+{
+}
+
+static void test_connect_restores_stream_timeout(void)
+{
+    TEST_ASSERT_TRUE(loop_until_connect_attempt());
+    TEST_ASSERT_EQUAL_UINT32(defaultTimeout_ms, wifiClient.getTimeout());
+}
+
+/*
+ * CONNACK later than the TCP connect timeout is accepted.
+ */
+static void test_late_connack_connects(void)
+{
+    drop_connection();
+    native_broker_set_connack(true, MQTT_TCP_CONNECT_TIMEOUT_MS * 2);
+    TEST_ASSERT_TRUE(loop_until_connect_attempt());
+    TEST_ASSERT_EQUAL_UINT32(defaultTimeout_ms, wifiClient.getTimeout());
+}
+
+/*
+ * Known limit: PubSubClient waits for CONNACK up to the socket timeout, so
+ * a broker which accepts TCP but does not answer blocks one loop() for
+ * MQTT_SOCKET_TIMEOUT_SEC.
+ */
+static void test_missing_connack_blocks_for_socket_timeout(void)
+{
+    char buf[64];
+
+    drop_connection();
+    native_broker_set_connack(false, 0);
+    TEST_ASSERT_FALSE(loop_until_connect_attempt());
+    snprintf(buf, sizeof(buf), "longest loop() without CONNACK: %u us", maxLoopTime_us);
+    TEST_MESSAGE(buf);
+    /* Timeout is measured by millis() */
+    TEST_ASSERT_GREATER_OR_EQUAL(MQTT_SOCKET_TIMEOUT_SEC * 1000000u - 1000u, maxLoopTime_us);
+    TEST_ASSERT_LESS_THAN(MQTT_SOCKET_TIMEOUT_SEC * 1000000u + 500000u, maxLoopTime_us);
+
+    /* Next attempt succeeds when broker answers again */
+    native_broker_set_connack(true, 0);
+    TEST_ASSERT_TRUE(loop_until_connect_attempt());
+}
+
+int main(int argc, char **argv)
+{
+    uint16_t port;
+
+    (void)argc;
+    (void)argv;
+
+    native_serial_echo(false);
+    if (!native_fs_mount_copy(NATIVE_DATA_DIR))
+    {
+        return 1;
+    }
+    port = native_broker_start();
+    native_net_redirect(IPAddress(192, 168, 5, 4), MQTT_SERVERPORT, port);
+    defaultTimeout_ms = wifiClient.getTimeout();
+    setup();
+
+    UNITY_BEGIN();
+    RUN_TEST(test_connect_restores_stream_timeout);
+    RUN_TEST(test_late_connack_connects);
+    RUN_TEST(test_missing_connack_blocks_for_socket_timeout);
+    native_broker_stop();
+
+    return UNITY_END();
+}
@@ -0,0 +1,293 @@
+/**
+ * @file        test_main.cpp
+ * @brief       Live and offline publishes of the MQTT queue
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-16 23:52:19
+ * Last modify: 2026-10-16 23:52:19 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * The firmware is connected to a local broker. Events while connected go
+ * to their topic even if a backlog is waiting, only events of the
+ * disconnected time go to "<topic>/offline". Queueing an event never uses
+ * the file system, the queue task moves the backlog to the spill file.
+ * Repeated events are counted in one record only within
+ * MQTT_QUEUE_COALESCE_S.
+ *
+ * pio test -e native -f test_mqtt_queue
+ */
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <unity.h>
+
+#include "native.h"
+#include "native_mqtt_broker.h"
+
+#include "config.h"
+#include "secrets.h"
+#include "main.h"
+#include "doorbell.h"
+#include "mqtt_queue.h"
+
+#define TEST_LOOP_STEP_US       10000
+#define TEST_MAX_LOOPS          10000
+#define TEST_TOPIC              "/test/event"
+#define TEST_TOPIC2             "/test/event2"
+#define TEST_COALESCE_STEP_US   (MQTT_QUEUE_COALESCE_S * 1000000u)
+
+extern void setup(void);
+extern void loop(void);
+
+static String testTopic = TEST_TOPIC;
+static String testTopic2 = TEST_TOPIC2;
+static uint8_t testTopicId;
+static uint8_t testTopic2Id;
+
+/*
+ * Loop until broker has received a message of topic.
+ *
+ * @return Payload of message, empty if nothing arrived.
+ */
+static String loop_until_message(const String &topic)
+{
+    uint32_t i;
+
+    for (i = 0; i < TEST_MAX_LOOPS; i++)
+    {
+        for (const nativeMqttMessage_t &msg : native_broker_messages())
+        {
+            if (topic == msg.topic.c_str())
+            {
+                return String(msg.payload.c_str());
+            }
+        }
+        loop();
+        native_clock_advance(TEST_LOOP_STEP_US);
+    }
+
+    return String();
+}
+
+/*
+ * Publish event after the coalescing window of previous ones.
+ */
+static bool publish_later(uint8_t topicId)
+{
+    native_clock_advance(TEST_COALESCE_STEP_US);
+
+    return mqtt_queue_publish(topicId, "1");
+}
+
+/*
+ * Reconnect and loop until the backlog and spill file are published.
+ */
+static void loop_until_flushed(size_t expectedMessages)
+{
+    uint32_t i;
+
+    native_wifi_set_status(WL_CONNECTED);
+    for (i = 0; i < TEST_MAX_LOOPS && (mqtt_queue_backlog() || LittleFS.exists(MQTT_QUEUE_SPILL_FILE)); i++)
+    {
+        loop();
+        native_clock_advance(TEST_LOOP_STEP_US);
+    }
+    for (i = 0; i < TEST_MAX_LOOPS && native_broker_messages().size() < expectedMessages; i++)
+    {
+        loop();
+        native_clock_advance(TEST_LOOP_STEP_US);
+    }
+}
+
+static bool loop_until_connected()
+{
+    uint32_t i;
+
+    for (i = 0; i < TEST_MAX_LOOPS && !mqttClient.connected(); i++)
+    {
+        loop();
+        native_clock_advance(TEST_LOOP_STEP_US);
+    }
+
+    return mqttClient.connected();
+}
+
+void setUp(void)
+{
+    native_broker_clear_messages();
+}
+
+void tearDown(void)
+{
+}
+
+static void test_switch_press_is_published_live(void)
+{
+    uint32_t i;
+
+    TEST_ASSERT_TRUE(loop_until_connected());
+    native_gpio_input(DOORBELL_SWITCH_PIN, LOW);
+    native_clock_advance(200000);
+    loop();
+    native_gpio_input(DOORBELL_SWITCH_PIN, HIGH);
+    TEST_ASSERT_EQUAL_STRING("1", loop_until_message(mqttSwitchesTopicPrefix + "press").c_str());
+    TEST_ASSERT_EQUAL_UINT32(0, mqtt_queue_backlog());
+    for (i = 0; i < TEST_MAX_LOOPS && doorbell_is_playing(); i++)
+    {
+        loop();
+        native_clock_advance(TEST_LOOP_STEP_US);
+    }
+}
+
+static void test_live_event_is_not_delayed_by_backlog(void)
+{
+    uint32_t i;
+    String payload;
+
+    /* Event while WiFi is down is queued */
+    native_wifi_set_status(WL_DISCONNECTED);
+    mqtt_task();
+    TEST_ASSERT_FALSE(mqttClient.connected());
+    TEST_ASSERT_TRUE(mqtt_queue_publish(testTopicId, "old"));
+    TEST_ASSERT_EQUAL_UINT32(1, mqtt_queue_backlog());
+
+    /* Only the connection is made, queue is not flushed yet */
+    native_wifi_set_status(WL_CONNECTED);
+    for (i = 0; i < TEST_MAX_LOOPS && !mqttClient.connected(); i++)
+    {
+        mqtt_task();
+        native_clock_advance(TEST_LOOP_STEP_US);
+    }
+    TEST_ASSERT_TRUE(mqttClient.connected());
+    TEST_ASSERT_EQUAL_UINT32(1, mqtt_queue_backlog());
+
+    /* New event goes to its topic at once */
+    TEST_ASSERT_TRUE(mqtt_queue_publish(testTopicId, "new"));
+    TEST_ASSERT_EQUAL_UINT32(1, mqtt_queue_backlog());
+    TEST_ASSERT_EQUAL_STRING("new", loop_until_message(TEST_TOPIC).c_str());
+
+    /* Old one is published as offline event: "<epoch>,<count>" */
+    payload = loop_until_message(TEST_TOPIC MQTT_QUEUE_OFFLINE_SUFFIX);
+    TEST_ASSERT_TRUE(payload.endsWith(",1"));
+    TEST_ASSERT_EQUAL_UINT32(0, mqtt_queue_backlog());
+    for (const nativeMqttMessage_t &msg : native_broker_messages())
+    {
+        TEST_ASSERT_TRUE(msg.payload != "old");
+    }
+}
+
+/*
+ * Events of two topics alternate, like press and playAudio of a ring.
+ */
+static void test_spill_file_is_written_by_task(void)
+{
+    uint32_t openCntr;
+    uint32_t offlineCnt = 0;
+    uint32_t i;
+    const char *expectedTopic = TEST_TOPIC MQTT_QUEUE_OFFLINE_SUFFIX;
+
+    native_wifi_set_status(WL_DISCONNECTED);
+    mqtt_task();
+    TEST_ASSERT_FALSE(mqttClient.connected());
+    openCntr = native_fs_stats().openCntr;
+    for (i = 0; i < MQTT_QUEUE_SIZE; i++)
+    {
+        TEST_ASSERT_TRUE(publish_later((i & 1) ? testTopic2Id : testTopicId));
+    }
+    TEST_ASSERT_EQUAL_UINT32(openCntr, native_fs_stats().openCntr);
+    TEST_ASSERT_EQUAL_UINT32(MQTT_QUEUE_SIZE, mqtt_queue_backlog());
+    TEST_ASSERT_FALSE(LittleFS.exists(MQTT_QUEUE_SPILL_FILE));
+
+    /* Older half goes to file, RAM has room again */
+    mqtt_queue_task();
+    TEST_ASSERT_TRUE(LittleFS.exists(MQTT_QUEUE_SPILL_FILE));
+    openCntr = native_fs_stats().openCntr;
+    for (i = MQTT_QUEUE_SIZE; i < MQTT_QUEUE_SIZE + MQTT_QUEUE_SPILL_THRESHOLD; i++)
+    {
+        TEST_ASSERT_TRUE(publish_later((i & 1) ? testTopic2Id : testTopicId));
+    }
+    TEST_ASSERT_EQUAL_UINT32(openCntr, native_fs_stats().openCntr);
+    TEST_ASSERT_EQUAL_UINT32(MQTT_QUEUE_SIZE + MQTT_QUEUE_SPILL_THRESHOLD, mqtt_queue_backlog());
+
+    /* Every event is published in order after reconnection */
+    loop_until_flushed(MQTT_QUEUE_SIZE + MQTT_QUEUE_SPILL_THRESHOLD);
+    TEST_ASSERT_EQUAL_UINT32(0, mqtt_queue_backlog());
+    TEST_ASSERT_FALSE(LittleFS.exists(MQTT_QUEUE_SPILL_FILE));
+    for (const nativeMqttMessage_t &msg : native_broker_messages())
+    {
+        if (msg.topic.find(MQTT_QUEUE_OFFLINE_SUFFIX) == std::string::npos)
+        {
+            continue;
+        }
+        TEST_ASSERT_EQUAL_STRING(expectedTopic, msg.topic.c_str());
+        expectedTopic = (++offlineCnt & 1) ? TEST_TOPIC2 MQTT_QUEUE_OFFLINE_SUFFIX : TEST_TOPIC MQTT_QUEUE_OFFLINE_SUFFIX;
+    }
+    TEST_ASSERT_EQUAL_UINT32(MQTT_QUEUE_SIZE + MQTT_QUEUE_SPILL_THRESHOLD, offlineCnt);
+}
+
+/*
+ * Events of a topic within the window are counted, even if the other topic
+ * comes in between. A later one starts a new record with its own time.
+ */
+static void test_events_are_coalesced_within_window(void)
+{
+    std::vector<std::string> payloads;
+    unsigned long first;
+    unsigned long later;
+    unsigned int count;
+
+    native_wifi_set_status(WL_DISCONNECTED);
+    mqtt_task();
+    TEST_ASSERT_FALSE(mqttClient.connected());
+    TEST_ASSERT_TRUE(mqtt_queue_publish(testTopicId, "1"));
+    TEST_ASSERT_TRUE(mqtt_queue_publish(testTopic2Id, "1"));
+    native_clock_advance(TEST_COALESCE_STEP_US / 2);
+    TEST_ASSERT_TRUE(mqtt_queue_publish(testTopicId, "1"));
+    TEST_ASSERT_EQUAL_UINT32(2, mqtt_queue_backlog());
+    TEST_ASSERT_TRUE(publish_later(testTopicId));
+    TEST_ASSERT_EQUAL_UINT32(3, mqtt_queue_backlog());
+
+    loop_until_flushed(3);
+    TEST_ASSERT_EQUAL_UINT32(0, mqtt_queue_backlog());
+    for (const nativeMqttMessage_t &msg : native_broker_messages())
+    {
+        if (msg.topic == TEST_TOPIC MQTT_QUEUE_OFFLINE_SUFFIX)
+        {
+            payloads.push_back(msg.payload);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(2, payloads.size());
+    TEST_ASSERT_EQUAL_INT(2, sscanf(payloads[0].c_str(), "%lu,%u", &first, &count));
+    TEST_ASSERT_EQUAL_UINT32(2, count);
+    TEST_ASSERT_EQUAL_INT(2, sscanf(payloads[1].c_str(), "%lu,%u", &later, &count));
+    TEST_ASSERT_EQUAL_UINT32(1, count);
+    TEST_ASSERT_TRUE(later - first >= MQTT_QUEUE_COALESCE_S);
+}
+
+int main(int argc, char **argv)
+{
+    uint16_t port;
+
+    (void)argc;
+    (void)argv;
+
+    native_serial_echo(false);
+    if (!native_fs_mount_copy(NATIVE_DATA_DIR))
+    {
+        return 1;
+    }
+    port = native_broker_start();
+    native_net_redirect(IPAddress(192, 168, 5, 4), MQTT_SERVERPORT, port);
+    setup();
+    testTopicId = mqtt_queue_add_topic(&testTopic);
+    testTopic2Id = mqtt_queue_add_topic(&testTopic2);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_switch_press_is_published_live);
+    RUN_TEST(test_live_event_is_not_delayed_by_backlog);
+    RUN_TEST(test_spill_file_is_written_by_task);
+    RUN_TEST(test_events_are_coalesced_within_window);
+    native_broker_stop();
+
+    return UNITY_END();
+}
@@ -0,0 +1,255 @@
+/**
+ * @file        test_main.cpp
+ * @brief       Simultaneous playback of doorbells of a multicast group
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-17 01:02:17
+ * Last modify: 2026-10-17 01:02:17 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * Every virtual doorbell is a process, the test process is the one whose
+ * switch is pressed, the followers are forked. Followers get the event late
+ * by a random network delay and their loop() is disturbed by random pauses.
+ * All processes use the clock of the host as NTP time, the first I2S sample
+ * of every doorbell shall be sent within TEST_MAX_SKEW_US.
+ *
+ * pio test -e native -f test_play_at_sync
+ */
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <unity.h>
+
+#include "native.h"
+#include "native_audio.h"
+
+#include "common.h"
+#include "config.h"
+#include "doorbell.h"
+
+#define TEST_FOLLOWER_CNT       4
+#define TEST_CHIP_ID            0x00C10C00
+#define TEST_PLAY_AT_DELAY_MS   300
+#define TEST_MAX_NET_DELAY_MS   100         /* Injected delay of event at followers */
+#define TEST_MAX_LOOP_PAUSE_US  2000        /* Injected pause between two loop() */
+#define TEST_MAX_SKEW_US        10000
+#define TEST_PRESS_MS           150
+#define TEST_TIMEOUT_MS         2000
+
+/* Result of a follower */
+typedef struct
+{
+    uint64_t armed_us;          /* native_clock_us() when event was received, 0: never */
+    uint64_t firstSample_us;    /* native_clock_us(), 0: audio was not played */
+} testResult_t;
+
+typedef struct
+{
+    pid_t pid;
+    int resultFd;
+} testFollower_t;
+
+extern void setup(void);
+extern void loop(void);
+
+static uint16_t testGroup;
+static testFollower_t testFollowers[TEST_FOLLOWER_CNT];
+static int testReadyFd = -1;    /* Read end, every follower writes a byte when it is ready */
+
+/*
+ * Start a doorbell of the group with play-at delay.
+ */
+static bool start_doorbell(uint32_t chipId)
+{
+    File file;
+
+    native_set_chip_id(chipId);
+    if (!native_fs_mount_copy(NATIVE_DATA_DIR))
+    {
+        return false;
+    }
+    file = LittleFS.open("/ring_multicast.txt", "w");
+    file.printf("%u\n1\n", testGroup);
+    file.close();
+    file = LittleFS.open("/doorbell.txt", "w");
+    file.printf("doorbell.wav\n1\n1000\n0.5\n%u\n", TEST_PLAY_AT_DELAY_MS);
+    file.close();
+    setup();
+
+    return true;
+}
+
+/*
+ * Real time passes, the clock is not advanced: processes share the host
+ * clock for the measurement.
+ */
+static void loop_for_ms(uint32_t time_ms, uint32_t maxPause_us, unsigned int *seed)
+{
+    uint32_t start_ms = millis();
+
+    while (millis() - start_ms < time_ms)
+    {
+        loop();
+        usleep(maxPause_us ? rand_r(seed) % maxPause_us : 100);
+    }
+}
+
+/*
+ * Forked doorbell: it is ready when it has joined the group, then the event
+ * is delayed by not calling loop() for a random time after the switch
+ * press.
+ */
+static void run_follower(uint8_t idx, int readyFd, int resultFd)
+{
+    unsigned int seed = idx + 1u;
+    testResult_t result;
+    uint32_t start_ms;
+
+    native_serial_echo(false);
+    if (!start_doorbell(TEST_CHIP_ID + idx + 1u))
+    {
+        exit(1);
+    }
+    loop_for_ms(10, 0, &seed);
+    if (write(readyFd, "r", 1) != 1)
+    {
+        exit(1);
+    }
+    usleep(TEST_PRESS_MS * 1000u + rand_r(&seed) % (TEST_MAX_NET_DELAY_MS * 1000u));
+    start_ms = millis();
+    while (!doorbell_is_playing() && millis() - start_ms < TEST_TIMEOUT_MS)
+    {
+        loop_for_ms(1, TEST_MAX_LOOP_PAUSE_US, &seed);
+    }
+    result.armed_us = doorbell_is_playing() ? native_clock_us() : 0;
+    while (!native_i2s_stats().firstSample_us && millis() - start_ms < TEST_TIMEOUT_MS)
+    {
+        loop_for_ms(1, TEST_MAX_LOOP_PAUSE_US, &seed);
+    }
+    result.firstSample_us = native_i2s_stats().firstSample_us;
+    if (write(resultFd, &result, sizeof(result)) != sizeof(result))
+    {
+        exit(1);
+    }
+    exit(0);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/*
+ * Switch of the test process is pressed, every doorbell starts playing at
+ * the same time despite the delay of the event.
+ */
+static void test_play_at_alignment(void)
+{
+    testResult_t results[TEST_FOLLOWER_CNT];
+    uint64_t press_us;
+    uint64_t firstSample_us;
+    unsigned int seed = 0;
+    int64_t skew_us;
+    int64_t maxSkew_us = 0;
+    uint64_t delay_us;
+    uint64_t maxDelay_us = 0;
+    uint32_t start_ms;
+    uint8_t i;
+    int status;
+    char msg[128];
+    char c;
+
+    for (i = 0; i < TEST_FOLLOWER_CNT; i++)
+    {
+        TEST_ASSERT_EQUAL_INT(1, read(testReadyFd, &c, 1));
+    }
+    native_gpio_input(DOORBELL_SWITCH_PIN, LOW);
+    loop_for_ms(TEST_PRESS_MS, 0, &seed);
+    native_gpio_input(DOORBELL_SWITCH_PIN, HIGH);
+    press_us = native_clock_us();
+    start_ms = millis();
+    while (!native_i2s_stats().firstSample_us && millis() - start_ms < TEST_TIMEOUT_MS)
+    {
+        loop_for_ms(1, 0, &seed);
+    }
+    firstSample_us = native_i2s_stats().firstSample_us;
+    TEST_ASSERT_TRUE(firstSample_us != 0);
+    /* Audio of the originator is delayed too */
+    TEST_ASSERT_TRUE(millis() - start_ms >= TEST_PLAY_AT_DELAY_MS - 1u);
+
+    for (i = 0; i < TEST_FOLLOWER_CNT; i++)
+    {
+        TEST_ASSERT_EQUAL_INT(sizeof(results[i]), read(testFollowers[i].resultFd, &results[i], sizeof(results[i])));
+        TEST_ASSERT_EQUAL_INT(testFollowers[i].pid, waitpid(testFollowers[i].pid, &status, 0));
+        TEST_ASSERT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+        TEST_ASSERT_TRUE(results[i].armed_us != 0 && results[i].firstSample_us != 0);
+        delay_us = results[i].armed_us - press_us;
+        skew_us = static_cast<int64_t>(results[i].firstSample_us - firstSample_us);
+        snprintf(msg, sizeof(msg), "Follower %u: event delay: %6llu us, start skew: %6lli us",
+                 i + 1u, static_cast<unsigned long long>(delay_us), static_cast<long long>(skew_us));
+        TEST_MESSAGE(msg);
+        maxSkew_us = MAX(maxSkew_us, llabs(skew_us));
+        maxDelay_us = MAX(maxDelay_us, delay_us);
+    }
+    snprintf(msg, sizeof(msg), "Max event delay: %llu us, max start skew: %lli us",
+             static_cast<unsigned long long>(maxDelay_us), static_cast<long long>(maxSkew_us));
+    TEST_MESSAGE(msg);
+    /* Without play-at the skew would be the delay of event */
+    TEST_ASSERT_TRUE(maxDelay_us > TEST_MAX_SKEW_US);
+    TEST_ASSERT_TRUE(maxSkew_us < TEST_MAX_SKEW_US);
+}
+
+int main(int argc, char **argv)
+{
+    int readyPipe[2];
+    int resultPipe[2];
+    uint8_t i;
+
+    (void)argc;
+    (void)argv;
+
+    /* Group of this run, parallel runs do not disturb each other */
+    testGroup = 1000 + getpid() % 50000;
+    if (pipe(readyPipe))
+    {
+        return 1;
+    }
+    /* Followers are forked before the file system of the test is mounted.
+     * Clock starts at its first reading, it is shared by the forks. */
+    native_clock_us();
+    fflush(stdout);
+    for (i = 0; i < TEST_FOLLOWER_CNT; i++)
+    {
+        if (pipe(resultPipe))
+        {
+            return 1;
+        }
+        testFollowers[i].pid = fork();
+        if (!testFollowers[i].pid)
+        {
+            close(readyPipe[0]);
+            close(resultPipe[0]);
+            run_follower(i, readyPipe[1], resultPipe[1]);
+        }
+        close(resultPipe[1]);
+        testFollowers[i].resultFd = resultPipe[0];
+    }
+    close(readyPipe[1]);
+    testReadyFd = readyPipe[0];
+    native_serial_echo(false);
+    if (!start_doorbell(TEST_CHIP_ID))
+    {
+        return 1;
+    }
+
+    UNITY_BEGIN();
+    RUN_TEST(test_play_at_alignment);
+
+    return UNITY_END();
+}
@@ -0,0 +1,265 @@
+/**
+ * @file        test_main.cpp
+ * @brief       Ring multicast between doorbells on localhost
+ * @author      Copyright (C) Peter Ivanov, 2026
+ *
+ * Created      2026-10-17 00:14:35
+ * Last modify: 2026-10-17 00:14:35 ivanovp {Time-stamp}
+ * Licence:     GPL
+ *
+ * Harness: every doorbell is a process running the firmware with its own
+ * chip ID and file system, datagrams go through multicast loopback of the
+ * host. The test process is one doorbell of the group, the others are
+ * forked. Datagrams of more peers than the peer table holds are sent by
+ * the test directly.
+ *
+ * pio test -e native -f test_ring_multicast
+ */
+
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <Arduino.h>
+#include <WiFiUdp.h>
+#include <unity.h>
+
+#include "native.h"
+#include "native_audio.h"
+
+#include "config.h"
+#include "doorbell_history.h"
+#include "http_server.h"
+#include "ring_multicast.h"
+
+#define TEST_CHIP_ID            0x00A11CE0
+#define TEST_PEER_CHIP_ID       0x00B0B000
+#define TEST_LOOP_STEP_US       1000
+#define TEST_MAX_LOOPS          20000
+#define TEST_PEER_RUN_MS        500         /* Time of forked doorbell after ring */
+#define TEST_SESSION_COOKIE     "ESPSESSIONID=1"
+
+extern void setup(void);
+extern void loop(void);
+
+static uint16_t testGroup;
+static pid_t peerPid;
+static int peerStartFd = -1;   /* Write end, forked doorbell rings when a byte is written */
+
+/*
+ * Start a doorbell of the group: mount a copy of the data directory and
+ * configure the group.
+ */
+static bool start_doorbell(uint32_t chipId)
+{
+    File file;
+
+    native_set_chip_id(chipId);
+    if (!native_fs_mount_copy(NATIVE_DATA_DIR))
+    {
+        return false;
+    }
+    file = LittleFS.open("/ring_multicast.txt", "w");
+    file.printf("%u\n1\n", testGroup);
+    file.close();
+    setup();
+
+    return true;
+}
+
+/*
+ * Forked doorbell: waits for the start signal, rings once and runs for
+ * TEST_PEER_RUN_MS, so its copies are sent. It is forked before the test
+ * process mounts its file system, the two copies are independent.
+ */
+static void run_peer(int startFd)
+{
+    uint32_t start_ms;
+    char c;
+
+    native_serial_echo(false);
+    if (!start_doorbell(TEST_PEER_CHIP_ID) || read(startFd, &c, 1) != 1)
+    {
+        exit(1);
+    }
+    native_gpio_input(DOORBELL_SWITCH_PIN, LOW);
+    delay(200);
+    loop();
+    native_gpio_input(DOORBELL_SWITCH_PIN, HIGH);
+    start_ms = millis();
+    while (millis() - start_ms < TEST_PEER_RUN_MS)
+    {
+        loop();
+        delayMicroseconds(100);
+    }
+    exit(0);
+}
+
+static void loop_for(uint32_t loopCnt)
+{
+    uint32_t i;
+
+    for (i = 0; i < loopCnt; i++)
+    {
+        loop();
+        native_clock_advance(TEST_LOOP_STEP_US);
+        usleep(100);
+    }
+}
+
+static String get_sysinfo()
+{
+    uint32_t i;
+
+    httpServer.nativeBeginRequest(HTTP_GET, SYSINFO_JSON);
+    httpServer.nativeAddHeader("Cookie", TEST_SESSION_COOKIE);
+    for (i = 0; i < TEST_MAX_LOOPS && httpServer.nativeRequestPending(); i++)
+    {
+        loop();
+    }
+
+    return String(httpServer.nativeResponse().body.c_str());
+}
+
+/*
+ * Peer entry of sysinfo.json, empty if origin is not in peer table.
+ */
+static String get_peer(const String &sysinfo, uint32_t origin)
+{
+    char key[32];
+    int start;
+
+    snprintf(key, sizeof(key), "{\"origin\": \"%08x\"", static_cast<unsigned int>(origin));
+    start = sysinfo.indexOf(key);
+    if (start < 0)
+    {
+        return String();
+    }
+
+    return sysinfo.substring(start, sysinfo.indexOf('}', start) + 1);
+}
+
+/*
+ * Send event of origin as the firmware does: first datagram and copies.
+ */
+static void send_event(uint32_t origin, uint32_t seq)
+{
+    WiFiUDP udp;
+    ringMulticastPacket_t packet;
+    struct timeval tv;
+    uint8_t i;
+
+    gettimeofday(&tv, NULL);
+    memset(&packet, 0, sizeof(packet));
+    packet.magic = RING_MULTICAST_MAGIC;
+    packet.version = RING_MULTICAST_VERSION;
+    packet.eventType = EVENT_DOORBELL;
+    packet.group = testGroup;
+    packet.seq = seq;
+    packet.origin = origin;
+    packet.originTime_s = tv.tv_sec;
+    packet.originTime_us = tv.tv_usec;
+    for (i = 0; i <= RING_MULTICAST_REPEAT; i++)
+    {
+        udp.beginPacketMulticast(IPAddress(RING_MULTICAST_ADDRESS), RING_MULTICAST_PORT, WiFi.localIP());
+        udp.write(reinterpret_cast<const uint8_t *>(&packet), sizeof(packet));
+        udp.endPacket();
+    }
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/*
+ * Ring of a forked doorbell is played once, its copies are dropped.
+ */
+static void test_peer_ring_is_played_once(void)
+{
+    uint32_t beginCntr = native_i2s_stats().beginCntr;
+    int status;
+    String peer;
+
+    TEST_ASSERT_EQUAL_INT(1, write(peerStartFd, "s", 1));
+    loop_for(TEST_PEER_RUN_MS * 2);
+    TEST_ASSERT_EQUAL_INT(peerPid, waitpid(peerPid, &status, 0));
+    TEST_ASSERT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    TEST_ASSERT_EQUAL_UINT32(beginCntr + 1, native_i2s_stats().beginCntr);
+    peer = get_peer(get_sysinfo(), TEST_PEER_CHIP_ID);
+    TEST_MESSAGE(peer.c_str());
+    TEST_ASSERT_TRUE(peer.indexOf("\"rxCntr\": 1,") >= 0);
+    TEST_ASSERT_TRUE(peer.indexOf("\"dupCntr\": " + String(RING_MULTICAST_REPEAT) + ",") >= 0);
+}
+
+/*
+ * More peers than the table holds: least recently heard peer is
+ * replaced, copies of the new peer are still dropped.
+ */
+static void test_full_peer_table_replaces_oldest(void)
+{
+    String sysinfo;
+    String peer;
+    uint32_t origin;
+
+    /* Peer of previous test is the oldest one */
+    for (origin = 1; origin < RING_MULTICAST_MAX_PEERS; origin++)
+    {
+        send_event(origin, 100);
+        loop_for(10);
+    }
+    sysinfo = get_sysinfo();
+    TEST_ASSERT_TRUE(sysinfo.indexOf("\"ringMulticastPeerEvictCntr\": 0") >= 0);
+    TEST_ASSERT_TRUE(get_peer(sysinfo, TEST_PEER_CHIP_ID).length() > 0);
+
+    send_event(RING_MULTICAST_MAX_PEERS, 100);
+    loop_for(10);
+    sysinfo = get_sysinfo();
+    TEST_ASSERT_TRUE(sysinfo.indexOf("\"ringMulticastPeerEvictCntr\": 1") >= 0);
+    TEST_ASSERT_EQUAL_UINT32(0, get_peer(sysinfo, TEST_PEER_CHIP_ID).length());
+    peer = get_peer(sysinfo, RING_MULTICAST_MAX_PEERS);
+    TEST_MESSAGE(peer.c_str());
+    TEST_ASSERT_TRUE(peer.indexOf("\"rxCntr\": 1,") >= 0);
+    TEST_ASSERT_TRUE(peer.indexOf("\"dupCntr\": " + String(RING_MULTICAST_REPEAT) + ",") >= 0);
+}
+
+int main(int argc, char **argv)
+{
+    int startPipe[2];
+
+    (void)argc;
+    (void)argv;
+
+    /* Group of this run, parallel runs do not disturb each other */
+    testGroup = 1000 + getpid() % 50000;
+    if (pipe(startPipe))
+    {
+        return 1;
+    }
+    fflush(stdout);
+    peerPid = fork();
+    if (!peerPid)
+    {
+        close(startPipe[1]);
+        run_peer(startPipe[0]);
+    }
+    close(startPipe[0]);
+    peerStartFd = startPipe[1];
+    native_serial_echo(false);
+    if (!start_doorbell(TEST_CHIP_ID))
+    {
+        return 1;
+    }
+    /* Join multicast group */
+    loop_for(10);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_peer_ring_is_played_once);
+    RUN_TEST(test_full_peer_table_replaces_oldest);
+
+    return UNITY_END();
+}
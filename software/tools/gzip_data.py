@@ -0,0 +1,149 @@
+#!/usr/bin/env python3
+#
+# @file        gzip_data.py
+# @brief       Pre-gzipped static assets for the LittleFS image
+# @author      Copyright (C) Peter Ivanov, 2026
+#
+# Created      2026-10-16 17:05:12
+# Last modify: 2026-10-16 17:05:12 ivanovp {Time-stamp}
+# Licence:     GPL
+#
+# The data/ directory is copied to .pio/data_gz and web assets (HTML, CSS,
+# JavaScript, etc.) get a gzip compressed sibling: style.css -> style.css.gz.
+# Originals are kept for clients which do not accept gzip. Configuration
+# (*.txt) and audio files are copied untouched.
+#
+# Content hash of each asset is written into /gz_manifest.txt, the web server
+# uses it as ETag and references like "/style.css" in HTML files are
+# rewritten to "/style.css?v=<hash>" which can be cached forever.
+#
+# As PlatformIO extra script (platformio.ini: extra_scripts = pre:tools/gzip_data.py)
+# it runs before "buildfs" and "uploadfs" and the file system image is made
+# from the generated directory.
+#
+# Standalone it prints the bytes on the wire before and after compression:
+#   gzip_data.py data
+#   gzip_data.py data /tmp/data_gz
+
+import gzip
+import hashlib
+import os
+import re
+import shutil
+import sys
+
+GZIP_EXTENSIONS = ('.htm', '.html', '.css', '.js', '.json', '.svg', '.xml', '.ico')
+HTML_EXTENSIONS = ('.htm', '.html')
+MANIFEST_FILE = 'gz_manifest.txt'
+HASH_LENGTH = 8
+FS_TARGETS = ('buildfs', 'uploadfs', 'uploadfsota')
+
+
+def content_hash(data):
+    return hashlib.sha1(data).hexdigest()[:HASH_LENGTH]
+
+
+def rewrite_references(data, hashes):
+    """Append ?v=<hash> to absolute references of hashed assets."""
+    text = data.decode('utf-8')
+    for path, digest in hashes.items():
+        text = re.sub(r'(["\'])' + re.escape(path) + r'\1',
+                      r'\g<1>' + path + '?v=' + digest + r'\g<1>', text)
+    return text.encode('utf-8')
+
+
+def gzip_data(data):
+    # mtime=0: same input gives same image
+    return gzip.compress(data, compresslevel=9, mtime=0)
+
+
+def build(src_dir, dst_dir):
+    """Copy src_dir to dst_dir, compress assets and write manifest.
+
+    @return List of (path, original size, size on the wire) tuples of assets.
+    """
+    if os.path.isdir(dst_dir):
+        shutil.rmtree(dst_dir)
+    os.makedirs(dst_dir)
+
+    assets = []
+    for name in sorted(os.listdir(src_dir)):
+        src = os.path.join(src_dir, name)
+        if not os.path.isfile(src) or name.endswith('.gz') or name == MANIFEST_FILE:
+            continue
+        if name.lower().endswith(GZIP_EXTENSIONS):
+            assets.append(name)
+        else:
+            shutil.copy2(src, os.path.join(dst_dir, name))
+
+    # HTML files reference the other assets, so they are hashed last
+    assets.sort(key=lambda name: name.lower().endswith(HTML_EXTENSIONS))
+
+    hashes = {}
+    report = []
+    for name in assets:
+        with open(os.path.join(src_dir, name), 'rb') as f:
+            data = f.read()
+        if name.lower().endswith(HTML_EXTENSIONS):
+            data = rewrite_references(data, hashes)
+        path = '/' + name
+        hashes[path] = content_hash(data)
+        with open(os.path.join(dst_dir, name), 'wb') as f:
+            f.write(data)
+        compressed = gzip_data(data)
+        if len(compressed) < len(data):
+            with open(os.path.join(dst_dir, name + '.gz'), 'wb') as f:
+                f.write(compressed)
+            report.append((path, len(data), len(compressed)))
+        else:
+            report.append((path, len(data), len(data)))
+
+    with open(os.path.join(dst_dir, MANIFEST_FILE), 'w') as f:
+        for path, digest in hashes.items():
+            f.write('%s %s\n' % (path, digest))
+
+    return report
+
+
+def print_report(report):
+    total_before = 0
+    total_after = 0
+    print('%-24s %10s %10s %7s' % ('File', 'Plain', 'Gzip', 'Ratio'))
+    for path, before, after in report:
+        total_before += before
+        total_after += after
+        print('%-24s %10i %10i %6.1f%%' % (path, before, after, 100.0 * after / before if before else 100.0))
+    if total_before:
+        print('%-24s %10i %10i %6.1f%%' % ('Total', total_before, total_after,
+                                          100.0 * total_after / total_before))
+
+
+def main(argv):
+    if len(argv) < 2:
+        print('Usage: %s <data dir> [output dir]' % argv[0])
+        return 1
+    if len(argv) > 2:
+        dst_dir = argv[2]
+    else:
+        dst_dir = os.path.join(os.path.dirname(os.path.abspath(argv[1])), '.pio', 'data_gz')
+    print_report(build(argv[1], dst_dir))
+    print('Output: %s' % dst_dir)
+    return 0
+
+
+try:
+    Import('env')  # noqa: F821, defined only when running from PlatformIO
+except NameError:
+    env = None
+
+if env is not None:
+    from SCons.Script import COMMAND_LINE_TARGETS  # noqa: E402
+
+    if any(target in FS_TARGETS for target in COMMAND_LINE_TARGETS):
+        data_dir = env.subst('$PROJECT_DATA_DIR')
+        gz_dir = os.path.join(env.subst('$PROJECT_WORKSPACE_DIR'), 'data_gz')
+        print('Compressing web assets of %s' % data_dir)
+        print_report(build(data_dir, gz_dir))
+        env.Replace(PROJECT_DATA_DIR=gz_dir)
+elif __name__ == '__main__':
+    sys.exit(main(sys.argv))
@@ -0,0 +1,120 @@
+#!/usr/bin/env python3
+#
+# @file        ring_multicast.py
+# @brief       Send and receive ring multicast datagrams
+# @author      Copyright (C) Peter Ivanov, 2026
+#
+# Created      2026-10-16 19:21:44
+# Last modify: 2026-10-16 19:21:44 ivanovp {Time-stamp}
+# Licence:     GPL
+#
+# Speaks the datagram format of ring_multicast.h. A PC can trigger the
+# doorbells of a group or watch their events with one-way latency and
+# duplicate statistics per origin. Sender and listener can run on the same
+# Linux host as well, multicast is looped back.
+#
+# With play delay the listener prints the time left until the common
+# deadline: a doorbell receiving the event with negative margin plays late.
+#
+# Usage:
+#   ring_multicast.py listen <group>
+#   ring_multicast.py send <group> [count] [interval_ms] [play_delay_ms]
+
+import random
+import socket
+import struct
+import sys
+import time
+
+MULTICAST_ADDRESS = '239.255.68.66'
+MULTICAST_PORT = 4366
+MAGIC = 0x4244
+VERSION = 1
+EVENT_DOORBELL = 0
+REPEAT = 2
+REPEAT_INTERVAL_S = 0.02
+SEQ_WINDOW = 64
+# magic, version, eventType, group, playDelay_ms, seq, origin, originTime_s, originTime_us
+PACKET = struct.Struct('<HBBHHIIII')
+
+
+def pack(group, seq, origin, play_delay_ms=0, event_type=EVENT_DOORBELL):
+    now = time.time()
+    return PACKET.pack(MAGIC, VERSION, event_type, group, play_delay_ms, seq, origin,
+                       int(now), int((now % 1) * 1000000))
+
+
+def send(group, count, interval_s, play_delay_ms):
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM, socket.IPPROTO_UDP)
+    sock.setsockopt(socket.IPPROTO_IP, socket.IP_MULTICAST_TTL, 1)
+    sock.setsockopt(socket.IPPROTO_IP, socket.IP_MULTICAST_LOOP, 1)
+    origin = random.getrandbits(32) or 1
+    seq = random.getrandbits(32)
+    for _ in range(count):
+        seq = (seq + 1) & 0xFFFFFFFF
+        packet = pack(group, seq, origin, play_delay_ms)
+        for copy in range(REPEAT + 1):
+            if copy:
+                time.sleep(REPEAT_INTERVAL_S)
+            sock.sendto(packet, (MULTICAST_ADDRESS, MULTICAST_PORT))
+        print('Sent group %i origin %08x seq %u' % (group, origin, seq))
+        time.sleep(interval_s)
+
+
+def listen(group):
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM, socket.IPPROTO_UDP)
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    sock.bind(('', MULTICAST_PORT))
+    mreq = struct.pack('4sl', socket.inet_aton(MULTICAST_ADDRESS), socket.INADDR_ANY)
+    sock.setsockopt(socket.IPPROTO_IP, socket.IP_ADD_MEMBERSHIP, mreq)
+    peers = {}
+    while True:
+        data, address = sock.recvfrom(64)
+        now = time.time()
+        if len(data) != PACKET.size:
+            print('%s: invalid size %i' % (address[0], len(data)))
+            continue
+        magic, version, event_type, pkt_group, play_delay_ms, seq, origin, time_s, time_us = PACKET.unpack(data)
+        if magic != MAGIC or version != VERSION or pkt_group != group:
+            continue
+        peer = peers.setdefault(origin, {'seq': None, 'rx': 0, 'dup': 0, 'latency': []})
+        if peer['seq'] is not None:
+            diff = (seq - peer['seq'] + 0x80000000) % 0x100000000 - 0x80000000
+            if -SEQ_WINDOW < diff <= 0:
+                peer['dup'] += 1
+                continue
+        peer['seq'] = seq
+        peer['rx'] += 1
+        line = '%s origin %08x seq %u event %i' % (address[0], origin, seq, event_type)
+        if time_s:
+            latency_ms = (now - (time_s + time_us / 1000000.0)) * 1000.0
+            peer['latency'].append(latency_ms)
+            lat = peer['latency']
+            line += ' latency %.1f ms (min %.1f avg %.1f max %.1f)' % (
+                latency_ms, min(lat), sum(lat) / len(lat), max(lat))
+            if play_delay_ms:
+                line += ' deadline margin %.1f ms' % (play_delay_ms - latency_ms)
+        print(line + ' rx %i dup %i' % (peer['rx'], peer['dup']))
+
+
+def main(argv):
+    if len(argv) < 3 or argv[1] not in ('listen', 'send'):
+        print('Usage: %s listen <group>' % argv[0])
+        print('       %s send <group> [count] [interval_ms] [play_delay_ms]' % argv[0])
+        return 1
+    group = int(argv[2])
+    if argv[1] == 'listen':
+        try:
+            listen(group)
+        except KeyboardInterrupt:
+            pass
+    else:
+        count = int(argv[3]) if len(argv) > 3 else 1
+        interval_s = int(argv[4]) / 1000.0 if len(argv) > 4 else 1.0
+        play_delay_ms = int(argv[5]) if len(argv) > 5 else 0
+        send(group, count, interval_s, play_delay_ms)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+#
+# @file        trace_decode.py
+# @brief       Decoder of binary trace
+# @author      Copyright (C) Peter Ivanov, 2026
+#
+# Created      2026-10-16 15:10:44
+# Last modify: 2026-10-16 15:10:44 ivanovp {Time-stamp}
+# Licence:     GPL
+#
+# Binary trace (ENABLE_BINARY_TRACE) stores only the address of the format
+# string and the arguments. This script downloads or reads the dump of
+# /trace_bin.bin and formats the records using the format strings of the
+# firmware's ELF file.
+#
+# Usage:
+#   trace_decode.py .pio/build/esp07/firmware.elf trace_bin.bin
+#   trace_decode.py .pio/build/esp07/firmware.elf http://doorbell/trace_bin.bin
+#
+# The ELF file must belong to the firmware running on the device.
+
+import datetime
+import re
+import struct
+import sys
+import urllib.request
+
+DUMP_MAGIC = 0x31425254     # "TRB1"
+TRACE_FLAG_ERROR = 0x01
+ARG_INT = 0
+ARG_DOUBLE = 1
+ARG_STR = 2
+SHT_NOBITS = 8
+
+CONVERSION_RE = re.compile(r'%([-+ #0]*\d*(?:\.\d+)?)(?:hh|h|ll|l|z|j|t)?([diouxXcsfFeEgGp%])')
+
+
+class ElfStrings:
+    """Read zero terminated strings from the loaded sections of an ELF file."""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+        if self.data[:4] != b'\x7fELF':
+            raise ValueError('%s is not an ELF file' % path)
+        is64 = self.data[4] == 2
+        endian = '<' if self.data[5] == 1 else '>'
+        if is64:
+            shoff, = struct.unpack_from(endian + 'Q', self.data, 0x28)
+            shentsize, shnum = struct.unpack_from(endian + 'HH', self.data, 0x3a)
+            fmt = endian + 'IIQQQQ'
+        else:
+            shoff, = struct.unpack_from(endian + 'I', self.data, 0x20)
+            shentsize, shnum = struct.unpack_from(endian + 'HH', self.data, 0x2e)
+            fmt = endian + 'IIIIII'
+        self.sections = []
+        for i in range(shnum):
+            _, sh_type, _, addr, offset, size = struct.unpack_from(fmt, self.data, shoff + i * shentsize)
+            if addr and size and sh_type != SHT_NOBITS:
+                self.sections.append((addr, offset, size))
+
+    def string(self, addr):
+        for sec_addr, offset, size in self.sections:
+            if sec_addr <= addr < sec_addr + size:
+                start = offset + addr - sec_addr
+                end = self.data.index(b'\0', start)
+                return self.data[start:end].decode('utf-8', 'replace')
+        return '<unknown format string 0x%08x>' % addr
+
+
+def format_record(fmt, args):
+    args = list(args)
+
+    def convert(match):
+        flags, conv = match.groups()
+        if conv == '%':
+            return '%'
+        if not args:
+            return '<?>'
+        arg = args.pop(0)
+        if conv in 'di' and isinstance(arg, int):
+            arg = arg - (1 << 32) if arg & 0x80000000 else arg
+            conv = 'd'
+        elif conv == 'u':
+            conv = 'd'
+        elif conv == 'p':
+            flags, conv = '#' + flags, 'x'
+        elif conv == 'c' and isinstance(arg, int):
+            arg = chr(arg & 0xff)
+        try:
+            return ('%' + flags + conv) % arg
+        except (TypeError, ValueError):
+            return str(arg)
+
+    return CONVERSION_RE.sub(convert, fmt)
+
+
+def decode(elf, dump):
+    magic, uptime_ms, epoch, dropped = struct.unpack_from('<4I', dump, 0)
+    if magic != DUMP_MAGIC:
+        raise ValueError('Not a binary trace dump')
+    if dropped:
+        print('# %u older records were overwritten' % dropped)
+    pos = 16
+    line_start = True
+    out = []
+    while pos + 12 <= len(dump):
+        size, flags, arg_cnt, timestamp_ms, fmt_addr = struct.unpack_from('<HBBII', dump, pos)
+        types = dump[pos + 12:pos + 12 + arg_cnt]
+        arg_pos = pos + 12 + arg_cnt
+        args = []
+        for arg_type in types:
+            if arg_type == ARG_STR:
+                length = dump[arg_pos]
+                args.append(dump[arg_pos + 1:arg_pos + 1 + length].decode('utf-8', 'replace'))
+                arg_pos += 1 + length
+            elif arg_type == ARG_DOUBLE:
+                args.append(struct.unpack_from('<d', dump, arg_pos)[0])
+                arg_pos += 8
+            else:
+                args.append(struct.unpack_from('<I', dump, arg_pos)[0])
+                arg_pos += 4
+        fmt = elf.string(fmt_addr)
+        if line_start:
+            if epoch > 1000000000:
+                # Time was set by NTP, convert uptime to local time
+                t = epoch - (uptime_ms - timestamp_ms) / 1000.0
+                out.append(datetime.datetime.fromtimestamp(t).strftime('%Y-%m-%d %H:%M:%S.%f')[:-3] + ' ')
+            else:
+                out.append('%u.%03u ' % (timestamp_ms // 1000, timestamp_ms % 1000))
+            if flags & TRACE_FLAG_ERROR:
+                out.append('ERROR: ')
+        out.append(format_record(fmt, args))
+        line_start = fmt.endswith('\n')
+        pos += size
+    sys.stdout.write(''.join(out))
+
+
+def main():
+    if len(sys.argv) != 3:
+        print('Usage: %s firmware.elf trace_bin.bin|URL' % sys.argv[0])
+        return 1
+    elf = ElfStrings(sys.argv[1])
+    if sys.argv[2].startswith('http://') or sys.argv[2].startswith('https://'):
+        with urllib.request.urlopen(sys.argv[2]) as response:
+            dump = response.read()
+    else:
+        with open(sys.argv[2], 'rb') as f:
+            dump = f.read()
+    decode(elf, dump)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())